@@ -21,7 +21,9 @@ include art/build/Android.common_build.mk
 LIBARTBENCHMARK_COMMON_SRC_FILES := \
   jobject-benchmark/jobject_benchmark.cc \
   jni-perf/perf_jni.cc \
-  scoped-primitive-array/scoped_primitive_array.cc
+  scoped-primitive-array/scoped_primitive_array.cc \
+  stack-walk/stack_walk_benchmark.cc \
+  utf-perf/utf_perf.cc
 
 # $(1): target or host
 define build-libartbenchmark
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import com.google.caliper.SimpleBenchmark;
+
+public class InterpreterBenchmark extends SimpleBenchmark {
+  static class Point {
+    int x;
+    long y;
+    Object z;
+
+    int getX() {
+      return x;
+    }
+  }
+
+  static class Point3 extends Point {
+    @Override
+    int getX() {
+      return x + 1;
+    }
+  }
+
+  private final Point point = new Point();
+  private final Point[] points = { new Point(), new Point3() };
+
+  public int timeArithmetic(int reps) {
+    int result = 0;
+    for (int i = 0; i < reps; ++i) {
+      result = (result * 31 + i) ^ (i >>> 3);
+    }
+    return result;
+  }
+
+  public long timeFieldGetPut(int reps) {
+    Point p = point;
+    for (int i = 0; i < reps; ++i) {
+      p.x = p.x + i;
+      p.y = p.y + p.x;
+      p.z = p;
+    }
+    return p.y;
+  }
+
+  public int timeInvokeVirtualMonomorphic(int reps) {
+    Point p = point;
+    int result = 0;
+    for (int i = 0; i < reps; ++i) {
+      result += p.getX();
+    }
+    return result;
+  }
+
+  public int timeInvokeVirtualPolymorphic(int reps) {
+    int result = 0;
+    for (int i = 0; i < reps; ++i) {
+      result += points[i & 1].getX();
+    }
+    return result;
+  }
+
+  public int timeInvokeStatic(int reps) {
+    int result = 0;
+    for (int i = 0; i < reps; ++i) {
+      result = add(result, i);
+    }
+    return result;
+  }
+
+  private static int add(int a, int b) {
+    return a + b;
+  }
+}
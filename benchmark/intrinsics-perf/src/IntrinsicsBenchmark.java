@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import com.google.caliper.Param;
+import com.google.caliper.SimpleBenchmark;
+
+import java.util.Arrays;
+
+public class IntrinsicsBenchmark extends SimpleBenchmark {
+  @Param({"8", "64", "1024"}) private int size;
+
+  private char[] chars;
+  private String string;
+  private byte[] bytes1;
+  private byte[] bytes2;
+  private int[] ints1;
+  private int[] ints2;
+
+  @Override
+  protected void setUp() {
+    chars = new char[size];
+    for (int i = 0; i < size; ++i) {
+      chars[i] = (char) ('a' + (i % 26));
+    }
+    string = new String(chars);
+    bytes1 = new byte[size];
+    bytes2 = new byte[size];
+    ints1 = new int[size];
+    ints2 = new int[size];
+  }
+
+  public int timeStringHashCode(int reps) {
+    int result = 0;
+    for (int i = 0; i < reps; ++i) {
+      // Use a fresh string so that the cached hash code is not returned.
+      result += new String(chars).hashCode();
+    }
+    return result;
+  }
+
+  public void timeArraysFillByte(int reps) {
+    for (int i = 0; i < reps; ++i) {
+      Arrays.fill(bytes1, (byte) i);
+    }
+  }
+
+  public void timeArraysFillInt(int reps) {
+    for (int i = 0; i < reps; ++i) {
+      Arrays.fill(ints1, i);
+    }
+  }
+
+  public boolean timeArraysEqualsByte(int reps) {
+    boolean result = true;
+    for (int i = 0; i < reps; ++i) {
+      result &= Arrays.equals(bytes1, bytes2);
+    }
+    return result;
+  }
+
+  public boolean timeArraysEqualsInt(int reps) {
+    boolean result = true;
+    for (int i = 0; i < reps; ++i) {
+      result &= Arrays.equals(ints1, ints2);
+    }
+    return result;
+  }
+
+  public void timeSystemArrayCopyByte(int reps) {
+    for (int i = 0; i < reps; ++i) {
+      System.arraycopy(bytes1, 0, bytes2, 0, size);
+    }
+  }
+
+  public void timeSystemArrayCopyInt(int reps) {
+    for (int i = 0; i < reps; ++i) {
+      System.arraycopy(ints1, 0, ints2, 0, size);
+    }
+  }
+
+  public int timeStringBuilderAppend(int reps) {
+    int result = 0;
+    for (int i = 0; i < reps; ++i) {
+      StringBuilder sb = new StringBuilder();
+      sb.append(string).append(chars).append(string);
+      result += sb.length();
+    }
+    return result;
+  }
+}
@@ -34,6 +34,21 @@ extern "C" JNIEXPORT void JNICALL Java_JniPerfBenchmark_perfSOAUncheckedCall(JNI
   ScopedObjectAccessUnchecked soa(Thread::Current());
 }
 
+extern "C" JNIEXPORT jint JNICALL Java_JniPerfBenchmark_perfJniStaticAdd(JNIEnv*,
+                                                                         jclass,
+                                                                         jint a,
+                                                                         jint b) {
+  return a + b;
+}
+
+// Same as above, but called through the critical native stub.
+extern "C" JNIEXPORT jint JNICALL Java_JniPerfBenchmark_perfCriticalNativeAdd(JNIEnv*,
+                                                                              jclass,
+                                                                              jint a,
+                                                                              jint b) {
+  return a + b;
+}
+
 }  // namespace
 
 }  // namespace art
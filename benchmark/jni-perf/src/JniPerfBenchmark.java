@@ -16,12 +16,17 @@
 
 import com.google.caliper.SimpleBenchmark;
 
+import dalvik.annotation.optimization.CriticalNative;
+
 public class JniPerfBenchmark extends SimpleBenchmark {
   private static final String MSG = "ABCDE";
 
   native void perfJniEmptyCall();
   native void perfSOACall();
   native void perfSOAUncheckedCall();
+  static native int perfJniStaticAdd(int a, int b);
+  @CriticalNative
+  static native int perfCriticalNativeAdd(int a, int b);
 
   public void timeFastJNI(int N) {
     // TODO: This might be an intrinsic.
@@ -48,6 +53,20 @@ public class JniPerfBenchmark extends SimpleBenchmark {
     }
   }
 
+  public void timeStaticAddCall(int N) {
+    int sum = 0;
+    for (long i = 0; i < N; i++) {
+      sum = perfJniStaticAdd(sum, 1);
+    }
+  }
+
+  public void timeCriticalNativeAddCall(int N) {
+    int sum = 0;
+    for (long i = 0; i < N; i++) {
+      sum = perfCriticalNativeAdd(sum, 1);
+    }
+  }
+
   {
     System.loadLibrary("artbenchmark");
   }
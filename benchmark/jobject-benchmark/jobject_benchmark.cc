@@ -33,6 +33,28 @@ extern "C" JNIEXPORT void JNICALL Java_JObjectBenchmark_timeAddRemoveLocal(
   }
 }
 
+extern "C" JNIEXPORT void JNICALL Java_JObjectBenchmark_timePushPopLocalFrame(
+    JNIEnv* env, jobject jobj, jint reps) {
+  for (jint i = 0; i < reps; ++i) {
+    CHECK_EQ(env->PushLocalFrame(4), JNI_OK);
+    env->NewLocalRef(jobj);
+    env->PopLocalFrame(nullptr);
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_JObjectBenchmark_timeAddManyLocalsInFrame(
+    JNIEnv* env, jobject jobj, jint reps) {
+  // Enough references to span several chunks of the local reference table.
+  static constexpr jint kLocalsPerFrame = 1000;
+  for (jint i = 0; i < reps; ++i) {
+    CHECK_EQ(env->PushLocalFrame(kLocalsPerFrame), JNI_OK);
+    for (jint j = 0; j < kLocalsPerFrame; ++j) {
+      env->NewLocalRef(jobj);
+    }
+    env->PopLocalFrame(nullptr);
+  }
+}
+
 extern "C" JNIEXPORT void JNICALL Java_JObjectBenchmark_timeDecodeLocal(
     JNIEnv* env, jobject jobj, jint reps) {
   ScopedObjectAccess soa(env);
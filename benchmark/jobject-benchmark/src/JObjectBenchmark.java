@@ -22,6 +22,8 @@ public class JObjectBenchmark extends SimpleBenchmark {
     System.loadLibrary("artbenchmark");
     timeAddRemoveLocal(1);
     timeDecodeLocal(1);
+    timePushPopLocalFrame(1);
+    timeAddManyLocalsInFrame(1);
     timeAddRemoveGlobal(1);
     timeDecodeGlobal(1);
     timeAddRemoveWeakGlobal(1);
@@ -31,6 +33,8 @@ public class JObjectBenchmark extends SimpleBenchmark {
 
   public native void timeAddRemoveLocal(int reps);
   public native void timeDecodeLocal(int reps);
+  public native void timePushPopLocalFrame(int reps);
+  public native void timeAddManyLocalsInFrame(int reps);
   public native void timeAddRemoveGlobal(int reps);
   public native void timeDecodeGlobal(int reps);
   public native void timeAddRemoveWeakGlobal(int reps);
@@ -56,3 +56,27 @@ extern "C" JNIEXPORT jlong JNICALL Java_ScopedPrimitiveArrayBenchmark_measureLon
   }
   return ret;
 }
+
+extern "C" JNIEXPORT jlong JNICALL Java_ScopedPrimitiveArrayBenchmark_measureByteArrayElements(
+    JNIEnv* env, jclass, int reps, jbyteArray arr) {
+  jlong ret = 0;
+  const jsize length = env->GetArrayLength(arr);
+  for (jint i = 0; i < reps; ++i) {
+    jbyte* elements = env->GetByteArrayElements(arr, nullptr);
+    ret += elements[0] + elements[length - 1];
+    env->ReleaseByteArrayElements(arr, elements, JNI_ABORT);
+  }
+  return ret;
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_ScopedPrimitiveArrayBenchmark_measureByteArrayCritical(
+    JNIEnv* env, jclass, int reps, jbyteArray arr) {
+  jlong ret = 0;
+  const jsize length = env->GetArrayLength(arr);
+  for (jint i = 0; i < reps; ++i) {
+    jbyte* elements = reinterpret_cast<jbyte*>(env->GetPrimitiveArrayCritical(arr, nullptr));
+    ret += elements[0] + elements[length - 1];
+    env->ReleasePrimitiveArrayCritical(arr, elements, JNI_ABORT);
+  }
+  return ret;
+}
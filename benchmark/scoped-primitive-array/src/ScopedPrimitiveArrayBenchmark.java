@@ -22,6 +22,9 @@ public class ScopedPrimitiveArrayBenchmark extends SimpleBenchmark {
   static native long measureShortArray(int reps, short[] arr);
   static native long measureIntArray(int reps, int[] arr);
   static native long measureLongArray(int reps, long[] arr);
+  // The same for byte arrays, through Get/Release<Type>ArrayElements and the critical variant.
+  static native long measureByteArrayElements(int reps, byte[] arr);
+  static native long measureByteArrayCritical(int reps, byte[] arr);
 
   static final int smallLength = 16;
   static final int mediumLength = 256;
@@ -51,6 +54,30 @@ public class ScopedPrimitiveArrayBenchmark extends SimpleBenchmark {
     measureByteArray(reps, largeBytes);
   }
 
+  public void timeSmallBytesElements(int reps) {
+    measureByteArrayElements(reps, smallBytes);
+  }
+
+  public void timeMediumBytesElements(int reps) {
+    measureByteArrayElements(reps, mediumBytes);
+  }
+
+  public void timeLargeBytesElements(int reps) {
+    measureByteArrayElements(reps, largeBytes);
+  }
+
+  public void timeSmallBytesCritical(int reps) {
+    measureByteArrayCritical(reps, smallBytes);
+  }
+
+  public void timeMediumBytesCritical(int reps) {
+    measureByteArrayCritical(reps, mediumBytes);
+  }
+
+  public void timeLargeBytesCritical(int reps) {
+    measureByteArrayCritical(reps, largeBytes);
+  }
+
   public void timeSmallShorts(int reps) {
     measureShortArray(reps, smallShorts);
   }
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import com.google.caliper.SimpleBenchmark;
+
+public class StackWalkBenchmark extends SimpleBenchmark {
+  private static final int SHALLOW_DEPTH = 10;
+  private static final int DEEP_DEPTH = 100;
+
+  private static final int WALK = 0;
+  private static final int WALK_WITH_INLINED_FRAMES = 1;
+  private static final int STACK_TRACE = 2;
+
+  public StackWalkBenchmark() {
+    // Make sure to link methods before benchmark starts.
+    System.loadLibrary("artbenchmark");
+    walkStack(1);
+    walkStackWithInlinedFrames(1);
+  }
+
+  private static int recurse(int depth, int kind, int reps) {
+    if (depth > 0) {
+      return recurse(depth - 1, kind, reps) + 1;
+    }
+    switch (kind) {
+      case WALK:
+        return walkStack(reps);
+      case WALK_WITH_INLINED_FRAMES:
+        return walkStackWithInlinedFrames(reps);
+      default:
+        int result = 0;
+        for (int i = 0; i < reps; ++i) {
+          result += new Throwable().getStackTrace().length;
+        }
+        return result;
+    }
+  }
+
+  public void timeWalkShallowStack(int reps) {
+    recurse(SHALLOW_DEPTH, WALK, reps);
+  }
+
+  public void timeWalkDeepStack(int reps) {
+    recurse(DEEP_DEPTH, WALK, reps);
+  }
+
+  public void timeWalkDeepStackWithInlinedFrames(int reps) {
+    recurse(DEEP_DEPTH, WALK_WITH_INLINED_FRAMES, reps);
+  }
+
+  public void timeDeepStackTrace(int reps) {
+    recurse(DEEP_DEPTH, STACK_TRACE, reps);
+  }
+
+  private static native int walkStack(int reps);
+  private static native int walkStackWithInlinedFrames(int reps);
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jni.h"
+
+#include "art_method-inl.h"
+#include "scoped_thread_state_change.h"
+#include "stack.h"
+#include "thread-inl.h"
+
+namespace art {
+namespace {
+
+// Visits every Java frame and decodes its dex pc, which for compiled frames
+// looks up and decodes the stack map of the current native pc.
+class DexPcVisitor FINAL : public StackVisitor {
+ public:
+  DexPcVisitor(Thread* thread, StackVisitor::StackWalkKind walk_kind)
+      SHARED_REQUIRES(Locks::mutator_lock_)
+      : StackVisitor(thread, nullptr, walk_kind), dex_pc_sum_(0u) {}
+
+  bool VisitFrame() OVERRIDE SHARED_REQUIRES(Locks::mutator_lock_) {
+    ArtMethod* m = GetMethod();
+    if (m != nullptr && !m->IsRuntimeMethod() && !m->IsNative()) {
+      dex_pc_sum_ += GetDexPc(/* abort_on_failure */ false);
+    }
+    return true;
+  }
+
+  uint32_t GetDexPcSum() const {
+    return dex_pc_sum_;
+  }
+
+ private:
+  uint32_t dex_pc_sum_;
+};
+
+static jint WalkStack(JNIEnv* env, jint reps, StackVisitor::StackWalkKind walk_kind) {
+  ScopedObjectAccess soa(env);
+  uint32_t result = 0u;
+  for (jint i = 0; i < reps; ++i) {
+    DexPcVisitor visitor(soa.Self(), walk_kind);
+    visitor.WalkStack();
+    result += visitor.GetDexPcSum();
+  }
+  return static_cast<jint>(result);
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_StackWalkBenchmark_walkStack(
+    JNIEnv* env, jclass, jint reps) {
+  return WalkStack(env, reps, StackVisitor::StackWalkKind::kSkipInlinedFrames);
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_StackWalkBenchmark_walkStackWithInlinedFrames(
+    JNIEnv* env, jclass, jint reps) {
+  return WalkStack(env, reps, StackVisitor::StackWalkKind::kIncludeInlinedFrames);
+}
+
+}  // namespace
+}  // namespace art
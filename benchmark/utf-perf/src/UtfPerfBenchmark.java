@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import com.google.caliper.Param;
+import com.google.caliper.SimpleBenchmark;
+
+public class UtfPerfBenchmark extends SimpleBenchmark {
+  @Param({"16", "256", "4096"}) private int length;
+  @Param({"true", "false"}) private boolean ascii;
+
+  private String string;
+
+  static native void initStrings(int length, boolean ascii);
+  static native long perfCountModifiedUtf8Chars(int reps);
+  static native void perfConvertModifiedUtf8ToUtf16(int reps);
+  static native void perfConvertUtf16ToModifiedUtf8(int reps);
+  static native long perfCountUtf8Bytes(int reps);
+  static native int perfComputeUtf16Hash(int reps);
+  static native int perfMemCmp16(int reps);
+  static native void perfNewStringUtf(int reps);
+  static native void perfGetStringUtfChars(String string, int reps);
+
+  @Override
+  protected void setUp() {
+    initStrings(length, ascii);
+    StringBuilder sb = new StringBuilder();
+    for (int i = 0; i < length; ++i) {
+      sb.append((!ascii && (i % 32) == 31) ? '\u00e9' : (char) ('a' + (i % 26)));
+    }
+    string = sb.toString();
+  }
+
+  public long timeCountModifiedUtf8Chars(int reps) {
+    return perfCountModifiedUtf8Chars(reps);
+  }
+
+  public void timeConvertModifiedUtf8ToUtf16(int reps) {
+    perfConvertModifiedUtf8ToUtf16(reps);
+  }
+
+  public void timeConvertUtf16ToModifiedUtf8(int reps) {
+    perfConvertUtf16ToModifiedUtf8(reps);
+  }
+
+  public long timeCountUtf8Bytes(int reps) {
+    return perfCountUtf8Bytes(reps);
+  }
+
+  public int timeComputeUtf16Hash(int reps) {
+    return perfComputeUtf16Hash(reps);
+  }
+
+  public int timeMemCmp16(int reps) {
+    return perfMemCmp16(reps);
+  }
+
+  public void timeNewStringUtf(int reps) {
+    perfNewStringUtf(reps);
+  }
+
+  public void timeGetStringUtfChars(int reps) {
+    perfGetStringUtfChars(string, reps);
+  }
+
+  {
+    System.loadLibrary("artbenchmark");
+  }
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include "arch/memcmp16.h"
+#include "jni.h"
+#include "utf.h"
+
+namespace art {
+
+namespace {
+
+// The strings being converted, set up by UtfPerfBenchmark.setUp().
+std::vector<uint16_t> utf16;
+std::vector<uint16_t> utf16_copy;
+std::vector<char> utf8;
+std::vector<uint16_t> utf16_out;
+std::vector<char> utf8_out;
+
+extern "C" JNIEXPORT void JNICALL Java_UtfPerfBenchmark_initStrings(JNIEnv*,
+                                                                    jclass,
+                                                                    jint length,
+                                                                    jboolean ascii) {
+  utf16.resize(length);
+  for (jint i = 0; i < length; ++i) {
+    // Put an e with acute accent, encoded as two bytes of UTF-8, in every 32 characters.
+    utf16[i] = (!ascii && (i % 32) == 31) ? 0xe9 : 'a' + (i % 26);
+  }
+  utf16_copy = utf16;
+  size_t byte_count = CountUtf8Bytes(utf16.data(), utf16.size());
+  // Null terminated for the debug checks of CountModifiedUtf8Chars.
+  utf8.assign(byte_count + 1, '\0');
+  ConvertUtf16ToModifiedUtf8(utf8.data(), byte_count, utf16.data(), utf16.size());
+  utf16_out.resize(utf16.size());
+  utf8_out.resize(byte_count);
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_UtfPerfBenchmark_perfCountModifiedUtf8Chars(JNIEnv*,
+                                                                                    jclass,
+                                                                                    jint reps) {
+  jlong result = 0;
+  for (jint i = 0; i < reps; ++i) {
+    result += CountModifiedUtf8Chars(utf8.data(), utf8.size() - 1);
+  }
+  return result;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_UtfPerfBenchmark_perfConvertModifiedUtf8ToUtf16(
+    JNIEnv*, jclass, jint reps) {
+  for (jint i = 0; i < reps; ++i) {
+    ConvertModifiedUtf8ToUtf16(utf16_out.data(), utf16_out.size(), utf8.data(), utf8.size() - 1);
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_UtfPerfBenchmark_perfConvertUtf16ToModifiedUtf8(
+    JNIEnv*, jclass, jint reps) {
+  for (jint i = 0; i < reps; ++i) {
+    ConvertUtf16ToModifiedUtf8(utf8_out.data(), utf8_out.size(), utf16.data(), utf16.size());
+  }
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_UtfPerfBenchmark_perfCountUtf8Bytes(JNIEnv*,
+                                                                           jclass,
+                                                                           jint reps) {
+  jlong result = 0;
+  for (jint i = 0; i < reps; ++i) {
+    result += CountUtf8Bytes(utf16.data(), utf16.size());
+  }
+  return result;
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_UtfPerfBenchmark_perfComputeUtf16Hash(JNIEnv*,
+                                                                            jclass,
+                                                                            jint reps) {
+  jint result = 0;
+  for (jint i = 0; i < reps; ++i) {
+    result += ComputeUtf16Hash(utf16.data(), utf16.size());
+  }
+  return result;
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_UtfPerfBenchmark_perfMemCmp16(JNIEnv*,
+                                                                    jclass,
+                                                                    jint reps) {
+  jint result = 0;
+  for (jint i = 0; i < reps; ++i) {
+    result += testing::MemCmp16Testing(utf16.data(), utf16_copy.data(), utf16.size());
+  }
+  return result;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_UtfPerfBenchmark_perfNewStringUtf(JNIEnv* env,
+                                                                        jclass,
+                                                                        jint reps) {
+  for (jint i = 0; i < reps; ++i) {
+    env->DeleteLocalRef(env->NewStringUTF(utf8.data()));
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_UtfPerfBenchmark_perfGetStringUtfChars(JNIEnv* env,
+                                                                             jclass,
+                                                                             jstring string,
+                                                                             jint reps) {
+  for (jint i = 0; i < reps; ++i) {
+    const char* chars = env->GetStringUTFChars(string, nullptr);
+    env->ReleaseStringUTFChars(string, chars);
+  }
+}
+
+}  // namespace
+
+}  // namespace art
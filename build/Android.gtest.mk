@@ -205,6 +205,7 @@ RUNTIME_GTEST_COMMON_SRC_FILES := \
   runtime/indirect_reference_table_test.cc \
   runtime/instrumentation_test.cc \
   runtime/intern_table_test.cc \
+  runtime/interpreter/interpreter_cache_test.cc \
   runtime/interpreter/safe_math_test.cc \
   runtime/interpreter/unstarted_runtime_test.cc \
   runtime/java_vm_ext_test.cc \
@@ -222,6 +223,7 @@ RUNTIME_GTEST_COMMON_SRC_FILES := \
   runtime/parsed_options_test.cc \
   runtime/prebuilt_tools_test.cc \
   runtime/reference_table_test.cc \
+  runtime/thread_list_test.cc \
   runtime/thread_pool_test.cc \
   runtime/transaction_test.cc \
   runtime/type_lookup_table_test.cc \
@@ -229,6 +231,7 @@ RUNTIME_GTEST_COMMON_SRC_FILES := \
   runtime/utils_test.cc \
   runtime/verifier/method_verifier_test.cc \
   runtime/verifier/reg_type_test.cc \
+  runtime/verifier/verification_cache_test.cc \
   runtime/zip_archive_test.cc
 
 COMPILER_GTEST_COMMON_SRC_FILES := \
@@ -250,6 +253,7 @@ COMPILER_GTEST_COMMON_SRC_FILES := \
   compiler/jni/jni_compiler_test.cc \
   compiler/oat_test.cc \
   compiler/optimizing/bounds_check_elimination_test.cc \
+  compiler/optimizing/code_sinking_test.cc \
   compiler/optimizing/dominator_test.cc \
   compiler/optimizing/find_loops_test.cc \
   compiler/optimizing/graph_checker_test.cc \
@@ -259,9 +263,12 @@ COMPILER_GTEST_COMMON_SRC_FILES := \
   compiler/optimizing/induction_var_range_test.cc \
   compiler/optimizing/licm_test.cc \
   compiler/optimizing/live_interval_test.cc \
+  compiler/optimizing/loop_unrolling_test.cc \
   compiler/optimizing/nodes_test.cc \
   compiler/optimizing/parallel_move_test.cc \
   compiler/optimizing/pretty_printer_test.cc \
+  compiler/optimizing/redundant_check_elimination_test.cc \
+  compiler/optimizing/select_generator_test.cc \
   compiler/optimizing/side_effects_test.cc \
   compiler/optimizing/ssa_test.cc \
   compiler/optimizing/stack_map_test.cc \
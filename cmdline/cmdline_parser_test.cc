@@ -464,6 +464,7 @@ TEST_F(CmdlineParserTest, TestJitOptions) {
   }
   {
     EXPECT_SINGLE_PARSE_VALUE(12345u, "-Xjitthreshold:12345", M::JITCompileThreshold);
+    EXPECT_SINGLE_PARSE_VALUE(0u, "-Xjitoptimizethreshold:0", M::JITOptimizeThreshold);
   }
 }  // TEST_F
 
@@ -568,6 +569,17 @@ TEST_F(CmdlineParserTest, TestVerify) {
   EXPECT_SINGLE_PARSE_VALUE(verifier::VerifyMode::kSoftFail, "-Xverify:softfail", M::Verify);
 }
 
+// -Xinterpreter:_
+TEST_F(CmdlineParserTest, TestInterpreterImpl) {
+  EXPECT_SINGLE_PARSE_VALUE(interpreter::InterpreterImplKind::kSwitchImpl,
+                            "-Xinterpreter:switch",
+                            M::InterpreterImpl);
+  EXPECT_SINGLE_PARSE_VALUE(interpreter::InterpreterImplKind::kComputedGotoImpl,
+                            "-Xinterpreter:goto",
+                            M::InterpreterImpl);
+  EXPECT_SINGLE_PARSE_FAIL("-Xinterpreter:whatever", CmdlineResult::kFailure);
+}
+
 TEST_F(CmdlineParserTest, TestIgnoreUnrecognized) {
   RuntimeParser::Builder parserBuilder;
 
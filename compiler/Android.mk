@@ -67,6 +67,7 @@ LIBART_COMPILER_SRC_FILES := \
 	optimizing/builder.cc \
 	optimizing/code_generator.cc \
 	optimizing/code_generator_utils.cc \
+	optimizing/code_sinking.cc \
 	optimizing/constant_folding.cc \
 	optimizing/dead_code_elimination.cc \
 	optimizing/dex_cache_array_fixups_arm.cc \
@@ -81,6 +82,7 @@ LIBART_COMPILER_SRC_FILES := \
 	optimizing/licm.cc \
 	optimizing/load_store_elimination.cc \
 	optimizing/locations.cc \
+	optimizing/loop_unrolling.cc \
 	optimizing/nodes.cc \
 	optimizing/nodes_arm64.cc \
 	optimizing/optimization.cc \
@@ -89,8 +91,10 @@ LIBART_COMPILER_SRC_FILES := \
 	optimizing/pc_relative_fixups_x86.cc \
 	optimizing/prepare_for_register_allocation.cc \
 	optimizing/primitive_type_propagation.cc \
+	optimizing/redundant_check_elimination.cc \
 	optimizing/reference_type_propagation.cc \
 	optimizing/register_allocator.cc \
+	optimizing/select_generator.cc \
 	optimizing/sharpening.cc \
 	optimizing/side_effects_analysis.cc \
 	optimizing/ssa_builder.cc \
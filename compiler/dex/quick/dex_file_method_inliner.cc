@@ -74,6 +74,11 @@ static constexpr bool kIntrinsicIsStatic[] = {
     false,  // kIntrinsicUnsafePut
     true,   // kIntrinsicSystemArrayCopyCharArray
     true,   // kIntrinsicSystemArrayCopy
+    true,   // kIntrinsicSystemArrayCopyByteArray
+    true,   // kIntrinsicSystemArrayCopyIntArray
+    false,  // kIntrinsicHashCode
+    true,   // kIntrinsicArraysFill
+    true,   // kIntrinsicArraysEquals
 };
 static_assert(arraysize(kIntrinsicIsStatic) == kInlineOpNop,
               "arraysize of kIntrinsicIsStatic unexpected");
@@ -124,6 +129,13 @@ static_assert(kIntrinsicIsStatic[kIntrinsicSystemArrayCopyCharArray],
               "SystemArrayCopyCharArray must be static");
 static_assert(kIntrinsicIsStatic[kIntrinsicSystemArrayCopy],
               "SystemArrayCopy must be static");
+static_assert(kIntrinsicIsStatic[kIntrinsicSystemArrayCopyByteArray],
+              "SystemArrayCopyByteArray must be static");
+static_assert(kIntrinsicIsStatic[kIntrinsicSystemArrayCopyIntArray],
+              "SystemArrayCopyIntArray must be static");
+static_assert(!kIntrinsicIsStatic[kIntrinsicHashCode], "HashCode must not be static");
+static_assert(kIntrinsicIsStatic[kIntrinsicArraysFill], "ArraysFill must be static");
+static_assert(kIntrinsicIsStatic[kIntrinsicArraysEquals], "ArraysEquals must be static");
 
 MIR* AllocReplacementMIR(MIRGraph* mir_graph, MIR* invoke) {
   MIR* insn = mir_graph->NewMIR();
@@ -184,6 +196,7 @@ const char* const DexFileMethodInliner::kClassCacheNames[] = {
     "Llibcore/io/Memory;",     // kClassCacheLibcoreIoMemory
     "Lsun/misc/Unsafe;",       // kClassCacheSunMiscUnsafe
     "Ljava/lang/System;",      // kClassCacheJavaLangSystem
+    "Ljava/util/Arrays;",      // kClassCacheJavaUtilArrays
 };
 
 const char* const DexFileMethodInliner::kNameCacheNames[] = {
@@ -245,6 +258,8 @@ const char* const DexFileMethodInliner::kNameCacheNames[] = {
     "numberOfTrailingZeros",  // kNameCacheNumberOfTrailingZeros
     "rotateRight",           // kNameCacheRotateRight
     "rotateLeft",            // kNameCacheRotateLeft
+    "hashCode",              // kNameCacheHashCode
+    "fill",                  // kNameCacheFill
 };
 
 const DexFileMethodInliner::ProtoDef DexFileMethodInliner::kProtoCacheDefs[] = {
@@ -332,6 +347,20 @@ const DexFileMethodInliner::ProtoDef DexFileMethodInliner::kProtoCacheDefs[] = {
     // kProtoCacheObjectIObjectII_V
     { kClassCacheVoid, 5, {kClassCacheJavaLangObject, kClassCacheInt,
         kClassCacheJavaLangObject, kClassCacheInt, kClassCacheInt} },
+    // kProtoCacheByteArrayIByteArrayII_V
+    { kClassCacheVoid, 5, {kClassCacheJavaLangByteArray, kClassCacheInt,
+        kClassCacheJavaLangByteArray, kClassCacheInt, kClassCacheInt} },
+    // kProtoCacheIntArrayIIntArrayII_V
+    { kClassCacheVoid, 5, {kClassCacheJavaLangIntArray, kClassCacheInt,
+        kClassCacheJavaLangIntArray, kClassCacheInt, kClassCacheInt} },
+    // kProtoCacheByteArrayB_V
+    { kClassCacheVoid, 2, { kClassCacheJavaLangByteArray, kClassCacheByte } },
+    // kProtoCacheIntArrayI_V
+    { kClassCacheVoid, 2, { kClassCacheJavaLangIntArray, kClassCacheInt } },
+    // kProtoCacheByteArrayByteArray_Z
+    { kClassCacheBoolean, 2, { kClassCacheJavaLangByteArray, kClassCacheJavaLangByteArray } },
+    // kProtoCacheIntArrayIntArray_Z
+    { kClassCacheBoolean, 2, { kClassCacheJavaLangIntArray, kClassCacheJavaLangIntArray } },
     // kProtoCacheIICharArrayI_V
     { kClassCacheVoid, 4, { kClassCacheInt, kClassCacheInt, kClassCacheJavaLangCharArray,
         kClassCacheInt } },
@@ -445,6 +474,7 @@ const DexFileMethodInliner::IntrinsicDef DexFileMethodInliner::kIntrinsicMethods
     INTRINSIC(JavaLangString, CompareTo, String_I, kIntrinsicCompareTo, 0),
     INTRINSIC(JavaLangString, Equals, Object_Z, kIntrinsicEquals, 0),
     INTRINSIC(JavaLangString, GetCharsNoCheck, IICharArrayI_V, kIntrinsicGetCharsNoCheck, 0),
+    INTRINSIC(JavaLangString, HashCode, _I, kIntrinsicHashCode, 0),
     INTRINSIC(JavaLangString, IsEmpty, _Z, kIntrinsicIsEmptyOrLength, kIntrinsicFlagIsEmpty),
     INTRINSIC(JavaLangString, IndexOf, II_I, kIntrinsicIndexOf, kIntrinsicFlagNone),
     INTRINSIC(JavaLangString, IndexOf, I_I, kIntrinsicIndexOf, kIntrinsicFlagBase0),
@@ -489,6 +519,15 @@ const DexFileMethodInliner::IntrinsicDef DexFileMethodInliner::kIntrinsicMethods
               0),
     INTRINSIC(JavaLangSystem, ArrayCopy, ObjectIObjectII_V , kIntrinsicSystemArrayCopy,
               0),
+    INTRINSIC(JavaLangSystem, ArrayCopy, ByteArrayIByteArrayII_V,
+              kIntrinsicSystemArrayCopyByteArray, 0),
+    INTRINSIC(JavaLangSystem, ArrayCopy, IntArrayIIntArrayII_V,
+              kIntrinsicSystemArrayCopyIntArray, 0),
+
+    INTRINSIC(JavaUtilArrays, Fill, ByteArrayB_V, kIntrinsicArraysFill, kSignedByte),
+    INTRINSIC(JavaUtilArrays, Fill, IntArrayI_V, kIntrinsicArraysFill, k32),
+    INTRINSIC(JavaUtilArrays, Equals, ByteArrayByteArray_Z, kIntrinsicArraysEquals, kSignedByte),
+    INTRINSIC(JavaUtilArrays, Equals, IntArrayIntArray_Z, kIntrinsicArraysEquals, k32),
 
     INTRINSIC(JavaLangInteger, RotateRight, II_I, kIntrinsicRotateRight, k32),
     INTRINSIC(JavaLangLong, RotateRight, JI_J, kIntrinsicRotateRight, k64),
@@ -662,6 +701,11 @@ bool DexFileMethodInliner::GenIntrinsic(Mir2Lir* backend, CallInfo* info) {
     case kIntrinsicRotateRight:
     case kIntrinsicRotateLeft:
     case kIntrinsicSystemArrayCopy:
+    case kIntrinsicSystemArrayCopyByteArray:
+    case kIntrinsicSystemArrayCopyIntArray:
+    case kIntrinsicHashCode:
+    case kIntrinsicArraysFill:
+    case kIntrinsicArraysEquals:
       return false;   // not implemented in quick.
     default:
       LOG(FATAL) << "Unexpected intrinsic opcode: " << intrinsic.opcode;
@@ -143,6 +143,7 @@ class DexFileMethodInliner {
       kClassCacheLibcoreIoMemory,
       kClassCacheSunMiscUnsafe,
       kClassCacheJavaLangSystem,
+      kClassCacheJavaUtilArrays,
       kClassCacheLast
     };
 
@@ -211,6 +212,8 @@ class DexFileMethodInliner {
       kNameCacheNumberOfTrailingZeros,
       kNameCacheRotateRight,
       kNameCacheRotateLeft,
+      kNameCacheHashCode,
+      kNameCacheFill,
       kNameCacheLast
     };
 
@@ -260,6 +263,12 @@ class DexFileMethodInliner {
       kProtoCacheObjectJObject_V,
       kProtoCacheCharArrayICharArrayII_V,
       kProtoCacheObjectIObjectII_V,
+      kProtoCacheByteArrayIByteArrayII_V,
+      kProtoCacheIntArrayIIntArrayII_V,
+      kProtoCacheByteArrayB_V,
+      kProtoCacheIntArrayI_V,
+      kProtoCacheByteArrayByteArray_Z,
+      kProtoCacheIntArrayIntArray_Z,
       kProtoCacheIICharArrayI_V,
       kProtoCacheByteArrayIII_String,
       kProtoCacheIICharArray_String,
@@ -93,7 +93,7 @@ class CompiledMethodStorage {
                                    LengthPrefixedArrayAlloc<T>,
                                    size_t,
                                    DedupeHashFunc<const T>,
-                                   4>;
+                                   16>;
 
   // Swap pool and allocator used for native allocations. May be file-backed. Needs to be first
   // as other fields rely on this.
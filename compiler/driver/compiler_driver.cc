@@ -526,6 +526,35 @@ static bool InstructionSetHasGenericJniStub(InstructionSet isa) {
   }
 }
 
+// Build-time annotation with which native methods opt into the critical native JNI stub, see
+// ArtJniCompileMethodInternal.
+static constexpr const char* kCriticalNativeAnnotationDescriptor =
+    "Ldalvik/annotation/optimization/CriticalNative;";
+
+static bool IsCriticalNativeMethod(const DexFile& dex_file,
+                                   uint16_t class_def_idx,
+                                   uint32_t method_idx,
+                                   uint32_t access_flags) {
+  DCHECK_NE(access_flags & kAccNative, 0u);
+  const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_idx);
+  if (!dex_file.IsMethodAnnotationPresent(class_def,
+                                          method_idx,
+                                          kCriticalNativeAnnotationDescriptor,
+                                          DexFile::kDexVisibilityBuild)) {
+    return false;
+  }
+  const char* shorty = dex_file.GetMethodShorty(dex_file.GetMethodId(method_idx));
+  if ((access_flags & kAccStatic) == 0 ||
+      (access_flags & kAccSynchronized) != 0 ||
+      strchr(shorty, 'L') != nullptr) {
+    LOG(WARNING) << "Ignoring @CriticalNative on " << PrettyMethod(method_idx, dex_file)
+                 << ": only static, unsynchronized methods with primitive arguments and return"
+                 << " type qualify";
+    return false;
+  }
+  return true;
+}
+
 static void CompileMethod(Thread* self,
                           CompilerDriver* driver,
                           const DexFile::CodeItem* code_item,
@@ -550,7 +579,11 @@ static void CompileMethod(Thread* self,
         InstructionSetHasGenericJniStub(driver->GetInstructionSet())) {
       // Leaving this empty will trigger the generic JNI version
     } else {
-      compiled_method = driver->GetCompiler()->JniCompile(access_flags, method_idx, dex_file);
+      uint32_t jni_access_flags = access_flags;
+      if (IsCriticalNativeMethod(dex_file, class_def_idx, method_idx, access_flags)) {
+        jni_access_flags |= kAccCriticalNative;
+      }
+      compiled_method = driver->GetCompiler()->JniCompile(jni_access_flags, method_idx, dex_file);
       CHECK(compiled_method != nullptr);
     }
   } else if ((access_flags & kAccAbstract) != 0) {
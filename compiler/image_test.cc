@@ -16,8 +16,10 @@
 
 #include "image.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "base/unix_file/fd_file.h"
@@ -33,6 +35,7 @@
 #include "oat_writer.h"
 #include "scoped_thread_state_change.h"
 #include "signal_catcher.h"
+#include "utf.h"
 #include "utils.h"
 #include "vector_output_stream.h"
 
@@ -44,6 +47,22 @@ class ImageTest : public CommonCompilerTest {
     ReserveImageSpace();
     CommonCompilerTest::SetUp();
   }
+
+  // Returns whether `object` starts one of the bins of `writer`. Only valid once the image
+  // address space has been prepared.
+  static bool IsAtBinStart(const ImageWriter& writer, mirror::Object* object)
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    const size_t* const begin = writer.bin_slot_offsets_;
+    const size_t* const end = begin + ImageWriter::kBinMirrorCount;
+    return std::find(begin, end, writer.GetImageOffset(object)) != end;
+  }
+};
+
+class ImageLayoutTest : public ImageTest {
+ protected:
+  std::unordered_set<std::string>* GetImageClasses() OVERRIDE {
+    return new std::unordered_set<std::string>({ "Ljava/util/ArrayList;", "Ljava/util/HashMap;" });
+  }
 };
 
 TEST_F(ImageTest, WriteRead) {
@@ -69,7 +88,9 @@ TEST_F(ImageTest, WriteRead) {
   std::unique_ptr<ImageWriter> writer(new ImageWriter(*compiler_driver_,
                                                       requested_image_base,
                                                       /*compile_pic*/false,
-                                                      /*compile_app_image*/false));
+                                                      /*compile_app_image*/false,
+                                                      /*startup_classes*/nullptr,
+                                                      /*class_loader*/nullptr));
   // TODO: compile_pic should be a test argument.
   {
     {
@@ -93,7 +114,8 @@ TEST_F(ImageTest, WriteRead) {
                            writer.get(),
                            /*compiling_boot_image*/true,
                            &timings,
-                           &key_value_store);
+                           &key_value_store,
+                           /* hot_methods */ nullptr);
       std::unique_ptr<ElfWriter> elf_writer = CreateElfWriterQuick(
           compiler_driver_->GetInstructionSet(),
           &compiler_driver_->GetCompilerOptions(),
@@ -238,6 +260,41 @@ TEST_F(ImageTest, WriteRead) {
   CHECK_EQ(0, rmdir_result);
 }
 
+TEST_F(ImageLayoutTest, StartupClassesFirst) {
+  TEST_DISABLED_FOR_NON_PIC_COMPILING_WITH_OPTIMIZING();
+  // HashMap is allocated long after the heap walk would otherwise reach the start of its bin.
+  // Unknown descriptors must be skipped without affecting the rest of the layout.
+  const std::vector<std::string> startup_classes = {
+      "Lno/such/Class;", "Ljava/util/HashMap;", "Ljava/util/ArrayList;" };
+  std::unique_ptr<ImageWriter> writer(new ImageWriter(*compiler_driver_,
+                                                      ART_BASE_ADDRESS,
+                                                      /*compile_pic*/false,
+                                                      /*compile_app_image*/false,
+                                                      &startup_classes,
+                                                      /*class_loader*/nullptr));
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  {
+    jobject class_loader = nullptr;
+    TimingLogger timings("ImageLayoutTest::StartupClassesFirst", false, false);
+    for (const DexFile* dex_file : class_linker->GetBootClassPath()) {
+      dex_file->EnableWrite();
+    }
+    compiler_driver_->SetDexFilesForOatFile(class_linker->GetBootClassPath());
+    compiler_driver_->CompileAll(class_loader, class_linker->GetBootClassPath(), &timings);
+  }
+  ASSERT_TRUE(writer->PrepareImageAddressSpace());
+
+  ScopedObjectAccess soa(Thread::Current());
+  const char* descriptor = "Ljava/util/HashMap;";
+  mirror::Class* hash_map = class_linker->LookupClass(soa.Self(),
+                                                      descriptor,
+                                                      ComputeModifiedUtf8Hash(descriptor),
+                                                      /*class_loader*/nullptr);
+  ASSERT_TRUE(hash_map != nullptr);
+  // The first startup class found is the first object walked, so it opens its bin.
+  EXPECT_TRUE(IsAtBinStart(*writer, hash_map));
+}
+
 TEST_F(ImageTest, ImageHeaderIsValid) {
     uint32_t image_begin = ART_BASE_ADDRESS;
     uint32_t image_size_ = 16 * KB;
@@ -25,6 +25,7 @@
 #include <set>
 #include <string>
 #include <ostream>
+#include <vector>
 
 #include "base/bit_utils.h"
 #include "base/macros.h"
@@ -54,7 +55,9 @@ class ImageWriter FINAL {
   ImageWriter(const CompilerDriver& compiler_driver,
               uintptr_t image_begin,
               bool compile_pic,
-              bool compile_app_image)
+              bool compile_app_image,
+              const std::vector<std::string>* startup_classes,
+              jobject class_loader)
       : compiler_driver_(compiler_driver),
         image_begin_(reinterpret_cast<uint8_t*>(image_begin)),
         image_end_(0),
@@ -64,6 +67,8 @@ class ImageWriter FINAL {
         oat_data_begin_(nullptr),
         compile_pic_(compile_pic),
         compile_app_image_(compile_app_image),
+        startup_classes_(startup_classes),
+        class_loader_(class_loader),
         boot_image_space_(nullptr),
         target_ptr_size_(InstructionSetPointerSize(compiler_driver_.GetInstructionSet())),
         bin_slot_sizes_(),
@@ -289,6 +294,10 @@ class ImageWriter FINAL {
       SHARED_REQUIRES(Locks::mutator_lock_);
   void WalkFieldsInOrder(mirror::Object* obj)
       SHARED_REQUIRES(Locks::mutator_lock_);
+  // Assign bin slots to the classes of the startup profile, and everything reachable from them,
+  // in the order the classes were first touched. This packs the objects used during startup at
+  // the beginning of each bin.
+  void WalkStartupClasses() SHARED_REQUIRES(Locks::mutator_lock_);
   static void WalkFieldsCallback(mirror::Object* obj, void* arg)
       SHARED_REQUIRES(Locks::mutator_lock_);
   static void UnbinObjectsIntoOffsetCallback(mirror::Object* obj, void* arg)
@@ -412,6 +421,12 @@ class ImageWriter FINAL {
   const bool compile_pic_;
   const bool compile_app_image_;
 
+  // Descriptors of the classes used during startup, in first-touch order. May be null.
+  const std::vector<std::string>* const startup_classes_;
+
+  // Class loader the startup classes of an app image are defined by. Null for the boot image.
+  const jobject class_loader_;
+
   // Cache the boot image space in this class for faster lookups.
   gc::space::ImageSpace* boot_image_space_;
 
@@ -457,6 +472,7 @@ class ImageWriter FINAL {
   friend class FixupClassVisitor;
   friend class FixupRootVisitor;
   friend class FixupVisitor;
+  friend class ImageTest;
   friend class NativeLocationVisitor;
   friend class NonImageClassesVisitor;
   DISALLOW_COPY_AND_ASSIGN(ImageWriter);
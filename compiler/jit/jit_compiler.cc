@@ -56,11 +56,11 @@ extern "C" void jit_unload(void* handle) {
   delete reinterpret_cast<JitCompiler*>(handle);
 }
 
-extern "C" bool jit_compile_method(void* handle, ArtMethod* method, Thread* self)
+extern "C" bool jit_compile_method(void* handle, ArtMethod* method, Thread* self, bool baseline)
     SHARED_REQUIRES(Locks::mutator_lock_) {
   auto* jit_compiler = reinterpret_cast<JitCompiler*>(handle);
   DCHECK(jit_compiler != nullptr);
-  return jit_compiler->CompileMethod(self, method);
+  return jit_compiler->CompileMethod(self, method, baseline);
 }
 
 // Callers of this method assume it has NO_RETURN.
@@ -163,15 +163,18 @@ JitCompiler::JitCompiler() : total_time_(0) {
 JitCompiler::~JitCompiler() {
 }
 
-bool JitCompiler::CompileMethod(Thread* self, ArtMethod* method) {
+bool JitCompiler::CompileMethod(Thread* self, ArtMethod* method, bool baseline) {
   TimingLogger logger("JIT compiler timing logger", true, VLOG_IS_ON(jit));
   const uint64_t start_time = NanoTime();
   StackHandleScope<2> hs(self);
   self->AssertNoPendingException();
   Runtime* runtime = Runtime::Current();
 
-  // Check if the method is already compiled.
-  if (runtime->GetJit()->GetCodeCache()->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
+  // Check if the method is already compiled. Baseline code only counts as compiled
+  // for another baseline compilation, as it is meant to be replaced.
+  JitCodeCache* const code_cache = runtime->GetJit()->GetCodeCache();
+  if (code_cache->ContainsPc(method->GetEntryPointFromQuickCompiledCode()) &&
+      (baseline || !code_cache->IsBaselineCompiled(method))) {
     VLOG(jit) << "Already compiled " << PrettyMethod(method);
     return true;
   }
@@ -190,14 +193,14 @@ bool JitCompiler::CompileMethod(Thread* self, ArtMethod* method) {
   }
 
   // Do the compilation.
-  JitCodeCache* const code_cache = runtime->GetJit()->GetCodeCache();
   bool success = false;
   {
     TimingLogger::ScopedTiming t2("Compiling", &logger);
     // If we get a request to compile a proxy method, we pass the actual Java method
     // of that proxy method, as the compiler does not expect a proxy method.
     ArtMethod* method_to_compile = method->GetInterfaceMethodIfProxy(sizeof(void*));
-    success = compiler_driver_->GetCompiler()->JitCompile(self, code_cache, method_to_compile);
+    success = compiler_driver_->GetCompiler()->JitCompile(
+        self, code_cache, method_to_compile, baseline);
   }
 
   // Trim maps to reduce memory usage.
@@ -37,7 +37,9 @@ class JitCompiler {
  public:
   static JitCompiler* Create();
   virtual ~JitCompiler();
-  bool CompileMethod(Thread* self, ArtMethod* method)
+  // Compiles `method` and installs the code. Baseline code is compiled quickly without
+  // optimizations, and is replaced once the method gets compiled without `baseline`.
+  bool CompileMethod(Thread* self, ArtMethod* method, bool baseline)
       SHARED_REQUIRES(Locks::mutator_lock_);
   CompilerCallbacks* GetCompilerCallbacks() const;
   size_t GetTotalCompileTime() const {
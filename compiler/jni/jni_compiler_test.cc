@@ -166,6 +166,7 @@ class JniCompilerTest : public CommonCompilerTest {
   void StackArgsFloatsFirstImpl();
   void StackArgsMixedImpl();
   void StackArgsSignExtendedMips64Impl();
+  void CriticalNativeIntIntMethodImpl();
 
   JNIEnv* env_;
   jmethodID jmethod_;
@@ -512,6 +513,34 @@ void JniCompilerTest::CompileAndRunStaticDoubleDoubleMethodImpl() {
 
 JNI_TEST(CompileAndRunStaticDoubleDoubleMethod)
 
+int gJava_MyClassNatives_criticalAdd_calls = 0;
+ThreadState gJava_MyClassNatives_criticalAdd_state = kTerminated;
+jint Java_MyClassNatives_criticalAdd(JNIEnv*, jclass, jint x, jint y) {
+  // The JNIEnv* and jclass arguments of a critical native must not be used.
+  gJava_MyClassNatives_criticalAdd_state = Thread::Current()->GetState();
+  gJava_MyClassNatives_criticalAdd_calls++;
+  return x + y;
+}
+
+void JniCompilerTest::CriticalNativeIntIntMethodImpl() {
+  SetUpForTest(true, "criticalAdd", "(II)I",
+               reinterpret_cast<void*>(&Java_MyClassNatives_criticalAdd));
+
+  EXPECT_EQ(0, gJava_MyClassNatives_criticalAdd_calls);
+  jint result = env_->CallStaticIntMethod(jklass_, jmethod_, 20, 30);
+  EXPECT_EQ(50, result);
+  EXPECT_EQ(1, gJava_MyClassNatives_criticalAdd_calls);
+  // The compiled stub stays Runnable, the generic JNI trampoline always transitions.
+  EXPECT_EQ(check_generic_jni_ ? kNative : kRunnable, gJava_MyClassNatives_criticalAdd_state);
+  result = env_->CallStaticIntMethod(jklass_, jmethod_, -7, 3);
+  EXPECT_EQ(-4, result);
+  EXPECT_EQ(2, gJava_MyClassNatives_criticalAdd_calls);
+
+  gJava_MyClassNatives_criticalAdd_calls = 0;
+}
+
+JNI_TEST(CriticalNativeIntIntMethod)
+
 // The x86 generic JNI code had a bug where it assumed a floating
 // point return value would be in xmm0. We use log, to somehow ensure
 // the compiler will use the floating point stack.
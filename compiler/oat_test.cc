@@ -126,7 +126,8 @@ class OatTest : public CommonCompilerTest {
 
   bool WriteElf(File* file,
                 const std::vector<const DexFile*>& dex_files,
-                SafeMap<std::string, std::string>& key_value_store) {
+                SafeMap<std::string, std::string>& key_value_store,
+                const std::set<MethodReference, MethodReferenceComparator>* hot_methods = nullptr) {
     TimingLogger timings("WriteElf", false, false);
     OatWriter oat_writer(dex_files,
                          42U,
@@ -136,7 +137,8 @@ class OatTest : public CommonCompilerTest {
                          nullptr,
                          /*compiling_boot_image*/false,
                          &timings,
-                         &key_value_store);
+                         &key_value_store,
+                         hot_methods);
     std::unique_ptr<ElfWriter> elf_writer = CreateElfWriterQuick(
         compiler_driver_->GetInstructionSet(),
         &compiler_driver_->GetCompilerOptions(),
@@ -337,4 +339,92 @@ TEST_F(OatTest, EmptyTextSection) {
   EXPECT_LT(static_cast<size_t>(oat_file->Size()), static_cast<size_t>(tmp.GetFile()->GetLength()));
 }
 
+TEST_F(OatTest, HotMethodsFirst) {
+  TimingLogger timings("OatTest::HotMethodsFirst", false, false);
+
+  Compiler::Kind compiler_kind = Compiler::kQuick;
+  InstructionSet insn_set = kRuntimeISA;
+  if (insn_set == kArm) insn_set = kThumb2;
+  std::string error_msg;
+  SetupCompiler(compiler_kind, insn_set, std::vector<std::string>(), /*out*/ &error_msg);
+
+  jobject class_loader;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    class_loader = LoadDex("Main");
+  }
+  ASSERT_TRUE(class_loader != nullptr);
+  std::vector<const DexFile*> dex_files = GetDexFiles(class_loader);
+  ASSERT_EQ(1u, dex_files.size());
+  const DexFile* dex_file = dex_files[0];
+
+  ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    class_linker->RegisterDexFile(
+        *dex_file,
+        class_linker->GetOrCreateAllocatorForClassLoader(
+            soa.Decode<mirror::ClassLoader*>(class_loader)));
+  }
+  compiler_driver_->SetDexFilesForOatFile(dex_files);
+  compiler_driver_->CompileAll(class_loader, dex_files, &timings);
+
+  // Collect the methods with code in definition order, remembering their oat class and index.
+  struct CompiledMethodInfo {
+    size_t class_def_index;
+    size_t class_method_index;
+  };
+  std::vector<CompiledMethodInfo> compiled_methods;
+  std::set<MethodReference, MethodReferenceComparator> hot_methods;
+  for (size_t i = 0; i != dex_file->NumClassDefs(); ++i) {
+    const uint8_t* class_data = dex_file->GetClassData(dex_file->GetClassDef(i));
+    if (class_data == nullptr) {
+      continue;
+    }
+    ClassDataItemIterator it(*dex_file, class_data);
+    while (it.HasNextStaticField() || it.HasNextInstanceField()) {
+      it.Next();
+    }
+    for (size_t class_method_index = 0u;
+         it.HasNextDirectMethod() || it.HasNextVirtualMethod();
+         ++class_method_index, it.Next()) {
+      MethodReference method_ref(dex_file, it.GetMemberIndex());
+      const CompiledMethod* compiled_method = compiler_driver_->GetCompiledMethod(method_ref);
+      if (compiled_method != nullptr && !compiled_method->GetQuickCode().empty()) {
+        compiled_methods.push_back(CompiledMethodInfo { i, class_method_index });
+        hot_methods.clear();
+        hot_methods.insert(method_ref);  // Keep the last one.
+      }
+    }
+  }
+  ASSERT_GE(compiled_methods.size(), 2u);
+
+  ScratchFile tmp;
+  SafeMap<std::string, std::string> key_value_store;
+  key_value_store.Put(OatHeader::kImageLocationKey, "test.art");
+  ASSERT_TRUE(WriteElf(tmp.GetFile(), dex_files, key_value_store, &hot_methods));
+
+  std::unique_ptr<OatFile> oat_file(OatFile::Open(tmp.GetFilename(),
+                                                  tmp.GetFilename(),
+                                                  nullptr,
+                                                  nullptr,
+                                                  false,
+                                                  nullptr,
+                                                  &error_msg));
+  ASSERT_TRUE(oat_file != nullptr) << error_msg;
+  ASSERT_EQ(1u, oat_file->GetOatDexFiles().size());
+  const OatFile::OatDexFile* oat_dex_file = oat_file->GetOatDexFiles()[0];
+
+  // The code of the last method in definition order must now come first.
+  auto get_code_offset = [oat_dex_file](const CompiledMethodInfo& info) {
+    return oat_dex_file->GetOatClass(info.class_def_index)
+        .GetOatMethod(info.class_method_index).GetCodeOffset();
+  };
+  uint32_t hot_code_offset = get_code_offset(compiled_methods.back());
+  ASSERT_NE(0u, hot_code_offset);
+  for (size_t i = 0; i + 1u < compiled_methods.size(); ++i) {
+    EXPECT_LT(hot_code_offset, get_code_offset(compiled_methods[i]));
+  }
+}
+
 }  // namespace art
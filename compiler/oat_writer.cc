@@ -68,11 +68,13 @@ OatWriter::OatWriter(const std::vector<const DexFile*>& dex_files,
                      ImageWriter* image_writer,
                      bool compiling_boot_image,
                      TimingLogger* timings,
-                     SafeMap<std::string, std::string>* key_value_store)
+                     SafeMap<std::string, std::string>* key_value_store,
+                     const std::set<MethodReference, MethodReferenceComparator>* hot_methods)
   : compiler_driver_(compiler),
     image_writer_(image_writer),
     compiling_boot_image_(compiling_boot_image),
     dex_files_(&dex_files),
+    hot_methods_(hot_methods),
     size_(0u),
     bss_size_(0u),
     oat_data_offset_(0u),
@@ -300,7 +302,14 @@ class OatWriter::OatDexMethodVisitor : public DexMethodVisitor {
   OatDexMethodVisitor(OatWriter* writer, size_t offset)
     : DexMethodVisitor(writer, offset),
       oat_class_index_(0u),
-      method_offsets_index_(0u) {
+      method_offsets_index_(0u),
+      code_layout_pass_(CodeLayoutPass::kAllMethods) {
+  }
+
+  // Start a new pass over all classes, visiting only the methods of the given layout pass.
+  void StartCodeLayoutPass(CodeLayoutPass pass) {
+    oat_class_index_ = 0u;
+    code_layout_pass_ = pass;
   }
 
   bool StartClass(const DexFile* dex_file, size_t class_def_index) {
@@ -316,8 +325,19 @@ class OatWriter::OatDexMethodVisitor : public DexMethodVisitor {
   }
 
  protected:
+  bool IsInCurrentCodeLayoutPass(const ClassDataItemIterator& it) const {
+    return writer_->IsInCodeLayoutPass(code_layout_pass_,
+                                       MethodReference(dex_file_, it.GetMemberIndex()));
+  }
+
+  // Whether this is the last pass over the classes, after which the final thunks go.
+  bool IsLastCodeLayoutPass() const {
+    return code_layout_pass_ != CodeLayoutPass::kHotMethods;
+  }
+
   size_t oat_class_index_;
   size_t method_offsets_index_;
+  CodeLayoutPass code_layout_pass_;
 };
 
 class OatWriter::InitOatClassesMethodVisitor : public DexMethodVisitor {
@@ -388,7 +408,7 @@ class OatWriter::InitCodeMethodVisitor : public OatDexMethodVisitor {
 
   bool EndClass() {
     OatDexMethodVisitor::EndClass();
-    if (oat_class_index_ == writer_->oat_classes_.size()) {
+    if (oat_class_index_ == writer_->oat_classes_.size() && IsLastCodeLayoutPass()) {
       offset_ = writer_->relative_patcher_->ReserveSpaceEnd(offset_);
     }
     return true;
@@ -399,7 +419,10 @@ class OatWriter::InitCodeMethodVisitor : public OatDexMethodVisitor {
     OatClass* oat_class = writer_->oat_classes_[oat_class_index_];
     CompiledMethod* compiled_method = oat_class->GetCompiledMethod(class_def_method_index);
 
-    if (compiled_method != nullptr) {
+    if (compiled_method != nullptr && !IsInCurrentCodeLayoutPass(it)) {
+      // Laid out in another pass.
+      ++method_offsets_index_;
+    } else if (compiled_method != nullptr) {
       // Derived from CompiledMethod.
       uint32_t quick_code_offset = 0;
 
@@ -698,7 +721,7 @@ class OatWriter::WriteCodeMethodVisitor : public OatDexMethodVisitor {
 
   bool EndClass() SHARED_REQUIRES(Locks::mutator_lock_) {
     bool result = OatDexMethodVisitor::EndClass();
-    if (oat_class_index_ == writer_->oat_classes_.size()) {
+    if (oat_class_index_ == writer_->oat_classes_.size() && IsLastCodeLayoutPass()) {
       DCHECK(result);  // OatDexMethodVisitor::EndClass() never fails.
       offset_ = writer_->relative_patcher_->WriteThunks(out_, offset_);
       if (UNLIKELY(offset_ == 0u)) {
@@ -716,7 +739,10 @@ class OatWriter::WriteCodeMethodVisitor : public OatDexMethodVisitor {
 
     // No thread suspension since dex_cache_ that may get invalidated if that occurs.
     ScopedAssertNoThreadSuspension tsc(Thread::Current(), __FUNCTION__);
-    if (compiled_method != nullptr) {  // ie. not an abstract method
+    if (compiled_method != nullptr && !IsInCurrentCodeLayoutPass(it)) {
+      // Written in another pass.
+      ++method_offsets_index_;
+    } else if (compiled_method != nullptr) {  // ie. not an abstract method
       size_t file_offset = file_offset_;
       OutputStream* out = out_;
 
@@ -982,6 +1008,27 @@ class OatWriter::WriteMapMethodVisitor : public OatDexMethodVisitor {
 };
 
 // Visit all methods from all classes in all dex files with the specified visitor.
+bool OatWriter::IsInCodeLayoutPass(CodeLayoutPass pass, MethodReference method_ref) const {
+  if (pass == CodeLayoutPass::kAllMethods) {
+    return true;
+  }
+  bool is_hot = hot_methods_->find(method_ref) != hot_methods_->end();
+  return is_hot == (pass == CodeLayoutPass::kHotMethods);
+}
+
+template <typename CodeVisitor>
+bool OatWriter::VisitDexMethodsInCodeLayoutOrder(CodeVisitor* visitor) {
+  if (!HasHotMethods()) {
+    return VisitDexMethods(visitor);
+  }
+  visitor->StartCodeLayoutPass(CodeLayoutPass::kHotMethods);
+  if (UNLIKELY(!VisitDexMethods(visitor))) {
+    return false;
+  }
+  visitor->StartCodeLayoutPass(CodeLayoutPass::kColdMethods);
+  return VisitDexMethods(visitor);
+}
+
 bool OatWriter::VisitDexMethods(DexMethodVisitor* visitor) {
   for (const DexFile* dex_file : *dex_files_) {
     const size_t class_def_count = dex_file->NumClassDefs();
@@ -1169,7 +1216,12 @@ size_t OatWriter::InitOatCodeDexFiles(size_t offset) {
       offset = visitor.GetOffset();                   \
     } while (false)
 
-  VISIT(InitCodeMethodVisitor);
+  {
+    InitCodeMethodVisitor visitor(this, offset);
+    bool success = VisitDexMethodsInCodeLayoutOrder(&visitor);
+    DCHECK(success);
+    offset = visitor.GetOffset();
+  }
   if (compiler_driver_->IsBootImage()) {
     VISIT(InitImageMethodVisitor);
   }
@@ -1448,7 +1500,7 @@ size_t OatWriter::WriteCodeDexFiles(OutputStream* out,
   #define VISIT(VisitorType)                                              \
     do {                                                                  \
       VisitorType visitor(this, out, file_offset, relative_offset);       \
-      if (UNLIKELY(!VisitDexMethods(&visitor))) {                         \
+      if (UNLIKELY(!VisitDexMethodsInCodeLayoutOrder(&visitor))) {        \
         return 0;                                                         \
       }                                                                   \
       relative_offset = visitor.GetOffset();                              \
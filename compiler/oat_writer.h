@@ -20,6 +20,7 @@
 #include <stdint.h>
 #include <cstddef>
 #include <memory>
+#include <set>
 
 #include "linker/relative_patcher.h"  // For linker::RelativePatcherTargetProvider.
 #include "mem_map.h"
@@ -89,6 +90,9 @@ struct MethodDebugInfo;
 // OatMethodHeader
 // MethodCode
 //
+// Methods are laid out in class definition order. If a set of hot methods is given, their code
+// is placed first and the code of all other methods follows, each group in definition order.
+//
 class OatWriter {
  public:
   OatWriter(const std::vector<const DexFile*>& dex_files,
@@ -99,7 +103,8 @@ class OatWriter {
             ImageWriter* image_writer,
             bool compiling_boot_image,
             TimingLogger* timings,
-            SafeMap<std::string, std::string>* key_value_store);
+            SafeMap<std::string, std::string>* key_value_store,
+            const std::set<MethodReference, MethodReferenceComparator>* hot_methods);
 
   // Returns whether the oat file has an associated image.
   bool HasImage() const {
@@ -169,6 +174,24 @@ class OatWriter {
   // with a given DexMethodVisitor.
   bool VisitDexMethods(DexMethodVisitor* visitor);
 
+  // The code is laid out in one pass over all methods, or in a pass over the hot methods
+  // followed by a pass over the remaining methods if we have a set of hot methods.
+  enum class CodeLayoutPass {
+    kAllMethods,
+    kHotMethods,
+    kColdMethods,
+  };
+
+  bool HasHotMethods() const {
+    return hot_methods_ != nullptr && !hot_methods_->empty();
+  }
+
+  bool IsInCodeLayoutPass(CodeLayoutPass pass, MethodReference method_ref) const;
+
+  // Visit the methods for each code layout pass with the given code visitor.
+  template <typename CodeVisitor>
+  bool VisitDexMethodsInCodeLayoutOrder(CodeVisitor* visitor);
+
   size_t InitOatHeader();
   size_t InitOatDexFiles(size_t offset);
   size_t InitLookupTables(size_t offset);
@@ -281,6 +304,9 @@ class OatWriter {
   // note OatFile does not take ownership of the DexFiles
   const std::vector<const DexFile*>* dex_files_;
 
+  // Methods whose code goes first, may be null.
+  const std::set<MethodReference, MethodReferenceComparator>* const hot_methods_;
+
   // Size required for Oat data structures.
   size_t size_;
 
@@ -1014,11 +1014,21 @@ void CodeGenerator::RecordPcInfo(HInstruction* instruction,
 void CodeGenerator::RecordCatchBlockInfo() {
   ArenaAllocator* arena = graph_->GetArena();
 
+  // The runtime binary searches catch stack maps by dex pc.
+  ArenaVector<HBasicBlock*> catch_blocks(arena->Adapter(kArenaAllocCodeGenerator));
   for (HBasicBlock* block : *block_order_) {
-    if (!block->IsCatchBlock()) {
-      continue;
+    if (block->IsCatchBlock()) {
+      catch_blocks.push_back(block);
     }
+  }
+  std::stable_sort(catch_blocks.begin(),
+                   catch_blocks.end(),
+                   [](HBasicBlock* lhs, HBasicBlock* rhs) {
+                     return lhs->GetDexPc() < rhs->GetDexPc();
+                   });
 
+  stack_map_stream_.BeginCatchStackMaps();
+  for (HBasicBlock* block : catch_blocks) {
     uint32_t dex_pc = block->GetDexPc();
     uint32_t num_vregs = graph_->GetNumberOfVRegs();
     uint32_t inlining_depth = 0;  // Inlining of catch blocks is not supported at the moment.
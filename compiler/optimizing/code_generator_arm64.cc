@@ -2938,6 +2938,50 @@ void InstructionCodeGeneratorARM64::VisitDeoptimize(HDeoptimize* deoptimize) {
                         /* false_target */ nullptr);
 }
 
+void LocationsBuilderARM64::VisitSelect(HSelect* select) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(select);
+  if (Primitive::IsFloatingPointType(select->GetType())) {
+    locations->SetInAt(0, Location::RequiresFpuRegister());
+    locations->SetInAt(1, Location::RequiresFpuRegister());
+    locations->SetOut(Location::RequiresFpuRegister());
+  } else {
+    locations->SetInAt(0, Location::RequiresRegister());
+    locations->SetInAt(1, Location::RequiresRegister());
+    locations->SetOut(Location::RequiresRegister());
+  }
+  if (IsBooleanValueOrMaterializedCondition(select->GetCondition())) {
+    locations->SetInAt(2, Location::RequiresRegister());
+  }
+}
+
+void InstructionCodeGeneratorARM64::VisitSelect(HSelect* select) {
+  HInstruction* cond = select->GetCondition();
+  Condition csel_condition = ne;
+  if (cond->IsCondition() &&
+      cond->GetNext() == select &&
+      !Primitive::IsFloatingPointType(cond->InputAt(0)->GetType())) {
+    // The integer condition was materialized right before, so its flags are still live.
+    // FP conditions may have overwritten them to handle NaNs.
+    DCHECK(cond->AsCondition()->NeedsMaterialization());
+    csel_condition = ARM64Condition(cond->AsCondition()->GetCondition());
+  } else {
+    DCHECK(IsBooleanValueOrMaterializedCondition(cond));
+    __ Cmp(InputRegisterAt(select, 2), 0);
+  }
+
+  if (Primitive::IsFloatingPointType(select->GetType())) {
+    __ Fcsel(OutputFPRegister(select),
+             InputFPRegisterAt(select, 1),
+             InputFPRegisterAt(select, 0),
+             csel_condition);
+  } else {
+    __ Csel(OutputRegister(select),
+            InputRegisterAt(select, 1),
+            InputRegisterAt(select, 0),
+            csel_condition);
+  }
+}
+
 void LocationsBuilderARM64::VisitInstanceFieldGet(HInstanceFieldGet* instruction) {
   HandleFieldGet(instruction);
 }
@@ -4163,6 +4207,20 @@ void InstructionCodeGeneratorARM64::VisitCurrentMethod(
   // Nothing to do, the method is already at its location.
 }
 
+void LocationsBuilderARM64::VisitLoadMethodAccessFlags(HLoadMethodAccessFlags* instruction) {
+  LocationSummary* locations =
+      new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kNoCall);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister());
+}
+
+void InstructionCodeGeneratorARM64::VisitLoadMethodAccessFlags(
+    HLoadMethodAccessFlags* instruction) {
+  __ Ldr(OutputRegister(instruction),
+         MemOperand(XRegisterFrom(instruction->GetLocations()->InAt(0)),
+                    ArtMethod::AccessFlagsOffset().Int32Value()));
+}
+
 void LocationsBuilderARM64::VisitPhi(HPhi* instruction) {
   LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(instruction);
   for (size_t i = 0, e = instruction->InputCount(); i < e; ++i) {
@@ -1540,6 +1540,57 @@ void InstructionCodeGeneratorX86_64::VisitDeoptimize(HDeoptimize* deoptimize) {
                         /* false_target */ nullptr);
 }
 
+void LocationsBuilderX86_64::VisitSelect(HSelect* select) {
+  LocationSummary* locations = new (GetGraph()->GetArena()) LocationSummary(select);
+  if (Primitive::IsFloatingPointType(select->GetType())) {
+    locations->SetInAt(0, Location::RequiresFpuRegister());
+    locations->SetInAt(1, Location::RequiresFpuRegister());
+  } else {
+    locations->SetInAt(0, Location::RequiresRegister());
+    locations->SetInAt(1, Location::RequiresRegister());
+  }
+  if (IsBooleanValueOrMaterializedCondition(select->GetCondition())) {
+    locations->SetInAt(2, Location::RequiresRegister());
+  }
+  locations->SetOut(Location::SameAsFirstInput());
+}
+
+void InstructionCodeGeneratorX86_64::VisitSelect(HSelect* select) {
+  LocationSummary* locations = select->GetLocations();
+  if (Primitive::IsFloatingPointType(select->GetType())) {
+    Label false_target;
+    GenerateTestAndBranch(select,
+                          /* condition_input_index */ 2,
+                          /* true_target */ nullptr,
+                          &false_target);
+    codegen_->MoveLocation(locations->Out(), locations->InAt(1), select->GetType());
+    __ Bind(&false_target);
+    return;
+  }
+
+  DCHECK(locations->InAt(0).Equals(locations->Out()));
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+  CpuRegister true_value = locations->InAt(1).AsRegister<CpuRegister>();
+  HInstruction* cond = select->GetCondition();
+  Condition cmov_condition = kNotEqual;
+  if (cond->IsIntConstant()) {
+    // Constant condition, normally folded away by the instruction simplifier.
+    if (cond->AsIntConstant()->IsOne()) {
+      __ movq(out, true_value);
+    }
+    return;
+  } else if (AreEflagsSetFrom(cond, select)) {
+    // The condition was materialized right before, so its flags are still live.
+    cmov_condition = X86_64IntegerCondition(cond->AsCondition()->GetCondition());
+  } else {
+    DCHECK(IsBooleanValueOrMaterializedCondition(cond));
+    CpuRegister cond_reg = locations->InAt(2).AsRegister<CpuRegister>();
+    __ testl(cond_reg, cond_reg);
+  }
+  // The output already holds the false value: overwrite it if the condition holds.
+  __ cmov(cmov_condition, out, true_value, Primitive::Is64BitType(select->GetType()));
+}
+
 void LocationsBuilderX86_64::VisitLocal(HLocal* local) {
   local->SetLocations(nullptr);
 }
@@ -3852,6 +3903,21 @@ void InstructionCodeGeneratorX86_64::VisitCurrentMethod(
   // Nothing to do, the method is already at its location.
 }
 
+void LocationsBuilderX86_64::VisitLoadMethodAccessFlags(HLoadMethodAccessFlags* instruction) {
+  LocationSummary* locations =
+      new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kNoCall);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister());
+}
+
+void InstructionCodeGeneratorX86_64::VisitLoadMethodAccessFlags(
+    HLoadMethodAccessFlags* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+  CpuRegister current_method = locations->InAt(0).AsRegister<CpuRegister>();
+  __ movl(out, Address(current_method, ArtMethod::AccessFlagsOffset().Int32Value()));
+}
+
 void LocationsBuilderX86_64::VisitNot(HNot* not_) {
   LocationSummary* locations =
       new (GetGraph()->GetArena()) LocationSummary(not_, LocationSummary::kNoCall);
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "code_sinking.h"
+
+#include <algorithm>
+
+#include "base/arena_bit_vector.h"
+#include "base/bit_vector-inl.h"
+#include "common_dominator.h"
+
+namespace art {
+
+// Sinking an instruction may allow its inputs to be sunk as well. Most chains are
+// handled in a single round because users are visited before their definitions.
+static constexpr size_t kMaxSinkingRounds = 3u;
+
+static bool IsUncommon(HBasicBlock* block, const ArenaBitVector& uncommon_blocks) {
+  return uncommon_blocks.IsBitSet(block->GetBlockId());
+}
+
+// Returns true if `instruction` can be executed later without any observable
+// difference other than the time it runs.
+static bool IsSinkableComputation(HInstruction* instruction) {
+  if (instruction->IsConstant() ||
+      instruction->IsParameterValue() ||
+      instruction->IsCurrentMethod() ||
+      instruction->IsSuspendCheck() ||
+      instruction->IsControlFlow()) {
+    return false;
+  }
+  return instruction->CanBeMoved() &&
+      !instruction->CanThrow() &&
+      SideEffects::CanTriggerGC().Includes(instruction->GetSideEffects());
+}
+
+// Returns true if `instruction` is an allocation which cannot throw anything
+// but OutOfMemoryError, and does not run class initialization.
+static bool IsSinkableAllocation(HInstruction* instruction) {
+  if (instruction->IsNewInstance()) {
+    HNewInstance* new_instance = instruction->AsNewInstance();
+    return !new_instance->IsFinalizable() &&
+        new_instance->GetEntrypoint() == kQuickAllocObjectInitialized;
+  } else if (instruction->IsNewArray()) {
+    HNewArray* new_array = instruction->AsNewArray();
+    HInstruction* length = new_array->InputAt(0);
+    return new_array->GetEntrypoint() == kQuickAllocArray &&
+        length->IsIntConstant() &&
+        length->AsIntConstant()->GetValue() >= 0;
+  }
+  return false;
+}
+
+// Returns true if `user` stores into `allocation` right after it has been
+// created, without letting the object escape.
+static bool IsInitializingStore(HInstruction* user, HInstruction* allocation) {
+  if (user->GetBlock() != allocation->GetBlock()) {
+    return false;
+  }
+  if (user->IsInstanceFieldSet()) {
+    return !user->AsInstanceFieldSet()->IsVolatile() &&
+        user->InputAt(0) == allocation &&
+        user->InputAt(1) != allocation;
+  } else if (user->IsArraySet()) {
+    return !user->AsArraySet()->NeedsTypeCheck() &&
+        user->InputAt(0) == allocation &&
+        user->InputAt(1) != allocation &&
+        user->InputAt(2) != allocation;
+  }
+  return false;
+}
+
+void CodeSinking::FindUncommonBlocks(ArenaBitVector* uncommon_blocks) const {
+  // Post order visits the successors of a block before the block itself, except
+  // along back edges. Blocks in loops are skipped: moving an instruction into
+  // them could execute it once per iteration. A throwing path branching out of a
+  // loop is not part of the loop, and qualifies: this pass does not run on graphs
+  // with try/catch, so the throw leaves the method and the path runs at most once.
+  for (HPostOrderIterator it(*graph_); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    if (block->IsEntryBlock() || block->IsInLoop()) {
+      continue;
+    }
+    if (block->GetLastInstruction()->IsThrow()) {
+      uncommon_blocks->SetBit(block->GetBlockId());
+      continue;
+    }
+    const ArenaVector<HBasicBlock*>& successors = block->GetSuccessors();
+    if (!successors.empty() &&
+        std::all_of(successors.begin(),
+                    successors.end(),
+                    [uncommon_blocks](HBasicBlock* successor) {
+                      return IsUncommon(successor, *uncommon_blocks);
+                    })) {
+      uncommon_blocks->SetBit(block->GetBlockId());
+    }
+  }
+}
+
+bool CodeSinking::TrySink(HInstruction* instruction,
+                          const ArenaBitVector& uncommon_blocks,
+                          ArenaVector<HInstruction*>* stores) {
+  if (!instruction->HasUses() || instruction->GetBlock()->IsInLoop()) {
+    return false;
+  }
+  bool is_allocation = IsSinkableAllocation(instruction);
+  if (!is_allocation && !IsSinkableComputation(instruction)) {
+    return false;
+  }
+
+  // Find the common dominator of all uses, which must be uncommon themselves.
+  stores->clear();
+  HBasicBlock* target_block = nullptr;
+  for (HUseIterator<HInstruction*> it(instruction->GetUses()); !it.Done(); it.Advance()) {
+    HInstruction* user = it.Current()->GetUser();
+    if (user->IsPhi()) {
+      return false;
+    } else if (IsUncommon(user->GetBlock(), uncommon_blocks)) {
+      target_block = (target_block == nullptr)
+          ? user->GetBlock()
+          : CommonDominator::ForPair(target_block, user->GetBlock());
+    } else if (is_allocation && IsInitializingStore(user, instruction)) {
+      stores->push_back(user);
+    } else {
+      return false;
+    }
+  }
+  for (HUseIterator<HEnvironment*> it(instruction->GetEnvUses()); !it.Done(); it.Advance()) {
+    HBasicBlock* user_block = it.Current()->GetUser()->GetHolder()->GetBlock();
+    if (!IsUncommon(user_block, uncommon_blocks)) {
+      return false;
+    }
+    target_block = (target_block == nullptr)
+        ? user_block
+        : CommonDominator::ForPair(target_block, user_block);
+  }
+  if (target_block == nullptr || !IsUncommon(target_block, uncommon_blocks)) {
+    return false;
+  }
+  DCHECK(instruction->GetBlock()->Dominates(target_block));
+
+  // Insert before the first use in the target block, or at its end.
+  HInstruction* cursor = nullptr;
+  auto update_cursor = [target_block, &cursor](HInstruction* user) {
+    if (user->GetBlock() == target_block &&
+        (cursor == nullptr || user->StrictlyDominates(cursor))) {
+      cursor = user;
+    }
+  };
+  for (HUseIterator<HInstruction*> it(instruction->GetUses()); !it.Done(); it.Advance()) {
+    update_cursor(it.Current()->GetUser());
+  }
+  for (HUseIterator<HEnvironment*> it(instruction->GetEnvUses()); !it.Done(); it.Advance()) {
+    update_cursor(it.Current()->GetUser()->GetHolder());
+  }
+  if (cursor == nullptr) {
+    cursor = target_block->GetLastInstruction();
+  }
+
+  instruction->MoveBefore(cursor);
+  // Keep the initializing stores in their original order after the allocation.
+  std::sort(stores->begin(), stores->end(), [](HInstruction* lhs, HInstruction* rhs) {
+    return lhs->StrictlyDominates(rhs);
+  });
+  for (HInstruction* store : *stores) {
+    store->MoveBefore(cursor);
+  }
+  MaybeRecordStat(MethodCompilationStat::kInstructionSunk);
+  return true;
+}
+
+void CodeSinking::Run() {
+  ArenaAllocator* allocator = graph_->GetArena();
+  ArenaBitVector uncommon_blocks(allocator, graph_->GetBlocks().size(), false);
+  FindUncommonBlocks(&uncommon_blocks);
+  if (uncommon_blocks.NumSetBits() == 0u) {
+    return;
+  }
+
+  ArenaVector<HInstruction*> stores(allocator->Adapter(kArenaAllocOptimization));
+  for (size_t round = 0; round != kMaxSinkingRounds; ++round) {
+    bool changed = false;
+    // Visit users before their definitions, so that chains of instructions can
+    // be sunk in a single round.
+    for (HPostOrderIterator block_it(*graph_); !block_it.Done(); block_it.Advance()) {
+      HBasicBlock* block = block_it.Current();
+      if (IsUncommon(block, uncommon_blocks)) {
+        continue;
+      }
+      for (HBackwardInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+        if (TrySink(it.Current(), uncommon_blocks, &stores)) {
+          changed = true;
+        }
+      }
+    }
+    if (!changed) {
+      break;
+    }
+  }
+}
+
+}  // namespace art
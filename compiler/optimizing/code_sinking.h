@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * This optimization moves instructions whose only uses are on paths that
+ * always end up throwing, such as the computation of an exception message or
+ * the allocation of the exception itself, down to the block that uses them:
+ *
+ *     B1:
+ *       l1  LoadString
+ *       i2  Add [ i3 i4 ]
+ *       z5  Equal [ i2 i6 ]
+ *       v7  If [ z5 ] then B2 else B3
+ *     B2:
+ *       v8  Return
+ *     B3:
+ *       l9  InvokeStaticOrDirect [ l1 i2 ]
+ *       v10 Throw [ l9 ]
+ *
+ * turns into
+ *
+ *     B1:
+ *       i2  Add [ i3 i4 ]
+ *       z5  Equal [ i2 i6 ]
+ *       v7  If [ z5 ] then B2 else B3
+ *     B2:
+ *       v8  Return
+ *     B3:
+ *       l1  LoadString
+ *       l9  InvokeStaticOrDirect [ l1 i2 ]
+ *       v10 Throw [ l9 ]
+ *
+ * Only instructions without side effects other than triggering GC are moved,
+ * together with object and array allocations which cannot throw anything but
+ * OutOfMemoryError. The field and array stores initializing a moved
+ * allocation follow it, provided they are in the allocation's block and
+ * nothing else observes the object before the uncommon path. Instructions in
+ * loops, and instructions used by phis, are left in place. Blocks in loops
+ * never count as uncommon, but a throwing path branching out of a loop does:
+ * the throw leaves the method, so whatever is sunk there runs at most once.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_CODE_SINKING_H_
+#define ART_COMPILER_OPTIMIZING_CODE_SINKING_H_
+
+#include "base/arena_containers.h"
+#include "optimization.h"
+
+namespace art {
+
+class ArenaBitVector;
+
+class CodeSinking : public HOptimization {
+ public:
+  CodeSinking(HGraph* graph, OptimizingCompilerStats* stats)
+      : HOptimization(graph, kCodeSinkingPassName, stats) {}
+
+  void Run() OVERRIDE;
+
+  static constexpr const char* kCodeSinkingPassName = "code_sinking";
+
+ private:
+  // Marks the blocks from which every path leads to an HThrow.
+  void FindUncommonBlocks(ArenaBitVector* uncommon_blocks) const;
+
+  // Moves `instruction` into the uncommon blocks if all its uses are there.
+  // `stores` is a scratch vector for the initializing stores of allocations.
+  // Returns whether the instruction was moved.
+  bool TrySink(HInstruction* instruction,
+               const ArenaBitVector& uncommon_blocks,
+               ArenaVector<HInstruction*>* stores);
+
+  DISALLOW_COPY_AND_ASSIGN(CodeSinking);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_CODE_SINKING_H_
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/arena_allocator.h"
+#include "code_sinking.h"
+#include "graph_checker.h"
+#include "gtest/gtest.h"
+#include "nodes.h"
+#include "optimizing_unit_test.h"
+
+namespace art {
+
+/**
+ * Fixture class for the code sinking tests.
+ */
+class CodeSinkingTest : public testing::Test {
+ public:
+  CodeSinkingTest() : pool_(), allocator_(&pool_) {
+    graph_ = CreateGraph(&allocator_);
+  }
+
+  ~CodeSinkingTest() { }
+
+  // Builds
+  //
+  //   preheader:  <instructions to sink>
+  //   loop:       while (first > second) {
+  //   body:         if (first < second) {
+  //   throw_:         throw exception;
+  //                 }
+  //               }
+  //   return_:    return first;
+  //
+  // Tests add instructions to the blocks, with their uses in `throw_`.
+  void BuildGraph() {
+    entry_ = new (&allocator_) HBasicBlock(graph_);
+    preheader_ = new (&allocator_) HBasicBlock(graph_);
+    loop_header_ = new (&allocator_) HBasicBlock(graph_);
+    loop_body_ = new (&allocator_) HBasicBlock(graph_);
+    throw_ = new (&allocator_) HBasicBlock(graph_);
+    return_ = new (&allocator_) HBasicBlock(graph_);
+    exit_ = new (&allocator_) HBasicBlock(graph_);
+    for (HBasicBlock* block :
+         { entry_, preheader_, loop_header_, loop_body_, throw_, return_, exit_ }) {
+      graph_->AddBlock(block);
+    }
+    graph_->SetEntryBlock(entry_);
+    graph_->SetExitBlock(exit_);
+    entry_->AddSuccessor(preheader_);
+    preheader_->AddSuccessor(loop_header_);
+    loop_header_->AddSuccessor(loop_body_);
+    loop_header_->AddSuccessor(return_);
+    loop_body_->AddSuccessor(throw_);
+    loop_body_->AddSuccessor(loop_header_);
+    throw_->AddSuccessor(exit_);
+    return_->AddSuccessor(exit_);
+
+    first_ = new (&allocator_) HParameterValue(graph_->GetDexFile(), 0, 0, Primitive::kPrimInt);
+    second_ = new (&allocator_) HParameterValue(graph_->GetDexFile(), 0, 1, Primitive::kPrimInt);
+    exception_ =
+        new (&allocator_) HParameterValue(graph_->GetDexFile(), 0, 2, Primitive::kPrimNot);
+    for (HInstruction* parameter : { first_, second_, exception_ }) {
+      entry_->AddInstruction(parameter);
+    }
+    entry_->AddInstruction(new (&allocator_) HGoto());
+    preheader_->AddInstruction(new (&allocator_) HGoto());
+    HInstruction* loop_condition = new (&allocator_) HGreaterThan(first_, second_);
+    loop_header_->AddInstruction(loop_condition);
+    loop_header_->AddInstruction(new (&allocator_) HIf(loop_condition));
+    HInstruction* throw_condition = new (&allocator_) HLessThan(first_, second_);
+    loop_body_->AddInstruction(throw_condition);
+    loop_body_->AddInstruction(new (&allocator_) HIf(throw_condition));
+    throw_->AddInstruction(new (&allocator_) HThrow(exception_, 0));
+    return_->AddInstruction(new (&allocator_) HReturn(first_));
+    exit_->AddInstruction(new (&allocator_) HExit());
+  }
+
+  // Adds a use of `value` to the throwing block.
+  HInstruction* UseInThrow(HInstruction* value) {
+    HInstruction* use = new (&allocator_) HDivZeroCheck(value, 0);
+    throw_->InsertInstructionBefore(use, throw_->GetLastInstruction());
+    return use;
+  }
+
+  // Adds `instruction` before the end of `block`.
+  HInstruction* Add(HBasicBlock* block, HInstruction* instruction) {
+    block->InsertInstructionBefore(instruction, block->GetLastInstruction());
+    return instruction;
+  }
+
+  // Runs code sinking, and checks that the graph is still valid.
+  void PerformCodeSinking() {
+    ASSERT_TRUE(graph_->TryBuildingSsa());
+    CodeSinking(graph_, nullptr).Run();
+    SSAChecker checker(graph_);
+    checker.Run();
+    ASSERT_TRUE(checker.IsValid());
+  }
+
+  ArenaPool pool_;
+  ArenaAllocator allocator_;
+  HGraph* graph_;
+
+  HBasicBlock* entry_;
+  HBasicBlock* preheader_;
+  HBasicBlock* loop_header_;
+  HBasicBlock* loop_body_;
+  HBasicBlock* throw_;
+  HBasicBlock* return_;
+  HBasicBlock* exit_;
+
+  HInstruction* first_;
+  HInstruction* second_;
+  HInstruction* exception_;
+};
+
+//
+// The actual code sinking tests.
+//
+
+TEST_F(CodeSinkingTest, SinkComputation) {
+  BuildGraph();
+  HInstruction* add = Add(preheader_, new (&allocator_) HAdd(Primitive::kPrimInt, first_, second_));
+  HInstruction* use = UseInThrow(add);
+  PerformCodeSinking();
+
+  // The throwing path branches out of the loop, so the add still runs at most once.
+  EXPECT_EQ(throw_, add->GetBlock());
+  EXPECT_EQ(use, add->GetNext());
+}
+
+TEST_F(CodeSinkingTest, SinkChain) {
+  BuildGraph();
+  HInstruction* add = Add(preheader_, new (&allocator_) HAdd(Primitive::kPrimInt, first_, second_));
+  HInstruction* neg = Add(preheader_, new (&allocator_) HNeg(Primitive::kPrimInt, add));
+  UseInThrow(neg);
+  PerformCodeSinking();
+
+  EXPECT_EQ(throw_, add->GetBlock());
+  EXPECT_EQ(throw_, neg->GetBlock());
+  EXPECT_EQ(neg, add->GetNext());
+}
+
+TEST_F(CodeSinkingTest, SinkAllocationWithStores) {
+  BuildGraph();
+  HInstruction* array = Add(preheader_, new (&allocator_) HNewArray(graph_->GetIntConstant(2),
+                                                                    graph_->GetCurrentMethod(),
+                                                                    0,
+                                                                    0,
+                                                                    graph_->GetDexFile(),
+                                                                    kQuickAllocArray));
+  HInstruction* store0 = Add(preheader_, new (&allocator_) HArraySet(
+      array, graph_->GetIntConstant(0), first_, Primitive::kPrimInt, 0));
+  HInstruction* store1 = Add(preheader_, new (&allocator_) HArraySet(
+      array, graph_->GetIntConstant(1), second_, Primitive::kPrimInt, 0));
+  HInstruction* length = Add(preheader_, new (&allocator_) HArrayLength(array, 0));
+  UseInThrow(length);
+  PerformCodeSinking();
+
+  // The initializing stores follow the allocation, in their original order.
+  EXPECT_EQ(throw_, array->GetBlock());
+  EXPECT_EQ(store0, array->GetNext());
+  EXPECT_EQ(store1, store0->GetNext());
+  EXPECT_EQ(length, store1->GetNext());
+}
+
+TEST_F(CodeSinkingTest, NoSinkingOfAllocationWithUnknownLength) {
+  BuildGraph();
+  HInstruction* array = Add(preheader_, new (&allocator_) HNewArray(first_,
+                                                                    graph_->GetCurrentMethod(),
+                                                                    0,
+                                                                    0,
+                                                                    graph_->GetDexFile(),
+                                                                    kQuickAllocArray));
+  UseInThrow(Add(throw_, new (&allocator_) HArrayLength(array, 0)));
+  PerformCodeSinking();
+
+  // A negative length would throw NegativeArraySizeException on the common path.
+  EXPECT_EQ(preheader_, array->GetBlock());
+}
+
+TEST_F(CodeSinkingTest, NoSinkingWithCommonUse) {
+  BuildGraph();
+  HInstruction* add = Add(preheader_, new (&allocator_) HAdd(Primitive::kPrimInt, first_, second_));
+  UseInThrow(add);
+  return_->GetLastInstruction()->ReplaceInput(add, 0);
+  PerformCodeSinking();
+
+  EXPECT_EQ(preheader_, add->GetBlock());
+}
+
+TEST_F(CodeSinkingTest, NoSinkingOutOfLoop) {
+  BuildGraph();
+  HInstruction* add = Add(loop_body_, new (&allocator_) HAdd(Primitive::kPrimInt, first_, second_));
+  HInstruction* array = Add(loop_body_, new (&allocator_) HNewArray(graph_->GetIntConstant(1),
+                                                                    graph_->GetCurrentMethod(),
+                                                                    0,
+                                                                    0,
+                                                                    graph_->GetDexFile(),
+                                                                    kQuickAllocArray));
+  Add(loop_body_, new (&allocator_) HArraySet(
+      array, graph_->GetIntConstant(0), add, Primitive::kPrimInt, 0));
+  UseInThrow(Add(throw_, new (&allocator_) HArrayLength(array, 0)));
+  PerformCodeSinking();
+
+  EXPECT_EQ(loop_body_, add->GetBlock());
+  EXPECT_EQ(loop_body_, array->GetBlock());
+}
+
+}  // namespace art
@@ -31,7 +31,9 @@ namespace art {
  *
  * The `Lookup` method returns an equivalent instruction to the given instruction
  * if there is one in the set. In GVN, we would say those instructions have the
- * same "number".
+ * same "number". An instruction can also be added with a different value, the
+ * phi which replaced it after partial redundancy elimination, in which case
+ * `Lookup` returns that value.
  */
 class ValueSet : public ArenaObject<kArenaAllocGvn> {
  public:
@@ -77,6 +79,11 @@ class ValueSet : public ArenaObject<kArenaAllocGvn> {
 
   // Adds an instruction in the set.
   void Add(HInstruction* instruction) {
+    Add(instruction, instruction);
+  }
+
+  // Adds an instruction in the set, to be replaced by `value`.
+  void Add(HInstruction* instruction, HInstruction* value) {
     DCHECK(Lookup(instruction) == nullptr);
     size_t hash_code = HashCode(instruction);
     size_t index = BucketIndex(hash_code);
@@ -84,7 +91,7 @@ class ValueSet : public ArenaObject<kArenaAllocGvn> {
     if (!buckets_owned_.IsBitSet(index)) {
       CloneBucket(index);
     }
-    buckets_[index] = new (allocator_) Node(instruction, hash_code, buckets_[index]);
+    buckets_[index] = new (allocator_) Node(instruction, value, hash_code, buckets_[index]);
     ++num_entries_;
   }
 
@@ -98,7 +105,7 @@ class ValueSet : public ArenaObject<kArenaAllocGvn> {
       if (node->GetHashCode() == hash_code) {
         HInstruction* existing = node->GetInstruction();
         if (existing->Equals(instruction)) {
-          return existing;
+          return node->GetValue();
         }
       }
     }
@@ -146,20 +153,22 @@ class ValueSet : public ArenaObject<kArenaAllocGvn> {
  private:
   class Node : public ArenaObject<kArenaAllocGvn> {
    public:
-    Node(HInstruction* instruction, size_t hash_code, Node* next)
-        : instruction_(instruction), hash_code_(hash_code), next_(next) {}
+    Node(HInstruction* instruction, HInstruction* value, size_t hash_code, Node* next)
+        : instruction_(instruction), value_(value), hash_code_(hash_code), next_(next) {}
 
     size_t GetHashCode() const { return hash_code_; }
     HInstruction* GetInstruction() const { return instruction_; }
+    HInstruction* GetValue() const { return value_; }
     Node* GetNext() const { return next_; }
     void SetNext(Node* node) { next_ = node; }
 
     Node* Dup(ArenaAllocator* allocator, Node* new_next = nullptr) {
-      return new (allocator) Node(instruction_, hash_code_, new_next);
+      return new (allocator) Node(instruction_, value_, hash_code_, new_next);
     }
 
    private:
     HInstruction* const instruction_;
+    HInstruction* const value_;
     const size_t hash_code_;
     Node* next_;
 
@@ -296,8 +305,137 @@ class ValueSet : public ArenaObject<kArenaAllocGvn> {
   DISALLOW_COPY_AND_ASSIGN(ValueSet);
 };
 
+// Returns whether the code motion done by GVN considers `instruction`, that is whether it is
+// a movable computation worth keeping in a register across a merge. Conditions are left alone
+// so that they can still be emitted at their use site.
+static bool IsCodeMotionCandidate(HInstruction* instruction) {
+  if (!instruction->CanBeMoved()) {
+    return false;
+  }
+  switch (instruction->GetKind()) {
+    case HInstruction::kAdd:
+    case HInstruction::kSub:
+    case HInstruction::kMul:
+    case HInstruction::kAnd:
+    case HInstruction::kOr:
+    case HInstruction::kXor:
+    case HInstruction::kShl:
+    case HInstruction::kShr:
+    case HInstruction::kUShr:
+    case HInstruction::kNeg:
+    case HInstruction::kNot:
+    case HInstruction::kTypeConversion:
+    case HInstruction::kArrayLength:
+    case HInstruction::kArrayGet:
+    case HInstruction::kInstanceFieldGet:
+    case HInstruction::kStaticFieldGet:
+    case HInstruction::kLoadString:
+      return true;
+    case HInstruction::kLoadClass:
+      // Users like HClinitCheck and HNewInstance must see the HLoadClass itself, not a phi.
+      for (HUseIterator<HInstruction*> it(instruction->GetUses()); !it.Done(); it.Advance()) {
+        HInstruction* user = it.Current()->GetUser();
+        if (!user->IsStaticFieldGet() && !user->IsStaticFieldSet()) {
+          return false;
+        }
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns whether `instruction` can execute before instructions with the combined side
+// effects `effects`, some of which can throw if `can_throw`.
+static bool CanMoveAbove(HInstruction* instruction, SideEffects effects, bool can_throw) {
+  SideEffects instruction_effects = instruction->GetSideEffects();
+  if (instruction_effects.MayDependOn(effects) || effects.MayDependOn(instruction_effects)) {
+    return false;
+  }
+  // An exception must not be thrown before or instead of an observable effect.
+  return !instruction->CanThrow() || (!can_throw && !effects.HasSideEffects());
+}
+
+// Returns whether the inputs and environment of `instruction` are all defined outside
+// of `block`, and thus available in the blocks dominating it.
+static bool DependsOnlyOnValuesOutside(HInstruction* instruction, HBasicBlock* block) {
+  for (size_t i = 0, e = instruction->InputCount(); i < e; ++i) {
+    if (instruction->InputAt(i)->GetBlock() == block) {
+      return false;
+    }
+  }
+  for (HEnvironment* environment = instruction->GetEnvironment();
+       environment != nullptr;
+       environment = environment->GetParent()) {
+    for (size_t i = 0, e = environment->Size(); i < e; ++i) {
+      HInstruction* value = environment->GetInstructionAt(i);
+      if (value != nullptr && value->GetBlock() == block) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Returns whether `first` and `second` compute the same value, possibly with the inputs of
+// a commutative operation in a different order. Unlike OrderInputs(), this leaves both
+// instructions untouched.
+static bool EqualsModuloCommutation(HInstruction* first, HInstruction* second) {
+  if (first->Equals(second)) {
+    return true;
+  }
+  if (!first->IsBinaryOperation() ||
+      !first->AsBinaryOperation()->IsCommutative() ||
+      !first->InstructionTypeEquals(second)) {
+    return false;
+  }
+  return first->InstructionDataEquals(second) &&
+      first->GetType() == second->GetType() &&
+      first->InputAt(0) == second->InputAt(1) &&
+      first->InputAt(1) == second->InputAt(0);
+}
+
+// Returns whether `instruction` has `value` as an input or in its environment.
+static bool UsesValue(HInstruction* instruction, HInstruction* value) {
+  for (HUseIterator<HInstruction*> it(value->GetUses()); !it.Done(); it.Advance()) {
+    if (it.Current()->GetUser() == instruction) {
+      return true;
+    }
+  }
+  for (HUseIterator<HEnvironment*> it(value->GetEnvUses()); !it.Done(); it.Advance()) {
+    if (it.Current()->GetUser()->GetHolder() == instruction) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns whether `block` is a merge whose predecessors all flow directly into it, so that
+// an instruction can be moved to their end.
+static bool IsMergeWithoutCriticalEdges(HBasicBlock* block) {
+  const ArenaVector<HBasicBlock*>& predecessors = block->GetPredecessors();
+  if (predecessors.size() < 2u || block->IsLoopHeader() || block->IsCatchBlock()) {
+    return false;
+  }
+  for (HBasicBlock* predecessor : predecessors) {
+    if (!predecessor->GetLastInstruction()->IsGoto()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /**
  * Optimization phase that removes redundant instruction.
+ *
+ * On top of dominator-based value numbering, it does some code motion:
+ *  - An instruction computed at the start of both successors of an HIf is hoisted
+ *    before the HIf, and the copy in the other successor is removed.
+ *  - An instruction in a merge block which is available at the end of its
+ *    predecessors, as different instructions, is replaced by a phi of them. If
+ *    one predecessor does not compute it, for example because a call on that
+ *    path killed the value, the instruction is moved to the end of that
+ *    predecessor. Instructions are never duplicated, so the code does not grow.
  */
 class GlobalValueNumberer : public ValueObject {
  public:
@@ -307,15 +445,34 @@ class GlobalValueNumberer : public ValueObject {
       : graph_(graph),
         allocator_(allocator),
         side_effects_(side_effects),
-        sets_(graph->GetBlocks().size(), nullptr, allocator->Adapter(kArenaAllocGvn)) {}
+        sets_(graph->GetBlocks().size(), nullptr, allocator->Adapter(kArenaAllocGvn)),
+        number_of_hoisted_instructions_(0),
+        number_of_partial_redundancies_(0) {}
 
   void Run();
 
+  size_t GetNumberOfHoistedInstructions() const { return number_of_hoisted_instructions_; }
+  size_t GetNumberOfPartialRedundancies() const { return number_of_partial_redundancies_; }
+
  private:
   // Per-block GVN. Will also update the ValueSet of the dominated and
   // successor blocks.
   void VisitBasicBlock(HBasicBlock* block);
 
+  // Hoists the instructions found at the start of both successors of the HIf
+  // ending `block`.
+  void HoistCommonInstructions(HBasicBlock* block);
+
+  // Replaces `instruction`, which is not available in the merge block `block`,
+  // with a phi of the equivalent instructions available at the end of its
+  // predecessors. The instructions before `instruction` in `block` have the
+  // combined side effects `prefix_effects` and can throw if `prefix_can_throw`.
+  // Returns the phi, or null if `instruction` was left alone.
+  HPhi* EliminatePartialRedundancy(HInstruction* instruction,
+                                  HBasicBlock* block,
+                                  SideEffects prefix_effects,
+                                  bool prefix_can_throw);
+
   HGraph* graph_;
   ArenaAllocator* const allocator_;
   const SideEffectsAnalysis& side_effects_;
@@ -325,6 +482,12 @@ class GlobalValueNumberer : public ValueObject {
   // in the path from the dominator to the block.
   ArenaVector<ValueSet*> sets_;
 
+  size_t number_of_hoisted_instructions_;
+  size_t number_of_partial_redundancies_;
+
+  // The number of instructions at the start of a successor looked at for hoisting.
+  static constexpr size_t kMaxHoistingScan = 16;
+
   DISALLOW_COPY_AND_ASSIGN(GlobalValueNumberer);
 };
 
@@ -332,6 +495,12 @@ void GlobalValueNumberer::Run() {
   DCHECK(side_effects_.HasRun());
   sets_[graph_->GetEntryBlock()->GetBlockId()] = new (allocator_) ValueSet(allocator_);
 
+  // Hoist first so that the value numbering below finds the hoisted instructions in
+  // the dominator. The post order lets hoisting from nested diamonds go first.
+  for (HPostOrderIterator it(*graph_); !it.Done(); it.Advance()) {
+    HoistCommonInstructions(it.Current());
+  }
+
   // Use the reverse post order to ensure the non back-edge predecessors of a block are
   // visited before the block itself.
   for (HReversePostOrderIterator it(*graph_); !it.Done(); it.Advance()) {
@@ -375,6 +544,11 @@ void GlobalValueNumberer::VisitBasicBlock(HBasicBlock* block) {
 
   sets_[block->GetBlockId()] = set;
 
+  bool is_merge = IsMergeWithoutCriticalEdges(block);
+  // The side effects of the instructions already visited which stay in the block.
+  SideEffects prefix_effects = SideEffects::None();
+  bool prefix_can_throw = false;
+
   HInstruction* current = block->GetFirstInstruction();
   while (current != nullptr) {
     // Save the next instruction in case `current` is removed from the graph.
@@ -396,19 +570,171 @@ void GlobalValueNumberer::VisitBasicBlock(HBasicBlock* block) {
         current->ReplaceWith(existing);
         current->GetBlock()->RemoveInstruction(current);
       } else {
+        HPhi* phi = is_merge
+            ? EliminatePartialRedundancy(current, block, prefix_effects, prefix_can_throw)
+            : nullptr;
         set->Kill(current->GetSideEffects());
-        set->Add(current);
+        if (phi != nullptr) {
+          // Equivalent instructions dominated by the phi which replaced `current` use it too.
+          set->Add(current, phi);
+        } else {
+          set->Add(current);
+          prefix_effects = prefix_effects.Union(current->GetSideEffects());
+          prefix_can_throw = prefix_can_throw || current->CanThrow();
+        }
       }
     } else {
       set->Kill(current->GetSideEffects());
+      prefix_effects = prefix_effects.Union(current->GetSideEffects());
+      prefix_can_throw = prefix_can_throw || current->CanThrow();
     }
     current = next;
   }
 }
 
+void GlobalValueNumberer::HoistCommonInstructions(HBasicBlock* block) {
+  HInstruction* last = block->GetLastInstruction();
+  if (!last->IsIf()) {
+    return;
+  }
+  HBasicBlock* first = block->GetSuccessors()[0];
+  HBasicBlock* second = block->GetSuccessors()[1];
+  if (first->GetSinglePredecessor() != block ||
+      second->GetSinglePredecessor() != block ||
+      first->GetLoopInformation() != block->GetLoopInformation() ||
+      second->GetLoopInformation() != block->GetLoopInformation()) {
+    return;
+  }
+
+  // Insert before the condition of the HIf when it immediately precedes it, so that
+  // it can still be emitted at its use site.
+  HInstruction* cursor = last;
+  if (last->GetPrevious() != nullptr && last->GetPrevious() == last->InputAt(0)) {
+    cursor = last->GetPrevious();
+  }
+
+  SideEffects first_effects = SideEffects::None();
+  bool first_can_throw = false;
+  size_t scanned = 0;
+  for (HInstruction* instruction = first->GetFirstInstruction(), *next = nullptr;
+       instruction != nullptr && scanned < kMaxHoistingScan;
+       instruction = next, ++scanned) {
+    next = instruction->GetNext();
+    HInstruction* other = nullptr;
+    if (IsCodeMotionCandidate(instruction) &&
+        !instruction->CanThrow() &&
+        CanMoveAbove(instruction, first_effects, first_can_throw) &&
+        DependsOnlyOnValuesOutside(instruction, first)) {
+      // Look for an equivalent instruction which can move to the start of `second`.
+      SideEffects second_effects = SideEffects::None();
+      bool second_can_throw = false;
+      size_t second_scanned = 0;
+      for (HInstruction* candidate = second->GetFirstInstruction();
+           candidate != nullptr && second_scanned < kMaxHoistingScan;
+           candidate = candidate->GetNext(), ++second_scanned) {
+        if (EqualsModuloCommutation(candidate, instruction)) {
+          if (CanMoveAbove(candidate, second_effects, second_can_throw)) {
+            other = candidate;
+          }
+          break;
+        }
+        second_effects = second_effects.Union(candidate->GetSideEffects());
+        second_can_throw = second_can_throw || candidate->CanThrow();
+      }
+    }
+
+    if (other == nullptr) {
+      first_effects = first_effects.Union(instruction->GetSideEffects());
+      first_can_throw = first_can_throw || instruction->CanThrow();
+      continue;
+    }
+    if (cursor != last && UsesValue(instruction, cursor)) {
+      // Keep the hoisted instructions in order.
+      cursor = last;
+    }
+    instruction->MoveBefore(cursor);
+    // Only canonicalize what is hoisted; the value numbering below orders the inputs
+    // of the other instructions as it visits them.
+    if (instruction->IsBinaryOperation() && instruction->AsBinaryOperation()->IsCommutative()) {
+      instruction->AsBinaryOperation()->OrderInputs();
+    }
+    other->ReplaceWith(instruction);
+    second->RemoveInstruction(other);
+    ++number_of_hoisted_instructions_;
+  }
+}
+
+HPhi* GlobalValueNumberer::EliminatePartialRedundancy(HInstruction* instruction,
+                                                      HBasicBlock* block,
+                                                      SideEffects prefix_effects,
+                                                      bool prefix_can_throw) {
+  if (!IsCodeMotionCandidate(instruction) ||
+      instruction->GetSideEffects().MayDependOn(prefix_effects)) {
+    return nullptr;
+  }
+
+  const ArenaVector<HBasicBlock*>& predecessors = block->GetPredecessors();
+  ArenaVector<HInstruction*> values(allocator_->Adapter(kArenaAllocGvn));
+  size_t missing_index = predecessors.size();
+  for (size_t i = 0, e = predecessors.size(); i < e; ++i) {
+    HInstruction* value = sets_[predecessors[i]->GetBlockId()]->Lookup(instruction);
+    if (value == nullptr) {
+      if (missing_index != predecessors.size()) {
+        // The instruction is moved, never duplicated, so it can be missing from one
+        // predecessor at most.
+        return nullptr;
+      }
+      missing_index = i;
+    }
+    values.push_back(value);
+  }
+
+  if (missing_index != predecessors.size()) {
+    // Move `instruction` to the end of the predecessor which does not compute it.
+    if (!DependsOnlyOnValuesOutside(instruction, block) ||
+        !CanMoveAbove(instruction, prefix_effects, prefix_can_throw) ||
+        (instruction->CanThrow() && graph_->HasTryCatch())) {
+      return nullptr;
+    }
+    HBasicBlock* predecessor = predecessors[missing_index];
+    instruction->MoveBefore(predecessor->GetLastInstruction());
+    sets_[predecessor->GetBlockId()]->Add(instruction);
+    values[missing_index] = instruction;
+  }
+
+  ArenaAllocator* arena = graph_->GetArena();
+  HPhi* phi = new (arena) HPhi(arena, kNoRegNumber, 0u, instruction->GetType());
+  block->AddPhi(phi);
+  for (HInstruction* value : values) {
+    phi->AddInput(value);
+  }
+  if (instruction->GetType() == Primitive::kPrimNot) {
+    ReferenceTypeInfo rti = instruction->GetReferenceTypeInfo();
+    if (rti.IsValid()) {
+      phi->SetReferenceTypeInfo(rti);
+    }
+    bool can_be_null = false;
+    for (HInstruction* value : values) {
+      can_be_null = can_be_null || value->CanBeNull();
+    }
+    phi->SetCanBeNull(can_be_null);
+  }
+
+  if (missing_index != predecessors.size()) {
+    instruction->ReplaceWithExceptInReplacementAtIndex(phi, missing_index);
+  } else {
+    instruction->ReplaceWith(phi);
+    block->RemoveInstruction(instruction);
+  }
+  ++number_of_partial_redundancies_;
+  return phi;
+}
+
 void GVNOptimization::Run() {
   GlobalValueNumberer gvn(graph_->GetArena(), graph_, side_effects_);
   gvn.Run();
+  MaybeRecordStat(kInstructionHoisted, gvn.GetNumberOfHoistedInstructions());
+  MaybeRecordStat(kRemovedPartialRedundancy, gvn.GetNumberOfPartialRedundancies());
 }
 
 }  // namespace art
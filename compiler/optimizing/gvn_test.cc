@@ -444,4 +444,180 @@ TEST(GVNTest, LoopSideEffects) {
     ASSERT_TRUE(side_effects.GetLoopEffects(inner_loop_header).DoesAnyWrite());
   }
 }
+
+// Test that a field get after a merge reuses the one before the branch, and is
+// moved to the branch which kills it.
+TEST(GVNTest, PartialRedundancyElimination) {
+  ArenaPool pool;
+  ArenaAllocator allocator(&pool);
+  NullHandle<mirror::DexCache> dex_cache;
+
+  HGraph* graph = CreateGraph(&allocator);
+  HBasicBlock* entry = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(entry);
+  graph->SetEntryBlock(entry);
+  HInstruction* parameter = new (&allocator) HParameterValue(graph->GetDexFile(),
+                                                             0,
+                                                             0,
+                                                             Primitive::kPrimNot);
+  HInstruction* condition = new (&allocator) HParameterValue(graph->GetDexFile(),
+                                                             0,
+                                                             1,
+                                                             Primitive::kPrimBoolean);
+  entry->AddInstruction(parameter);
+  entry->AddInstruction(condition);
+
+  HBasicBlock* block = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(block);
+  entry->AddSuccessor(block);
+  block->AddInstruction(new (&allocator) HInstanceFieldGet(parameter,
+                                                           Primitive::kPrimNot,
+                                                           MemberOffset(42),
+                                                           false,
+                                                           kUnknownFieldIndex,
+                                                           kUnknownClassDefIndex,
+                                                           graph->GetDexFile(),
+                                                           dex_cache,
+                                                           0));
+  HInstruction* field_get_before = block->GetLastInstruction();
+  block->AddInstruction(new (&allocator) HIf(condition));
+
+  HBasicBlock* then = new (&allocator) HBasicBlock(graph);
+  HBasicBlock* else_ = new (&allocator) HBasicBlock(graph);
+  HBasicBlock* join = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(then);
+  graph->AddBlock(else_);
+  graph->AddBlock(join);
+
+  block->AddSuccessor(then);
+  block->AddSuccessor(else_);
+  then->AddSuccessor(join);
+  else_->AddSuccessor(join);
+
+  // Kill the value on one branch only.
+  then->AddInstruction(new (&allocator) HInstanceFieldSet(parameter,
+                                                          parameter,
+                                                          Primitive::kPrimNot,
+                                                          MemberOffset(42),
+                                                          false,
+                                                          kUnknownFieldIndex,
+                                                          kUnknownClassDefIndex,
+                                                          graph->GetDexFile(),
+                                                          dex_cache,
+                                                          0));
+  then->AddInstruction(new (&allocator) HGoto());
+  else_->AddInstruction(new (&allocator) HGoto());
+  join->AddInstruction(new (&allocator) HInstanceFieldGet(parameter,
+                                                          Primitive::kPrimNot,
+                                                          MemberOffset(42),
+                                                          false,
+                                                          kUnknownFieldIndex,
+                                                          kUnknownClassDefIndex,
+                                                          graph->GetDexFile(),
+                                                          dex_cache,
+                                                          0));
+  HInstruction* field_get_after = join->GetLastInstruction();
+  join->AddInstruction(new (&allocator) HExit());
+
+  graph->TryBuildingSsa();
+  SideEffectsAnalysis side_effects(graph);
+  side_effects.Run();
+  GVNOptimization(graph, side_effects).Run();
+
+  // The field get after the merge is only needed after the field set.
+  ASSERT_EQ(field_get_before->GetBlock(), block);
+  ASSERT_EQ(field_get_after->GetBlock(), then);
+  HInstruction* phi = join->GetFirstPhi();
+  ASSERT_TRUE(phi != nullptr);
+  ASSERT_EQ(phi->InputAt(0), field_get_after);
+  ASSERT_EQ(phi->InputAt(1), field_get_before);
+}
+
+// Test that an instruction computed on both branches is hoisted before the branch.
+TEST(GVNTest, HoistingFromBranches) {
+  ArenaPool pool;
+  ArenaAllocator allocator(&pool);
+  NullHandle<mirror::DexCache> dex_cache;
+
+  HGraph* graph = CreateGraph(&allocator);
+  HBasicBlock* entry = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(entry);
+  graph->SetEntryBlock(entry);
+  HInstruction* object = new (&allocator) HParameterValue(graph->GetDexFile(),
+                                                          0,
+                                                          0,
+                                                          Primitive::kPrimNot);
+  HInstruction* first = new (&allocator) HParameterValue(graph->GetDexFile(),
+                                                         0,
+                                                         1,
+                                                         Primitive::kPrimInt);
+  HInstruction* second = new (&allocator) HParameterValue(graph->GetDexFile(),
+                                                          0,
+                                                          2,
+                                                          Primitive::kPrimInt);
+  HInstruction* condition = new (&allocator) HParameterValue(graph->GetDexFile(),
+                                                             0,
+                                                             3,
+                                                             Primitive::kPrimBoolean);
+  entry->AddInstruction(object);
+  entry->AddInstruction(first);
+  entry->AddInstruction(second);
+  entry->AddInstruction(condition);
+
+  HBasicBlock* block = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(block);
+  entry->AddSuccessor(block);
+  block->AddInstruction(new (&allocator) HIf(condition));
+
+  HBasicBlock* then = new (&allocator) HBasicBlock(graph);
+  HBasicBlock* else_ = new (&allocator) HBasicBlock(graph);
+  HBasicBlock* join = new (&allocator) HBasicBlock(graph);
+  graph->AddBlock(then);
+  graph->AddBlock(else_);
+  graph->AddBlock(join);
+
+  block->AddSuccessor(then);
+  block->AddSuccessor(else_);
+  then->AddSuccessor(join);
+  else_->AddSuccessor(join);
+
+  HInstruction* then_add = new (&allocator) HAdd(Primitive::kPrimInt, first, second);
+  then->AddInstruction(then_add);
+  then->AddInstruction(new (&allocator) HInstanceFieldSet(object,
+                                                          then_add,
+                                                          Primitive::kPrimInt,
+                                                          MemberOffset(42),
+                                                          false,
+                                                          kUnknownFieldIndex,
+                                                          kUnknownClassDefIndex,
+                                                          graph->GetDexFile(),
+                                                          dex_cache,
+                                                          0));
+  then->AddInstruction(new (&allocator) HGoto());
+  HInstruction* else_add = new (&allocator) HAdd(Primitive::kPrimInt, second, first);
+  else_->AddInstruction(else_add);
+  else_->AddInstruction(new (&allocator) HInstanceFieldSet(object,
+                                                           else_add,
+                                                           Primitive::kPrimInt,
+                                                           MemberOffset(43),
+                                                           false,
+                                                           kUnknownFieldIndex,
+                                                           kUnknownClassDefIndex,
+                                                           graph->GetDexFile(),
+                                                           dex_cache,
+                                                           0));
+  else_->AddInstruction(new (&allocator) HGoto());
+  join->AddInstruction(new (&allocator) HExit());
+
+  graph->TryBuildingSsa();
+  SideEffectsAnalysis side_effects(graph);
+  side_effects.Run();
+  GVNOptimization(graph, side_effects).Run();
+
+  ASSERT_EQ(then_add->GetBlock(), block);
+  ASSERT_TRUE(else_add->GetBlock() == nullptr);
+  ASSERT_EQ(then->GetFirstInstruction()->InputAt(1), then_add);
+  ASSERT_EQ(else_->GetFirstInstruction()->InputAt(1), then_add);
+}
+
 }  // namespace art
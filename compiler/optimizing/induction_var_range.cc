@@ -152,6 +152,22 @@ void InductionVarRange::GenerateTakenTest(HInstruction* context,
   }
 }
 
+bool InductionVarRange::IsConstantTripCount(HLoopInformation* loop,
+                                            /*out*/int64_t* trip_count) {
+  HInductionVarAnalysis::InductionInfo* trip =
+      induction_analysis_->LookupInfo(loop, loop->GetHeader()->GetLastInstruction());
+  if (trip != nullptr &&
+      trip->induction_class == HInductionVarAnalysis::kInvariant &&
+      trip->operation == HInductionVarAnalysis::kTripCountInLoop) {
+    int32_t value;
+    if (GetConstant(trip->op_a, &value) && value > 0) {
+      *trip_count = value;
+      return true;
+    }
+  }
+  return false;
+}
+
 //
 // Private class methods.
 //
@@ -112,6 +112,12 @@ class InductionVarRange {
                          HBasicBlock* block,
                          /*out*/HInstruction** taken_test);
 
+  /**
+   * Returns true if the given loop is known to be taken and to execute its body a constant
+   * number of times, which is returned in the output parameter trip_count.
+   */
+  bool IsConstantTripCount(HLoopInformation* loop, /*out*/int64_t* trip_count);
+
  private:
   //
   // Private helper methods.
@@ -483,6 +483,12 @@ TEST_F(InductionVarRangeTest, ConstantTripCountUp) {
   EXPECT_FALSE(needs_finite_test);
   ExpectEqual(Value(1), v1);
   ExpectEqual(Value(1000), v2);
+
+  // Trip count is known.
+  int64_t trip_count = 0;
+  EXPECT_TRUE(range.IsConstantTripCount(
+      condition_->GetBlock()->GetLoopInformation(), &trip_count));
+  EXPECT_EQ(1000, trip_count);
 }
 
 TEST_F(InductionVarRangeTest, ConstantTripCountDown) {
@@ -508,6 +514,12 @@ TEST_F(InductionVarRangeTest, ConstantTripCountDown) {
   EXPECT_FALSE(needs_finite_test);
   ExpectEqual(Value(0), v1);
   ExpectEqual(Value(999), v2);
+
+  // Trip count is known.
+  int64_t trip_count = 0;
+  EXPECT_TRUE(range.IsConstantTripCount(
+      condition_->GetBlock()->GetLoopInformation(), &trip_count));
+  EXPECT_EQ(1000, trip_count);
 }
 
 TEST_F(InductionVarRangeTest, SymbolicTripCountUp) {
@@ -578,6 +590,11 @@ TEST_F(InductionVarRangeTest, SymbolicTripCountUp) {
   ASSERT_TRUE(taken->InputAt(0)->IsIntConstant());
   EXPECT_EQ(0, taken->InputAt(0)->AsIntConstant()->GetValue());
   EXPECT_TRUE(taken->InputAt(1)->IsParameterValue());
+
+  // Trip count is not a constant.
+  int64_t trip_count = 0;
+  EXPECT_FALSE(range.IsConstantTripCount(
+      condition_->GetBlock()->GetLoopInformation(), &trip_count));
 }
 
 TEST_F(InductionVarRangeTest, SymbolicTripCountDown) {
@@ -16,6 +16,7 @@
 
 #include "inliner.h"
 
+#include "art_field-inl.h"
 #include "art_method-inl.h"
 #include "builder.h"
 #include "class_linker.h"
@@ -26,6 +27,8 @@
 #include "driver/dex_compilation_unit.h"
 #include "instruction_simplifier.h"
 #include "intrinsics.h"
+#include "jit/jit.h"
+#include "jit/profiling_info.h"
 #include "mirror/class_loader.h"
 #include "mirror/dex_cache.h"
 #include "nodes.h"
@@ -43,6 +46,14 @@ namespace art {
 
 static constexpr size_t kMaximumNumberOfHInstructions = 12;
 
+// Budget for call sites that the JIT profile shows were executed. Inlining there pays off more
+// often, so we accept bigger callees.
+static constexpr size_t kMaximumNumberOfHInstructionsForProfiledCall = 24;
+
+// Maximum number of receiver types we are willing to check before an inlined call.
+static constexpr size_t kMaximumNumberOfTypeGuards =
+    ProfilingInfo::InlineCache::kIndividualCacheSize - 1;
+
 void HInliner::Run() {
   const CompilerOptions& compiler_options = compiler_driver_->GetCompilerOptions();
   if ((compiler_options.GetInlineDepthLimit() == 0)
@@ -214,17 +225,279 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
     return false;
   }
 
+  size_t instructions_budget = kMaximumNumberOfHInstructions;
   if (!invoke_instruction->IsInvokeStaticOrDirect()) {
-    resolved_method = FindVirtualOrInterfaceTarget(invoke_instruction, resolved_method);
-    if (resolved_method == nullptr) {
+    ArtMethod* actual_method = FindVirtualOrInterfaceTarget(invoke_instruction, resolved_method);
+    if (actual_method == nullptr) {
       VLOG(compiler) << "Interface or virtual call to "
                      << PrettyMethod(method_index, caller_dex_file)
                      << " could not be statically determined";
+      if (!TryInlineSingleImplementation(invoke_instruction, resolved_method) &&
+          !TryInlineFromInlineCache(invoke_instruction, resolved_method)) {
+        return false;
+      }
+      MaybeRecordStat(kInlinedInvoke);
+      return true;
+    }
+    resolved_method = actual_method;
+    ProfilingInfo* profiling_info = GetCallerProfilingInfo();
+    if (profiling_info != nullptr) {
+      ProfilingInfo::InlineCache* cache =
+          profiling_info->GetInlineCache(invoke_instruction->GetDexPc());
+      if (cache != nullptr && !cache->IsUnitialized()) {
+        instructions_budget = kMaximumNumberOfHInstructionsForProfiledCall;
+      }
+    }
+  }
+
+  if (!TryInline(invoke_instruction, resolved_method, instructions_budget)) {
+    return false;
+  }
+  MaybeRecordStat(kInlinedInvoke);
+  return true;
+}
+
+ProfilingInfo* HInliner::GetCallerProfilingInfo() const {
+  // Profiles are only collected, and can only be trusted to stay alive, when JIT compiling:
+  // the JIT code cache only frees them from the thread that compiles.
+  Runtime* runtime = Runtime::Current();
+  if (!runtime->UseJit()) {
+    return nullptr;
+  }
+  size_t pointer_size = caller_compilation_unit_.GetClassLinker()->GetImagePointerSize();
+  ArtMethod* caller = caller_compilation_unit_.GetDexCache()->GetResolvedMethod(
+      caller_compilation_unit_.GetDexMethodIndex(), pointer_size);
+  if (caller == nullptr || caller->IsNative()) {
+    return nullptr;
+  }
+  return caller->GetProfilingInfo(pointer_size);
+}
+
+/**
+ * Return the index of `cls` in the type ids of `dex_file`, provided that `dex_cache`,
+ * the dex cache of `dex_file`, has it resolved to that very class.
+ * Return DexFile::kDexNoIndex otherwise.
+ */
+static uint32_t FindClassIndexIn(mirror::Class* cls,
+                                 const DexFile& dex_file,
+                                 Handle<mirror::DexCache> dex_cache)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  uint32_t index = DexFile::kDexNoIndex;
+  if (cls->GetDexCache() == nullptr) {
+    DCHECK(cls->IsArrayClass() || cls->IsProxyClass()) << PrettyClass(cls);
+  } else if (IsSameDexFile(cls->GetDexFile(), dex_file)) {
+    index = cls->GetDexTypeIndex();
+  } else {
+    std::string temp;
+    const DexFile::TypeId* type_id = dex_file.FindTypeId(cls->GetDescriptor(&temp));
+    if (type_id != nullptr) {
+      index = dex_file.GetIndexForTypeId(*type_id);
+    }
+  }
+  // The guard loads the class from the dex cache without a slow path, so it must be there.
+  if (index != DexFile::kDexNoIndex && dex_cache->GetResolvedType(index) != cls) {
+    index = DexFile::kDexNoIndex;
+  }
+  return index;
+}
+
+bool HInliner::TryInlineSingleImplementation(HInvoke* invoke_instruction,
+                                             ArtMethod* resolved_method) {
+  // Only JIT code can be invalidated when a class breaks the assumption.
+  if (!Runtime::Current()->UseJit() || !invoke_instruction->IsInvokeVirtual()) {
+    return false;
+  }
+  if (!resolved_method->IsSingleImplementation()) {
+    return false;
+  }
+  // Don't rely on class hierarchy analysis again once it failed for the method being compiled,
+  // or the method would keep deoptimizing.
+  size_t pointer_size = outer_compilation_unit_.GetClassLinker()->GetImagePointerSize();
+  ArtMethod* outermost_method = outer_compilation_unit_.GetDexCache()->GetResolvedMethod(
+      outer_compilation_unit_.GetDexMethodIndex(), pointer_size);
+  if (outermost_method == nullptr ||
+      outermost_method->HasInvalidatedSingleImplementationAssumption()) {
+    return false;
+  }
+
+  HInstruction* cursor = invoke_instruction->GetPrevious();
+  HBasicBlock* bb_cursor = invoke_instruction->GetBlock();
+  if (!TryInline(invoke_instruction, resolved_method, kMaximumNumberOfHInstructions)) {
+    return false;
+  }
+  AddCHAGuard(cursor, bb_cursor, invoke_instruction);
+  outermost_graph_->AddCHASingleImplementationDependency(resolved_method);
+  MaybeRecordStat(kInlinedSingleImplementationCall);
+  return true;
+}
+
+void HInliner::AddCHAGuard(HInstruction* cursor,
+                           HBasicBlock* bb_cursor,
+                           HInvoke* invoke_instruction) {
+  ArenaAllocator* arena = graph_->GetArena();
+  uint32_t dex_pc = invoke_instruction->GetDexPc();
+  HLoadMethodAccessFlags* access_flags =
+      new (arena) HLoadMethodAccessFlags(graph_->GetCurrentMethod(), dex_pc);
+  HAnd* invalidated = new (arena) HAnd(Primitive::kPrimInt,
+                                       access_flags,
+                                       graph_->GetIntConstant(kAccSingleImplementationInvalidated),
+                                       dex_pc);
+  HNotEqual* condition = new (arena) HNotEqual(invalidated, graph_->GetIntConstant(0));
+  HDeoptimize* deoptimize = new (arena) HDeoptimize(condition, dex_pc);
+  if (cursor != nullptr) {
+    bb_cursor->InsertInstructionAfter(access_flags, cursor);
+  } else {
+    bb_cursor->InsertInstructionBefore(access_flags, bb_cursor->GetFirstInstruction());
+  }
+  bb_cursor->InsertInstructionAfter(invalidated, access_flags);
+  bb_cursor->InsertInstructionAfter(condition, invalidated);
+  bb_cursor->InsertInstructionAfter(deoptimize, condition);
+  deoptimize->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
+}
+
+bool HInliner::TryInlineFromInlineCache(HInvoke* invoke_instruction, ArtMethod* resolved_method) {
+  ProfilingInfo* profiling_info = GetCallerProfilingInfo();
+  if (profiling_info == nullptr) {
+    return false;
+  }
+  ProfilingInfo::InlineCache* cache =
+      profiling_info->GetInlineCache(invoke_instruction->GetDexPc());
+  if (cache == nullptr || cache->IsUnitialized()) {
+    VLOG(compiler) << "No profile for the call to " << PrettyMethod(resolved_method);
+    return false;
+  }
+  if (cache->IsMegamorphic()) {
+    VLOG(compiler) << "Call to " << PrettyMethod(resolved_method) << " is megamorphic";
+    return false;
+  }
+
+  // Find the target for each receiver type seen. The cache is concurrently updated by the
+  // interpreter, so only the entries we read here are guarded against.
+  ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
+  size_t pointer_size = class_linker->GetImagePointerSize();
+  const DexFile& caller_dex_file = *caller_compilation_unit_.GetDexFile();
+  uint32_t class_indices[kMaximumNumberOfTypeGuards];
+  size_t number_of_classes = 0;
+  ArtMethod* actual_method = nullptr;
+  for (size_t i = 0; i < kMaximumNumberOfTypeGuards; ++i) {
+    mirror::Class* cls = cache->GetTypeAt(i);
+    if (cls == nullptr) {
+      break;
+    }
+    ArtMethod* method = invoke_instruction->IsInvokeInterface()
+        ? cls->FindVirtualMethodForInterface(resolved_method, pointer_size)
+        : cls->FindVirtualMethodForVirtual(resolved_method, pointer_size);
+    if (method == nullptr || !method->IsInvokable()) {
+      VLOG(compiler) << "Call to " << PrettyMethod(resolved_method)
+                     << " has no invokable target for " << PrettyClass(cls);
+      return false;
+    }
+    if (actual_method != nullptr && actual_method != method) {
+      // Only caches whose receiver types all share a single target are inlined.
+      VLOG(compiler) << "Call to " << PrettyMethod(resolved_method)
+                     << " has several targets in the profile";
+      return false;
+    }
+    actual_method = method;
+    uint32_t class_index =
+        FindClassIndexIn(cls, caller_dex_file, caller_compilation_unit_.GetDexCache());
+    if (class_index == DexFile::kDexNoIndex) {
+      VLOG(compiler) << "Call to " << PrettyMethod(resolved_method)
+                     << " cannot be guarded because " << PrettyClass(cls)
+                     << " is not accessible from the caller";
       return false;
     }
+    class_indices[number_of_classes++] = class_index;
+  }
+  if (number_of_classes == 0) {
+    return false;
+  }
+
+  HInstruction* receiver = invoke_instruction->InputAt(0);
+  HInstruction* cursor = invoke_instruction->GetPrevious();
+  HBasicBlock* bb_cursor = invoke_instruction->GetBlock();
+  if (!TryInline(invoke_instruction, actual_method, kMaximumNumberOfHInstructionsForProfiledCall)) {
+    return false;
+  }
+
+  AddTypeGuard(receiver, cursor, bb_cursor, class_indices, number_of_classes, invoke_instruction);
+
+  // Run type propagation to get the guard typed.
+  ReferenceTypePropagation rtp_fixup(graph_, handles_);
+  rtp_fixup.Run();
+
+  MaybeRecordStat(number_of_classes == 1 ? kInlinedMonomorphicCall : kInlinedPolymorphicCall);
+  return true;
+}
+
+void HInliner::AddTypeGuard(HInstruction* receiver,
+                            HInstruction* cursor,
+                            HBasicBlock* bb_cursor,
+                            const uint32_t* class_indices,
+                            size_t number_of_classes,
+                            HInvoke* invoke_instruction) {
+  ArenaAllocator* arena = graph_->GetArena();
+  uint32_t dex_pc = invoke_instruction->GetDexPc();
+  ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
+  // The class of an object is stored in the first instance field of java.lang.Object.
+  ArtField* field = class_linker->GetClassRoot(ClassLinker::kJavaLangObject)->GetInstanceField(0);
+  DCHECK_EQ(std::string(field->GetName()), "shadow$_klass_");
+  HInstanceFieldGet* receiver_class = new (arena) HInstanceFieldGet(
+      receiver,
+      Primitive::kPrimNot,
+      field->GetOffset(),
+      field->IsVolatile(),
+      field->GetDexFieldIndex(),
+      field->GetDeclaringClass()->GetDexClassDefIndex(),
+      *field->GetDexFile(),
+      handles_->NewHandle(field->GetDexCache()),
+      dex_pc);
+  if (cursor != nullptr) {
+    bb_cursor->InsertInstructionAfter(receiver_class, cursor);
+  } else {
+    bb_cursor->InsertInstructionBefore(receiver_class, bb_cursor->GetFirstInstruction());
+  }
+
+  const DexFile& caller_dex_file = *caller_compilation_unit_.GetDexFile();
+  HInstruction* last = receiver_class;
+  HInstruction* condition = nullptr;
+  for (size_t i = 0; i < number_of_classes; ++i) {
+    HLoadClass* load_class = new (arena) HLoadClass(graph_->GetCurrentMethod(),
+                                                    class_indices[i],
+                                                    caller_dex_file,
+                                                    /* is_referrers_class */ false,
+                                                    dex_pc,
+                                                    /* needs_access_check */ false,
+                                                    /* is_in_dex_cache */ true);
+    HNotEqual* compare = new (arena) HNotEqual(load_class, receiver_class);
+    bb_cursor->InsertInstructionAfter(load_class, last);
+    bb_cursor->InsertInstructionAfter(compare, load_class);
+    last = compare;
+    if (condition == nullptr) {
+      condition = compare;
+    } else {
+      // Deoptimize only if the class differs from all the guarded ones.
+      HAnd* both = new (arena) HAnd(Primitive::kPrimInt, condition, compare, dex_pc);
+      bb_cursor->InsertInstructionAfter(both, last);
+      last = both;
+      condition = both;
+    }
+  }
+
+  HDeoptimize* deoptimize = new (arena) HDeoptimize(condition, dex_pc);
+  bb_cursor->InsertInstructionAfter(deoptimize, last);
+  deoptimize->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
+}
+
+bool HInliner::TryInline(HInvoke* invoke_instruction,
+                         ArtMethod* resolved_method,
+                         size_t instructions_budget) {
+  const DexFile& caller_dex_file = *caller_compilation_unit_.GetDexFile();
+  if (!invoke_instruction->IsInvokeStaticOrDirect()) {
     // We have found a method, but we need to find where that method is for the caller's
     // dex file.
-    method_index = FindMethodIndexIn(resolved_method, caller_dex_file, method_index);
+    uint32_t method_index = FindMethodIndexIn(
+        resolved_method, caller_dex_file, invoke_instruction->GetDexMethodIndex());
     if (method_index == DexFile::kDexNoIndex) {
       VLOG(compiler) << "Interface or virtual call to "
                      << PrettyMethod(resolved_method)
@@ -239,20 +512,20 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
   const DexFile::CodeItem* code_item = resolved_method->GetCodeItem();
 
   if (code_item == nullptr) {
-    VLOG(compiler) << "Method " << PrettyMethod(method_index, caller_dex_file)
+    VLOG(compiler) << "Method " << PrettyMethod(resolved_method)
                    << " is not inlined because it is native";
     return false;
   }
 
   size_t inline_max_code_units = compiler_driver_->GetCompilerOptions().GetInlineMaxCodeUnits();
   if (code_item->insns_size_in_code_units_ > inline_max_code_units) {
-    VLOG(compiler) << "Method " << PrettyMethod(method_index, caller_dex_file)
+    VLOG(compiler) << "Method " << PrettyMethod(resolved_method)
                    << " is too big to inline";
     return false;
   }
 
   if (code_item->tries_size_ != 0) {
-    VLOG(compiler) << "Method " << PrettyMethod(method_index, caller_dex_file)
+    VLOG(compiler) << "Method " << PrettyMethod(resolved_method)
                    << " is not inlined because of try block";
     return false;
   }
@@ -261,7 +534,7 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
     uint16_t class_def_idx = resolved_method->GetDeclaringClass()->GetDexClassDefIndex();
     if (!compiler_driver_->IsMethodVerifiedWithoutFailures(
           resolved_method->GetDexMethodIndex(), class_def_idx, *resolved_method->GetDexFile())) {
-      VLOG(compiler) << "Method " << PrettyMethod(method_index, caller_dex_file)
+      VLOG(compiler) << "Method " << PrettyMethod(resolved_method)
                      << " couldn't be verified, so it cannot be inlined";
       return false;
     }
@@ -271,24 +544,24 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
       invoke_instruction->AsInvokeStaticOrDirect()->IsStaticWithImplicitClinitCheck()) {
     // Case of a static method that cannot be inlined because it implicitly
     // requires an initialization check of its declaring class.
-    VLOG(compiler) << "Method " << PrettyMethod(method_index, caller_dex_file)
+    VLOG(compiler) << "Method " << PrettyMethod(resolved_method)
                    << " is not inlined because it is static and requires a clinit"
                    << " check that cannot be emitted due to Dex cache limitations";
     return false;
   }
 
-  if (!TryBuildAndInline(resolved_method, invoke_instruction, same_dex_file)) {
+  if (!TryBuildAndInline(resolved_method, invoke_instruction, same_dex_file, instructions_budget)) {
     return false;
   }
 
-  VLOG(compiler) << "Successfully inlined " << PrettyMethod(method_index, caller_dex_file);
-  MaybeRecordStat(kInlinedInvoke);
+  VLOG(compiler) << "Successfully inlined " << PrettyMethod(resolved_method);
   return true;
 }
 
 bool HInliner::TryBuildAndInline(ArtMethod* resolved_method,
                                  HInvoke* invoke_instruction,
-                                 bool same_dex_file) {
+                                 bool same_dex_file,
+                                 size_t instructions_budget) {
   ScopedObjectAccess soa(Thread::Current());
   const DexFile::CodeItem* code_item = resolved_method->GetCodeItem();
   const DexFile& callee_dex_file = *resolved_method->GetDexFile();
@@ -419,9 +692,10 @@ bool HInliner::TryBuildAndInline(ArtMethod* resolved_method,
     optimization->Run();
   }
 
-  size_t number_of_instructions_budget = kMaximumNumberOfHInstructions;
+  size_t number_of_instructions_budget = instructions_budget;
   if (depth_ + 1 < compiler_driver_->GetCompilerOptions().GetInlineDepthLimit()) {
     HInliner inliner(callee_graph,
+                     outermost_graph_,
                      codegen_,
                      outer_compilation_unit_,
                      dex_compilation_unit,
@@ -22,16 +22,20 @@
 
 namespace art {
 
+class ArtMethod;
 class CodeGenerator;
 class CompilerDriver;
 class DexCompilationUnit;
 class HGraph;
+class HInstruction;
 class HInvoke;
 class OptimizingCompilerStats;
+class ProfilingInfo;
 
 class HInliner : public HOptimization {
  public:
   HInliner(HGraph* outer_graph,
+           HGraph* outermost_graph,
            CodeGenerator* codegen,
            const DexCompilationUnit& outer_compilation_unit,
            const DexCompilationUnit& caller_compilation_unit,
@@ -40,6 +44,7 @@ class HInliner : public HOptimization {
            OptimizingCompilerStats* stats,
            size_t depth = 0)
       : HOptimization(outer_graph, kInlinerPassName, stats),
+        outermost_graph_(outermost_graph),
         outer_compilation_unit_(outer_compilation_unit),
         caller_compilation_unit_(caller_compilation_unit),
         codegen_(codegen),
@@ -54,10 +59,53 @@ class HInliner : public HOptimization {
 
  private:
   bool TryInline(HInvoke* invoke_instruction);
+
+  // Try to inline `resolved_method` in place of `invoke_instruction`, allowing the callee
+  // graph at most `instructions_budget` instructions besides the ones it inlined itself.
+  bool TryInline(HInvoke* invoke_instruction,
+                 ArtMethod* resolved_method,
+                 size_t instructions_budget)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Try to inline the target(s) of a virtual or interface call based on the receiver types
+  // recorded in the JIT inline cache of the caller. The inlined code is guarded by a check on
+  // the class of the receiver that deoptimizes when it does not match.
+  bool TryInlineFromInlineCache(HInvoke* invoke_instruction, ArtMethod* resolved_method)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Try to inline the only implementation of a virtual method, as found by class hierarchy
+  // analysis. The inlined code is guarded by a check that deoptimizes once a class overriding
+  // the method gets loaded.
+  bool TryInlineSingleImplementation(HInvoke* invoke_instruction, ArtMethod* resolved_method)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
   bool TryBuildAndInline(ArtMethod* resolved_method,
                          HInvoke* invoke_instruction,
-                         bool same_dex_file);
+                         bool same_dex_file,
+                         size_t instructions_budget);
+
+  // Return the profiling info of the method being compiled by this inliner, or null if it
+  // does not have one.
+  ProfilingInfo* GetCallerProfilingInfo() const SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Insert, after `cursor` in `bb_cursor`, a deoptimization that triggers when the class of
+  // `receiver` is none of the `number_of_classes` classes whose type indices in the caller's
+  // dex file are `class_indices`.
+  void AddTypeGuard(HInstruction* receiver,
+                    HInstruction* cursor,
+                    HBasicBlock* bb_cursor,
+                    const uint32_t* class_indices,
+                    size_t number_of_classes,
+                    HInvoke* invoke_instruction)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Insert, after `cursor` in `bb_cursor`, a deoptimization that triggers when the runtime
+  // has invalidated a single implementation assumption of the method being compiled.
+  void AddCHAGuard(HInstruction* cursor, HBasicBlock* bb_cursor, HInvoke* invoke_instruction);
 
+  // The graph of the method being compiled, which records the dependencies of the code on
+  // class hierarchy analysis.
+  HGraph* const outermost_graph_;
   const DexCompilationUnit& outer_compilation_unit_;
   const DexCompilationUnit& caller_compilation_unit_;
   CodeGenerator* const codegen_;
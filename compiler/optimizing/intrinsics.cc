@@ -209,6 +209,32 @@ static Intrinsics GetIntrinsic(InlineMethod method) {
 
     case kIntrinsicSystemArrayCopy:
       return Intrinsics::kSystemArrayCopy;
+    case kIntrinsicSystemArrayCopyByteArray:
+      return Intrinsics::kSystemArrayCopyByte;
+    case kIntrinsicSystemArrayCopyIntArray:
+      return Intrinsics::kSystemArrayCopyInt;
+
+    // java.util.Arrays.
+    case kIntrinsicArraysFill:
+      switch (GetType(method.d.data, true)) {
+        case Primitive::kPrimByte:
+          return Intrinsics::kArraysFillByte;
+        case Primitive::kPrimInt:
+          return Intrinsics::kArraysFillInt;
+        default:
+          LOG(FATAL) << "Unknown/unsupported op size " << method.d.data;
+          UNREACHABLE();
+      }
+    case kIntrinsicArraysEquals:
+      switch (GetType(method.d.data, true)) {
+        case Primitive::kPrimByte:
+          return Intrinsics::kArraysEqualsByte;
+        case Primitive::kPrimInt:
+          return Intrinsics::kArraysEqualsInt;
+        default:
+          LOG(FATAL) << "Unknown/unsupported op size " << method.d.data;
+          UNREACHABLE();
+      }
 
     // Thread.currentThread.
     case kIntrinsicCurrentThread:
@@ -255,6 +281,8 @@ static Intrinsics GetIntrinsic(InlineMethod method) {
       return Intrinsics::kStringEquals;
     case kIntrinsicGetCharsNoCheck:
       return Intrinsics::kStringGetCharsNoCheck;
+    case kIntrinsicHashCode:
+      return Intrinsics::kStringHashCode;
     case kIntrinsicIsEmptyOrLength:
       // The inliner can handle these two cases - and this is the preferred approach
       // since after inlining the call is no longer visible (as opposed to waiting
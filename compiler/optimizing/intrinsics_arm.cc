@@ -1677,6 +1677,13 @@ UNIMPLEMENTED_INTRINSIC(UnsafeCASLong)     // High register pressure.
 UNIMPLEMENTED_INTRINSIC(SystemArrayCopyChar)
 UNIMPLEMENTED_INTRINSIC(ReferenceGetReferent)
 UNIMPLEMENTED_INTRINSIC(StringGetCharsNoCheck)
+UNIMPLEMENTED_INTRINSIC(SystemArrayCopyByte)
+UNIMPLEMENTED_INTRINSIC(SystemArrayCopyInt)
+UNIMPLEMENTED_INTRINSIC(ArraysFillByte)
+UNIMPLEMENTED_INTRINSIC(ArraysFillInt)
+UNIMPLEMENTED_INTRINSIC(ArraysEqualsByte)
+UNIMPLEMENTED_INTRINSIC(ArraysEqualsInt)
+UNIMPLEMENTED_INTRINSIC(StringHashCode)
 
 #undef UNIMPLEMENTED_INTRINSIC
 
@@ -1192,6 +1192,400 @@ void IntrinsicCodeGeneratorARM64::VisitStringCharAt(HInvoke* invoke) {
   __ Bind(slow_path->GetExitLabel());
 }
 
+static void CreateSystemArrayCopyPrimitiveLocations(ArenaAllocator* arena, HInvoke* invoke) {
+  // Check to see if we have known failures that will cause us to have to bail out
+  // to the runtime, and just generate the runtime call directly.
+  HIntConstant* src_pos = invoke->InputAt(1)->AsIntConstant();
+  HIntConstant* dest_pos = invoke->InputAt(3)->AsIntConstant();
+  HIntConstant* length = invoke->InputAt(4)->AsIntConstant();
+  if ((src_pos != nullptr && src_pos->GetValue() < 0) ||
+      (dest_pos != nullptr && dest_pos->GetValue() < 0) ||
+      (length != nullptr && length->GetValue() < 0)) {
+    // We will have to fail anyways.
+    return;
+  }
+
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kCallOnSlowPath,
+                                                           kIntrinsified);
+  // arraycopy(Object src, int src_pos, Object dest, int dest_pos, int length).
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresRegister());
+  locations->SetInAt(3, Location::RequiresRegister());
+  locations->SetInAt(4, Location::RequiresRegister());
+
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+}
+
+// Branches to `slow_path` unless `pos` and `pos + length` are within the bounds of `array`.
+// `pos` and `length` are known to be non-negative.
+static void CheckPosition(vixl::MacroAssembler* masm,
+                          Register array,
+                          Register pos,
+                          Register length,
+                          Register temp,
+                          SlowPathCodeARM64* slow_path) {
+  const int32_t length_offset = mirror::Array::LengthOffset().Int32Value();
+  // length(array) - pos is negative if pos is out of bounds.
+  __ Ldr(temp, MemOperand(array.X(), length_offset));
+  __ Sub(temp, temp, pos);
+  __ Cmp(temp, length);
+  __ B(lt, slow_path->GetEntryLabel());
+}
+
+// Copies `count` bytes from `src` to `dest`, `count` being a multiple of the size of `type`.
+// Clobbers all the registers passed in.
+static void GenMemoryCopy(vixl::MacroAssembler* masm,
+                          Primitive::Type type,
+                          Register src,
+                          Register dest,
+                          Register count,
+                          Register temp1,
+                          Register temp2) {
+  vixl::Label loop, tail, skip8;
+  size_t shift = Primitive::ComponentSizeShift(type);
+
+  // Copy 16 bytes at a time.
+  __ Bind(&loop);
+  __ Subs(count, count, 16);
+  __ B(&tail, lt);
+  __ Ldp(temp1, temp2, MemOperand(src, 16, PostIndex));
+  __ Stp(temp1, temp2, MemOperand(dest, 16, PostIndex));
+  __ B(&loop);
+
+  // Copy the last 0 to 15 bytes, using the bits of the remaining count.
+  __ Bind(&tail);
+  __ Add(count, count, 16);
+  __ Tbz(count, 3, &skip8);
+  __ Ldr(temp1, MemOperand(src, 8, PostIndex));
+  __ Str(temp1, MemOperand(dest, 8, PostIndex));
+  __ Bind(&skip8);
+  if (shift <= 2) {
+    vixl::Label skip;
+    __ Tbz(count, 2, &skip);
+    __ Ldr(temp1.W(), MemOperand(src, 4, PostIndex));
+    __ Str(temp1.W(), MemOperand(dest, 4, PostIndex));
+    __ Bind(&skip);
+  }
+  if (shift <= 1) {
+    vixl::Label skip;
+    __ Tbz(count, 1, &skip);
+    __ Ldrh(temp1.W(), MemOperand(src, 2, PostIndex));
+    __ Strh(temp1.W(), MemOperand(dest, 2, PostIndex));
+    __ Bind(&skip);
+  }
+  if (shift == 0) {
+    vixl::Label skip;
+    __ Tbz(count, 0, &skip);
+    __ Ldrb(temp1.W(), MemOperand(src));
+    __ Strb(temp1.W(), MemOperand(dest));
+    __ Bind(&skip);
+  }
+}
+
+// Copies between two distinct arrays of `type`, bailing out to the slow path for overlapping
+// copies and for anything that would throw.
+static void GenSystemArrayCopyPrimitive(HInvoke* invoke,
+                                        Primitive::Type type,
+                                        CodeGeneratorARM64* codegen) {
+  vixl::MacroAssembler* masm = codegen->GetAssembler()->vixl_masm_;
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register src = WRegisterFrom(locations->InAt(0));
+  Register src_pos = WRegisterFrom(locations->InAt(1));
+  Register dest = WRegisterFrom(locations->InAt(2));
+  Register dest_pos = WRegisterFrom(locations->InAt(3));
+  Register length = WRegisterFrom(locations->InAt(4));
+  Register src_base = XRegisterFrom(locations->GetTemp(0));
+  Register dest_base = XRegisterFrom(locations->GetTemp(1));
+  Register count = XRegisterFrom(locations->GetTemp(2));
+
+  UseScratchRegisterScope scratch_scope(masm);
+  Register temp1 = scratch_scope.AcquireX();
+  Register temp2 = scratch_scope.AcquireX();
+
+  SlowPathCodeARM64* slow_path =
+      new (codegen->GetGraph()->GetArena()) IntrinsicSlowPathARM64(invoke);
+  codegen->AddSlowPath(slow_path);
+
+  // Bail out if the source and destination are the same, or if either is null.
+  __ Cmp(src, dest);
+  __ B(eq, slow_path->GetEntryLabel());
+  __ Cbz(src, slow_path->GetEntryLabel());
+  __ Cbz(dest, slow_path->GetEntryLabel());
+
+  // Bail out if the length or a position is negative.
+  __ Tbnz(length, kWRegSize - 1, slow_path->GetEntryLabel());
+  __ Tbnz(src_pos, kWRegSize - 1, slow_path->GetEntryLabel());
+  __ Tbnz(dest_pos, kWRegSize - 1, slow_path->GetEntryLabel());
+
+  CheckPosition(masm, src, src_pos, length, count.W(), slow_path);
+  CheckPosition(masm, dest, dest_pos, length, count.W(), slow_path);
+
+  const size_t shift = Primitive::ComponentSizeShift(type);
+  const int32_t data_offset =
+      mirror::Array::DataOffset(Primitive::ComponentSize(type)).Int32Value();
+  __ Add(src_base, src.X(), data_offset);
+  __ Add(src_base, src_base, Operand(src_pos, UXTW, shift));
+  __ Add(dest_base, dest.X(), data_offset);
+  __ Add(dest_base, dest_base, Operand(dest_pos, UXTW, shift));
+  __ Ubfiz(count, length.X(), shift, kWRegSize);
+
+  GenMemoryCopy(masm, type, src_base, dest_base, count, temp1, temp2);
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderARM64::VisitSystemArrayCopyChar(HInvoke* invoke) {
+  CreateSystemArrayCopyPrimitiveLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitSystemArrayCopyChar(HInvoke* invoke) {
+  GenSystemArrayCopyPrimitive(invoke, Primitive::kPrimChar, codegen_);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitSystemArrayCopyByte(HInvoke* invoke) {
+  CreateSystemArrayCopyPrimitiveLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitSystemArrayCopyByte(HInvoke* invoke) {
+  GenSystemArrayCopyPrimitive(invoke, Primitive::kPrimByte, codegen_);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitSystemArrayCopyInt(HInvoke* invoke) {
+  CreateSystemArrayCopyPrimitiveLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitSystemArrayCopyInt(HInvoke* invoke) {
+  GenSystemArrayCopyPrimitive(invoke, Primitive::kPrimInt, codegen_);
+}
+
+static void CreateArraysFillLocations(ArenaAllocator* arena, HInvoke* invoke) {
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kCallOnSlowPath,
+                                                           kIntrinsified);
+  // fill(byte[] a, byte val) and fill(int[] a, int val).
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+}
+
+static void GenArraysFill(HInvoke* invoke, Primitive::Type type, CodeGeneratorARM64* codegen) {
+  vixl::MacroAssembler* masm = codegen->GetAssembler()->vixl_masm_;
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register array = WRegisterFrom(locations->InAt(0));
+  Register value = WRegisterFrom(locations->InAt(1));
+  Register dest = XRegisterFrom(locations->GetTemp(0));
+  Register count = XRegisterFrom(locations->GetTemp(1));
+
+  UseScratchRegisterScope scratch_scope(masm);
+  Register pattern = scratch_scope.AcquireX();
+
+  const size_t shift = Primitive::ComponentSizeShift(type);
+  const int32_t length_offset = mirror::Array::LengthOffset().Int32Value();
+  const int32_t data_offset =
+      mirror::Array::DataOffset(Primitive::ComponentSize(type)).Int32Value();
+
+  // Let the managed code throw the NullPointerException.
+  SlowPathCodeARM64* slow_path =
+      new (codegen->GetGraph()->GetArena()) IntrinsicSlowPathARM64(invoke);
+  codegen->AddSlowPath(slow_path);
+  __ Cbz(array, slow_path->GetEntryLabel());
+
+  // Replicate the value over 64 bits.
+  __ Mov(pattern, value.X());
+  if (type == Primitive::kPrimByte) {
+    __ Bfi(pattern, pattern, 8, 8);
+    __ Bfi(pattern, pattern, 16, 16);
+  } else {
+    DCHECK_EQ(type, Primitive::kPrimInt);
+  }
+  __ Bfi(pattern, pattern, 32, 32);
+
+  __ Ldr(count.W(), MemOperand(array.X(), length_offset));
+  __ Lsl(count, count, shift);
+  __ Add(dest, array.X(), data_offset);
+
+  // Store 16 bytes at a time.
+  vixl::Label loop, tail;
+  __ Bind(&loop);
+  __ Subs(count, count, 16);
+  __ B(&tail, lt);
+  __ Stp(pattern, pattern, MemOperand(dest, 16, PostIndex));
+  __ B(&loop);
+
+  // Store the last 0 to 15 bytes, using the bits of the remaining count.
+  __ Bind(&tail);
+  __ Add(count, count, 16);
+  vixl::Label skip8;
+  __ Tbz(count, 3, &skip8);
+  __ Str(pattern, MemOperand(dest, 8, PostIndex));
+  __ Bind(&skip8);
+  vixl::Label skip4;
+  __ Tbz(count, 2, &skip4);
+  __ Str(pattern.W(), MemOperand(dest, 4, PostIndex));
+  __ Bind(&skip4);
+  if (type == Primitive::kPrimByte) {
+    vixl::Label skip2, skip1;
+    __ Tbz(count, 1, &skip2);
+    __ Strh(pattern.W(), MemOperand(dest, 2, PostIndex));
+    __ Bind(&skip2);
+    __ Tbz(count, 0, &skip1);
+    __ Strb(pattern.W(), MemOperand(dest));
+    __ Bind(&skip1);
+  }
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysFillByte(HInvoke* invoke) {
+  CreateArraysFillLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysFillByte(HInvoke* invoke) {
+  GenArraysFill(invoke, Primitive::kPrimByte, codegen_);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysFillInt(HInvoke* invoke) {
+  CreateArraysFillLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysFillInt(HInvoke* invoke) {
+  GenArraysFill(invoke, Primitive::kPrimInt, codegen_);
+}
+
+static void CreateArraysEqualsLocations(ArenaAllocator* arena, HInvoke* invoke) {
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kNoCall,
+                                                           kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+static void GenArraysEquals(HInvoke* invoke, Primitive::Type type, vixl::MacroAssembler* masm) {
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register lhs = WRegisterFrom(locations->InAt(0));
+  Register rhs = WRegisterFrom(locations->InAt(1));
+  Register lhs_pointer = XRegisterFrom(locations->GetTemp(0));
+  Register rhs_pointer = XRegisterFrom(locations->GetTemp(1));
+  Register lhs_data = XRegisterFrom(locations->GetTemp(2));
+  Register lhs_data2 = XRegisterFrom(locations->GetTemp(3));
+  // Holds the number of bytes left to compare until the result is known.
+  Register out = XRegisterFrom(locations->Out());
+
+  UseScratchRegisterScope scratch_scope(masm);
+  Register rhs_data = scratch_scope.AcquireX();
+  Register rhs_data2 = scratch_scope.AcquireX();
+
+  const int32_t length_offset = mirror::Array::LengthOffset().Int32Value();
+  const int32_t data_offset =
+      mirror::Array::DataOffset(Primitive::ComponentSize(type)).Int32Value();
+
+  vixl::Label loop, tail, tail4, tail2, tail1, end, return_true, return_false;
+
+  // Reference equality check, which also covers two null arrays.
+  __ Cmp(lhs, rhs);
+  __ B(&return_true, eq);
+
+  // Return false if either array is null.
+  __ Cbz(lhs, &return_false);
+  __ Cbz(rhs, &return_false);
+
+  // Return false if the lengths differ.
+  __ Ldr(out.W(), MemOperand(lhs.X(), length_offset));
+  __ Ldr(rhs_data.W(), MemOperand(rhs.X(), length_offset));
+  __ Cmp(out.W(), rhs_data.W());
+  __ B(&return_false, ne);
+
+  // Compare exactly the bytes of the array data; the object padding after them is not
+  // guaranteed to hold the same values in both arrays and must not be read.
+  const size_t component_size_shift = Primitive::ComponentSizeShift(type);
+  __ Lsl(out, out, component_size_shift);
+  __ Add(lhs_pointer, lhs.X(), data_offset);
+  __ Add(rhs_pointer, rhs.X(), data_offset);
+
+  // Compare 16 bytes at a time.
+  __ Bind(&loop);
+  __ Subs(out, out, 16);
+  __ B(&tail, lt);
+  __ Ldp(lhs_data, lhs_data2, MemOperand(lhs_pointer, 16, PostIndex));
+  __ Ldp(rhs_data, rhs_data2, MemOperand(rhs_pointer, 16, PostIndex));
+  __ Cmp(lhs_data, rhs_data);
+  __ Ccmp(lhs_data2, rhs_data2, NoFlag, eq);
+  __ B(&return_false, ne);
+  __ B(&loop);
+
+  // Fewer than 16 bytes are left: compare chunks of 8, 4, 2 and 1 bytes as selected by the
+  // bits of the remaining count. Chunks smaller than a component cannot occur.
+  __ Bind(&tail);
+  __ Add(out, out, 16);
+  __ Tbz(out, 3, &tail4);
+  __ Ldr(lhs_data, MemOperand(lhs_pointer, 8, PostIndex));
+  __ Ldr(rhs_data, MemOperand(rhs_pointer, 8, PostIndex));
+  __ Cmp(lhs_data, rhs_data);
+  __ B(&return_false, ne);
+
+  __ Bind(&tail4);
+  __ Tbz(out, 2, &tail2);
+  __ Ldr(lhs_data.W(), MemOperand(lhs_pointer, 4, PostIndex));
+  __ Ldr(rhs_data.W(), MemOperand(rhs_pointer, 4, PostIndex));
+  __ Cmp(lhs_data.W(), rhs_data.W());
+  __ B(&return_false, ne);
+
+  __ Bind(&tail2);
+  if (component_size_shift < 2) {
+    __ Tbz(out, 1, &tail1);
+    __ Ldrh(lhs_data.W(), MemOperand(lhs_pointer, 2, PostIndex));
+    __ Ldrh(rhs_data.W(), MemOperand(rhs_pointer, 2, PostIndex));
+    __ Cmp(lhs_data.W(), rhs_data.W());
+    __ B(&return_false, ne);
+  }
+
+  __ Bind(&tail1);
+  if (component_size_shift < 1) {
+    __ Tbz(out, 0, &return_true);
+    __ Ldrb(lhs_data.W(), MemOperand(lhs_pointer));
+    __ Ldrb(rhs_data.W(), MemOperand(rhs_pointer));
+    __ Cmp(lhs_data.W(), rhs_data.W());
+    __ B(&return_false, ne);
+  }
+
+  __ Bind(&return_true);
+  __ Mov(out, 1);
+  __ B(&end);
+
+  __ Bind(&return_false);
+  __ Mov(out, 0);
+  __ Bind(&end);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysEqualsByte(HInvoke* invoke) {
+  CreateArraysEqualsLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysEqualsByte(HInvoke* invoke) {
+  GenArraysEquals(invoke, Primitive::kPrimByte, GetVIXLAssembler());
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysEqualsInt(HInvoke* invoke) {
+  CreateArraysEqualsLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysEqualsInt(HInvoke* invoke) {
+  GenArraysEquals(invoke, Primitive::kPrimInt, GetVIXLAssembler());
+}
+
 void IntrinsicLocationsBuilderARM64::VisitStringCompareTo(HInvoke* invoke) {
   LocationSummary* locations = new (arena_) LocationSummary(invoke,
                                                             LocationSummary::kCall,
@@ -1317,6 +1711,75 @@ void IntrinsicCodeGeneratorARM64::VisitStringEquals(HInvoke* invoke) {
   __ Bind(&end);
 }
 
+void IntrinsicLocationsBuilderARM64::VisitStringHashCode(HInvoke* invoke) {
+  LocationSummary* locations = new (arena_) LocationSummary(invoke,
+                                                            LocationSummary::kNoCall,
+                                                            kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitStringHashCode(HInvoke* invoke) {
+  vixl::MacroAssembler* masm = GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register str = WRegisterFrom(locations->InAt(0));
+  Register count = WRegisterFrom(locations->GetTemp(0));
+  Register pointer = XRegisterFrom(locations->GetTemp(1));
+  Register char0 = WRegisterFrom(locations->GetTemp(2));
+  Register char1 = WRegisterFrom(locations->GetTemp(3));
+  Register out = WRegisterFrom(locations->Out());
+
+  UseScratchRegisterScope scratch_scope(masm);
+  Register factor = scratch_scope.AcquireW();
+  Register factor2 = scratch_scope.AcquireW();
+
+  const int32_t count_offset = mirror::String::CountOffset().Int32Value();
+  const int32_t value_offset = mirror::String::ValueOffset().Int32Value();
+  const int32_t hash_code_offset = mirror::String::HashCodeOffset().Int32Value();
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  vixl::Label loop, tail, store, end;
+
+  // Return the cached hash code if there is one. The empty string has a zero hash code.
+  __ Ldr(out, MemOperand(str.X(), hash_code_offset));
+  __ Cbnz(out, &end);
+  __ Ldr(count, MemOperand(str.X(), count_offset));
+  __ Cbz(count, &end);
+  __ Add(pointer, str.X(), value_offset);
+  __ Mov(factor, 31);
+  __ Mov(factor2, 31 * 31);
+
+  // Fold two characters per iteration: h = h * 31^2 + (c0 * 31 + c1).
+  __ Cmp(count, 2);
+  __ B(&tail, lt);
+  __ Bind(&loop);
+  __ Ldrh(char0, MemOperand(pointer, sizeof(uint16_t), PostIndex));
+  __ Ldrh(char1, MemOperand(pointer, sizeof(uint16_t), PostIndex));
+  __ Madd(char1, char0, factor, char1);
+  __ Madd(out, out, factor2, char1);
+  __ Sub(count, count, 2);
+  __ Cmp(count, 2);
+  __ B(&loop, ge);
+
+  // At most one character is left.
+  __ Bind(&tail);
+  __ Cbz(count, &store);
+  __ Ldrh(char0, MemOperand(pointer));
+  __ Madd(out, out, factor, char0);
+
+  // Cache the hash code like String.hashCode() does.
+  __ Bind(&store);
+  __ Str(out, MemOperand(str.X(), hash_code_offset));
+  __ Bind(&end);
+}
+
 static void GenerateVisitStringIndexOf(HInvoke* invoke,
                                        vixl::MacroAssembler* masm,
                                        CodeGeneratorARM64* codegen,
@@ -1488,7 +1951,6 @@ void IntrinsicLocationsBuilderARM64::Visit ## Name(HInvoke* invoke ATTRIBUTE_UNU
 void IntrinsicCodeGeneratorARM64::Visit ## Name(HInvoke* invoke ATTRIBUTE_UNUSED) {    \
 }
 
-UNIMPLEMENTED_INTRINSIC(SystemArrayCopyChar)
 UNIMPLEMENTED_INTRINSIC(SystemArrayCopy)
 UNIMPLEMENTED_INTRINSIC(ReferenceGetReferent)
 UNIMPLEMENTED_INTRINSIC(StringGetCharsNoCheck)
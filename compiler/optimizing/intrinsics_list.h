@@ -59,6 +59,12 @@
   V(MathRoundFloat, kStatic, kNeedsEnvironmentOrCache) \
   V(SystemArrayCopyChar, kStatic, kNeedsEnvironmentOrCache) \
   V(SystemArrayCopy, kStatic, kNeedsEnvironmentOrCache) \
+  V(SystemArrayCopyByte, kStatic, kNeedsEnvironmentOrCache) \
+  V(SystemArrayCopyInt, kStatic, kNeedsEnvironmentOrCache) \
+  V(ArraysFillByte, kStatic, kNeedsEnvironmentOrCache) \
+  V(ArraysFillInt, kStatic, kNeedsEnvironmentOrCache) \
+  V(ArraysEqualsByte, kStatic, kNeedsEnvironmentOrCache) \
+  V(ArraysEqualsInt, kStatic, kNeedsEnvironmentOrCache) \
   V(ThreadCurrentThread, kStatic, kNeedsEnvironmentOrCache) \
   V(MemoryPeekByte, kStatic, kNeedsEnvironmentOrCache) \
   V(MemoryPeekIntNative, kStatic, kNeedsEnvironmentOrCache) \
@@ -72,6 +78,7 @@
   V(StringCompareTo, kDirect, kNeedsEnvironmentOrCache) \
   V(StringEquals, kDirect, kNeedsEnvironmentOrCache) \
   V(StringGetCharsNoCheck, kDirect, kNeedsEnvironmentOrCache) \
+  V(StringHashCode, kDirect, kNeedsEnvironmentOrCache) \
   V(StringIndexOf, kDirect, kNeedsEnvironmentOrCache) \
   V(StringIndexOfAfter, kDirect, kNeedsEnvironmentOrCache) \
   V(StringNewStringFromBytes, kStatic, kNeedsEnvironmentOrCache) \
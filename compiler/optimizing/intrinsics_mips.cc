@@ -530,6 +530,13 @@ UNIMPLEMENTED_INTRINSIC(ReferenceGetReferent)
 UNIMPLEMENTED_INTRINSIC(StringGetCharsNoCheck)
 UNIMPLEMENTED_INTRINSIC(SystemArrayCopyChar)
 UNIMPLEMENTED_INTRINSIC(SystemArrayCopy)
+UNIMPLEMENTED_INTRINSIC(SystemArrayCopyByte)
+UNIMPLEMENTED_INTRINSIC(SystemArrayCopyInt)
+UNIMPLEMENTED_INTRINSIC(ArraysFillByte)
+UNIMPLEMENTED_INTRINSIC(ArraysFillInt)
+UNIMPLEMENTED_INTRINSIC(ArraysEqualsByte)
+UNIMPLEMENTED_INTRINSIC(ArraysEqualsInt)
+UNIMPLEMENTED_INTRINSIC(StringHashCode)
 
 #undef UNIMPLEMENTED_INTRINSIC
 
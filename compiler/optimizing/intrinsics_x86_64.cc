@@ -742,7 +742,7 @@ void IntrinsicCodeGeneratorX86_64::VisitStringCharAt(HInvoke* invoke) {
   __ Bind(slow_path->GetExitLabel());
 }
 
-void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
+static void CreateSystemArrayCopyPrimitiveLocations(ArenaAllocator* arena, HInvoke* invoke) {
   // Check to see if we have known failures that will cause us to have to bail out
   // to the runtime, and just generate the runtime call directly.
   HIntConstant* src_pos = invoke->InputAt(1)->AsIntConstant();
@@ -765,9 +765,9 @@ void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyChar(HInvoke* invoke)
     }
   }
 
-  LocationSummary* locations = new (arena_) LocationSummary(invoke,
-                                                            LocationSummary::kCallOnSlowPath,
-                                                            kIntrinsified);
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kCallOnSlowPath,
+                                                           kIntrinsified);
   // arraycopy(Object src, int src_pos, Object dest, int dest_pos, int length).
   locations->SetInAt(0, Location::RequiresRegister());
   locations->SetInAt(1, Location::RegisterOrConstant(invoke->InputAt(1)));
@@ -775,12 +775,24 @@ void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyChar(HInvoke* invoke)
   locations->SetInAt(3, Location::RegisterOrConstant(invoke->InputAt(3)));
   locations->SetInAt(4, Location::RegisterOrConstant(invoke->InputAt(4)));
 
-  // And we need some temporaries.  We will use REP MOVSW, so we need fixed registers.
+  // And we need some temporaries.  We will use REP MOVS, so we need fixed registers.
   locations->AddTemp(Location::RegisterLocation(RSI));
   locations->AddTemp(Location::RegisterLocation(RDI));
   locations->AddTemp(Location::RegisterLocation(RCX));
 }
 
+void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
+  CreateSystemArrayCopyPrimitiveLocations(arena_, invoke);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyByte(HInvoke* invoke) {
+  CreateSystemArrayCopyPrimitiveLocations(arena_, invoke);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyInt(HInvoke* invoke) {
+  CreateSystemArrayCopyPrimitiveLocations(arena_, invoke);
+}
+
 static void CheckPosition(X86_64Assembler* assembler,
                           Location pos,
                           CpuRegister input,
@@ -847,8 +859,12 @@ static void CheckPosition(X86_64Assembler* assembler,
   }
 }
 
-void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
-  X86_64Assembler* assembler = GetAssembler();
+// Copies between two distinct arrays of `type`, bailing out to the slow path for overlapping
+// copies and for anything that would throw.
+static void GenSystemArrayCopyPrimitive(HInvoke* invoke,
+                                        Primitive::Type type,
+                                        CodeGeneratorX86_64* codegen) {
+  X86_64Assembler* assembler = codegen->GetAssembler();
   LocationSummary* locations = invoke->GetLocations();
 
   CpuRegister src = locations->InAt(0).AsRegister<CpuRegister>();
@@ -857,7 +873,7 @@ void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
   Location dest_pos = locations->InAt(3);
   Location length = locations->InAt(4);
 
-  // Temporaries that we need for MOVSW.
+  // Temporaries that we need for MOVS.
   CpuRegister src_base = locations->GetTemp(0).AsRegister<CpuRegister>();
   DCHECK_EQ(src_base.AsRegister(), RSI);
   CpuRegister dest_base = locations->GetTemp(1).AsRegister<CpuRegister>();
@@ -865,8 +881,8 @@ void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
   CpuRegister count = locations->GetTemp(2).AsRegister<CpuRegister>();
   DCHECK_EQ(count.AsRegister(), RCX);
 
-  SlowPathCode* slow_path = new (GetAllocator()) IntrinsicSlowPathX86_64(invoke);
-  codegen_->AddSlowPath(slow_path);
+  SlowPathCode* slow_path = new (codegen->GetGraph()->GetArena()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
 
   // Bail out if the source and destination are the same.
   __ cmpl(src, dest);
@@ -901,33 +917,54 @@ void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
   }
 
   // Okay, everything checks out.  Finally time to do the copy.
-  // Check assumption that sizeof(Char) is 2 (used in scaling below).
-  const size_t char_size = Primitive::ComponentSize(Primitive::kPrimChar);
-  DCHECK_EQ(char_size, 2u);
-
-  const uint32_t data_offset = mirror::Array::DataOffset(char_size).Uint32Value();
+  const size_t component_size = Primitive::ComponentSize(type);
+  const ScaleFactor scale_factor = static_cast<ScaleFactor>(Primitive::ComponentSizeShift(type));
+  const uint32_t data_offset = mirror::Array::DataOffset(component_size).Uint32Value();
 
   if (src_pos.IsConstant()) {
     int32_t src_pos_const = src_pos.GetConstant()->AsIntConstant()->GetValue();
-    __ leal(src_base, Address(src, char_size * src_pos_const + data_offset));
+    __ leal(src_base, Address(src, component_size * src_pos_const + data_offset));
   } else {
-    __ leal(src_base, Address(src, src_pos.AsRegister<CpuRegister>(),
-                              ScaleFactor::TIMES_2, data_offset));
+    __ leal(src_base, Address(src, src_pos.AsRegister<CpuRegister>(), scale_factor, data_offset));
   }
   if (dest_pos.IsConstant()) {
     int32_t dest_pos_const = dest_pos.GetConstant()->AsIntConstant()->GetValue();
-    __ leal(dest_base, Address(dest, char_size * dest_pos_const + data_offset));
+    __ leal(dest_base, Address(dest, component_size * dest_pos_const + data_offset));
   } else {
-    __ leal(dest_base, Address(dest, dest_pos.AsRegister<CpuRegister>(),
-                               ScaleFactor::TIMES_2, data_offset));
+    __ leal(dest_base,
+            Address(dest, dest_pos.AsRegister<CpuRegister>(), scale_factor, data_offset));
   }
 
   // Do the move.
-  __ rep_movsw();
+  switch (type) {
+    case Primitive::kPrimByte:
+      __ rep_movsb();
+      break;
+    case Primitive::kPrimChar:
+      __ rep_movsw();
+      break;
+    case Primitive::kPrimInt:
+      __ rep_movsl();
+      break;
+    default:
+      LOG(FATAL) << "Unexpected type " << type;
+      UNREACHABLE();
+  }
 
   __ Bind(slow_path->GetExitLabel());
 }
 
+void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
+  GenSystemArrayCopyPrimitive(invoke, Primitive::kPrimChar, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyByte(HInvoke* invoke) {
+  GenSystemArrayCopyPrimitive(invoke, Primitive::kPrimByte, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyInt(HInvoke* invoke) {
+  GenSystemArrayCopyPrimitive(invoke, Primitive::kPrimInt, codegen_);
+}
 
 void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopy(HInvoke* invoke) {
   CodeGenerator::CreateSystemArrayCopyLocationSummary(invoke);
@@ -1157,6 +1194,203 @@ void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopy(HInvoke* invoke) {
   __ Bind(slow_path->GetExitLabel());
 }
 
+static void CreateArraysFillLocations(ArenaAllocator* arena, HInvoke* invoke) {
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kCallOnSlowPath,
+                                                           kIntrinsified);
+  // fill(byte[] a, byte val) and fill(int[] a, int val).
+  locations->SetInAt(0, Location::RequiresRegister());
+  // REP STOS stores the value from AL/EAX to [RDI] and counts down RCX.
+  locations->SetInAt(1, Location::RegisterLocation(RAX));
+  locations->AddTemp(Location::RegisterLocation(RDI));
+  locations->AddTemp(Location::RegisterLocation(RCX));
+}
+
+static void GenArraysFill(HInvoke* invoke, Primitive::Type type, CodeGeneratorX86_64* codegen) {
+  X86_64Assembler* assembler = codegen->GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister array = locations->InAt(0).AsRegister<CpuRegister>();
+  DCHECK_EQ(locations->InAt(1).AsRegister<CpuRegister>().AsRegister(), RAX);
+  CpuRegister dest_base = locations->GetTemp(0).AsRegister<CpuRegister>();
+  DCHECK_EQ(dest_base.AsRegister(), RDI);
+  CpuRegister count = locations->GetTemp(1).AsRegister<CpuRegister>();
+  DCHECK_EQ(count.AsRegister(), RCX);
+
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset =
+      mirror::Array::DataOffset(Primitive::ComponentSize(type)).Uint32Value();
+
+  // Let the managed code throw the NullPointerException.
+  SlowPathCode* slow_path = new (codegen->GetGraph()->GetArena()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
+  __ testl(array, array);
+  __ j(kEqual, slow_path->GetEntryLabel());
+
+  __ movl(count, Address(array, length_offset));
+  __ leal(dest_base, Address(array, data_offset));
+  if (type == Primitive::kPrimByte) {
+    __ rep_stosb();
+  } else {
+    DCHECK_EQ(type, Primitive::kPrimInt);
+    __ rep_stosl();
+  }
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysFillByte(HInvoke* invoke) {
+  CreateArraysFillLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysFillByte(HInvoke* invoke) {
+  GenArraysFill(invoke, Primitive::kPrimByte, codegen_);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysFillInt(HInvoke* invoke) {
+  CreateArraysFillLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysFillInt(HInvoke* invoke) {
+  GenArraysFill(invoke, Primitive::kPrimInt, codegen_);
+}
+
+static void CreateArraysEqualsLocations(ArenaAllocator* arena, HInvoke* invoke) {
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kNoCall,
+                                                           kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+static void GenArraysEquals(HInvoke* invoke, Primitive::Type type, X86_64Assembler* assembler) {
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister lhs = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister rhs = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister offset = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister temp = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister temp2 = locations->GetTemp(2).AsRegister<CpuRegister>();
+  XmmRegister lhs_chunk = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  XmmRegister rhs_chunk = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
+  // Holds the number of bytes left to compare until the result is known.
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset =
+      mirror::Array::DataOffset(Primitive::ComponentSize(type)).Uint32Value();
+
+  NearLabel loop, tail, tail4, tail2, tail1;
+  // The early exits at the top are too far from the result labels for near jumps.
+  Label end, return_true, return_false;
+
+  // Reference equality check, which also covers two null arrays.
+  __ cmpl(lhs, rhs);
+  __ j(kEqual, &return_true);
+
+  // Return false if either array is null.
+  __ testl(lhs, lhs);
+  __ j(kEqual, &return_false);
+  __ testl(rhs, rhs);
+  __ j(kEqual, &return_false);
+
+  // Return false if the lengths differ.
+  __ movl(out, Address(lhs, length_offset));
+  __ cmpl(out, Address(rhs, length_offset));
+  __ j(kNotEqual, &return_false);
+
+  // Compare exactly the bytes of the array data; the object padding after them is not
+  // guaranteed to hold the same values in both arrays and must not be read.
+  const size_t component_size_shift = Primitive::ComponentSizeShift(type);
+  if (component_size_shift != 0) {
+    __ shll(out, Immediate(component_size_shift));
+  }
+  __ movl(offset, Immediate(data_offset));
+
+  // Compare 16 bytes at a time.
+  __ Bind(&loop);
+  __ cmpl(out, Immediate(16));
+  __ j(kLess, &tail);
+  __ movdqu(lhs_chunk, Address(lhs, offset, ScaleFactor::TIMES_1, 0));
+  __ movdqu(rhs_chunk, Address(rhs, offset, ScaleFactor::TIMES_1, 0));
+  __ pcmpeqb(lhs_chunk, rhs_chunk);
+  __ pmovmskb(temp, lhs_chunk);
+  __ cmpl(temp, Immediate(0xffff));
+  __ j(kNotEqual, &return_false);
+  __ addl(offset, Immediate(16));
+  __ subl(out, Immediate(16));
+  __ jmp(&loop);
+
+  // Fewer than 16 bytes are left: compare chunks of 8, 4, 2 and 1 bytes as selected by the
+  // bits of the remaining count. Chunks smaller than a component cannot occur.
+  __ Bind(&tail);
+  __ testl(out, Immediate(8));
+  __ j(kEqual, &tail4);
+  __ movq(temp, Address(lhs, offset, ScaleFactor::TIMES_1, 0));
+  __ cmpq(temp, Address(rhs, offset, ScaleFactor::TIMES_1, 0));
+  __ j(kNotEqual, &return_false);
+  __ addl(offset, Immediate(8));
+
+  __ Bind(&tail4);
+  __ testl(out, Immediate(4));
+  __ j(kEqual, &tail2);
+  __ movl(temp, Address(lhs, offset, ScaleFactor::TIMES_1, 0));
+  __ cmpl(temp, Address(rhs, offset, ScaleFactor::TIMES_1, 0));
+  __ j(kNotEqual, &return_false);
+  __ addl(offset, Immediate(4));
+
+  __ Bind(&tail2);
+  if (component_size_shift < 2) {
+    __ testl(out, Immediate(2));
+    __ j(kEqual, &tail1);
+    __ movzxw(temp, Address(lhs, offset, ScaleFactor::TIMES_1, 0));
+    __ movzxw(temp2, Address(rhs, offset, ScaleFactor::TIMES_1, 0));
+    __ cmpl(temp, temp2);
+    __ j(kNotEqual, &return_false);
+    __ addl(offset, Immediate(2));
+  }
+
+  __ Bind(&tail1);
+  if (component_size_shift < 1) {
+    __ testl(out, Immediate(1));
+    __ j(kEqual, &return_true);
+    __ movzxb(temp, Address(lhs, offset, ScaleFactor::TIMES_1, 0));
+    __ movzxb(temp2, Address(rhs, offset, ScaleFactor::TIMES_1, 0));
+    __ cmpl(temp, temp2);
+    __ j(kNotEqual, &return_false);
+  }
+
+  __ Bind(&return_true);
+  __ movl(out, Immediate(1));
+  __ jmp(&end);
+
+  __ Bind(&return_false);
+  __ xorl(out, out);
+  __ Bind(&end);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysEqualsByte(HInvoke* invoke) {
+  CreateArraysEqualsLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysEqualsByte(HInvoke* invoke) {
+  GenArraysEquals(invoke, Primitive::kPrimByte, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysEqualsInt(HInvoke* invoke) {
+  CreateArraysEqualsLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysEqualsInt(HInvoke* invoke) {
+  GenArraysEquals(invoke, Primitive::kPrimInt, GetAssembler());
+}
+
 void IntrinsicLocationsBuilderX86_64::VisitStringCompareTo(HInvoke* invoke) {
   LocationSummary* locations = new (arena_) LocationSummary(invoke,
                                                             LocationSummary::kCall,
@@ -1273,6 +1507,85 @@ void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
   __ Bind(&end);
 }
 
+void IntrinsicLocationsBuilderX86_64::VisitStringHashCode(HInvoke* invoke) {
+  LocationSummary* locations = new (arena_) LocationSummary(invoke,
+                                                            LocationSummary::kNoCall,
+                                                            kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitStringHashCode(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister str = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister count = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister pointer = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister temp = locations->GetTemp(2).AsRegister<CpuRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  const uint32_t count_offset = mirror::String::CountOffset().Uint32Value();
+  const uint32_t value_offset = mirror::String::ValueOffset().Uint32Value();
+  const uint32_t hash_code_offset = mirror::String::HashCodeOffset().Uint32Value();
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  NearLabel loop4, loop1, tail, store, end;
+
+  // Return the cached hash code if there is one. The empty string has a zero hash code.
+  __ movl(out, Address(str, hash_code_offset));
+  __ testl(out, out);
+  __ j(kNotEqual, &end);
+  __ movl(count, Address(str, count_offset));
+  __ testl(count, count);
+  __ j(kEqual, &end);
+  __ leaq(pointer, Address(str, value_offset));
+
+  // Fold four characters per iteration to break the dependency on the previous
+  // multiplication: h = h * 31^4 + c0 * 31^3 + c1 * 31^2 + c2 * 31 + c3.
+  __ cmpl(count, Immediate(4));
+  __ j(kLess, &tail);
+  __ Bind(&loop4);
+  __ imull(out, out, Immediate(31 * 31 * 31 * 31));
+  __ movzxw(temp, Address(pointer, 0));
+  __ imull(temp, temp, Immediate(31 * 31 * 31));
+  __ addl(out, temp);
+  __ movzxw(temp, Address(pointer, 2));
+  __ imull(temp, temp, Immediate(31 * 31));
+  __ addl(out, temp);
+  __ movzxw(temp, Address(pointer, 4));
+  __ imull(temp, temp, Immediate(31));
+  __ addl(out, temp);
+  __ movzxw(temp, Address(pointer, 6));
+  __ addl(out, temp);
+  __ addq(pointer, Immediate(4 * sizeof(uint16_t)));
+  __ subl(count, Immediate(4));
+  __ cmpl(count, Immediate(4));
+  __ j(kGreaterEqual, &loop4);
+
+  // Remaining characters.
+  __ Bind(&tail);
+  __ testl(count, count);
+  __ j(kEqual, &store);
+  __ Bind(&loop1);
+  __ imull(out, out, Immediate(31));
+  __ movzxw(temp, Address(pointer, 0));
+  __ addl(out, temp);
+  __ addq(pointer, Immediate(sizeof(uint16_t)));
+  __ subl(count, Immediate(1));
+  __ j(kNotEqual, &loop1);
+
+  // Cache the hash code like String.hashCode() does.
+  __ Bind(&store);
+  __ movl(Address(str, hash_code_offset), out);
+  __ Bind(&end);
+}
+
 static void CreateStringIndexOfLocations(HInvoke* invoke,
                                          ArenaAllocator* allocator,
                                          bool start_at_zero) {
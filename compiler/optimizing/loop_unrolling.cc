@@ -0,0 +1,639 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "loop_unrolling.h"
+
+#include <algorithm>
+
+#include "induction_var_analysis.h"
+#include "induction_var_range.h"
+
+namespace art {
+
+// Size limits of the transformations, in number of HIR instructions.
+struct UnrollingLimits {
+  // Maximum number of copies of the body in an unrolled loop.
+  size_t max_factor;
+  // Maximum number of instructions in the body of an unrolled or peeled loop.
+  size_t max_unrolled_instructions;
+  // Maximum number of instructions generated when fully unrolling a loop.
+  size_t max_fully_unrolled_instructions;
+};
+
+static bool GetUnrollingLimits(InstructionSet instruction_set, UnrollingLimits* limits) {
+  switch (instruction_set) {
+    case kArm:
+    case kThumb2:
+    case kX86:
+    case kMips:
+      // Keep the unrolled bodies small on register starved instruction sets,
+      // where longer live ranges quickly lead to spilling.
+      *limits = { 2u, 16u, 24u };
+      return true;
+    case kArm64:
+    case kX86_64:
+    case kMips64:
+      *limits = { 4u, 32u, 48u };
+      return true;
+    default:
+      return false;
+  }
+}
+
+static HInstruction* Lookup(const HLoopUnrolling::ValueMap& values, HInstruction* instruction) {
+  auto it = values.find(instruction);
+  return (it != values.end()) ? it->second : instruction;
+}
+
+// Returns whether `instruction` only needs to execute in the first iteration of
+// `loop`. Its inputs must be defined before the loop, or by other instructions
+// in `hoisted`, and it must be movable without depending on any side effect,
+// which is also the criterion GVN uses for instructions it never kills.
+static bool IsHoistable(HLoopInformation* loop,
+                        HInstruction* instruction,
+                        const ArenaSet<HInstruction*>& hoisted) {
+  if (!instruction->CanBeMoved() || instruction->GetSideEffects().HasDependencies()) {
+    return false;
+  }
+  for (size_t i = 0, e = instruction->InputCount(); i < e; ++i) {
+    HInstruction* input = instruction->InputAt(i);
+    if (loop->Contains(*input->GetBlock()) && hoisted.find(input) == hoisted.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns whether `instruction` is of a kind CloneInstruction() knows how to copy.
+static bool CanClone(HInstruction* instruction) {
+  switch (instruction->GetKind()) {
+    case HInstruction::kAdd:
+    case HInstruction::kSub:
+    case HInstruction::kMul:
+    case HInstruction::kAnd:
+    case HInstruction::kOr:
+    case HInstruction::kXor:
+    case HInstruction::kShl:
+    case HInstruction::kShr:
+    case HInstruction::kUShr:
+    case HInstruction::kNeg:
+    case HInstruction::kNot:
+    case HInstruction::kBooleanNot:
+    case HInstruction::kTypeConversion:
+    case HInstruction::kNullCheck:
+    case HInstruction::kBoundsCheck:
+    case HInstruction::kDivZeroCheck:
+    case HInstruction::kArrayLength:
+    case HInstruction::kInstanceFieldGet:
+    case HInstruction::kInstanceFieldSet:
+    case HInstruction::kStaticFieldGet:
+    case HInstruction::kStaticFieldSet:
+      return true;
+    case HInstruction::kEqual:
+    case HInstruction::kNotEqual:
+    case HInstruction::kLessThan:
+    case HInstruction::kLessThanOrEqual:
+    case HInstruction::kGreaterThan:
+    case HInstruction::kGreaterThanOrEqual:
+    case HInstruction::kBelow:
+    case HInstruction::kBelowOrEqual:
+    case HInstruction::kAbove:
+    case HInstruction::kAboveOrEqual:
+      // Floating point conditions carry a bias we do not bother to copy.
+      return !Primitive::IsFloatingPointType(instruction->InputAt(0)->GetType());
+    case HInstruction::kArrayGet:
+      // Do not lose additional side effects given by the builder.
+      return instruction->GetSideEffects().Equals(
+          SideEffects::ArrayReadOfType(instruction->GetType()));
+    case HInstruction::kArraySet: {
+      HArraySet* array_set = instruction->AsArraySet();
+      return array_set->GetSideEffects().Equals(
+          SideEffects::ArrayWriteOfType(array_set->GetRawExpectedComponentType()).Union(
+              HArraySet::SideEffectsForArchRuntimeCalls(array_set->GetValue()->GetType())));
+    }
+    default:
+      return false;
+  }
+}
+
+// Returns a copy of `instruction` whose inputs are looked up in `values`.
+static HInstruction* CloneInstruction(ArenaAllocator* arena,
+                                      HInstruction* instruction,
+                                      const HLoopUnrolling::ValueMap& values) {
+  DCHECK(CanClone(instruction));
+  size_t input_count = instruction->InputCount();
+  HInstruction* input0 = (input_count > 0u) ? Lookup(values, instruction->InputAt(0)) : nullptr;
+  HInstruction* input1 = (input_count > 1u) ? Lookup(values, instruction->InputAt(1)) : nullptr;
+  HInstruction* input2 = (input_count > 2u) ? Lookup(values, instruction->InputAt(2)) : nullptr;
+  Primitive::Type type = instruction->GetType();
+  uint32_t dex_pc = instruction->GetDexPc();
+  switch (instruction->GetKind()) {
+    case HInstruction::kAdd: return new (arena) HAdd(type, input0, input1, dex_pc);
+    case HInstruction::kSub: return new (arena) HSub(type, input0, input1, dex_pc);
+    case HInstruction::kMul: return new (arena) HMul(type, input0, input1, dex_pc);
+    case HInstruction::kAnd: return new (arena) HAnd(type, input0, input1, dex_pc);
+    case HInstruction::kOr: return new (arena) HOr(type, input0, input1, dex_pc);
+    case HInstruction::kXor: return new (arena) HXor(type, input0, input1, dex_pc);
+    case HInstruction::kShl: return new (arena) HShl(type, input0, input1, dex_pc);
+    case HInstruction::kShr: return new (arena) HShr(type, input0, input1, dex_pc);
+    case HInstruction::kUShr: return new (arena) HUShr(type, input0, input1, dex_pc);
+    case HInstruction::kNeg: return new (arena) HNeg(type, input0, dex_pc);
+    case HInstruction::kNot: return new (arena) HNot(type, input0, dex_pc);
+    case HInstruction::kBooleanNot: return new (arena) HBooleanNot(input0, dex_pc);
+    case HInstruction::kTypeConversion: return new (arena) HTypeConversion(type, input0, dex_pc);
+    case HInstruction::kEqual: return new (arena) HEqual(input0, input1, dex_pc);
+    case HInstruction::kNotEqual: return new (arena) HNotEqual(input0, input1, dex_pc);
+    case HInstruction::kLessThan: return new (arena) HLessThan(input0, input1, dex_pc);
+    case HInstruction::kLessThanOrEqual:
+      return new (arena) HLessThanOrEqual(input0, input1, dex_pc);
+    case HInstruction::kGreaterThan: return new (arena) HGreaterThan(input0, input1, dex_pc);
+    case HInstruction::kGreaterThanOrEqual:
+      return new (arena) HGreaterThanOrEqual(input0, input1, dex_pc);
+    case HInstruction::kBelow: return new (arena) HBelow(input0, input1, dex_pc);
+    case HInstruction::kBelowOrEqual: return new (arena) HBelowOrEqual(input0, input1, dex_pc);
+    case HInstruction::kAbove: return new (arena) HAbove(input0, input1, dex_pc);
+    case HInstruction::kAboveOrEqual: return new (arena) HAboveOrEqual(input0, input1, dex_pc);
+    case HInstruction::kNullCheck: return new (arena) HNullCheck(input0, dex_pc);
+    case HInstruction::kBoundsCheck: return new (arena) HBoundsCheck(input0, input1, dex_pc);
+    case HInstruction::kDivZeroCheck: return new (arena) HDivZeroCheck(input0, dex_pc);
+    case HInstruction::kArrayLength: return new (arena) HArrayLength(input0, dex_pc);
+    case HInstruction::kArrayGet: return new (arena) HArrayGet(input0, input1, type, dex_pc);
+    case HInstruction::kArraySet: {
+      HArraySet* array_set = instruction->AsArraySet();
+      HArraySet* clone = new (arena) HArraySet(
+          input0, input1, input2, array_set->GetRawExpectedComponentType(), dex_pc);
+      if (!array_set->NeedsTypeCheck()) {
+        clone->ClearNeedsTypeCheck();
+      }
+      if (!array_set->GetValueCanBeNull()) {
+        clone->ClearValueCanBeNull();
+      }
+      if (array_set->StaticTypeOfArrayIsObjectArray()) {
+        clone->SetStaticTypeOfArrayIsObjectArray();
+      }
+      return clone;
+    }
+    case HInstruction::kInstanceFieldGet: {
+      const FieldInfo& info = instruction->AsInstanceFieldGet()->GetFieldInfo();
+      return new (arena) HInstanceFieldGet(input0,
+                                           info.GetFieldType(),
+                                           info.GetFieldOffset(),
+                                           info.IsVolatile(),
+                                           info.GetFieldIndex(),
+                                           info.GetDeclaringClassDefIndex(),
+                                           info.GetDexFile(),
+                                           info.GetDexCache(),
+                                           dex_pc);
+    }
+    case HInstruction::kInstanceFieldSet: {
+      HInstanceFieldSet* field_set = instruction->AsInstanceFieldSet();
+      const FieldInfo& info = field_set->GetFieldInfo();
+      HInstanceFieldSet* clone = new (arena) HInstanceFieldSet(input0,
+                                                               input1,
+                                                               info.GetFieldType(),
+                                                               info.GetFieldOffset(),
+                                                               info.IsVolatile(),
+                                                               info.GetFieldIndex(),
+                                                               info.GetDeclaringClassDefIndex(),
+                                                               info.GetDexFile(),
+                                                               info.GetDexCache(),
+                                                               dex_pc);
+      if (!field_set->GetValueCanBeNull()) {
+        clone->ClearValueCanBeNull();
+      }
+      return clone;
+    }
+    case HInstruction::kStaticFieldGet: {
+      const FieldInfo& info = instruction->AsStaticFieldGet()->GetFieldInfo();
+      return new (arena) HStaticFieldGet(input0,
+                                         info.GetFieldType(),
+                                         info.GetFieldOffset(),
+                                         info.IsVolatile(),
+                                         info.GetFieldIndex(),
+                                         info.GetDeclaringClassDefIndex(),
+                                         info.GetDexFile(),
+                                         info.GetDexCache(),
+                                         dex_pc);
+    }
+    case HInstruction::kStaticFieldSet: {
+      HStaticFieldSet* field_set = instruction->AsStaticFieldSet();
+      const FieldInfo& info = field_set->GetFieldInfo();
+      HStaticFieldSet* clone = new (arena) HStaticFieldSet(input0,
+                                                           input1,
+                                                           info.GetFieldType(),
+                                                           info.GetFieldOffset(),
+                                                           info.IsVolatile(),
+                                                           info.GetFieldIndex(),
+                                                           info.GetDeclaringClassDefIndex(),
+                                                           info.GetDexFile(),
+                                                           info.GetDexCache(),
+                                                           dex_pc);
+      if (!field_set->GetValueCanBeNull()) {
+        clone->ClearValueCanBeNull();
+      }
+      return clone;
+    }
+    default:
+      LOG(FATAL) << "Unexpected instruction " << instruction->DebugName();
+      UNREACHABLE();
+  }
+}
+
+// Replaces the values of the environment of `instruction` with their copies in `values`.
+static void RemapEnvironment(HInstruction* instruction, const HLoopUnrolling::ValueMap& values) {
+  for (HEnvironment* environment = instruction->GetEnvironment();
+       environment != nullptr;
+       environment = environment->GetParent()) {
+    for (size_t i = 0, e = environment->Size(); i < e; ++i) {
+      HInstruction* value = environment->GetInstructionAt(i);
+      if (value == nullptr) {
+        continue;
+      }
+      HInstruction* copy = Lookup(values, value);
+      if (copy != value) {
+        environment->RemoveAsUserOfInput(i);
+        environment->SetRawEnvAt(i, copy);
+        copy->AddEnvUseAt(environment, i);
+      }
+    }
+  }
+}
+
+// Maps the phis of `header` to their values at the start of the next iteration.
+static void AdvancePhis(HBasicBlock* header,
+                        size_t back_edge_index,
+                        HLoopUnrolling::ValueMap* values) {
+  // Phis may feed each other, so look up all the new values before updating any.
+  ArenaVector<HInstruction*> next_values(
+      header->GetGraph()->GetArena()->Adapter(kArenaAllocOptimization));
+  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
+    next_values.push_back(Lookup(*values, it.Current()->InputAt(back_edge_index)));
+  }
+  values->clear();
+  size_t index = 0u;
+  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
+    values->Overwrite(it.Current(), next_values[index++]);
+  }
+}
+
+// Sets the input of the phis of `header` coming from `predecessor_index` to their values in
+// `values`.
+static void UpdatePhiInputs(HBasicBlock* header,
+                            size_t predecessor_index,
+                            const HLoopUnrolling::ValueMap& values) {
+  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
+    HInstruction* phi = it.Current();
+    HInstruction* value = Lookup(values, phi);
+    if (value != phi->InputAt(predecessor_index)) {
+      phi->ReplaceInput(value, predecessor_index);
+    }
+  }
+}
+
+// Removes the instructions in `hoisted` from `instructions`.
+static void RemoveHoisted(const ArenaSet<HInstruction*>& hoisted,
+                          ArenaVector<HInstruction*>* instructions) {
+  instructions->erase(
+      std::remove_if(instructions->begin(),
+                     instructions->end(),
+                     [&hoisted](HInstruction* instruction) {
+                       return hoisted.find(instruction) != hoisted.end();
+                     }),
+      instructions->end());
+}
+
+// Makes the uses of `instruction` after the exit of `loop` use a new phi in
+// `exit` instead, merging `instruction` with `peeled_value`, its value when the
+// peeled iteration does not enter the loop.
+static void AddExitPhi(HLoopInformation* loop,
+                       HInstruction* instruction,
+                       HInstruction* peeled_value,
+                       HBasicBlock* exit) {
+  ArenaAllocator* arena = exit->GetGraph()->GetArena();
+  ArenaVector<std::pair<HInstruction*, size_t>> uses(arena->Adapter(kArenaAllocOptimization));
+  for (HUseIterator<HInstruction*> it(instruction->GetUses()); !it.Done(); it.Advance()) {
+    HInstruction* user = it.Current()->GetUser();
+    if (!loop->Contains(*user->GetBlock())) {
+      uses.push_back(std::make_pair(user, it.Current()->GetIndex()));
+    }
+  }
+  ArenaVector<std::pair<HEnvironment*, size_t>> env_uses(
+      arena->Adapter(kArenaAllocOptimization));
+  for (HUseIterator<HEnvironment*> it(instruction->GetEnvUses()); !it.Done(); it.Advance()) {
+    HEnvironment* user = it.Current()->GetUser();
+    if (!loop->Contains(*user->GetHolder()->GetBlock())) {
+      env_uses.push_back(std::make_pair(user, it.Current()->GetIndex()));
+    }
+  }
+  if (uses.empty() && env_uses.empty()) {
+    return;
+  }
+
+  uint32_t reg_number = instruction->IsPhi() ? instruction->AsPhi()->GetRegNumber() : kNoRegNumber;
+  HPhi* phi = new (arena) HPhi(arena, reg_number, 0u, instruction->GetType());
+  exit->AddPhi(phi);
+  DCHECK_EQ(exit->GetPredecessors().size(), 2u);
+  DCHECK(loop->Contains(*exit->GetPredecessors()[0]));
+  phi->AddInput(instruction);
+  phi->AddInput(peeled_value);
+  if (instruction->GetType() == Primitive::kPrimNot) {
+    phi->SetReferenceTypeInfo(instruction->GetReferenceTypeInfo());
+    phi->SetCanBeNull(instruction->CanBeNull() || peeled_value->CanBeNull());
+  }
+  for (const auto& use : uses) {
+    use.first->ReplaceInput(phi, use.second);
+  }
+  for (const auto& env_use : env_uses) {
+    env_use.first->RemoveAsUserOfInput(env_use.second);
+    env_use.first->SetRawEnvAt(env_use.second, phi);
+    phi->AddEnvUseAt(env_use.first, env_use.second);
+  }
+}
+
+void HLoopUnrolling::Run() {
+  UnrollingLimits limits;
+  if (graph_->HasTryCatch() || !GetUnrollingLimits(graph_->GetInstructionSet(), &limits)) {
+    return;
+  }
+
+  // Collect the loops first, as peeling adds blocks to the graph.
+  ArenaVector<HBasicBlock*> headers(graph_->GetArena()->Adapter(kArenaAllocOptimization));
+  for (HPostOrderIterator it(*graph_); !it.Done(); it.Advance()) {
+    if (it.Current()->IsLoopHeader()) {
+      headers.push_back(it.Current());
+    }
+  }
+  if (headers.empty()) {
+    return;
+  }
+
+  // Bounds check elimination may have changed the loops since the last induction
+  // variable analysis, so run a new one.
+  HInductionVarAnalysis induction(graph_);
+  induction.Run();
+  InductionVarRange range(&induction);
+  for (HBasicBlock* header : headers) {
+    TryUnrollLoop(header, limits, &range);
+  }
+}
+
+void HLoopUnrolling::TryUnrollLoop(HBasicBlock* header,
+                                   const UnrollingLimits& limits,
+                                   InductionVarRange* range) {
+  // Only consider innermost loops made of the header and a single body block,
+  // which is the back edge and is entered when the exit test fails.
+  HLoopInformation* loop = header->GetLoopInformation();
+  if (loop->NumberOfBackEdges() != 1u ||
+      loop->GetBlocks().NumSetBits() != 2u ||
+      header->GetPredecessors().size() != 2u ||
+      !header->EndsWithIf()) {
+    return;
+  }
+  HBasicBlock* body = loop->GetBackEdges()[0];
+  HIf* if_instruction = header->GetLastInstruction()->AsIf();
+  bool body_is_true_successor = (if_instruction->IfTrueSuccessor() == body);
+  HBasicBlock* exit = body_is_true_successor
+      ? if_instruction->IfFalseSuccessor()
+      : if_instruction->IfTrueSuccessor();
+  if (body == header ||
+      (!body_is_true_successor && if_instruction->IfFalseSuccessor() != body) ||
+      body->GetPredecessors().size() != 1u ||
+      !body->GetLastInstruction()->IsGoto() ||
+      loop->Contains(*exit)) {
+    return;
+  }
+  size_t back_edge_index = header->GetPredecessorIndexOf(body);
+  size_t pre_header_index = 1u - back_edge_index;
+  HBasicBlock* pre_header = header->GetPredecessors()[pre_header_index];
+  if (pre_header->GetSuccessors().size() != 1u || !pre_header->GetLastInstruction()->IsGoto()) {
+    return;
+  }
+
+  // Check that each instruction of an iteration can be either copied, or moved
+  // to the first peeled iteration.
+  ArenaAllocator* arena = graph_->GetArena();
+  ArenaVector<HInstruction*> header_instructions(arena->Adapter(kArenaAllocOptimization));
+  ArenaVector<HInstruction*> body_instructions(arena->Adapter(kArenaAllocOptimization));
+  ArenaSet<HInstruction*> hoisted(arena->Adapter(kArenaAllocOptimization));
+  size_t num_instructions = 0u;
+  for (HInstructionIterator it(header->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (instruction != loop->GetSuspendCheck() && instruction != if_instruction) {
+      header_instructions.push_back(instruction);
+    }
+  }
+  for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (instruction != body->GetLastInstruction()) {
+      body_instructions.push_back(instruction);
+    }
+  }
+  for (const ArenaVector<HInstruction*>* instructions : { &header_instructions,
+                                                          &body_instructions }) {
+    for (HInstruction* instruction : *instructions) {
+      if (IsHoistable(loop, instruction, hoisted)) {
+        hoisted.insert(instruction);
+      } else if (CanClone(instruction)) {
+        ++num_instructions;
+      } else {
+        return;
+      }
+    }
+  }
+  bool must_peel = !hoisted.empty();
+
+  int64_t trip_count = 0;
+  if (!range->IsConstantTripCount(loop, &trip_count)) {
+    // Without a known trip count, only peel the loop to hoist instructions out
+    // of it, and only if the exit does not need to merge other paths.
+    if (must_peel &&
+        num_instructions <= limits.max_unrolled_instructions &&
+        exit->GetPredecessors().size() == 1u &&
+        exit->GetPhis().IsEmpty()) {
+      PeelWithExitTest(loop, header_instructions, body_instructions, hoisted);
+      MaybeRecordStat(MethodCompilationStat::kLoopPeeled);
+    }
+    return;
+  }
+
+  // Pick the number of iterations to peel into the pre-header, and how many
+  // copies of the body the remaining loop should have.
+  uint64_t num_iterations = static_cast<uint64_t>(trip_count);
+  uint64_t num_peeled = 0u;
+  uint64_t factor = 1u;
+  bool fully_unroll =
+      num_iterations <= limits.max_fully_unrolled_instructions &&
+      num_iterations * num_instructions <= limits.max_fully_unrolled_instructions;
+  if (fully_unroll) {
+    num_peeled = num_iterations;
+  } else {
+    for (uint64_t f = limits.max_factor; f > 1u; --f) {
+      uint64_t peel = must_peel ? (num_iterations - 1u) % f + 1u : num_iterations % f;
+      if (f * num_instructions <= limits.max_unrolled_instructions &&
+          num_iterations - peel >= f) {
+        num_peeled = peel;
+        factor = f;
+        break;
+      }
+    }
+    if (factor == 1u) {
+      if (!must_peel) {
+        return;
+      }
+      num_peeled = 1u;
+    }
+  }
+
+  // Peel the first iterations at the end of the pre-header, moving the hoisted
+  // instructions to the first of them.
+  ValueMap values(std::less<HInstruction*>(), arena->Adapter(kArenaAllocOptimization));
+  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
+    values.Overwrite(it.Current(), it.Current()->InputAt(pre_header_index));
+  }
+  HInstruction* cursor = pre_header->GetLastInstruction();
+  for (uint64_t i = 0; i < num_peeled; ++i) {
+    CopyIteration(header_instructions, hoisted, cursor, &values);
+    CopyIteration(body_instructions, hoisted, cursor, &values);
+    if (i == 0u) {
+      RemoveHoisted(hoisted, &header_instructions);
+      RemoveHoisted(hoisted, &body_instructions);
+      hoisted.clear();
+    }
+    AdvancePhis(header, back_edge_index, &values);
+  }
+  UpdatePhiInputs(header, pre_header_index, values);
+
+  if (fully_unroll) {
+    // The loop is now never entered. Dead code elimination removes it, together
+    // with its suspend check.
+    if_instruction->ReplaceInput(graph_->GetIntConstant(body_is_true_successor ? 0 : 1), 0);
+    MaybeRecordStat(MethodCompilationStat::kLoopFullyUnrolled);
+    return;
+  }
+
+  // Append the other copies of the loop to the body. Since the remaining trip
+  // count is a multiple of `factor`, they do not need to test for the exit.
+  values.clear();
+  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
+    values.Overwrite(it.Current(), it.Current()->InputAt(back_edge_index));
+  }
+  cursor = body->GetLastInstruction();
+  for (uint64_t i = 1u; i < factor; ++i) {
+    CopyIteration(header_instructions, hoisted, cursor, &values);
+    CopyIteration(body_instructions, hoisted, cursor, &values);
+    AdvancePhis(header, back_edge_index, &values);
+  }
+  UpdatePhiInputs(header, back_edge_index, values);
+  MaybeRecordStat(factor > 1u ? MethodCompilationStat::kLoopUnrolled
+                              : MethodCompilationStat::kLoopPeeled);
+}
+
+void HLoopUnrolling::CopyIteration(const ArenaVector<HInstruction*>& instructions,
+                                   const ArenaSet<HInstruction*>& hoisted,
+                                   HInstruction* cursor,
+                                   ValueMap* values) {
+  ArenaAllocator* arena = graph_->GetArena();
+  HBasicBlock* block = cursor->GetBlock();
+  for (HInstruction* instruction : instructions) {
+    HInstruction* copy = instruction;
+    if (hoisted.find(instruction) != hoisted.end()) {
+      // Later iterations would compute the same value, so move the instruction
+      // itself rather than a copy.
+      instruction->MoveBefore(cursor);
+    } else {
+      copy = CloneInstruction(arena, instruction, *values);
+      block->InsertInstructionBefore(copy, cursor);
+      if (instruction->HasEnvironment()) {
+        copy->CopyEnvironmentFrom(instruction->GetEnvironment());
+      }
+      if (instruction->GetType() == Primitive::kPrimNot) {
+        copy->SetReferenceTypeInfo(instruction->GetReferenceTypeInfo());
+      }
+      values->Overwrite(instruction, copy);
+    }
+    RemapEnvironment(copy, *values);
+  }
+}
+
+void HLoopUnrolling::PeelWithExitTest(HLoopInformation* loop,
+                                      const ArenaVector<HInstruction*>& header_instructions,
+                                      const ArenaVector<HInstruction*>& body_instructions,
+                                      const ArenaSet<HInstruction*>& hoisted) {
+  ArenaAllocator* arena = graph_->GetArena();
+  HBasicBlock* header = loop->GetHeader();
+  HBasicBlock* body = loop->GetBackEdges()[0];
+  HIf* if_instruction = header->GetLastInstruction()->AsIf();
+  bool body_is_true_successor = (if_instruction->IfTrueSuccessor() == body);
+  HBasicBlock* exit = body_is_true_successor
+      ? if_instruction->IfFalseSuccessor()
+      : if_instruction->IfTrueSuccessor();
+  size_t pre_header_index = 1u - header->GetPredecessorIndexOf(body);
+  size_t back_edge_index = header->GetPredecessorIndexOf(body);
+  HBasicBlock* pre_header = header->GetPredecessors()[pre_header_index];
+
+  // Insert the peeled header and body between the pre-header and the header,
+  // keeping the predecessor index of the header phis. The peeled header leaves
+  // through a new block to the exit, in the same order as the header does.
+  HBasicBlock* peeled_header = graph_->SplitEdge(pre_header, header);
+  HBasicBlock* peeled_body = graph_->SplitEdge(peeled_header, header);
+  HBasicBlock* peeled_exit = new (arena) HBasicBlock(graph_, exit->GetDexPc());
+  graph_->AddBlock(peeled_exit);
+  peeled_header->AddSuccessor(peeled_exit);
+  if (!body_is_true_successor) {
+    peeled_header->SwapSuccessors();
+  }
+  peeled_exit->AddSuccessor(exit);
+  for (HBasicBlock* block : { peeled_header, peeled_body, peeled_exit }) {
+    block->SetLoopInformation(pre_header->GetLoopInformation());
+    for (HLoopInformationOutwardIterator it(*pre_header); !it.Done(); it.Advance()) {
+      it.Current()->Add(block);
+    }
+  }
+  HInstruction* header_cursor = new (arena) HGoto(header->GetDexPc());
+  peeled_header->AddInstruction(header_cursor);
+  peeled_body->AddInstruction(new (arena) HGoto(body->GetLastInstruction()->GetDexPc()));
+  peeled_exit->AddInstruction(new (arena) HGoto(exit->GetDexPc()));
+
+  // Copy the header and its exit test.
+  ValueMap values(std::less<HInstruction*>(), arena->Adapter(kArenaAllocOptimization));
+  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
+    values.Overwrite(it.Current(), it.Current()->InputAt(pre_header_index));
+  }
+  CopyIteration(header_instructions, hoisted, header_cursor, &values);
+  peeled_header->RemoveInstruction(header_cursor);
+  peeled_header->AddInstruction(new (arena) HIf(Lookup(values, if_instruction->InputAt(0)),
+                                                if_instruction->GetDexPc()));
+
+  // Values of the header reach the exit from both the loop and the peeled header.
+  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
+    AddExitPhi(loop, it.Current(), Lookup(values, it.Current()), exit);
+  }
+  for (HInstruction* instruction : header_instructions) {
+    if (instruction->GetBlock() == header) {
+      AddExitPhi(loop, instruction, Lookup(values, instruction), exit);
+    }
+  }
+
+  // Copy the body, and enter the loop with the values of the second iteration.
+  CopyIteration(body_instructions, hoisted, peeled_body->GetLastInstruction(), &values);
+  AdvancePhis(header, back_edge_index, &values);
+  UpdatePhiInputs(header, pre_header_index, values);
+
+  graph_->ClearDominanceInformation();
+  graph_->ComputeDominanceInformation();
+}
+
+}  // namespace art
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * This optimization unrolls and peels small innermost loops of the form
+ *
+ *     B1 (pre-header):
+ *       v1  Goto B2
+ *     B2 (header):
+ *       i2  Phi [ i0 i6 ]
+ *       v3  SuspendCheck
+ *       z4  LessThan [ i2 i9 ]
+ *       v5  If [ z4 ] then B3 else B4
+ *     B3 (body, back edge):
+ *       i6  Add [ i2 i7 ]
+ *       v8  Goto B2
+ *
+ * using the trip count computed by induction variable analysis:
+ *
+ *  - A loop with a small constant trip count is fully unrolled into its
+ *    pre-header. The loop itself is left to be removed by dead code
+ *    elimination, together with its suspend check.
+ *  - A loop with a larger constant trip count has its body replicated a few
+ *    times without intermediate exit tests. The first iterations are peeled
+ *    into the pre-header so that the remaining trip count is a multiple of the
+ *    unrolling factor, and the unrolled body keeps a single suspend check.
+ *  - A loop whose trip count is unknown is peeled once, behind a copy of the
+ *    exit test, if this allows loop invariant checks to leave the loop.
+ *
+ * When at least one iteration is peeled, instructions which only depend on
+ * values defined outside the loop and whose result cannot change from one
+ * iteration to the next (e.g. HNullCheck, HLoadClass or HClinitCheck) are
+ * moved to the peeled iteration instead of being copied, which covers the
+ * checks that LICM cannot hoist because they would throw or run class
+ * initialization too early.
+ *
+ * The size limits depend on the instruction set, and the pass is disabled for
+ * instruction sets which are not listed.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_LOOP_UNROLLING_H_
+#define ART_COMPILER_OPTIMIZING_LOOP_UNROLLING_H_
+
+#include "base/arena_containers.h"
+#include "optimization.h"
+
+namespace art {
+
+class InductionVarRange;
+struct UnrollingLimits;
+
+class HLoopUnrolling : public HOptimization {
+ public:
+  // Maps the instructions of the loop to their copies in the iteration being created.
+  typedef ArenaSafeMap<HInstruction*, HInstruction*> ValueMap;
+
+  HLoopUnrolling(HGraph* graph, OptimizingCompilerStats* stats)
+      : HOptimization(graph, kLoopUnrollingPassName, stats) {}
+
+  void Run() OVERRIDE;
+
+  static constexpr const char* kLoopUnrollingPassName = "loop_unrolling";
+
+ private:
+  // Tries to unroll or peel the loop with the given header, using `range` to
+  // find its trip count.
+  void TryUnrollLoop(HBasicBlock* header, const UnrollingLimits& limits, InductionVarRange* range);
+
+  // Inserts a copy of `instructions` before `cursor`, using `values` for their
+  // inputs and recording the new copies in it. Instructions in `hoisted` are
+  // moved before `cursor` instead of being copied.
+  void CopyIteration(const ArenaVector<HInstruction*>& instructions,
+                     const ArenaSet<HInstruction*>& hoisted,
+                     HInstruction* cursor,
+                     ValueMap* values);
+
+  // Peels the first iteration of `loop` into new blocks between the pre-header
+  // and the header. The peeled iteration tests the loop condition first and
+  // branches to the loop exit if the loop is not taken.
+  void PeelWithExitTest(HLoopInformation* loop,
+                        const ArenaVector<HInstruction*>& header_instructions,
+                        const ArenaVector<HInstruction*>& body_instructions,
+                        const ArenaSet<HInstruction*>& hoisted);
+
+  DISALLOW_COPY_AND_ASSIGN(HLoopUnrolling);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_LOOP_UNROLLING_H_
@@ -0,0 +1,330 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/arena_allocator.h"
+#include "builder.h"
+#include "constant_folding.h"
+#include "graph_checker.h"
+#include "gtest/gtest.h"
+#include "loop_unrolling.h"
+#include "nodes.h"
+#include "optimizing_unit_test.h"
+
+namespace art {
+
+/**
+ * Fixture class for the loop unrolling tests.
+ */
+class LoopUnrollingTest : public testing::Test {
+ public:
+  LoopUnrollingTest() : pool_(), allocator_(&pool_) {
+    // Use a fixed instruction set, as the size limits of the pass depend on it.
+    graph_ = new (&allocator_) HGraph(
+        &allocator_, *reinterpret_cast<DexFile*>(allocator_.Alloc(sizeof(DexFile))), -1, false,
+        kX86_64);
+    array_ = new (&allocator_) HParameterValue(graph_->GetDexFile(), 0, 0, Primitive::kPrimNot);
+    parameter_ = new (&allocator_) HParameterValue(graph_->GetDexFile(), 0, 1, Primitive::kPrimInt);
+  }
+
+  ~LoopUnrollingTest() { }
+
+  // Builds the loop
+  //
+  //   int sum = 0;
+  //   for (int i = 0; i < upper; ++i) {
+  //     sum += i;                  // or sum += array.length, if `with_check`.
+  //   }
+  //   return sum;
+  //
+  // where `upper` is either a constant or a parameter.
+  void BuildLoop(HInstruction* upper, bool with_check) {
+    graph_->SetNumberOfVRegs(2);
+    entry_ = new (&allocator_) HBasicBlock(graph_);
+    loop_preheader_ = new (&allocator_) HBasicBlock(graph_);
+    loop_header_ = new (&allocator_) HBasicBlock(graph_);
+    loop_body_ = new (&allocator_) HBasicBlock(graph_);
+    return_ = new (&allocator_) HBasicBlock(graph_);
+    exit_ = new (&allocator_) HBasicBlock(graph_);
+    for (HBasicBlock* block :
+         { entry_, loop_preheader_, loop_header_, loop_body_, return_, exit_ }) {
+      graph_->AddBlock(block);
+    }
+    graph_->SetEntryBlock(entry_);
+    graph_->SetExitBlock(exit_);
+    entry_->AddSuccessor(loop_preheader_);
+    loop_preheader_->AddSuccessor(loop_header_);
+    loop_header_->AddSuccessor(loop_body_);
+    loop_header_->AddSuccessor(return_);
+    loop_body_->AddSuccessor(loop_header_);
+    return_->AddSuccessor(exit_);
+
+    HLocal* induc = new (&allocator_) HLocal(0);
+    HLocal* sum = new (&allocator_) HLocal(1);
+    entry_->AddInstruction(array_);
+    entry_->AddInstruction(parameter_);
+    entry_->AddInstruction(induc);
+    entry_->AddInstruction(sum);
+    entry_->AddInstruction(new (&allocator_) HGoto());
+
+    HInstruction* zero = graph_->GetIntConstant(0);
+    loop_preheader_->AddInstruction(new (&allocator_) HStoreLocal(induc, zero));  // i = 0
+    loop_preheader_->AddInstruction(new (&allocator_) HStoreLocal(sum, zero));  // sum = 0
+    loop_preheader_->AddInstruction(new (&allocator_) HGoto());
+
+    HInstruction* load = new (&allocator_) HLoadLocal(induc, Primitive::kPrimInt);
+    loop_header_->AddInstruction(load);
+    condition_ = new (&allocator_) HLessThan(load, upper);  // i < upper
+    loop_header_->AddInstruction(condition_);
+    loop_header_->AddInstruction(new (&allocator_) HIf(condition_));
+
+    HInstruction* addend = nullptr;
+    if (with_check) {
+      null_check_ = new (&allocator_) HNullCheck(array_, 0);
+      loop_body_->AddInstruction(null_check_);
+      array_length_ = new (&allocator_) HArrayLength(null_check_, 0);
+      loop_body_->AddInstruction(array_length_);
+      addend = array_length_;
+    } else {
+      addend = new (&allocator_) HLoadLocal(induc, Primitive::kPrimInt);
+      loop_body_->AddInstruction(addend);
+    }
+    load = new (&allocator_) HLoadLocal(sum, Primitive::kPrimInt);
+    loop_body_->AddInstruction(load);
+    sum_update_ = new (&allocator_) HAdd(Primitive::kPrimInt, load, addend);
+    loop_body_->AddInstruction(sum_update_);
+    loop_body_->AddInstruction(new (&allocator_) HStoreLocal(sum, sum_update_));  // sum += ..
+    load = new (&allocator_) HLoadLocal(induc, Primitive::kPrimInt);
+    loop_body_->AddInstruction(load);
+    induc_update_ = new (&allocator_) HAdd(Primitive::kPrimInt, load, graph_->GetIntConstant(1));
+    loop_body_->AddInstruction(induc_update_);
+    loop_body_->AddInstruction(new (&allocator_) HStoreLocal(induc, induc_update_));  // i++
+    loop_body_->AddInstruction(new (&allocator_) HGoto());
+
+    load = new (&allocator_) HLoadLocal(sum, Primitive::kPrimInt);
+    return_->AddInstruction(load);
+    return_->AddInstruction(new (&allocator_) HReturn(load));
+    exit_->AddInstruction(new (&allocator_) HExit());
+
+    ASSERT_TRUE(graph_->TryBuildingSsa());
+    induc_phi_ = FindPhi(induc_update_);
+    sum_phi_ = FindPhi(sum_update_);
+    ASSERT_TRUE(induc_phi_ != nullptr);
+    ASSERT_TRUE(sum_phi_ != nullptr);
+  }
+
+  void BuildLoop(int32_t trip_count) {
+    BuildLoop(graph_->GetIntConstant(trip_count), /* with_check */ false);
+  }
+
+  // Performs loop unrolling and checks that the graph is still valid.
+  void PerformLoopUnrolling() {
+    HLoopUnrolling unrolling(graph_, nullptr);
+    unrolling.Run();
+    SSAChecker checker(graph_);
+    checker.Run();
+    ASSERT_TRUE(checker.IsValid());
+  }
+
+  void PerformConstantFolding() {
+    HConstantFolding(graph_).Run();
+  }
+
+  // Returns the phi of the loop header updated by `update` on the back edge.
+  HPhi* FindPhi(HInstruction* update) {
+    size_t back_edge_index = loop_header_->GetPredecessorIndexOf(loop_body_);
+    for (HInstructionIterator it(loop_header_->GetPhis()); !it.Done(); it.Advance()) {
+      if (it.Current()->InputAt(back_edge_index) == update) {
+        return it.Current()->AsPhi();
+      }
+    }
+    return nullptr;
+  }
+
+  HInstruction* PreHeaderInput(HPhi* phi) {
+    return phi->InputAt(1u - loop_header_->GetPredecessorIndexOf(loop_body_));
+  }
+
+  static size_t CountAdds(HBasicBlock* block) {
+    size_t count = 0u;
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      if (it.Current()->IsAdd()) {
+        ++count;
+      }
+    }
+    return count;
+  }
+
+  void ExpectConstant(int32_t expected, HInstruction* instruction) {
+    ASSERT_TRUE(instruction->IsIntConstant());
+    EXPECT_EQ(expected, instruction->AsIntConstant()->GetValue());
+  }
+
+  // General building fields.
+  ArenaPool pool_;
+  ArenaAllocator allocator_;
+  HGraph* graph_;
+
+  // Specific basic blocks.
+  HBasicBlock* entry_;
+  HBasicBlock* loop_preheader_;
+  HBasicBlock* loop_header_;
+  HBasicBlock* loop_body_;
+  HBasicBlock* return_;
+  HBasicBlock* exit_;
+
+  HInstruction* array_ = nullptr;
+  HInstruction* parameter_ = nullptr;
+  HInstruction* condition_ = nullptr;
+  HInstruction* null_check_ = nullptr;
+  HInstruction* array_length_ = nullptr;
+  HInstruction* sum_update_ = nullptr;
+  HInstruction* induc_update_ = nullptr;
+  HPhi* sum_phi_ = nullptr;
+  HPhi* induc_phi_ = nullptr;
+};
+
+//
+// The actual loop unrolling tests.
+//
+
+TEST_F(LoopUnrollingTest, FullUnrolling) {
+  BuildLoop(5);
+  PerformLoopUnrolling();
+
+  // All five iterations run in the pre-header, and the loop is never entered.
+  EXPECT_EQ(10u, CountAdds(loop_preheader_));
+  EXPECT_EQ(2u, CountAdds(loop_body_));
+  ExpectConstant(0, loop_header_->GetLastInstruction()->InputAt(0));
+
+  // The values entering the loop are the results of the whole loop.
+  PerformConstantFolding();
+  ExpectConstant(5, PreHeaderInput(induc_phi_));
+  ExpectConstant(0 + 1 + 2 + 3 + 4, PreHeaderInput(sum_phi_));
+  EXPECT_EQ(sum_phi_, return_->GetLastInstruction()->InputAt(0));
+}
+
+TEST_F(LoopUnrollingTest, TripCountOne) {
+  BuildLoop(1);
+  PerformLoopUnrolling();
+
+  EXPECT_EQ(2u, CountAdds(loop_preheader_));
+  ExpectConstant(0, loop_header_->GetLastInstruction()->InputAt(0));
+
+  PerformConstantFolding();
+  ExpectConstant(1, PreHeaderInput(induc_phi_));
+  ExpectConstant(0, PreHeaderInput(sum_phi_));
+}
+
+TEST_F(LoopUnrollingTest, TripCountZero) {
+  BuildLoop(0);
+  PerformLoopUnrolling();
+
+  // A loop which is never taken is left alone.
+  EXPECT_EQ(0u, CountAdds(loop_preheader_));
+  EXPECT_EQ(2u, CountAdds(loop_body_));
+  EXPECT_EQ(condition_, loop_header_->GetLastInstruction()->InputAt(0));
+  ExpectConstant(0, PreHeaderInput(induc_phi_));
+  ExpectConstant(0, PreHeaderInput(sum_phi_));
+}
+
+TEST_F(LoopUnrollingTest, PartialUnrolling) {
+  // The trip count is too large to fully unroll, and a multiple of the factor.
+  BuildLoop(100);
+  PerformLoopUnrolling();
+
+  // The body holds four iterations, and no iteration is peeled.
+  EXPECT_EQ(0u, CountAdds(loop_preheader_));
+  EXPECT_EQ(8u, CountAdds(loop_body_));
+  EXPECT_EQ(condition_, loop_header_->GetLastInstruction()->InputAt(0));
+  ExpectConstant(0, PreHeaderInput(induc_phi_));
+  ExpectConstant(0, PreHeaderInput(sum_phi_));
+
+  // The back edge carries the value of the last copy, which adds 1 to the third one.
+  size_t back_edge_index = loop_header_->GetPredecessorIndexOf(loop_body_);
+  HInstruction* induc_back_edge = induc_phi_->InputAt(back_edge_index);
+  ASSERT_TRUE(induc_back_edge->IsAdd());
+  EXPECT_NE(induc_update_, induc_back_edge);
+  EXPECT_EQ(loop_body_, induc_back_edge->GetBlock());
+}
+
+TEST_F(LoopUnrollingTest, PartialUnrollingWithRemainder) {
+  // 102 iterations are unrolled by four, after peeling the remaining two.
+  BuildLoop(102);
+  PerformLoopUnrolling();
+
+  EXPECT_EQ(4u, CountAdds(loop_preheader_));
+  EXPECT_EQ(8u, CountAdds(loop_body_));
+  EXPECT_EQ(condition_, loop_header_->GetLastInstruction()->InputAt(0));
+
+  // The loop is entered with the values of the third iteration.
+  PerformConstantFolding();
+  ExpectConstant(2, PreHeaderInput(induc_phi_));
+  ExpectConstant(0 + 1, PreHeaderInput(sum_phi_));
+}
+
+TEST_F(LoopUnrollingTest, NoUnrollingWithoutHoisting) {
+  // Without a constant trip count nor instructions to hoist, the loop is left alone.
+  BuildLoop(parameter_, /* with_check */ false);
+  PerformLoopUnrolling();
+
+  EXPECT_EQ(2u, loop_header_->GetPredecessors().size());
+  EXPECT_EQ(loop_preheader_, loop_header_->GetLoopInformation()->GetPreHeader());
+  EXPECT_EQ(1u, return_->GetPredecessors().size());
+  EXPECT_TRUE(return_->GetPhis().IsEmpty());
+}
+
+TEST_F(LoopUnrollingTest, PeelWithExitTest) {
+  BuildLoop(parameter_, /* with_check */ true);
+  PerformLoopUnrolling();
+
+  // The null check and the array length moved to a peeled iteration, which is
+  // entered behind a copy of the exit test.
+  HLoopInformation* loop = loop_header_->GetLoopInformation();
+  HBasicBlock* peeled_body = loop->GetPreHeader();
+  EXPECT_NE(loop_preheader_, peeled_body);
+  EXPECT_EQ(peeled_body, null_check_->GetBlock());
+  EXPECT_EQ(peeled_body, array_length_->GetBlock());
+  EXPECT_FALSE(loop->Contains(*null_check_->GetBlock()));
+  EXPECT_EQ(2u, CountAdds(loop_body_));
+
+  ASSERT_EQ(1u, peeled_body->GetPredecessors().size());
+  HBasicBlock* peeled_header = peeled_body->GetSinglePredecessor();
+  ASSERT_TRUE(peeled_header->EndsWithIf());
+  HInstruction* peeled_condition = peeled_header->GetLastInstruction()->InputAt(0);
+  ASSERT_TRUE(peeled_condition->IsLessThan());
+  EXPECT_NE(condition_, peeled_condition);
+  ExpectConstant(0, peeled_condition->InputAt(0));
+  EXPECT_EQ(parameter_, peeled_condition->InputAt(1));
+  EXPECT_EQ(loop_preheader_, peeled_header->GetSinglePredecessor());
+
+  // The second iteration enters the loop.
+  EXPECT_EQ(array_length_, PreHeaderInput(sum_phi_)->InputAt(1));
+  EXPECT_EQ(induc_update_->GetKind(), PreHeaderInput(induc_phi_)->GetKind());
+  EXPECT_EQ(peeled_body, PreHeaderInput(induc_phi_)->GetBlock());
+
+  // The exit merges the sum computed by the loop with its initial value, when
+  // the peeled exit test leaves right away.
+  ASSERT_EQ(2u, return_->GetPredecessors().size());
+  EXPECT_EQ(loop_header_, return_->GetPredecessors()[0]);
+  HInstruction* exit_phi = return_->GetFirstPhi();
+  ASSERT_TRUE(exit_phi != nullptr);
+  EXPECT_EQ(exit_phi, return_->GetLastPhi());
+  EXPECT_EQ(sum_phi_, exit_phi->InputAt(0));
+  ExpectConstant(0, exit_phi->InputAt(1));
+  EXPECT_EQ(exit_phi, return_->GetLastInstruction()->InputAt(0));
+}
+
+}  // namespace art
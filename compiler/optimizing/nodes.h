@@ -179,7 +179,8 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
         cached_float_constants_(std::less<int32_t>(), arena->Adapter(kArenaAllocConstantsMap)),
         cached_long_constants_(std::less<int64_t>(), arena->Adapter(kArenaAllocConstantsMap)),
         cached_double_constants_(std::less<int64_t>(), arena->Adapter(kArenaAllocConstantsMap)),
-        cached_current_method_(nullptr) {
+        cached_current_method_(nullptr),
+        cha_single_implementation_list_(arena->Adapter(kArenaAllocGraph)) {
     blocks_.reserve(kDefaultNumberOfBlocks);
   }
 
@@ -321,6 +322,15 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
     has_bounds_checks_ = value;
   }
 
+  // Record that the compiled code relies on `method` having a single implementation.
+  void AddCHASingleImplementationDependency(ArtMethod* method) {
+    cha_single_implementation_list_.insert(method);
+  }
+
+  const ArenaSet<ArtMethod*>& GetCHASingleImplementationList() const {
+    return cha_single_implementation_list_;
+  }
+
   bool ShouldGenerateConstructorBarrier() const {
     return should_generate_constructor_barrier_;
   }
@@ -479,6 +489,10 @@ class HGraph : public ArenaObject<kArenaAllocGraph> {
 
   HCurrentMethod* cached_current_method_;
 
+  // Methods that the compiled code assumes have a single implementation, as found by class
+  // hierarchy analysis. The JIT registers the code as depending on them.
+  ArenaSet<ArtMethod*> cha_single_implementation_list_;
+
   friend class SsaBuilder;           // For caching constants.
   friend class SsaLivenessAnalysis;  // For the linear order.
   ART_FRIEND_TEST(GraphTest, IfSuccessorSimpleJoinBlock1);
@@ -1054,6 +1068,7 @@ class HLoopInformationOutwardIterator : public ValueObject {
   M(LessThan, Condition)                                                \
   M(LessThanOrEqual, Condition)                                         \
   M(LoadClass, Instruction)                                             \
+  M(LoadMethodAccessFlags, Instruction)                                 \
   M(LoadException, Instruction)                                         \
   M(LoadLocal, Instruction)                                             \
   M(LoadString, Instruction)                                            \
@@ -1077,6 +1092,7 @@ class HLoopInformationOutwardIterator : public ValueObject {
   M(Rem, BinaryOperation)                                               \
   M(Return, Instruction)                                                \
   M(ReturnVoid, Instruction)                                            \
+  M(Select, Instruction)                                                \
   M(Shl, BinaryOperation)                                               \
   M(Shr, BinaryOperation)                                               \
   M(StaticFieldGet, Instruction)                                        \
@@ -2490,6 +2506,22 @@ class HCurrentMethod : public HExpression<0> {
   DISALLOW_COPY_AND_ASSIGN(HCurrentMethod);
 };
 
+// Loads the access flags of the method being executed. The runtime may update some of them
+// while the method runs, like kAccSingleImplementationInvalidated, so the load can neither be
+// moved nor merged with another one.
+class HLoadMethodAccessFlags : public HExpression<1> {
+ public:
+  HLoadMethodAccessFlags(HCurrentMethod* current_method, uint32_t dex_pc)
+      : HExpression(Primitive::kPrimInt, SideEffects::None(), dex_pc) {
+    SetRawInputAt(0, current_method);
+  }
+
+  DECLARE_INSTRUCTION(LoadMethodAccessFlags);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HLoadMethodAccessFlags);
+};
+
 // PackedSwitch (jump table). A block ending with a PackedSwitch instruction will
 // have one successor for each entry in the switch table, and the final successor
 // will be the block containing the next Dex opcode.
@@ -4423,6 +4455,40 @@ class HPhi : public HInstruction {
   DISALLOW_COPY_AND_ASSIGN(HPhi);
 };
 
+// Selects `true_value` if `condition` holds and `false_value` otherwise, without branching.
+// The false value comes first so that code generators can overwrite it in place.
+class HSelect : public HExpression<3> {
+ public:
+  HSelect(HInstruction* condition,
+          HInstruction* true_value,
+          HInstruction* false_value,
+          uint32_t dex_pc)
+      : HExpression(HPhi::ToPhiType(true_value->GetType()), SideEffects::None(), dex_pc) {
+    DCHECK_EQ(HPhi::ToPhiType(true_value->GetType()), HPhi::ToPhiType(false_value->GetType()));
+    SetRawInputAt(0, false_value);
+    SetRawInputAt(1, true_value);
+    SetRawInputAt(2, condition);
+  }
+
+  HInstruction* GetFalseValue() const { return InputAt(0); }
+  HInstruction* GetTrueValue() const { return InputAt(1); }
+  HInstruction* GetCondition() const { return InputAt(2); }
+
+  bool CanBeMoved() const OVERRIDE { return true; }
+  bool InstructionDataEquals(HInstruction* other ATTRIBUTE_UNUSED) const OVERRIDE {
+    return true;
+  }
+
+  bool CanBeNull() const OVERRIDE {
+    return GetTrueValue()->CanBeNull() || GetFalseValue()->CanBeNull();
+  }
+
+  DECLARE_INSTRUCTION(Select);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HSelect);
+};
+
 class HNullCheck : public HExpression<1> {
  public:
   HNullCheck(HInstruction* value, uint32_t dex_pc)
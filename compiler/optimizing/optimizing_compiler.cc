@@ -41,6 +41,7 @@
 #include "bounds_check_elimination.h"
 #include "builder.h"
 #include "code_generator.h"
+#include "code_sinking.h"
 #include "compiled_method.h"
 #include "compiler.h"
 #include "constant_folding.h"
@@ -62,12 +63,15 @@
 #include "intrinsics.h"
 #include "jit/jit_code_cache.h"
 #include "licm.h"
+#include "loop_unrolling.h"
 #include "jni/quick/jni_compiler.h"
 #include "load_store_elimination.h"
 #include "nodes.h"
 #include "prepare_for_register_allocation.h"
+#include "redundant_check_elimination.h"
 #include "reference_type_propagation.h"
 #include "register_allocator.h"
+#include "select_generator.h"
 #include "sharpening.h"
 #include "side_effects_analysis.h"
 #include "ssa_builder.h"
@@ -295,7 +299,7 @@ class OptimizingCompiler FINAL : public Compiler {
     }
   }
 
-  bool JitCompile(Thread* self, jit::JitCodeCache* code_cache, ArtMethod* method)
+  bool JitCompile(Thread* self, jit::JitCodeCache* code_cache, ArtMethod* method, bool baseline)
       OVERRIDE
       SHARED_REQUIRES(Locks::mutator_lock_);
 
@@ -322,7 +326,8 @@ class OptimizingCompiler FINAL : public Compiler {
   // 1) Builds the graph. Returns null if it failed to build it.
   // 2) If `run_optimizations_` is set:
   //    2.1) Transform the graph to SSA. Returns null if it failed.
-  //    2.2) Run optimizations on the graph, including register allocator.
+  //    2.2) Run optimizations on the graph, including register allocator. Only
+  //         the cheapest ones are run if `jit_baseline` is set.
   // 3) Generate code with the `code_allocator` provided.
   CodeGenerator* TryCompile(ArenaAllocator* arena,
                             CodeVectorAllocator* code_allocator,
@@ -333,7 +338,8 @@ class OptimizingCompiler FINAL : public Compiler {
                             uint32_t method_idx,
                             jobject class_loader,
                             const DexFile& dex_file,
-                            Handle<mirror::DexCache> dex_cache) const;
+                            Handle<mirror::DexCache> dex_cache,
+                            bool jit_baseline) const;
 
   std::unique_ptr<OptimizingCompilerStats> compilation_stats_;
 
@@ -427,7 +433,7 @@ static void MaybeRunInliner(HGraph* graph,
     return;
   }
   HInliner* inliner = new (graph->GetArena()) HInliner(
-    graph, codegen, dex_compilation_unit, dex_compilation_unit, driver, handles, stats);
+    graph, graph, codegen, dex_compilation_unit, dex_compilation_unit, driver, handles, stats);
   HOptimization* optimizations[] = { inliner };
 
   RunOptimizations(optimizations, arraysize(optimizations), pass_observer);
@@ -455,7 +461,8 @@ static void RunArchOptimizations(InstructionSet instruction_set,
       arm64::InstructionSimplifierArm64* simplifier =
           new (arena) arm64::InstructionSimplifierArm64(graph, stats);
       SideEffectsAnalysis* side_effects = new (arena) SideEffectsAnalysis(graph);
-      GVNOptimization* gvn = new (arena) GVNOptimization(graph, *side_effects, "GVN_after_arch");
+      GVNOptimization* gvn =
+          new (arena) GVNOptimization(graph, *side_effects, stats, "GVN_after_arch");
       HOptimization* arm64_optimizations[] = {
         simplifier,
         side_effects,
@@ -514,14 +521,19 @@ static void RunOptimizations(HGraph* graph,
   HConstantFolding* fold1 = new (arena) HConstantFolding(graph);
   InstructionSimplifier* simplify1 = new (arena) InstructionSimplifier(graph, stats);
   HBooleanSimplifier* boolean_simplify = new (arena) HBooleanSimplifier(graph);
+  HSelectGenerator* select_generator = new (arena) HSelectGenerator(graph, stats);
+  RedundantCheckElimination* check_elimination =
+      new (arena) RedundantCheckElimination(graph, stats);
   HConstantFolding* fold2 = new (arena) HConstantFolding(graph, "constant_folding_after_inlining");
   HConstantFolding* fold3 = new (arena) HConstantFolding(graph, "constant_folding_after_bce");
   SideEffectsAnalysis* side_effects = new (arena) SideEffectsAnalysis(graph);
-  GVNOptimization* gvn = new (arena) GVNOptimization(graph, *side_effects);
+  GVNOptimization* gvn = new (arena) GVNOptimization(graph, *side_effects, stats);
   LICM* licm = new (arena) LICM(graph, *side_effects);
   LoadStoreElimination* lse = new (arena) LoadStoreElimination(graph, *side_effects);
+  CodeSinking* code_sinking = new (arena) CodeSinking(graph, stats);
   HInductionVarAnalysis* induction = new (arena) HInductionVarAnalysis(graph);
   BoundsCheckElimination* bce = new (arena) BoundsCheckElimination(graph, *side_effects, induction);
+  HLoopUnrolling* unrolling = new (arena) HLoopUnrolling(graph, stats);
   ReferenceTypePropagation* type_propagation =
       new (arena) ReferenceTypePropagation(graph, &handles);
   HSharpening* sharpening = new (arena) HSharpening(graph, codegen, dex_compilation_unit, driver);
@@ -552,7 +564,9 @@ static void RunOptimizations(HGraph* graph,
   //       pipeline for all methods.
   if (graph->HasTryCatch()) {
     HOptimization* optimizations2[] = {
+      check_elimination,
       boolean_simplify,
+      select_generator,
       side_effects,
       gvn,
       dce2,
@@ -565,18 +579,23 @@ static void RunOptimizations(HGraph* graph,
     RunOptimizations(optimizations2, arraysize(optimizations2), pass_observer);
   } else {
     HOptimization* optimizations2[] = {
+      // Needs to see the branches before the select generator removes them.
+      check_elimination,
       // BooleanSimplifier depends on the InstructionSimplifier removing
       // redundant suspend checks to recognize empty blocks.
       boolean_simplify,
+      select_generator,
       fold2,  // TODO: if we don't inline we can also skip fold2.
       side_effects,
       gvn,
       licm,
       induction,
       bce,
-      fold3,  // evaluates code generated by dynamic bce
+      unrolling,
+      fold3,  // evaluates code generated by dynamic bce and unrolled loops
       simplify3,
       lse,
+      code_sinking,
       dce2,
       // The codegen has a few assumptions that only the instruction simplifier
       // can satisfy. For example, the code generator does not expect to see a
@@ -591,6 +610,27 @@ static void RunOptimizations(HGraph* graph,
   AllocateRegisters(graph, codegen, pass_observer);
 }
 
+// Passes run for the baseline tier of the JIT. They do not need reference type
+// information, and keep the compilation time close to the cost of building the
+// graph. The method is compiled again with all optimizations once it is hot.
+static void RunBaselineOptimizations(HGraph* graph,
+                                     CodeGenerator* codegen,
+                                     OptimizingCompilerStats* stats,
+                                     PassObserver* pass_observer) {
+  ArenaAllocator* arena = graph->GetArena();
+  HConstantFolding* fold = new (arena) HConstantFolding(graph);
+  HDeadCodeElimination* dce = new (arena) HDeadCodeElimination(
+      graph, stats, HDeadCodeElimination::kFinalDeadCodeEliminationPassName);
+
+  HOptimization* optimizations[] = {
+    fold,
+    dce
+  };
+
+  RunOptimizations(optimizations, arraysize(optimizations), pass_observer);
+  AllocateRegisters(graph, codegen, pass_observer);
+}
+
 // The stack map we generate must be 4-byte aligned on ARM. Since existing
 // maps are generated alongside these stack maps, we must also align them.
 static ArrayRef<const uint8_t> AlignVectorSize(ArenaVector<uint8_t>& vector) {
@@ -686,7 +726,8 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* arena,
                                               uint32_t method_idx,
                                               jobject class_loader,
                                               const DexFile& dex_file,
-                                              Handle<mirror::DexCache> dex_cache) const {
+                                              Handle<mirror::DexCache> dex_cache,
+                                              bool jit_baseline) const {
   MaybeRecordStat(MethodCompilationStat::kAttemptCompilation);
   CompilerDriver* compiler_driver = GetCompilerDriver();
   InstructionSet instruction_set = compiler_driver->GetInstructionSet();
@@ -801,12 +842,16 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* arena,
       }
     }
 
-    RunOptimizations(graph,
-                     codegen.get(),
-                     compiler_driver,
-                     compilation_stats_.get(),
-                     dex_compilation_unit,
-                     &pass_observer);
+    if (jit_baseline) {
+      RunBaselineOptimizations(graph, codegen.get(), compilation_stats_.get(), &pass_observer);
+    } else {
+      RunOptimizations(graph,
+                       codegen.get(),
+                       compiler_driver,
+                       compilation_stats_.get(),
+                       dex_compilation_unit,
+                       &pass_observer);
+    }
     codegen->CompileOptimized(code_allocator);
   } else {
     codegen->CompileBaseline(code_allocator);
@@ -859,7 +904,8 @@ CompiledMethod* OptimizingCompiler::Compile(const DexFile::CodeItem* code_item,
                    method_idx,
                    jclass_loader,
                    dex_file,
-                   dex_cache));
+                   dex_cache,
+                   /* jit_baseline */ false));
     if (codegen.get() != nullptr) {
       MaybeRecordStat(MethodCompilationStat::kCompiled);
       if (run_optimizations_) {
@@ -905,7 +951,8 @@ bool IsCompilingWithCoreImage() {
 
 bool OptimizingCompiler::JitCompile(Thread* self,
                                     jit::JitCodeCache* code_cache,
-                                    ArtMethod* method) {
+                                    ArtMethod* method,
+                                    bool baseline) {
   StackHandleScope<2> hs(self);
   Handle<mirror::ClassLoader> class_loader(hs.NewHandle(
       method->GetDeclaringClass()->GetClassLoader()));
@@ -937,7 +984,8 @@ bool OptimizingCompiler::JitCompile(Thread* self,
                    method_idx,
                    jclass_loader,
                    *dex_file,
-                   dex_cache));
+                   dex_cache,
+                   baseline));
     if (codegen.get() == nullptr) {
       return false;
     }
@@ -959,7 +1007,9 @@ bool OptimizingCompiler::JitCompile(Thread* self,
       codegen->GetCoreSpillMask(),
       codegen->GetFpuSpillMask(),
       code_allocator.GetMemory().data(),
-      code_allocator.GetSize());
+      code_allocator.GetSize(),
+      codegen->GetGraph()->GetCHASingleImplementationList(),
+      baseline);
 
   if (code == nullptr) {
     code_cache->ClearData(self, stack_map_data);
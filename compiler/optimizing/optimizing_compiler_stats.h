@@ -29,6 +29,9 @@ enum MethodCompilationStat {
   kAttemptCompilation = 0,
   kCompiled,
   kInlinedInvoke,
+  kInlinedMonomorphicCall,
+  kInlinedPolymorphicCall,
+  kInlinedSingleImplementationCall,
   kInstructionSimplifications,
   kInstructionSimplificationsArch,
   kUnresolvedMethod,
@@ -36,7 +39,15 @@ enum MethodCompilationStat {
   kUnresolvedFieldNotAFastAccess,
   kRemovedCheckedCast,
   kRemovedDeadInstruction,
+  kRemovedInstanceOf,
   kRemovedNullCheck,
+  kSelectGenerated,
+  kLoopFullyUnrolled,
+  kLoopUnrolled,
+  kLoopPeeled,
+  kInstructionSunk,
+  kInstructionHoisted,
+  kRemovedPartialRedundancy,
   kNotCompiledBranchOutsideMethodCode,
   kNotCompiledCannotBuildSSA,
   kNotCompiledHugeMethod,
@@ -91,6 +102,9 @@ class OptimizingCompilerStats {
       case kAttemptCompilation : name = "AttemptCompilation"; break;
       case kCompiled : name = "Compiled"; break;
       case kInlinedInvoke : name = "InlinedInvoke"; break;
+      case kInlinedMonomorphicCall : name = "InlinedMonomorphicCall"; break;
+      case kInlinedPolymorphicCall : name = "InlinedPolymorphicCall"; break;
+      case kInlinedSingleImplementationCall : name = "InlinedSingleImplementationCall"; break;
       case kInstructionSimplifications: name = "InstructionSimplifications"; break;
       case kInstructionSimplificationsArch: name = "InstructionSimplificationsArch"; break;
       case kUnresolvedMethod : name = "UnresolvedMethod"; break;
@@ -98,7 +112,15 @@ class OptimizingCompilerStats {
       case kUnresolvedFieldNotAFastAccess : name = "UnresolvedFieldNotAFastAccess"; break;
       case kRemovedCheckedCast: name = "RemovedCheckedCast"; break;
       case kRemovedDeadInstruction: name = "RemovedDeadInstruction"; break;
+      case kRemovedInstanceOf: name = "RemovedInstanceOf"; break;
       case kRemovedNullCheck: name = "RemovedNullCheck"; break;
+      case kSelectGenerated: name = "SelectGenerated"; break;
+      case kLoopFullyUnrolled: name = "LoopFullyUnrolled"; break;
+      case kLoopUnrolled: name = "LoopUnrolled"; break;
+      case kLoopPeeled: name = "LoopPeeled"; break;
+      case kInstructionSunk: name = "InstructionSunk"; break;
+      case kInstructionHoisted: name = "InstructionHoisted"; break;
+      case kRemovedPartialRedundancy: name = "RemovedPartialRedundancy"; break;
       case kNotCompiledBranchOutsideMethodCode: name = "NotCompiledBranchOutsideMethodCode"; break;
       case kNotCompiledCannotBuildSSA : name = "NotCompiledCannotBuildSSA"; break;
       case kNotCompiledHugeMethod : name = "NotCompiledHugeMethod"; break;
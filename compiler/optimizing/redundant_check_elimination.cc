@@ -0,0 +1,311 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "redundant_check_elimination.h"
+
+#include "base/arena_containers.h"
+#include "scoped_thread_state_change.h"
+
+namespace art {
+
+// What is known about an object at a given position of the method.
+enum class ObjectFactKind {
+  kNonNull,        // The object is not null.
+  kNull,           // The object is null.
+  kInstanceOf,     // The object is not null and is an instance of the class.
+  kCastTo,         // The object is null or an instance of the class.
+  kNotInstanceOf,  // The object is null or not an instance of the class.
+};
+
+struct ObjectFact {
+  HInstruction* object;
+  ObjectFactKind kind;
+  HLoadClass* klass;
+};
+
+// HNullCheck and HBoundType forward their input, so facts are recorded for the
+// object they refer to.
+static HInstruction* GetOriginalObject(HInstruction* instruction) {
+  while (instruction->IsNullCheck() || instruction->IsBoundType()) {
+    instruction = instruction->InputAt(0);
+  }
+  return instruction;
+}
+
+static bool IsSameClass(HLoadClass* lhs, HLoadClass* rhs) {
+  return lhs == rhs ||
+      (lhs->GetTypeIndex() == rhs->GetTypeIndex() &&
+       IsSameDexFile(lhs->GetDexFile(), rhs->GetDexFile()));
+}
+
+// Returns whether every instance of the class loaded by `sub` is an instance of the
+// class loaded by `super`.
+static bool IsSubclassOf(HLoadClass* sub, HLoadClass* super) {
+  if (IsSameClass(sub, super)) {
+    return true;
+  }
+  ScopedObjectAccess soa(Thread::Current());
+  ReferenceTypeInfo sub_rti = sub->GetLoadedClassRTI();
+  ReferenceTypeInfo super_rti = super->GetLoadedClassRTI();
+  return sub_rti.IsValid() && super_rti.IsValid() && super_rti.IsSupertypeOf(sub_rti);
+}
+
+// Returns whether the reference type of `object`, or of one of the instructions it
+// forwards, shows that it is an instance of `klass` when it is not null. The types
+// of instructions inlined from a callee may not have been refined since inlining,
+// so a bound type on the way may be more precise than the object itself.
+static bool HasTypeOf(HInstruction* object, HLoadClass* klass) {
+  ScopedObjectAccess soa(Thread::Current());
+  ReferenceTypeInfo class_rti = klass->GetLoadedClassRTI();
+  if (!class_rti.IsValid()) {
+    // Happens when the loaded class is unresolved.
+    return false;
+  }
+  for (HInstruction* current = object; ; current = current->InputAt(0)) {
+    ReferenceTypeInfo rti = current->GetReferenceTypeInfo();
+    if (rti.IsValid() && class_rti.IsSupertypeOf(rti)) {
+      return true;
+    }
+    if (!current->IsNullCheck() && !current->IsBoundType()) {
+      return false;
+    }
+  }
+}
+
+class RCEVisitor : public HGraphVisitor {
+ public:
+  RCEVisitor(HGraph* graph, OptimizingCompilerStats* stats)
+      : HGraphVisitor(graph),
+        stats_(stats),
+        facts_(graph->GetArena()->Adapter(kArenaAllocOptimization)) {}
+
+  // Visits the blocks in a depth-first order of the dominator tree, so that the
+  // facts of a block are only seen by the blocks it dominates.
+  void VisitDominatorTree() {
+    ArenaVector<std::pair<HBasicBlock*, size_t>> worklist(
+        GetGraph()->GetArena()->Adapter(kArenaAllocOptimization));
+    worklist.push_back(std::make_pair(GetGraph()->GetEntryBlock(), 0u));
+    while (!worklist.empty()) {
+      HBasicBlock* block = worklist.back().first;
+      size_t number_of_dominating_facts = worklist.back().second;
+      worklist.pop_back();
+      // Drop the facts of the blocks visited since the dominator of `block`.
+      facts_.erase(facts_.begin() + number_of_dominating_facts, facts_.end());
+
+      AddBranchFacts(block);
+      for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+        it.Current()->Accept(this);
+      }
+      for (HBasicBlock* dominated : block->GetDominatedBlocks()) {
+        worklist.push_back(std::make_pair(dominated, facts_.size()));
+      }
+    }
+  }
+
+  void VisitNullCheck(HNullCheck* null_check) OVERRIDE {
+    HInstruction* object = null_check->InputAt(0);
+    if (IsKnownNonNull(object)) {
+      null_check->ReplaceWith(object);
+      null_check->GetBlock()->RemoveInstruction(null_check);
+      RecordStat(MethodCompilationStat::kRemovedNullCheck);
+    } else {
+      AddFact(object, ObjectFactKind::kNonNull, nullptr);
+    }
+  }
+
+  void VisitCheckCast(HCheckCast* check_cast) OVERRIDE {
+    HInstruction* object = check_cast->InputAt(0);
+    HLoadClass* load_class = check_cast->InputAt(1)->AsLoadClass();
+    if (!load_class->NeedsAccessCheck()) {
+      bool outcome;
+      bool is_null = IsKnownNull(object);
+      if (is_null || (TypeCheckHasKnownOutcome(object, load_class, &outcome) && outcome)) {
+        check_cast->GetBlock()->RemoveInstruction(check_cast);
+        RecordStat(MethodCompilationStat::kRemovedCheckedCast);
+        if (!is_null && !load_class->HasUses()) {
+          // The object is an instance of the class or of one of its subclasses, hence
+          // the class was already loaded.
+          load_class->GetBlock()->RemoveInstruction(load_class);
+        }
+        return;
+      }
+      if (IsKnownNonNull(object)) {
+        check_cast->ClearMustDoNullCheck();
+      }
+    }
+    AddFact(object, ObjectFactKind::kCastTo, load_class);
+  }
+
+  void VisitInstanceOf(HInstanceOf* instance_of) OVERRIDE {
+    HInstruction* object = instance_of->InputAt(0);
+    HLoadClass* load_class = instance_of->InputAt(1)->AsLoadClass();
+    if (load_class->NeedsAccessCheck()) {
+      // If we need to perform an access check we cannot remove the instruction.
+      return;
+    }
+    bool is_non_null = IsKnownNonNull(object);
+    if (is_non_null) {
+      instance_of->ClearMustDoNullCheck();
+    }
+
+    HGraph* graph = GetGraph();
+    HInstruction* replacement = nullptr;
+    bool outcome = false;
+    if (IsKnownNull(object)) {
+      replacement = graph->GetIntConstant(0);
+    } else if (TypeCheckHasKnownOutcome(object, load_class, &outcome)) {
+      if (!outcome) {
+        replacement = graph->GetIntConstant(0);
+      } else if (is_non_null) {
+        replacement = graph->GetIntConstant(1);
+      } else {
+        // Type test will succeed, we just need a null test.
+        replacement = new (graph->GetArena()) HNotEqual(graph->GetNullConstant(), object);
+        instance_of->GetBlock()->InsertInstructionBefore(replacement, instance_of);
+      }
+    }
+    if (replacement == nullptr) {
+      return;
+    }
+    instance_of->ReplaceWith(replacement);
+    instance_of->GetBlock()->RemoveInstruction(instance_of);
+    RecordStat(MethodCompilationStat::kRemovedInstanceOf);
+    if (outcome && !load_class->HasUses()) {
+      // We cannot rely on DCE to remove the class because the `HLoadClass` thinks it can throw.
+      load_class->GetBlock()->RemoveInstruction(load_class);
+    }
+  }
+
+ private:
+  void AddFact(HInstruction* object, ObjectFactKind kind, HLoadClass* klass) {
+    facts_.push_back(ObjectFact { GetOriginalObject(object), kind, klass });
+  }
+
+  // Records the facts established by the branch leading to `block`. Critical
+  // edges are split, so an HIf always branches to blocks with a single predecessor.
+  void AddBranchFacts(HBasicBlock* block) {
+    if (block->GetPredecessors().size() != 1u) {
+      return;
+    }
+    HIf* if_instruction = block->GetSinglePredecessor()->GetLastInstruction()->AsIf();
+    if (if_instruction == nullptr) {
+      return;
+    }
+    bool is_true_branch = (if_instruction->IfTrueSuccessor() == block);
+    HInstruction* condition = if_instruction->InputAt(0);
+    if (condition->IsBooleanNot()) {
+      condition = condition->InputAt(0);
+      is_true_branch = !is_true_branch;
+    }
+
+    if (condition->IsEqual() || condition->IsNotEqual()) {
+      HInstruction* lhs = condition->InputAt(0);
+      HInstruction* rhs = condition->InputAt(1);
+      HInstruction* object = nullptr;
+      if (rhs->IsNullConstant()) {
+        object = lhs;
+      } else if (lhs->IsNullConstant()) {
+        object = rhs;
+      } else {
+        return;
+      }
+      bool is_null = (condition->IsEqual() == is_true_branch);
+      AddFact(object, is_null ? ObjectFactKind::kNull : ObjectFactKind::kNonNull, nullptr);
+    } else if (condition->IsInstanceOf()) {
+      AddFact(condition->InputAt(0),
+              is_true_branch ? ObjectFactKind::kInstanceOf : ObjectFactKind::kNotInstanceOf,
+              condition->InputAt(1)->AsLoadClass());
+    }
+  }
+
+  bool IsKnownNonNull(HInstruction* object) const {
+    for (HInstruction* current = object; ; current = current->InputAt(0)) {
+      if (!current->CanBeNull()) {
+        return true;
+      }
+      if (!current->IsNullCheck() && !current->IsBoundType()) {
+        break;
+      }
+    }
+    HInstruction* original = GetOriginalObject(object);
+    for (const ObjectFact& fact : facts_) {
+      if (fact.object == original &&
+          (fact.kind == ObjectFactKind::kNonNull || fact.kind == ObjectFactKind::kInstanceOf)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool IsKnownNull(HInstruction* object) const {
+    HInstruction* original = GetOriginalObject(object);
+    if (original->IsNullConstant()) {
+      return true;
+    }
+    for (const ObjectFact& fact : facts_) {
+      if (fact.object == original && fact.kind == ObjectFactKind::kNull) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Returns whether testing `object` against `klass` has a known outcome when `object`
+  // is not null. The outcome is stored in `outcome`.
+  bool TypeCheckHasKnownOutcome(HInstruction* object, HLoadClass* klass, bool* outcome) const {
+    HInstruction* original = GetOriginalObject(object);
+    for (const ObjectFact& fact : facts_) {
+      if (fact.object != original || fact.klass == nullptr) {
+        continue;
+      }
+      if (fact.kind == ObjectFactKind::kNotInstanceOf) {
+        if (IsSubclassOf(klass, fact.klass)) {
+          *outcome = false;
+          return true;
+        }
+      } else if (IsSubclassOf(fact.klass, klass)) {
+        *outcome = true;
+        return true;
+      }
+    }
+    if (HasTypeOf(object, klass)) {
+      *outcome = true;
+      return true;
+    }
+    return false;
+  }
+
+  void RecordStat(MethodCompilationStat stat) {
+    if (stats_ != nullptr) {
+      stats_->RecordStat(stat);
+    }
+  }
+
+  OptimizingCompilerStats* const stats_;
+
+  // The facts holding at the current position, starting with those established by
+  // the dominators of the current block.
+  ArenaVector<ObjectFact> facts_;
+
+  DISALLOW_COPY_AND_ASSIGN(RCEVisitor);
+};
+
+void RedundantCheckElimination::Run() {
+  RCEVisitor visitor(graph_, stats_);
+  visitor.VisitDominatorTree();
+}
+
+}  // namespace art
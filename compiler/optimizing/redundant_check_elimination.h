@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * This optimization removes HNullCheck, HCheckCast and HInstanceOf
+ * instructions whose outcome is implied by a dominating check on the same
+ * object:
+ *
+ *     B1:
+ *       z3  NotEqual [ l1 l2 ]      (l2 is the null constant)
+ *       v4  If [ z3 ] then B2 else B3
+ *     B2:
+ *       l5  NullCheck [ l1 ]
+ *       i6  InstanceFieldGet [ l5 ]
+ *
+ * turns into
+ *
+ *     B2:
+ *       i6  InstanceFieldGet [ l1 ]
+ *
+ * The facts come from the branches of HIf instructions testing an object
+ * against null or with HInstanceOf, and from the HNullCheck and HCheckCast
+ * instructions themselves. They are collected while walking the dominator
+ * tree, so a fact holds for every block dominated by the edge or the
+ * instruction which established it.
+ *
+ * Reference type propagation only narrows the uses it sees when it runs, so
+ * the checks of inlined callees are not refined by the branches of their
+ * caller. This pass looks through HBoundType and HNullCheck to the object
+ * they refer to, which makes it independent of the types computed before
+ * inlining.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_REDUNDANT_CHECK_ELIMINATION_H_
+#define ART_COMPILER_OPTIMIZING_REDUNDANT_CHECK_ELIMINATION_H_
+
+#include "optimization.h"
+
+namespace art {
+
+class RedundantCheckElimination : public HOptimization {
+ public:
+  RedundantCheckElimination(HGraph* graph, OptimizingCompilerStats* stats)
+      : HOptimization(graph, kRedundantCheckEliminationPassName, stats) {}
+
+  void Run() OVERRIDE;
+
+  static constexpr const char* kRedundantCheckEliminationPassName =
+      "redundant_check_elimination";
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(RedundantCheckElimination);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_REDUNDANT_CHECK_ELIMINATION_H_
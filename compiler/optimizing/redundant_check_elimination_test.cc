@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/arena_allocator.h"
+#include "nodes.h"
+#include "optimizing_unit_test.h"
+#include "redundant_check_elimination.h"
+
+#include "gtest/gtest.h"
+
+namespace art {
+
+class RedundantCheckEliminationTest : public testing::Test {
+ public:
+  RedundantCheckEliminationTest() : pool_(), allocator_(&pool_) {
+    graph_ = CreateGraph(&allocator_);
+    entry_ = new (&allocator_) HBasicBlock(graph_);
+    graph_->AddBlock(entry_);
+    graph_->SetEntryBlock(entry_);
+    parameter_ = new (&allocator_) HParameterValue(graph_->GetDexFile(),
+                                                   0,
+                                                   0,
+                                                   Primitive::kPrimNot);
+    entry_->AddInstruction(parameter_);
+    flag_ = new (&allocator_) HParameterValue(graph_->GetDexFile(),
+                                              0,
+                                              1,
+                                              Primitive::kPrimBoolean);
+    entry_->AddInstruction(flag_);
+  }
+
+  // Builds a diamond branching on `condition`, which is added to the branching
+  // block unless it is a parameter.
+  void BuildDiamond(HInstruction* condition) {
+    block_ = new (&allocator_) HBasicBlock(graph_);
+    then_ = new (&allocator_) HBasicBlock(graph_);
+    else_ = new (&allocator_) HBasicBlock(graph_);
+    join_ = new (&allocator_) HBasicBlock(graph_);
+    graph_->AddBlock(block_);
+    graph_->AddBlock(then_);
+    graph_->AddBlock(else_);
+    graph_->AddBlock(join_);
+    entry_->AddSuccessor(block_);
+    block_->AddSuccessor(then_);
+    block_->AddSuccessor(else_);
+    then_->AddSuccessor(join_);
+    else_->AddSuccessor(join_);
+
+    if (condition->GetBlock() == nullptr) {
+      block_->AddInstruction(condition);
+    }
+    block_->AddInstruction(new (&allocator_) HIf(condition));
+    then_->AddInstruction(new (&allocator_) HGoto());
+    else_->AddInstruction(new (&allocator_) HGoto());
+    join_->AddInstruction(new (&allocator_) HExit());
+  }
+
+  // Inserts a null check of `parameter_` at the start of `block`.
+  HInstruction* AddNullCheck(HBasicBlock* block) {
+    HInstruction* null_check = new (&allocator_) HNullCheck(parameter_, 0);
+    block->InsertInstructionBefore(null_check, block->GetFirstInstruction());
+    return null_check;
+  }
+
+  void RunPass() {
+    graph_->TryBuildingSsa();
+    RedundantCheckElimination(graph_, nullptr).Run();
+  }
+
+  ArenaPool pool_;
+  ArenaAllocator allocator_;
+  HGraph* graph_;
+
+  HBasicBlock* entry_;
+  HBasicBlock* block_;
+  HBasicBlock* then_;
+  HBasicBlock* else_;
+  HBasicBlock* join_;
+  HInstruction* parameter_;
+  HInstruction* flag_;
+};
+
+// A null check on the branch where the object was tested against null is removed.
+TEST_F(RedundantCheckEliminationTest, NullCheckAfterNullTest) {
+  BuildDiamond(new (&allocator_) HNotEqual(parameter_, graph_->GetNullConstant()));
+  HInstruction* then_check = AddNullCheck(then_);
+  HInstruction* else_check = AddNullCheck(else_);
+  RunPass();
+
+  ASSERT_TRUE(then_check->GetBlock() == nullptr);
+  ASSERT_EQ(else_check->GetBlock(), else_);
+}
+
+// The same holds when the test is negated.
+TEST_F(RedundantCheckEliminationTest, NullCheckAfterNegatedNullTest) {
+  BuildDiamond(new (&allocator_) HEqual(parameter_, graph_->GetNullConstant()));
+  HInstruction* then_check = AddNullCheck(then_);
+  HInstruction* else_check = AddNullCheck(else_);
+  RunPass();
+
+  ASSERT_EQ(then_check->GetBlock(), then_);
+  ASSERT_TRUE(else_check->GetBlock() == nullptr);
+}
+
+// A null check dominated by another null check of the same object is removed,
+// and its users use the object directly.
+TEST_F(RedundantCheckEliminationTest, NullCheckAfterNullCheck) {
+  BuildDiamond(flag_);
+  HInstruction* dominating_check = AddNullCheck(block_);
+  HInstruction* then_check = AddNullCheck(then_);
+  HInstruction* user = new (&allocator_) HNotEqual(then_check, graph_->GetNullConstant());
+  then_->InsertInstructionBefore(user, then_->GetLastInstruction());
+  HInstruction* join_check = AddNullCheck(join_);
+  RunPass();
+
+  ASSERT_EQ(dominating_check->GetBlock(), block_);
+  ASSERT_TRUE(then_check->GetBlock() == nullptr);
+  ASSERT_TRUE(join_check->GetBlock() == nullptr);
+  ASSERT_EQ(user->InputAt(0), parameter_);
+}
+
+// A null check on one branch says nothing about the code after the merge.
+TEST_F(RedundantCheckEliminationTest, NullCheckOnOneBranch) {
+  BuildDiamond(flag_);
+  HInstruction* then_check = AddNullCheck(then_);
+  HInstruction* join_check = AddNullCheck(join_);
+  RunPass();
+
+  ASSERT_EQ(then_check->GetBlock(), then_);
+  ASSERT_EQ(join_check->GetBlock(), join_);
+}
+
+}  // namespace art
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * This optimization recognizes small diamonds whose only purpose is to pick
+ * one of two values, and replaces them with a branchless HSelect:
+ *
+ *     B1:
+ *       z1  Condition
+ *       v2  If [ z1 ] then B2 else B3
+ *     B2:
+ *       i3  Add [ i5 i6 ]
+ *       v4  Goto B4
+ *     B3:
+ *       v7  Goto B4
+ *     B4:
+ *       i8  Phi [ i3 i9 ]
+ *
+ * turns into
+ *
+ *     B1:
+ *       z1  Condition
+ *       i3  Add [ i5 i6 ]
+ *       i8  Select [ i9 i3 z1 ]
+ *
+ * Each branch may compute at most one value, provided it is cheap, cannot
+ * throw and has no side effects, since it gets executed unconditionally.
+ * Boolean selections are left to HBooleanSimplifier, which should run first.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_SELECT_GENERATOR_H_
+#define ART_COMPILER_OPTIMIZING_SELECT_GENERATOR_H_
+
+#include "optimization.h"
+
+namespace art {
+
+class HSelectGenerator : public HOptimization {
+ public:
+  HSelectGenerator(HGraph* graph, OptimizingCompilerStats* stats)
+    : HOptimization(graph, kSelectGeneratorPassName, stats) {}
+
+  void Run() OVERRIDE;
+
+  static constexpr const char* kSelectGeneratorPassName = "select_generator";
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(HSelectGenerator);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_SELECT_GENERATOR_H_
@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "base/arena_allocator.h"
+#include "graph_checker.h"
+#include "gtest/gtest.h"
+#include "instruction_simplifier.h"
+#include "nodes.h"
+#include "optimizing_unit_test.h"
+#include "select_generator.h"
+
+namespace art {
+
+/**
+ * Fixture class for the select generator tests.
+ */
+class SelectGeneratorTest : public testing::Test {
+ public:
+  SelectGeneratorTest() : pool_(), allocator_(&pool_) {
+    graph_ = CreateGraph(&allocator_);
+  }
+
+  ~SelectGeneratorTest() { }
+
+  // Builds the diamond
+  //
+  //   value = condition ? true_value : false_value;
+  //   return value;
+  //
+  // where the values are parameters of type `type` and the condition compares two
+  // int parameters. Tests can replace the phi inputs or add instructions to the
+  // branches before running the passes.
+  void BuildDiamond(Primitive::Type type) {
+    entry_ = new (&allocator_) HBasicBlock(graph_);
+    if_block_ = new (&allocator_) HBasicBlock(graph_);
+    true_block_ = new (&allocator_) HBasicBlock(graph_);
+    false_block_ = new (&allocator_) HBasicBlock(graph_);
+    merge_ = new (&allocator_) HBasicBlock(graph_);
+    exit_ = new (&allocator_) HBasicBlock(graph_);
+    for (HBasicBlock* block : { entry_, if_block_, true_block_, false_block_, merge_, exit_ }) {
+      graph_->AddBlock(block);
+    }
+    graph_->SetEntryBlock(entry_);
+    graph_->SetExitBlock(exit_);
+    entry_->AddSuccessor(if_block_);
+    if_block_->AddSuccessor(true_block_);
+    if_block_->AddSuccessor(false_block_);
+    true_block_->AddSuccessor(merge_);
+    false_block_->AddSuccessor(merge_);
+    merge_->AddSuccessor(exit_);
+
+    lhs_ = new (&allocator_) HParameterValue(graph_->GetDexFile(), 0, 0, Primitive::kPrimInt);
+    rhs_ = new (&allocator_) HParameterValue(graph_->GetDexFile(), 0, 1, Primitive::kPrimInt);
+    true_value_ = new (&allocator_) HParameterValue(graph_->GetDexFile(), 0, 2, type);
+    false_value_ = new (&allocator_) HParameterValue(graph_->GetDexFile(), 0, 3, type);
+    for (HInstruction* parameter : { lhs_, rhs_, true_value_, false_value_ }) {
+      entry_->AddInstruction(parameter);
+    }
+    entry_->AddInstruction(new (&allocator_) HGoto());
+
+    condition_ = new (&allocator_) HGreaterThan(lhs_, rhs_);
+    if_block_->AddInstruction(condition_);
+    if_ = new (&allocator_) HIf(condition_);
+    if_block_->AddInstruction(if_);
+    true_block_->AddInstruction(new (&allocator_) HGoto());
+    false_block_->AddInstruction(new (&allocator_) HGoto());
+
+    phi_ = new (&allocator_) HPhi(&allocator_, 0, 0, HPhi::ToPhiType(type));
+    merge_->AddPhi(phi_);
+    phi_->AddInput(true_value_);
+    phi_->AddInput(false_value_);
+    return_ = new (&allocator_) HReturn(phi_);
+    merge_->AddInstruction(return_);
+    exit_->AddInstruction(new (&allocator_) HExit());
+  }
+
+  // Runs the select generator, followed by the instruction simplifier if
+  // `simplify`, and checks that the graph is still valid.
+  void PerformSelectGeneration(bool simplify = false) {
+    graph_->BuildDominatorTree();
+    HSelectGenerator(graph_, nullptr).Run();
+    if (simplify) {
+      InstructionSimplifier(graph_).Run();
+    }
+    SSAChecker checker(graph_);
+    checker.Run();
+    ASSERT_TRUE(checker.IsValid());
+  }
+
+  // Checks that the diamond became a select of `true_value` and `false_value`
+  // on `condition`, returned from the block that held the If.
+  void ExpectSelect(HInstruction* condition,
+                    HInstruction* true_value,
+                    HInstruction* false_value) {
+    HInstruction* select = return_->InputAt(0);
+    ASSERT_TRUE(select->IsSelect());
+    EXPECT_EQ(phi_->GetType(), select->GetType());
+    EXPECT_EQ(condition, select->AsSelect()->GetCondition());
+    EXPECT_EQ(true_value, select->AsSelect()->GetTrueValue());
+    EXPECT_EQ(false_value, select->AsSelect()->GetFalseValue());
+    EXPECT_EQ(if_block_, select->GetBlock());
+    EXPECT_EQ(if_block_, return_->GetBlock());
+    EXPECT_FALSE(if_block_->EndsWithIf());
+    EXPECT_TRUE(graph_->GetBlocks()[true_block_->GetBlockId()] == nullptr);
+  }
+
+  // Checks that the diamond was left alone.
+  void ExpectNoSelect() {
+    EXPECT_EQ(phi_, return_->InputAt(0));
+    EXPECT_EQ(merge_, return_->GetBlock());
+    EXPECT_TRUE(if_block_->EndsWithIf());
+  }
+
+  ArenaPool pool_;
+  ArenaAllocator allocator_;
+  HGraph* graph_;
+
+  HBasicBlock* entry_;
+  HBasicBlock* if_block_;
+  HBasicBlock* true_block_;
+  HBasicBlock* false_block_;
+  HBasicBlock* merge_;
+  HBasicBlock* exit_;
+
+  HInstruction* lhs_;
+  HInstruction* rhs_;
+  HInstruction* true_value_;
+  HInstruction* false_value_;
+  HInstruction* condition_;
+  HIf* if_;
+  HPhi* phi_;
+  HReturn* return_;
+};
+
+//
+// The actual select generator tests.
+//
+
+TEST_F(SelectGeneratorTest, IntSelect) {
+  BuildDiamond(Primitive::kPrimInt);
+  PerformSelectGeneration();
+  ExpectSelect(condition_, true_value_, false_value_);
+}
+
+TEST_F(SelectGeneratorTest, LongSelect) {
+  BuildDiamond(Primitive::kPrimLong);
+  PerformSelectGeneration();
+  ExpectSelect(condition_, true_value_, false_value_);
+}
+
+TEST_F(SelectGeneratorTest, FloatSelect) {
+  BuildDiamond(Primitive::kPrimFloat);
+  PerformSelectGeneration();
+  ExpectSelect(condition_, true_value_, false_value_);
+}
+
+TEST_F(SelectGeneratorTest, DoubleSelect) {
+  BuildDiamond(Primitive::kPrimDouble);
+  PerformSelectGeneration();
+  ExpectSelect(condition_, true_value_, false_value_);
+}
+
+TEST_F(SelectGeneratorTest, MovesCheapInstruction) {
+  BuildDiamond(Primitive::kPrimInt);
+  HInstruction* add = new (&allocator_) HAdd(Primitive::kPrimInt, true_value_, false_value_);
+  true_block_->InsertInstructionBefore(add, true_block_->GetLastInstruction());
+  phi_->ReplaceInput(add, 0);
+  PerformSelectGeneration();
+
+  // The add now executes unconditionally, before the select.
+  ExpectSelect(condition_, add, false_value_);
+  EXPECT_EQ(if_block_, add->GetBlock());
+  EXPECT_TRUE(add->StrictlyDominates(return_->InputAt(0)));
+}
+
+TEST_F(SelectGeneratorTest, NoSelectWithTwoInstructions) {
+  BuildDiamond(Primitive::kPrimInt);
+  HInstruction* add = new (&allocator_) HAdd(Primitive::kPrimInt, true_value_, false_value_);
+  true_block_->InsertInstructionBefore(add, true_block_->GetLastInstruction());
+  HInstruction* sub = new (&allocator_) HSub(Primitive::kPrimInt, add, false_value_);
+  true_block_->InsertInstructionBefore(sub, true_block_->GetLastInstruction());
+  phi_->ReplaceInput(sub, 0);
+  PerformSelectGeneration();
+
+  ExpectNoSelect();
+  EXPECT_EQ(true_block_, add->GetBlock());
+}
+
+TEST_F(SelectGeneratorTest, NoSelectWithThrowingInstruction) {
+  BuildDiamond(Primitive::kPrimInt);
+  HInstruction* check = new (&allocator_) HDivZeroCheck(true_value_, 0);
+  true_block_->InsertInstructionBefore(check, true_block_->GetLastInstruction());
+  phi_->ReplaceInput(check, 0);
+  PerformSelectGeneration();
+
+  ExpectNoSelect();
+  EXPECT_EQ(true_block_, check->GetBlock());
+}
+
+TEST_F(SelectGeneratorTest, NoSelectWithTwoPhis) {
+  BuildDiamond(Primitive::kPrimInt);
+  HPhi* other_phi = new (&allocator_) HPhi(&allocator_, 1, 0, Primitive::kPrimInt);
+  merge_->AddPhi(other_phi);
+  other_phi->AddInput(false_value_);
+  other_phi->AddInput(true_value_);
+  HInstruction* add = new (&allocator_) HAdd(Primitive::kPrimInt, phi_, other_phi);
+  merge_->InsertInstructionBefore(add, return_);
+  return_->ReplaceInput(add, 0);
+  PerformSelectGeneration();
+
+  EXPECT_EQ(merge_, add->GetBlock());
+  EXPECT_TRUE(if_block_->EndsWithIf());
+}
+
+//
+// Simplifications of the generated selects.
+//
+
+TEST_F(SelectGeneratorTest, SimplifySameValues) {
+  BuildDiamond(Primitive::kPrimLong);
+  phi_->ReplaceInput(false_value_, 0);
+  PerformSelectGeneration(/* simplify */ true);
+
+  // (condition ? x : x) is x.
+  EXPECT_EQ(false_value_, return_->InputAt(0));
+  EXPECT_EQ(if_block_, return_->GetBlock());
+}
+
+TEST_F(SelectGeneratorTest, SimplifyConstantCondition) {
+  BuildDiamond(Primitive::kPrimInt);
+  if_->ReplaceInput(graph_->GetIntConstant(1), 0);
+  PerformSelectGeneration(/* simplify */ true);
+
+  // (true ? x : y) is x.
+  EXPECT_EQ(true_value_, return_->InputAt(0));
+}
+
+TEST_F(SelectGeneratorTest, SimplifyNegatedCondition) {
+  BuildDiamond(Primitive::kPrimFloat);
+  HInstruction* negated = new (&allocator_) HBooleanNot(condition_);
+  if_block_->InsertInstructionBefore(negated, if_);
+  if_->ReplaceInput(negated, 0);
+  PerformSelectGeneration(/* simplify */ true);
+
+  // (!condition ? x : y) is (condition ? y : x).
+  HInstruction* select = return_->InputAt(0);
+  ASSERT_TRUE(select->IsSelect());
+  EXPECT_EQ(condition_, select->AsSelect()->GetCondition());
+  EXPECT_EQ(false_value_, select->AsSelect()->GetTrueValue());
+  EXPECT_EQ(true_value_, select->AsSelect()->GetFalseValue());
+}
+
+}  // namespace art
@@ -56,6 +56,11 @@ void StackMapStream::BeginStackMapEntry(uint32_t dex_pc,
 
 void StackMapStream::EndStackMapEntry() {
   current_entry_.same_dex_register_map_as_ = FindEntryWithTheSameDexMap();
+  if (recording_catch_stack_maps_) {
+    DCHECK(number_of_catch_stack_maps_ == 0u ||
+           stack_maps_.back().dex_pc <= current_entry_.dex_pc);
+    ++number_of_catch_stack_maps_;
+  }
   stack_maps_.push_back(current_entry_);
   current_entry_ = StackMapEntry();
 }
@@ -136,32 +141,98 @@ uint32_t StackMapStream::ComputeMaxNativePcOffset() const {
   return max_native_pc_offset;
 }
 
+void StackMapStream::PrepareRegisterMasks() {
+  register_masks_.clear();
+  ArenaSafeMap<uint32_t, uint32_t> register_mask_indices(
+      std::less<uint32_t>(), allocator_->Adapter(kArenaAllocStackMapStream));
+  for (StackMapEntry& entry : stack_maps_) {
+    auto it = register_mask_indices.find(entry.register_mask);
+    if (it == register_mask_indices.end()) {
+      it = register_mask_indices.Put(entry.register_mask, register_masks_.size());
+      register_masks_.push_back(entry.register_mask);
+    }
+    entry.register_mask_index = it->second;
+  }
+}
+
+void StackMapStream::PrepareStackMasks(size_t entry_size_in_bytes) {
+  stack_masks_.clear();
+  stack_mask_hash_to_indices_.clear();
+  number_of_stack_masks_ = 0;
+  for (StackMapEntry& entry : stack_maps_) {
+    // Tentatively append the mask of `entry` to the table, and drop it again if an
+    // identical mask is already there.
+    size_t offset = stack_masks_.size();
+    stack_masks_.resize(offset + entry_size_in_bytes, 0u);
+    if (entry.sp_mask != nullptr && entry_size_in_bytes != 0u) {
+      entry.sp_mask->CopyTo(&stack_masks_[offset], entry_size_in_bytes);
+    }
+    uint32_t hash = 0u;
+    for (size_t i = 0; i != entry_size_in_bytes; ++i) {
+      hash = hash * 31u + stack_masks_[offset + i];
+    }
+    auto it = stack_mask_hash_to_indices_.find(hash);
+    if (it == stack_mask_hash_to_indices_.end()) {
+      it = stack_mask_hash_to_indices_.Put(
+          hash, ArenaVector<uint32_t>(allocator_->Adapter(kArenaAllocStackMapStream)));
+    }
+    entry.stack_mask_index = number_of_stack_masks_;
+    for (uint32_t index : it->second) {
+      if (std::equal(stack_masks_.begin() + offset,
+                     stack_masks_.end(),
+                     stack_masks_.begin() + index * entry_size_in_bytes)) {
+        entry.stack_mask_index = index;
+        break;
+      }
+    }
+    if (entry.stack_mask_index == number_of_stack_masks_) {
+      it->second.push_back(number_of_stack_masks_);
+      ++number_of_stack_masks_;
+    } else {
+      stack_masks_.resize(offset);
+    }
+  }
+}
+
 size_t StackMapStream::PrepareForFillIn() {
   int stack_mask_number_of_bits = stack_mask_max_ + 1;  // Need room for max element too.
   stack_mask_size_ = RoundUp(stack_mask_number_of_bits, kBitsPerByte) / kBitsPerByte;
   inline_info_size_ = ComputeInlineInfoSize();
   dex_register_maps_size_ = ComputeDexRegisterMapsSize();
   uint32_t max_native_pc_offset = ComputeMaxNativePcOffset();
+  PrepareRegisterMasks();
+  PrepareStackMasks(stack_mask_size_);
   stack_map_encoding_ = StackMapEncoding::CreateFromSizes(stack_mask_size_,
                                                           inline_info_size_,
                                                           dex_register_maps_size_,
                                                           dex_pc_max_,
                                                           max_native_pc_offset,
-                                                          register_mask_max_);
-  stack_maps_size_ = stack_maps_.size() * stack_map_encoding_.ComputeStackMapSize();
+                                                          register_mask_max_,
+                                                          register_masks_.size(),
+                                                          number_of_stack_masks_);
+  stack_maps_size_ = RoundUp(stack_maps_.size() * stack_map_encoding_.ComputeStackMapSizeInBits(),
+                             kBitsPerByte) / kBitsPerByte;
+  register_masks_size_ = RoundUp(
+      register_masks_.size() * stack_map_encoding_.NumberOfBitsForRegisterMask(),
+      kBitsPerByte) / kBitsPerByte;
+  stack_masks_size_ = stack_masks_.size();
   dex_register_location_catalog_size_ = ComputeDexRegisterLocationCatalogSize();
 
   // Note: use RoundUp to word-size here if you want CodeInfo objects to be word aligned.
   needed_size_ = CodeInfo::kFixedSize
       + stack_maps_size_
+      + register_masks_size_
+      + stack_masks_size_
       + dex_register_location_catalog_size_
       + dex_register_maps_size_
       + inline_info_size_;
 
   stack_maps_start_ = CodeInfo::kFixedSize;
+  register_masks_start_ = stack_maps_start_ + stack_maps_size_;
+  stack_masks_start_ = register_masks_start_ + register_masks_size_;
   // TODO: Move the catalog at the end. It is currently too expensive at runtime
   // to compute its size (note that we do not encode that size in the CodeInfo).
-  dex_register_location_catalog_start_ = stack_maps_start_ + stack_maps_size_;
+  dex_register_location_catalog_start_ = stack_masks_start_ + stack_masks_size_;
   dex_register_maps_start_ =
       dex_register_location_catalog_start_ + dex_register_location_catalog_size_;
   inline_infos_start_ = dex_register_maps_start_ + dex_register_maps_size_;
@@ -224,6 +295,18 @@ size_t StackMapStream::ComputeInlineInfoSize() const {
     + (number_of_stack_maps_with_inline_info_ * InlineInfo::kFixedSize);
 }
 
+size_t StackMapStream::ComputeNumberOfSortedStackMaps() const {
+  if (stack_maps_.empty()) {
+    return 0u;
+  }
+  size_t i = 1;
+  while (i < stack_maps_.size() &&
+         stack_maps_[i - 1].native_pc_offset <= stack_maps_[i].native_pc_offset) {
+    ++i;
+  }
+  return i;
+}
+
 void StackMapStream::FillIn(MemoryRegion region) {
   DCHECK_EQ(0u, current_entry_.dex_pc) << "EndStackMapEntry not called after BeginStackMapEntry";
   DCHECK_NE(0u, needed_size_) << "PrepareForFillIn not called before FillIn";
@@ -240,7 +323,23 @@ void StackMapStream::FillIn(MemoryRegion region) {
 
   code_info.SetEncoding(stack_map_encoding_);
   code_info.SetNumberOfStackMaps(stack_maps_.size());
+  code_info.SetNumberOfSortedStackMaps(ComputeNumberOfSortedStackMaps());
+  code_info.SetNumberOfCatchStackMaps(number_of_catch_stack_maps_);
+  code_info.SetNumberOfRegisterMasks(register_masks_.size());
+  code_info.SetNumberOfStackMasks(number_of_stack_masks_);
   DCHECK_EQ(code_info.GetStackMapsSize(code_info.ExtractEncoding()), stack_maps_size_);
+  DCHECK_EQ(code_info.GetStackMasksOffset(stack_map_encoding_), stack_masks_start_);
+
+  // Clear the bit-packed tables so that padding bits are deterministic.
+  memset(region.start() + stack_maps_start_, 0, stack_maps_size_ + register_masks_size_);
+
+  // Set the deduplicated register masks and stack masks.
+  for (size_t i = 0, e = register_masks_.size(); i < e; ++i) {
+    code_info.SetRegisterMaskAt(i, stack_map_encoding_, register_masks_[i]);
+  }
+  if (stack_masks_size_ != 0u) {
+    memcpy(region.start() + stack_masks_start_, stack_masks_.data(), stack_masks_size_);
+  }
 
   // Set the Dex register location catalog.
   code_info.SetNumberOfLocationCatalogEntries(location_catalog_entries_.size());
@@ -265,10 +364,8 @@ void StackMapStream::FillIn(MemoryRegion region) {
 
     stack_map.SetDexPc(stack_map_encoding_, entry.dex_pc);
     stack_map.SetNativePcOffset(stack_map_encoding_, entry.native_pc_offset);
-    stack_map.SetRegisterMask(stack_map_encoding_, entry.register_mask);
-    if (entry.sp_mask != nullptr) {
-      stack_map.SetStackMask(stack_map_encoding_, *entry.sp_mask);
-    }
+    stack_map.SetRegisterMaskIndex(stack_map_encoding_, entry.register_mask_index);
+    stack_map.SetStackMaskIndex(stack_map_encoding_, entry.stack_mask_index);
 
     if (entry.num_dex_registers == 0) {
       // No dex map available.
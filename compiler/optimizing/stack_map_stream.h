@@ -66,10 +66,17 @@ class StackMapStream : public ValueObject {
         location_catalog_entries_indices_(allocator->Adapter(kArenaAllocStackMapStream)),
         dex_register_locations_(allocator->Adapter(kArenaAllocStackMapStream)),
         inline_infos_(allocator->Adapter(kArenaAllocStackMapStream)),
+        register_masks_(allocator->Adapter(kArenaAllocStackMapStream)),
+        stack_masks_(allocator->Adapter(kArenaAllocStackMapStream)),
+        stack_mask_hash_to_indices_(std::less<uint32_t>(),
+                                    allocator->Adapter(kArenaAllocStackMapStream)),
+        number_of_stack_masks_(0),
         stack_mask_max_(-1),
         dex_pc_max_(0),
         register_mask_max_(0),
         number_of_stack_maps_with_inline_info_(0),
+        recording_catch_stack_maps_(false),
+        number_of_catch_stack_maps_(0),
         dex_map_hash_to_stack_map_indices_(std::less<uint32_t>(),
                                            allocator->Adapter(kArenaAllocStackMapStream)),
         current_entry_(),
@@ -78,9 +85,13 @@ class StackMapStream : public ValueObject {
         inline_info_size_(0),
         dex_register_maps_size_(0),
         stack_maps_size_(0),
+        register_masks_size_(0),
+        stack_masks_size_(0),
         dex_register_location_catalog_size_(0),
         dex_register_location_catalog_start_(0),
         stack_maps_start_(0),
+        register_masks_start_(0),
+        stack_masks_start_(0),
         dex_register_maps_start_(0),
         inline_infos_start_(0),
         needed_size_(0),
@@ -105,6 +116,8 @@ class StackMapStream : public ValueObject {
     BitVector* live_dex_registers_mask;
     uint32_t dex_register_map_hash;
     size_t same_dex_register_map_as_;
+    uint32_t register_mask_index;
+    uint32_t stack_mask_index;
   };
 
   struct InlineInfoEntry {
@@ -124,6 +137,14 @@ class StackMapStream : public ValueObject {
                           uint8_t inlining_depth);
   void EndStackMapEntry();
 
+  // All stack maps recorded after this call are catch block entries. They must be the last
+  // stack maps of the method, recorded in increasing dex pc order, so that the runtime can
+  // binary search them.
+  void BeginCatchStackMaps() {
+    DCHECK(!recording_catch_stack_maps_);
+    recording_catch_stack_maps_ = true;
+  }
+
   void AddDexRegisterEntry(DexRegisterLocation::Kind kind, int32_t value);
 
   void BeginInlineInfoEntry(uint32_t method_index,
@@ -157,6 +178,14 @@ class StackMapStream : public ValueObject {
                                    const BitVector* live_dex_registers_mask) const;
   size_t ComputeDexRegisterMapsSize() const;
   size_t ComputeInlineInfoSize() const;
+  // Length of the longest prefix of stack maps sorted by native pc offset. Safepoints are
+  // recorded in code order, catch block entries are appended after them.
+  size_t ComputeNumberOfSortedStackMaps() const;
+
+  // Fill the deduplicated register mask and stack mask tables, and record the index of
+  // the mask of each stack map in these tables.
+  void PrepareRegisterMasks();
+  void PrepareStackMasks(size_t entry_size_in_bytes);
 
   // Returns the index of an entry with the same dex register map as the current_entry,
   // or kNoSameDexMapFound if no such entry exists.
@@ -183,10 +212,18 @@ class StackMapStream : public ValueObject {
   // A set of concatenated maps of Dex register locations indices to `location_catalog_entries_`.
   ArenaVector<size_t> dex_register_locations_;
   ArenaVector<InlineInfoEntry> inline_infos_;
+  // The distinct register masks of the stack maps.
+  ArenaVector<uint32_t> register_masks_;
+  // The distinct stack masks of the stack maps, `stack_mask_size_` bytes each.
+  ArenaVector<uint8_t> stack_masks_;
+  ArenaSafeMap<uint32_t, ArenaVector<uint32_t>> stack_mask_hash_to_indices_;
+  size_t number_of_stack_masks_;
   int stack_mask_max_;
   uint32_t dex_pc_max_;
   uint32_t register_mask_max_;
   size_t number_of_stack_maps_with_inline_info_;
+  bool recording_catch_stack_maps_;
+  size_t number_of_catch_stack_maps_;
 
   ArenaSafeMap<uint32_t, ArenaVector<uint32_t>> dex_map_hash_to_stack_map_indices_;
 
@@ -197,9 +234,13 @@ class StackMapStream : public ValueObject {
   size_t inline_info_size_;
   size_t dex_register_maps_size_;
   size_t stack_maps_size_;
+  size_t register_masks_size_;
+  size_t stack_masks_size_;
   size_t dex_register_location_catalog_size_;
   size_t dex_register_location_catalog_start_;
   size_t stack_maps_start_;
+  size_t register_masks_start_;
+  size_t stack_masks_start_;
   size_t dex_register_maps_start_;
   size_t inline_infos_start_;
   size_t needed_size_;
@@ -17,6 +17,7 @@
 #include "stack_map.h"
 
 #include "base/arena_bit_vector.h"
+#include "stack_map_cache.h"
 #include "stack_map_stream.h"
 
 #include "gtest/gtest.h"
@@ -70,9 +71,9 @@ TEST(StackMapTest, Test1) {
   ASSERT_TRUE(stack_map.Equals(code_info.GetStackMapForNativePcOffset(64, encoding)));
   ASSERT_EQ(0u, stack_map.GetDexPc(encoding));
   ASSERT_EQ(64u, stack_map.GetNativePcOffset(encoding));
-  ASSERT_EQ(0x3u, stack_map.GetRegisterMask(encoding));
+  ASSERT_EQ(0x3u, code_info.GetRegisterMaskOf(stack_map, encoding));
 
-  MemoryRegion stack_mask = stack_map.GetStackMask(encoding);
+  MemoryRegion stack_mask = code_info.GetStackMaskOf(stack_map, encoding);
   ASSERT_TRUE(SameBits(stack_mask, sp_mask));
 
   ASSERT_TRUE(stack_map.HasDexRegisterMap(encoding));
@@ -186,9 +187,9 @@ TEST(StackMapTest, Test2) {
     ASSERT_TRUE(stack_map.Equals(code_info.GetStackMapForNativePcOffset(64, encoding)));
     ASSERT_EQ(0u, stack_map.GetDexPc(encoding));
     ASSERT_EQ(64u, stack_map.GetNativePcOffset(encoding));
-    ASSERT_EQ(0x3u, stack_map.GetRegisterMask(encoding));
+    ASSERT_EQ(0x3u, code_info.GetRegisterMaskOf(stack_map, encoding));
 
-    MemoryRegion stack_mask = stack_map.GetStackMask(encoding);
+    MemoryRegion stack_mask = code_info.GetStackMaskOf(stack_map, encoding);
     ASSERT_TRUE(SameBits(stack_mask, sp_mask1));
 
     ASSERT_TRUE(stack_map.HasDexRegisterMap(encoding));
@@ -248,9 +249,9 @@ TEST(StackMapTest, Test2) {
     ASSERT_TRUE(stack_map.Equals(code_info.GetStackMapForNativePcOffset(128u, encoding)));
     ASSERT_EQ(1u, stack_map.GetDexPc(encoding));
     ASSERT_EQ(128u, stack_map.GetNativePcOffset(encoding));
-    ASSERT_EQ(0xFFu, stack_map.GetRegisterMask(encoding));
+    ASSERT_EQ(0xFFu, code_info.GetRegisterMaskOf(stack_map, encoding));
 
-    MemoryRegion stack_mask = stack_map.GetStackMask(encoding);
+    MemoryRegion stack_mask = code_info.GetStackMaskOf(stack_map, encoding);
     ASSERT_TRUE(SameBits(stack_mask, sp_mask2));
 
     ASSERT_TRUE(stack_map.HasDexRegisterMap(encoding));
@@ -303,9 +304,9 @@ TEST(StackMapTest, Test2) {
     ASSERT_TRUE(stack_map.Equals(code_info.GetStackMapForNativePcOffset(192u, encoding)));
     ASSERT_EQ(2u, stack_map.GetDexPc(encoding));
     ASSERT_EQ(192u, stack_map.GetNativePcOffset(encoding));
-    ASSERT_EQ(0xABu, stack_map.GetRegisterMask(encoding));
+    ASSERT_EQ(0xABu, code_info.GetRegisterMaskOf(stack_map, encoding));
 
-    MemoryRegion stack_mask = stack_map.GetStackMask(encoding);
+    MemoryRegion stack_mask = code_info.GetStackMaskOf(stack_map, encoding);
     ASSERT_TRUE(SameBits(stack_mask, sp_mask3));
 
     ASSERT_TRUE(stack_map.HasDexRegisterMap(encoding));
@@ -358,9 +359,9 @@ TEST(StackMapTest, Test2) {
     ASSERT_TRUE(stack_map.Equals(code_info.GetStackMapForNativePcOffset(256u, encoding)));
     ASSERT_EQ(3u, stack_map.GetDexPc(encoding));
     ASSERT_EQ(256u, stack_map.GetNativePcOffset(encoding));
-    ASSERT_EQ(0xCDu, stack_map.GetRegisterMask(encoding));
+    ASSERT_EQ(0xCDu, code_info.GetRegisterMaskOf(stack_map, encoding));
 
-    MemoryRegion stack_mask = stack_map.GetStackMask(encoding);
+    MemoryRegion stack_mask = code_info.GetStackMaskOf(stack_map, encoding);
     ASSERT_TRUE(SameBits(stack_mask, sp_mask4));
 
     ASSERT_TRUE(stack_map.HasDexRegisterMap(encoding));
@@ -442,7 +443,7 @@ TEST(StackMapTest, TestNonLiveDexRegisters) {
   ASSERT_TRUE(stack_map.Equals(code_info.GetStackMapForNativePcOffset(64, encoding)));
   ASSERT_EQ(0u, stack_map.GetDexPc(encoding));
   ASSERT_EQ(64u, stack_map.GetNativePcOffset(encoding));
-  ASSERT_EQ(0x3u, stack_map.GetRegisterMask(encoding));
+  ASSERT_EQ(0x3u, code_info.GetRegisterMaskOf(stack_map, encoding));
 
   ASSERT_TRUE(stack_map.HasDexRegisterMap(encoding));
   DexRegisterMap dex_register_map =
@@ -634,7 +635,7 @@ TEST(StackMapTest, TestNoDexRegisterMap) {
   ASSERT_TRUE(stack_map.Equals(code_info.GetStackMapForNativePcOffset(64, encoding)));
   ASSERT_EQ(0u, stack_map.GetDexPc(encoding));
   ASSERT_EQ(64u, stack_map.GetNativePcOffset(encoding));
-  ASSERT_EQ(0x3u, stack_map.GetRegisterMask(encoding));
+  ASSERT_EQ(0x3u, code_info.GetRegisterMaskOf(stack_map, encoding));
 
   ASSERT_FALSE(stack_map.HasDexRegisterMap(encoding));
   ASSERT_FALSE(stack_map.HasInlineInfo(encoding));
@@ -812,4 +813,199 @@ TEST(StackMapTest, InlineTest) {
   }
 }
 
+TEST(StackMapTest, TestDeduplicateMasks) {
+  ArenaPool pool;
+  ArenaAllocator arena(&pool);
+  StackMapStream stream(&arena);
+
+  ArenaBitVector sp_mask1(&arena, 0, true);
+  sp_mask1.SetBit(1);
+  sp_mask1.SetBit(4);
+  ArenaBitVector sp_mask2(&arena, 0, true);
+  sp_mask2.SetBit(3);
+  sp_mask2.SetBit(8);
+
+  // Four stack maps, using two distinct stack masks and two distinct register masks.
+  stream.BeginStackMapEntry(0, 4, 0x3, &sp_mask1, 0, 0);
+  stream.EndStackMapEntry();
+  stream.BeginStackMapEntry(1, 8, 0x3, &sp_mask2, 0, 0);
+  stream.EndStackMapEntry();
+  stream.BeginStackMapEntry(2, 12, 0x11, &sp_mask1, 0, 0);
+  stream.EndStackMapEntry();
+  stream.BeginStackMapEntry(3, 16, 0x11, &sp_mask2, 0, 0);
+  stream.EndStackMapEntry();
+
+  size_t size = stream.PrepareForFillIn();
+  void* memory = arena.Alloc(size, kArenaAllocMisc);
+  MemoryRegion region(memory, size);
+  stream.FillIn(region);
+
+  CodeInfo code_info(region);
+  StackMapEncoding encoding = code_info.ExtractEncoding();
+  ASSERT_EQ(4u, code_info.GetNumberOfStackMaps());
+  ASSERT_EQ(2u, code_info.GetNumberOfRegisterMasks());
+  ASSERT_EQ(2u, code_info.GetNumberOfStackMasks());
+  ASSERT_EQ(2u, encoding.NumberOfBytesForStackMask());
+  ASSERT_EQ(2u * encoding.NumberOfBytesForStackMask(), code_info.GetStackMasksSize(encoding));
+
+  StackMap stack_map0 = code_info.GetStackMapAt(0, encoding);
+  StackMap stack_map1 = code_info.GetStackMapAt(1, encoding);
+  StackMap stack_map2 = code_info.GetStackMapAt(2, encoding);
+  StackMap stack_map3 = code_info.GetStackMapAt(3, encoding);
+  ASSERT_EQ(stack_map0.GetStackMaskIndex(encoding), stack_map2.GetStackMaskIndex(encoding));
+  ASSERT_EQ(stack_map1.GetStackMaskIndex(encoding), stack_map3.GetStackMaskIndex(encoding));
+  ASSERT_NE(stack_map0.GetStackMaskIndex(encoding), stack_map1.GetStackMaskIndex(encoding));
+  ASSERT_EQ(stack_map0.GetRegisterMaskIndex(encoding), stack_map1.GetRegisterMaskIndex(encoding));
+  ASSERT_EQ(stack_map2.GetRegisterMaskIndex(encoding), stack_map3.GetRegisterMaskIndex(encoding));
+
+  ASSERT_TRUE(SameBits(code_info.GetStackMaskOf(stack_map0, encoding), sp_mask1));
+  ASSERT_TRUE(SameBits(code_info.GetStackMaskOf(stack_map1, encoding), sp_mask2));
+  ASSERT_TRUE(SameBits(code_info.GetStackMaskOf(stack_map2, encoding), sp_mask1));
+  ASSERT_TRUE(SameBits(code_info.GetStackMaskOf(stack_map3, encoding), sp_mask2));
+  ASSERT_EQ(0x3u, code_info.GetRegisterMaskOf(stack_map0, encoding));
+  ASSERT_EQ(0x3u, code_info.GetRegisterMaskOf(stack_map1, encoding));
+  ASSERT_EQ(0x11u, code_info.GetRegisterMaskOf(stack_map2, encoding));
+  ASSERT_EQ(0x11u, code_info.GetRegisterMaskOf(stack_map3, encoding));
+}
+
+TEST(StackMapTest, TestBitPackedStackMaps) {
+  ArenaPool pool;
+  ArenaAllocator arena(&pool);
+  StackMapStream stream(&arena);
+
+  // Use field values whose widths add up to a stack map size that is not a
+  // multiple of a byte, so that most stack maps straddle byte boundaries.
+  const size_t number_of_stack_maps = 37;
+  for (size_t i = 0; i < number_of_stack_maps; ++i) {
+    stream.BeginStackMapEntry(i * 3, i * 13, 1u << (i % 5), nullptr, 0, 0);
+    stream.EndStackMapEntry();
+  }
+
+  size_t size = stream.PrepareForFillIn();
+  void* memory = arena.Alloc(size, kArenaAllocMisc);
+  MemoryRegion region(memory, size);
+  stream.FillIn(region);
+
+  CodeInfo code_info(region);
+  StackMapEncoding encoding = code_info.ExtractEncoding();
+  ASSERT_EQ(MinimumBitsToStore(36u * 13u), encoding.NumberOfBitsForNativePc());
+  ASSERT_EQ(MinimumBitsToStore(36u * 3u), encoding.NumberOfBitsForDexPc());
+  ASSERT_EQ(0u, encoding.NumberOfBitsForDexRegisterMap());
+  ASSERT_EQ(0u, encoding.NumberOfBitsForInlineInfo());
+  ASSERT_EQ(5u, code_info.GetNumberOfRegisterMasks());
+  ASSERT_EQ(3u, encoding.NumberOfBitsForRegisterMaskIndex());
+  ASSERT_EQ(5u, encoding.NumberOfBitsForRegisterMask());
+  ASSERT_EQ(1u, code_info.GetNumberOfStackMasks());
+  ASSERT_EQ(0u, encoding.NumberOfBitsForStackMaskIndex());
+  size_t stack_map_bits = encoding.ComputeStackMapSizeInBits();
+  ASSERT_EQ(RoundUp(number_of_stack_maps * stack_map_bits, kBitsPerByte) / kBitsPerByte,
+            code_info.GetStackMapsSize(encoding));
+
+  for (size_t i = 0; i < number_of_stack_maps; ++i) {
+    StackMap stack_map = code_info.GetStackMapAt(i, encoding);
+    ASSERT_TRUE(stack_map.Equals(code_info.GetStackMapForNativePcOffset(i * 13, encoding)));
+    ASSERT_TRUE(stack_map.Equals(code_info.GetStackMapForDexPc(i * 3, encoding)));
+    ASSERT_EQ(i * 3, stack_map.GetDexPc(encoding));
+    ASSERT_EQ(i * 13, stack_map.GetNativePcOffset(encoding));
+    ASSERT_EQ(1u << (i % 5), code_info.GetRegisterMaskOf(stack_map, encoding));
+    ASSERT_FALSE(stack_map.HasDexRegisterMap(encoding));
+    ASSERT_FALSE(stack_map.HasInlineInfo(encoding));
+  }
+}
+
+TEST(StackMapTest, TestFindStackMapForNativePcOffset) {
+  ArenaPool pool;
+  ArenaAllocator arena(&pool);
+  StackMapStream stream(&arena);
+
+  ArenaBitVector sp_mask(&arena, 0, false);
+  // Safepoints in code order, two of them sharing a native pc offset, followed by
+  // catch block entries whose native pc offsets are interleaved with the safepoints.
+  const uint32_t native_pcs[] = { 4, 16, 16, 32, 64, 24, 8 };
+  for (size_t i = 0; i < arraysize(native_pcs); ++i) {
+    stream.BeginStackMapEntry(i, native_pcs[i], 0, &sp_mask, 0, 0);
+    stream.EndStackMapEntry();
+  }
+
+  size_t size = stream.PrepareForFillIn();
+  void* memory = arena.Alloc(size, kArenaAllocMisc);
+  MemoryRegion region(memory, size);
+  stream.FillIn(region);
+
+  CodeInfo code_info(region);
+  StackMapEncoding encoding = code_info.ExtractEncoding();
+  ASSERT_EQ(7u, code_info.GetNumberOfStackMaps());
+  ASSERT_EQ(5u, code_info.GetNumberOfSortedStackMaps());
+
+  ASSERT_EQ(0u, code_info.FindStackMapIndexForNativePcOffset(4, encoding));
+  ASSERT_EQ(1u, code_info.FindStackMapIndexForNativePcOffset(16, encoding));
+  ASSERT_EQ(3u, code_info.FindStackMapIndexForNativePcOffset(32, encoding));
+  ASSERT_EQ(4u, code_info.FindStackMapIndexForNativePcOffset(64, encoding));
+  ASSERT_EQ(5u, code_info.FindStackMapIndexForNativePcOffset(24, encoding));
+  ASSERT_EQ(6u, code_info.FindStackMapIndexForNativePcOffset(8, encoding));
+  const size_t kNotFound = CodeInfo::kNoStackMapIndex;
+  ASSERT_EQ(kNotFound, code_info.FindStackMapIndexForNativePcOffset(0, encoding));
+  ASSERT_EQ(kNotFound, code_info.FindStackMapIndexForNativePcOffset(12, encoding));
+  ASSERT_EQ(kNotFound, code_info.FindStackMapIndexForNativePcOffset(128, encoding));
+  ASSERT_FALSE(code_info.GetStackMapForNativePcOffset(12, encoding).IsValid());
+  ASSERT_EQ(5u, code_info.GetStackMapForNativePcOffset(24, encoding).GetDexPc(encoding));
+
+  ASSERT_TRUE(code_info.IsSortedStackMapIndexForNativePcOffset(1, 16, encoding));
+  ASSERT_FALSE(code_info.IsSortedStackMapIndexForNativePcOffset(2, 16, encoding));
+  ASSERT_FALSE(code_info.IsSortedStackMapIndexForNativePcOffset(3, 16, encoding));
+  ASSERT_FALSE(code_info.IsSortedStackMapIndexForNativePcOffset(5, 24, encoding));
+
+  // Cached lookups agree with the search, and stale entries are not returned.
+  StackMapCache cache;
+  const uintptr_t code_start = 0x1000;
+  for (size_t round = 0; round < 2; ++round) {
+    for (size_t i = 0; i < arraysize(native_pcs); ++i) {
+      uint32_t native_pc = native_pcs[i];
+      StackMap stack_map = cache.Lookup(code_start + native_pc, native_pc, code_info, encoding);
+      ASSERT_TRUE(stack_map.Equals(code_info.GetStackMapForNativePcOffset(native_pc, encoding)));
+    }
+  }
+  ASSERT_FALSE(cache.Lookup(code_start + 32, 12, code_info, encoding).IsValid());
+}
+
+TEST(StackMapTest, TestCatchStackMaps) {
+  ArenaPool pool;
+  ArenaAllocator arena(&pool);
+  StackMapStream stream(&arena);
+
+  ArenaBitVector sp_mask(&arena, 0, false);
+  stream.BeginStackMapEntry(0, 8, 0, &sp_mask, 0, 0);
+  stream.EndStackMapEntry();
+  stream.BeginStackMapEntry(7, 24, 0, &sp_mask, 0, 0);
+  stream.EndStackMapEntry();
+  // Catch stack maps, in dex pc order. Their native pcs are not sorted.
+  stream.BeginCatchStackMaps();
+  const uint32_t catch_dex_pcs[] = { 3, 7, 12, 20 };
+  const uint32_t catch_native_pcs[] = { 40, 16, 32, 12 };
+  for (size_t i = 0; i < arraysize(catch_dex_pcs); ++i) {
+    stream.BeginStackMapEntry(catch_dex_pcs[i], catch_native_pcs[i], 0, &sp_mask, 0, 0);
+    stream.EndStackMapEntry();
+  }
+
+  size_t size = stream.PrepareForFillIn();
+  void* memory = arena.Alloc(size, kArenaAllocMisc);
+  MemoryRegion region(memory, size);
+  stream.FillIn(region);
+
+  CodeInfo code_info(region);
+  StackMapEncoding encoding = code_info.ExtractEncoding();
+  ASSERT_EQ(6u, code_info.GetNumberOfStackMaps());
+  ASSERT_EQ(4u, code_info.GetNumberOfCatchStackMaps());
+
+  for (size_t i = 0; i < arraysize(catch_dex_pcs); ++i) {
+    StackMap stack_map = code_info.GetCatchStackMapForDexPc(catch_dex_pcs[i], encoding);
+    ASSERT_TRUE(stack_map.IsValid());
+    ASSERT_TRUE(stack_map.Equals(code_info.GetStackMapAt(2 + i, encoding)));
+    ASSERT_EQ(catch_native_pcs[i], stack_map.GetNativePcOffset(encoding));
+  }
+  // Dex pc 0 only has a safepoint.
+  ASSERT_FALSE(code_info.GetCatchStackMapForDexPc(0, encoding).IsValid());
+  ASSERT_FALSE(code_info.GetCatchStackMapForDexPc(21, encoding).IsValid());
+}
+
 }  // namespace art
@@ -21,13 +21,12 @@
 
 #include <algorithm>
 #include <inttypes.h>
-#include <unordered_map>
+#include <vector>
 
-#include "base/mutex.h"
-#include "base/hash_set.h"
-#include "base/stl_util.h"
+#include "base/logging.h"
 #include "base/stringprintf.h"
 #include "base/time_utils.h"
+#include "globals.h"
 
 namespace art {
 
@@ -42,6 +41,8 @@ struct DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Stats {
   size_t collision_max = 0u;
   size_t total_probe_distance = 0u;
   size_t total_size = 0u;
+  size_t max_chain_length = 0u;
+  size_t total_hits = 0u;
 };
 
 template <typename InKey,
@@ -52,130 +53,244 @@ template <typename InKey,
           HashType kShard>
 class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
  public:
-  Shard(const Alloc& alloc, const std::string& lock_name)
+  explicit Shard(const Alloc& alloc)
       : alloc_(alloc),
-        lock_name_(lock_name),
-        lock_(lock_name_.c_str()),
-        keys_() {
+        first_table_(nullptr),
+        current_table_(nullptr),
+        size_(0u),
+        resizing_(false),
+        hits_(0u) {
   }
 
   ~Shard() {
-    for (const HashedKey<StoreKey>& key : keys_) {
-      DCHECK(key.Key() != nullptr);
-      alloc_.Destroy(key.Key());
+    Table* table = first_table_.LoadRelaxed();
+    if (table == nullptr) {
+      return;
     }
-  }
-
-  const StoreKey* Add(Thread* self, size_t hash, const InKey& in_key) REQUIRES(!lock_) {
-    MutexLock lock(self, lock_);
-    HashedKey<InKey> hashed_in_key(hash, &in_key);
-    auto it = keys_.Find(hashed_in_key);
-    if (it != keys_.end()) {
-      DCHECK(it->Key() != nullptr);
-      return it->Key();
+    // Every key has been migrated to the newest table. Older tables only hold copies of its nodes.
+    while (table != nullptr) {
+      Table* next = table->next.LoadRelaxed();
+      for (size_t i = 0; i != table->num_buckets; ++i) {
+        Node* node = Untag(table->buckets[i].LoadRelaxed());
+        while (node != nullptr) {
+          Node* next_node = node->next;
+          if (next == nullptr) {
+            DCHECK(node->key != nullptr);
+            alloc_.Destroy(node->key);
+          }
+          delete node;
+          node = next_node;
+        }
+      }
+      delete table;
+      table = next;
     }
-    const StoreKey* store_key = alloc_.Copy(in_key);
-    keys_.Insert(HashedKey<StoreKey> { hash, store_key });
-    return store_key;
   }
 
-  void UpdateStats(Thread* self, Stats* global_stats) REQUIRES(!lock_) {
-    // HashSet<> doesn't keep entries ordered by hash, so we actually allocate memory
-    // for bookkeeping while collecting the stats.
-    std::unordered_map<HashType, size_t> stats;
-    {
-      MutexLock lock(self, lock_);
-      // Note: The total_probe_distance will be updated with the current state.
-      // It may have been higher before a re-hash.
-      global_stats->total_probe_distance += keys_.TotalProbeDistance();
-      global_stats->total_size += keys_.Size();
-      for (const HashedKey<StoreKey>& key : keys_) {
-        auto it = stats.find(key.Hash());
-        if (it == stats.end()) {
-          stats.insert({key.Hash(), 1u});
-        } else {
-          ++it->second;
+  const StoreKey* Add(size_t hash, const InKey& in_key) {
+    Table* table = GetCurrentTable();
+    Node* node = nullptr;
+    while (true) {
+      Atomic<Node*>* bucket = &table->buckets[hash % table->num_buckets];
+      Node* head = bucket->LoadSequentiallyConsistent();
+      const StoreKey* existing = Find(Untag(head), nullptr, hash, in_key);
+      if (existing != nullptr) {
+        return Hit(node, existing);
+      }
+      if (IsSealed(head)) {
+        // The bucket is being migrated to a bigger table and can no longer change, so the key is
+        // not in this table. Equal keys hash to the same sealed bucket and follow us.
+        table = table->next.LoadSequentiallyConsistent();
+        DCHECK(table != nullptr);
+        continue;
+      }
+      // Copy the key outside of any critical section and try to publish it as the new bucket
+      // head. If another thread changed the head meanwhile, only the nodes it prepended need
+      // checking.
+      if (node == nullptr) {
+        node = new Node { hash, alloc_.Copy(in_key), head };
+      } else {
+        node->next = head;
+      }
+      bool published = false;
+      while (true) {
+        if (bucket->CompareExchangeWeakRelease(node->next, node)) {
+          published = true;
+          break;
+        }
+        Node* new_head = bucket->LoadSequentiallyConsistent();
+        existing = Find(Untag(new_head), node->next, hash, in_key);
+        if (existing != nullptr) {
+          // Lost the race against an equal key.
+          return Hit(node, existing);
         }
+        if (IsSealed(new_head)) {
+          break;
+        }
+        node->next = new_head;
       }
-    }
-    for (const auto& entry : stats) {
-      size_t number_of_entries = entry.second;
-      if (number_of_entries > 1u) {
-        global_stats->collision_sum += number_of_entries - 1u;
-        global_stats->collision_max = std::max(global_stats->collision_max, number_of_entries);
+      if (published) {
+        break;
       }
+      // Sealed before our CAS went through; retry in the next table.
+      table = table->next.LoadSequentiallyConsistent();
+      DCHECK(table != nullptr);
     }
+    if (size_.FetchAndAddRelaxed(1u) + 1u > kMaxLoadFactor * table->num_buckets) {
+      MaybeGrow(table);
+    }
+    return node->key;
   }
 
- private:
-  template <typename T>
-  class HashedKey {
-   public:
-    HashedKey() : hash_(0u), key_(nullptr) { }
-    HashedKey(size_t hash, const T* key) : hash_(hash), key_(key) { }
-
-    size_t Hash() const {
-      return hash_;
+  void UpdateStats(Stats* global_stats) const {
+    global_stats->total_hits += hits_.LoadRelaxed();
+    Table* table = current_table_.LoadSequentiallyConsistent();
+    if (table == nullptr) {
+      return;
     }
-
-    const T* Key() const {
-      return key_;
+    std::vector<size_t> hashes;
+    for (size_t i = 0; i != table->num_buckets; ++i) {
+      hashes.clear();
+      size_t chain_length = 0u;
+      for (Node* node = Untag(table->buckets[i].LoadSequentiallyConsistent());
+           node != nullptr;
+           node = node->next) {
+        global_stats->total_probe_distance += chain_length;
+        ++chain_length;
+        hashes.push_back(node->hash);
+      }
+      global_stats->total_size += chain_length;
+      global_stats->max_chain_length = std::max(global_stats->max_chain_length, chain_length);
+      // Entries with the same full hash always share a chain, so count collisions per chain.
+      std::sort(hashes.begin(), hashes.end());
+      for (size_t start = 0u, end; start != hashes.size(); start = end) {
+        for (end = start + 1u; end != hashes.size() && hashes[end] == hashes[start]; ++end) {
+        }
+        size_t number_of_entries = end - start;
+        if (number_of_entries > 1u) {
+          global_stats->collision_sum += number_of_entries - 1u;
+          global_stats->collision_max = std::max(global_stats->collision_max, number_of_entries);
+        }
+      }
     }
+  }
 
-    bool IsEmpty() const {
-      return Key() == nullptr;
-    }
+ private:
+  // Chain nodes are immutable once published, except for `next` of a node that has not been
+  // published yet. Nodes are only freed when the whole set is destroyed.
+  struct Node {
+    size_t hash;
+    const StoreKey* key;
+    Node* next;
+  };
 
-    void MakeEmpty() {
-      key_ = nullptr;
+  // A bucket array. When the shard grows, each bucket of the old table is sealed by tagging its
+  // head, which freezes the chain, and the chain is then copied to `next`. The old table stays
+  // valid for threads still reading it.
+  struct Table {
+    explicit Table(size_t buckets)
+        : num_buckets(buckets), buckets(new Atomic<Node*>[buckets]), next(nullptr) {
     }
 
-   private:
-    size_t hash_;
-    const T* key_;
+    const size_t num_buckets;
+    const std::unique_ptr<Atomic<Node*>[]> buckets;
+    Atomic<Table*> next;
   };
 
-  class ShardEmptyFn {
-   public:
-    bool IsEmpty(const HashedKey<StoreKey>& key) const {
-      return key.IsEmpty();
-    }
+  // Number of buckets of the first table. Tables are allocated on first use, so unused sets (e.g.
+  // when deduplication is disabled for JIT) do not pay for them.
+  static constexpr size_t kInitialBuckets = 256u;
+  // Grow the shard once it holds more entries than this many per bucket.
+  static constexpr size_t kMaxLoadFactor = 2u;
+  static constexpr uintptr_t kSealedBit = 1u;
+
+  static bool IsSealed(Node* head) {
+    return (reinterpret_cast<uintptr_t>(head) & kSealedBit) != 0u;
+  }
+
+  static Node* Untag(Node* head) {
+    return reinterpret_cast<Node*>(reinterpret_cast<uintptr_t>(head) & ~kSealedBit);
+  }
 
-    void MakeEmpty(HashedKey<StoreKey>& key) {
-      key.MakeEmpty();
+  const StoreKey* Hit(Node* unpublished_node, const StoreKey* existing) {
+    if (unpublished_node != nullptr) {
+      alloc_.Destroy(unpublished_node->key);
+      delete unpublished_node;
     }
-  };
+    hits_.FetchAndAddRelaxed(1u);
+    return existing;
+  }
 
-  struct ShardHashFn {
-    template <typename T>
-    size_t operator()(const HashedKey<T>& key) const {
-      return key.Hash();
+  Table* GetCurrentTable() {
+    Table* table = current_table_.LoadSequentiallyConsistent();
+    if (UNLIKELY(table == nullptr)) {
+      Table* new_table = new Table(kInitialBuckets);
+      if (first_table_.CompareExchangeStrongSequentiallyConsistent(nullptr, new_table)) {
+        current_table_.StoreSequentiallyConsistent(new_table);
+        table = new_table;
+      } else {
+        delete new_table;
+        table = first_table_.LoadSequentiallyConsistent();
+      }
     }
-  };
+    return table;
+  }
 
-  struct ShardPred {
-    typename std::enable_if<!std::is_same<StoreKey, InKey>::value, bool>::type
-    operator()(const HashedKey<StoreKey>& lhs, const HashedKey<StoreKey>& rhs) const {
-      DCHECK(lhs.Key() != nullptr);
-      DCHECK(rhs.Key() != nullptr);
-      // Rehashing: stored keys are already deduplicated, so we can simply compare key pointers.
-      return lhs.Key() == rhs.Key();
+  // Double the bucket count of `table` if it is still the newest one and no other thread is
+  // already growing the shard. Other threads keep adding while the chains are copied: new
+  // threads start in the old table and are forwarded bucket by bucket as they get sealed. The
+  // new table only becomes current once it holds every key, so that lookups starting there
+  // cannot miss a key that is still only in the old table.
+  void MaybeGrow(Table* table) {
+    if (current_table_.LoadSequentiallyConsistent() != table ||
+        !resizing_.CompareExchangeStrongSequentiallyConsistent(false, true)) {
+      return;
+    }
+    if (current_table_.LoadSequentiallyConsistent() == table &&
+        size_.LoadRelaxed() > kMaxLoadFactor * table->num_buckets) {
+      Table* new_table = new Table(2u * table->num_buckets);
+      table->next.StoreSequentiallyConsistent(new_table);
+      for (size_t i = 0; i != table->num_buckets; ++i) {
+        Atomic<Node*>* bucket = &table->buckets[i];
+        Node* head = bucket->LoadSequentiallyConsistent();
+        while (!bucket->CompareExchangeWeakSequentiallyConsistent(
+            head, reinterpret_cast<Node*>(reinterpret_cast<uintptr_t>(head) | kSealedBit))) {
+          head = bucket->LoadSequentiallyConsistent();
+        }
+        for (Node* node = head; node != nullptr; node = node->next) {
+          Atomic<Node*>* new_bucket = &new_table->buckets[node->hash % new_table->num_buckets];
+          Node* copy = new Node { node->hash, node->key, new_bucket->LoadSequentiallyConsistent() };
+          while (!new_bucket->CompareExchangeWeakRelease(copy->next, copy)) {
+            copy->next = new_bucket->LoadSequentiallyConsistent();
+          }
+        }
+      }
+      current_table_.StoreSequentiallyConsistent(new_table);
     }
+    resizing_.StoreSequentiallyConsistent(false);
+  }
 
-    template <typename LeftT, typename RightT>
-    bool operator()(const HashedKey<LeftT>& lhs, const HashedKey<RightT>& rhs) const {
-      DCHECK(lhs.Key() != nullptr);
-      DCHECK(rhs.Key() != nullptr);
-      return lhs.Hash() == rhs.Hash() &&
-          lhs.Key()->size() == rhs.Key()->size() &&
-          std::equal(lhs.Key()->begin(), lhs.Key()->end(), rhs.Key()->begin());
+  // Search the chain starting at `begin`, stopping before `end`.
+  static const StoreKey* Find(Node* begin, Node* end, size_t hash, const InKey& in_key) {
+    for (Node* node = begin; node != end; node = node->next) {
+      DCHECK(node != nullptr);
+      const StoreKey* key = node->key;
+      if (node->hash == hash &&
+          key->size() == in_key.size() &&
+          std::equal(in_key.begin(), in_key.end(), key->begin())) {
+        return key;
+      }
     }
-  };
+    return nullptr;
+  }
 
   Alloc alloc_;
-  const std::string lock_name_;
-  Mutex lock_;
-  HashSet<HashedKey<StoreKey>, ShardEmptyFn, ShardHashFn, ShardPred> keys_ GUARDED_BY(lock_);
+  // The oldest table, which owns the chain of newer ones, and the newest fully populated table.
+  Atomic<Table*> first_table_;
+  Atomic<Table*> current_table_;
+  Atomic<size_t> size_;
+  Atomic<bool> resizing_;
+  Atomic<size_t> hits_;
 };
 
 template <typename InKey,
@@ -185,7 +300,7 @@ template <typename InKey,
           typename HashFunc,
           HashType kShard>
 const StoreKey* DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Add(
-    Thread* self, const InKey& key) {
+    Thread* self ATTRIBUTE_UNUSED, const InKey& key) {
   uint64_t hash_start;
   if (kIsDebugBuild) {
     hash_start = NanoTime();
@@ -193,11 +308,11 @@ const StoreKey* DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::A
   HashType raw_hash = HashFunc()(key);
   if (kIsDebugBuild) {
     uint64_t hash_end = NanoTime();
-    hash_time_ += hash_end - hash_start;
+    hash_time_.FetchAndAddRelaxed(hash_end - hash_start);
   }
   HashType shard_hash = raw_hash / kShard;
   HashType shard_bin = raw_hash % kShard;
-  return shards_[shard_bin]->Add(self, shard_hash, key);
+  return shards_[shard_bin]->Add(shard_hash, key);
 }
 
 template <typename InKey,
@@ -206,13 +321,10 @@ template <typename InKey,
           typename HashType,
           typename HashFunc,
           HashType kShard>
-DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::DedupeSet(const char* set_name,
-                                                                         const Alloc& alloc)
-    : hash_time_(0) {
+DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::DedupeSet(const Alloc& alloc)
+    : hash_time_(0u) {
   for (HashType i = 0; i < kShard; ++i) {
-    std::ostringstream oss;
-    oss << set_name << " lock " << i;
-    shards_[i].reset(new Shard(alloc, oss.str()));
+    shards_[i].reset(new Shard(alloc));
   }
 }
 
@@ -233,18 +345,25 @@ template <typename InKey,
           typename HashFunc,
           HashType kShard>
 std::string DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::DumpStats(
-    Thread* self) const {
+    Thread* self ATTRIBUTE_UNUSED) const {
   Stats stats;
   for (HashType shard = 0; shard < kShard; ++shard) {
-    shards_[shard]->UpdateStats(self, &stats);
+    shards_[shard]->UpdateStats(&stats);
   }
+  // Every Add() either hits an existing key or stores a new one.
+  size_t total_adds = stats.total_hits + stats.total_size;
   return StringPrintf("%zu collisions, %zu max hash collisions, "
-                      "%zu/%zu probe distance, %" PRIu64 " ns hash time",
+                      "%zu/%zu probe distance, %zu max chain length, "
+                      "%zu/%zu hits (%.1f%%), %" PRIu64 " ns hash time",
                       stats.collision_sum,
                       stats.collision_max,
                       stats.total_probe_distance,
                       stats.total_size,
-                      hash_time_);
+                      stats.max_chain_length,
+                      stats.total_hits,
+                      total_adds,
+                      total_adds == 0u ? 0.0 : 100.0 * stats.total_hits / total_adds,
+                      hash_time_.LoadRelaxed());
 }
 
 
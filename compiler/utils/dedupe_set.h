@@ -21,6 +21,7 @@
 #include <stdint.h>
 #include <string>
 
+#include "atomic.h"
 #include "base/macros.h"
 
 namespace art {
@@ -28,8 +29,11 @@ namespace art {
 class Thread;
 
 // A set of Keys that support a HashFunc returning HashType. Used to find duplicates of Key in the
-// Add method. The data-structure is thread-safe through the use of internal locks, it also
-// supports the lock being sharded.
+// Add method. The data-structure is thread-safe and lock-free: keys are hashed by the caller's
+// thread, looked up in a bucket chain without synchronization beyond an acquiring load, and new
+// keys are published with a single CAS on the bucket head. The set is split into kShard
+// independent tables to spread the buckets across more cache lines. Each table doubles its bucket
+// count when the load factor gets too high, without blocking concurrent Add() calls.
 template <typename InKey,
           typename StoreKey,
           typename Alloc,
@@ -41,10 +45,12 @@ class DedupeSet {
   // Add a new key to the dedupe set if not present. Return the equivalent deduplicated stored key.
   const StoreKey* Add(Thread* self, const InKey& key);
 
-  DedupeSet(const char* set_name, const Alloc& alloc);
+  explicit DedupeSet(const Alloc& alloc);
 
   ~DedupeSet();
 
+  // Returns collision, chain length and hit rate statistics. May run concurrently with Add(), in
+  // which case the numbers are only approximate.
   std::string DumpStats(Thread* self) const;
 
  private:
@@ -52,7 +58,8 @@ class DedupeSet {
   class Shard;
 
   std::unique_ptr<Shard> shards_[kShard];
-  uint64_t hash_time_;
+  // Only updated in debug builds.
+  Atomic<uint64_t> hash_time_;
 
   DISALLOW_COPY_AND_ASSIGN(DedupeSet);
 };
@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <pthread.h>
 #include <vector>
 
 #include "dedupe_set-inl.h"
@@ -58,7 +59,7 @@ TEST(DedupeSetTest, Test) {
             std::vector<uint8_t>,
             DedupeSetTestAlloc,
             size_t,
-            DedupeSetTestHashFunc> deduplicator("test", alloc);
+            DedupeSetTestHashFunc> deduplicator(alloc);
   const std::vector<uint8_t>* array1;
   {
     uint8_t raw_test1[] = { 10u, 20u, 30u, 45u };
@@ -88,4 +89,93 @@ TEST(DedupeSetTest, Test) {
   }
 }
 
+typedef DedupeSet<ArrayRef<const uint8_t>,
+                  std::vector<uint8_t>,
+                  DedupeSetTestAlloc,
+                  size_t,
+                  DedupeSetTestHashFunc,
+                  4> ShardedTestDedupeSet;
+
+static constexpr size_t kConcurrentThreads = 4u;
+// Enough keys for every shard to grow several times while the threads race.
+static constexpr size_t kConcurrentKeys = 8192u;
+
+struct ConcurrentAddArgs {
+  ShardedTestDedupeSet* deduplicator;
+  size_t thread_index;
+  std::vector<const std::vector<uint8_t>*> results;
+};
+
+static void* ConcurrentAdd(void* arg) {
+  ConcurrentAddArgs* args = reinterpret_cast<ConcurrentAddArgs*>(arg);
+  args->results.resize(kConcurrentKeys);
+  // Each thread walks the keys in a different order to provoke races on the bucket heads.
+  for (size_t i = 0; i != kConcurrentKeys; ++i) {
+    size_t key_index = (i * (2u * args->thread_index + 1u)) % kConcurrentKeys;
+    uint8_t raw_key[] = { static_cast<uint8_t>(key_index), static_cast<uint8_t>(key_index >> 8) };
+    args->results[key_index] = args->deduplicator->Add(nullptr, ArrayRef<const uint8_t>(raw_key));
+  }
+  return nullptr;
+}
+
+TEST(DedupeSetTest, ConcurrentAdd) {
+  DedupeSetTestAlloc alloc;
+  ShardedTestDedupeSet deduplicator(alloc);
+  ConcurrentAddArgs args[kConcurrentThreads];
+  pthread_t threads[kConcurrentThreads];
+  for (size_t t = 0; t != kConcurrentThreads; ++t) {
+    args[t].deduplicator = &deduplicator;
+    args[t].thread_index = t;
+    ASSERT_EQ(0, pthread_create(&threads[t], nullptr, ConcurrentAdd, &args[t]));
+  }
+  for (size_t t = 0; t != kConcurrentThreads; ++t) {
+    ASSERT_EQ(0, pthread_join(threads[t], nullptr));
+  }
+  for (size_t i = 0; i != kConcurrentKeys; ++i) {
+    ASSERT_NE(args[0].results[i], nullptr);
+    ASSERT_EQ(2u, args[0].results[i]->size());
+    ASSERT_EQ(static_cast<uint8_t>(i), (*args[0].results[i])[0]);
+    for (size_t t = 1; t != kConcurrentThreads; ++t) {
+      ASSERT_EQ(args[0].results[i], args[t].results[i]);
+    }
+  }
+  // Only the first Add() of each key stores it; everything else is a hit.
+  std::string stats = deduplicator.DumpStats(nullptr);
+  std::string expected_hits = StringPrintf("%zu/%zu hits",
+                                           (kConcurrentThreads - 1u) * kConcurrentKeys,
+                                           kConcurrentThreads * kConcurrentKeys);
+  EXPECT_NE(std::string::npos, stats.find(expected_hits)) << stats;
+  std::string expected_size = StringPrintf("/%zu probe distance", kConcurrentKeys);
+  EXPECT_NE(std::string::npos, stats.find(expected_size)) << stats;
+}
+
+TEST(DedupeSetTest, Grow) {
+  static constexpr size_t kKeys = 65536u;
+  DedupeSetTestAlloc alloc;
+  DedupeSet<ArrayRef<const uint8_t>,
+            std::vector<uint8_t>,
+            DedupeSetTestAlloc,
+            size_t,
+            DedupeSetTestHashFunc> deduplicator(alloc);
+  std::vector<const std::vector<uint8_t>*> results(kKeys);
+  for (size_t i = 0; i != kKeys; ++i) {
+    uint8_t raw_key[] = { static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8) };
+    results[i] = deduplicator.Add(nullptr, ArrayRef<const uint8_t>(raw_key));
+  }
+  // Keys added before the table grew are still found and deduplicated.
+  for (size_t i = 0; i != kKeys; ++i) {
+    uint8_t raw_key[] = { static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8) };
+    ASSERT_EQ(results[i], deduplicator.Add(nullptr, ArrayRef<const uint8_t>(raw_key)));
+  }
+  std::string stats = deduplicator.DumpStats(nullptr);
+  EXPECT_NE(std::string::npos, stats.find(StringPrintf("/%zu probe distance", kKeys))) << stats;
+  // With a fixed number of buckets the chains would be hundreds of entries long.
+  size_t max_chain_length;
+  size_t pos = stats.find("probe distance, ");
+  ASSERT_NE(std::string::npos, pos) << stats;
+  ASSERT_EQ(1, sscanf(stats.c_str() + pos, "probe distance, %zu max chain length",
+                      &max_chain_length)) << stats;
+  EXPECT_LT(max_chain_length, 32u) << stats;
+}
+
 }  // namespace art
@@ -26,8 +26,13 @@
 
 namespace art {
 
-// The chunk size by which the swap file is increased and mapped.
+// The minimum and maximum chunk size by which the swap file is increased and mapped. In between,
+// the file grows geometrically so that big compilations need few ftruncate() and mmap() calls.
 static constexpr size_t kMininumMapSize = 16 * MB;
+static constexpr size_t kMaximumMapSize = 256 * MB;
+
+// Size classes are refilled with runs of this size.
+static constexpr size_t kSizeClassRunSize = 16 * KB;
 
 static constexpr bool kCheckFreeMaps = false;
 
@@ -69,6 +74,9 @@ SwapSpace::SwapSpace(int fd, size_t initial_size)
       lock_("SwapSpace lock", static_cast<LockLevel>(LockLevel::kDefaultMutexLevel - 1)) {
   // Assume that the file is unlinked.
 
+  for (size_t i = 0; i != kNumSizeClasses; ++i) {
+    size_classes_[i].reset(new SizeClass());
+  }
   InsertChunk(&free_by_start_, &free_by_size_, NewFileChunk(initial_size));
 }
 
@@ -102,9 +110,46 @@ static size_t CollectFree(const FreeByStartSet& free_by_start, const FreeBySizeS
 }
 
 void* SwapSpace::Alloc(size_t size) {
+  size = RoundUp(std::max<size_t>(size, 1u), 8U);
+  if (size <= kMaxSizeClassSize) {
+    return AllocFromSizeClass(size);
+  }
   MutexLock lock(Thread::Current(), lock_);
-  size = RoundUp(size, 8U);
+  return AllocChunk(size);
+}
+
+void* SwapSpace::AllocFromSizeClass(size_t size) {
+  Thread* self = Thread::Current();
+  SizeClass* size_class = size_classes_[SizeClassIndex(size)].get();
+  {
+    MutexLock mu(self, size_class->lock);
+    FreeListEntry* entry = size_class->free_list;
+    if (entry != nullptr) {
+      size_class->free_list = entry->next;
+      return entry;
+    }
+  }
+
+  // Carve a new run out of the general free map. The first slot goes to the caller and the rest
+  // is linked up before publishing it to the size class.
+  const size_t count = kSizeClassRunSize / size;
+  uint8_t* run;
+  {
+    MutexLock mu(self, lock_);
+    run = reinterpret_cast<uint8_t*>(AllocChunk(count * size));
+  }
+  FreeListEntry* first = reinterpret_cast<FreeListEntry*>(run + size);
+  FreeListEntry* last = reinterpret_cast<FreeListEntry*>(run + (count - 1u) * size);
+  for (uint8_t* slot = run + size; slot != run + (count - 1u) * size; slot += size) {
+    reinterpret_cast<FreeListEntry*>(slot)->next = reinterpret_cast<FreeListEntry*>(slot + size);
+  }
+  MutexLock mu(self, size_class->lock);
+  last->next = size_class->free_list;
+  size_class->free_list = first;
+  return run;
+}
 
+void* SwapSpace::AllocChunk(size_t size) {
   // Check the free list for something that fits.
   // TODO: Smarter implementation. Global biggest chunk, ...
   SpaceChunk old_chunk;
@@ -132,7 +177,8 @@ void* SwapSpace::Alloc(size_t size) {
 
 SpaceChunk SwapSpace::NewFileChunk(size_t min_size) {
 #if !defined(__APPLE__)
-  size_t next_part = std::max(RoundUp(min_size, kPageSize), RoundUp(kMininumMapSize, kPageSize));
+  size_t map_size = std::min(std::max(size_, kMininumMapSize), kMaximumMapSize);
+  size_t next_part = std::max(RoundUp(min_size, kPageSize), RoundUp(map_size, kPageSize));
   int result = TEMP_FAILURE_RETRY(ftruncate64(fd_, size_ + next_part));
   if (result != 0) {
     PLOG(FATAL) << "Unable to increase swap file.";
@@ -152,7 +198,7 @@ SpaceChunk SwapSpace::NewFileChunk(size_t min_size) {
   maps_.push_back(new_chunk);
   return new_chunk;
 #else
-  UNUSED(min_size, kMininumMapSize);
+  UNUSED(min_size, kMininumMapSize, kMaximumMapSize);
   LOG(FATAL) << "No swap file support on the Mac.";
   UNREACHABLE();
 #endif
@@ -160,8 +206,17 @@ SpaceChunk SwapSpace::NewFileChunk(size_t min_size) {
 
 // TODO: Full coalescing.
 void SwapSpace::Free(void* ptrV, size_t size) {
+  size = RoundUp(std::max<size_t>(size, 1u), 8U);
+  if (size <= kMaxSizeClassSize) {
+    // Slots of size classes are never returned to the general free map.
+    SizeClass* size_class = size_classes_[SizeClassIndex(size)].get();
+    FreeListEntry* entry = reinterpret_cast<FreeListEntry*>(ptrV);
+    MutexLock mu(Thread::Current(), size_class->lock);
+    entry->next = size_class->free_list;
+    size_class->free_list = entry;
+    return;
+  }
   MutexLock lock(Thread::Current(), lock_);
-  size = RoundUp(size, 8U);
 
   size_t free_before = 0;
   if (kCheckFreeMaps) {
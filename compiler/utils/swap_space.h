@@ -19,6 +19,7 @@
 
 #include <cstdlib>
 #include <list>
+#include <memory>
 #include <set>
 #include <stdint.h>
 #include <stddef.h>
@@ -56,6 +57,11 @@ class SortChunkByPtr {
 };
 
 // An arena pool that creates arenas backed by an mmaped file.
+//
+// Small allocations are served from segregated free lists, one per size class, each with its own
+// lock. A size class is refilled by carving a whole run out of the general free map, so compiler
+// threads storing many small tables rarely contend on the general lock. Larger allocations use
+// the general free map, which coalesces adjacent free chunks.
 class SwapSpace {
  public:
   SwapSpace(int fd, size_t initial_size);
@@ -68,12 +74,43 @@ class SwapSpace {
   }
 
  private:
+  // Allocations of up to kMaxSizeClassSize bytes use one size class per multiple of 8 bytes.
+  static constexpr size_t kMaxSizeClassSize = 256u;
+  static constexpr size_t kNumSizeClasses = kMaxSizeClassSize / 8u;
+
+  // Singly linked list threaded through the free slots of a size class.
+  struct FreeListEntry {
+    FreeListEntry* next;
+  };
+
+  struct SizeClass {
+    // Same level as the general lock; the two are never held together.
+    SizeClass()
+        : lock("SwapSpace size class lock",
+               static_cast<LockLevel>(LockLevel::kDefaultMutexLevel - 1)),
+          free_list(nullptr) { }
+
+    Mutex lock;
+    FreeListEntry* free_list GUARDED_BY(lock);
+  };
+
+  static size_t SizeClassIndex(size_t size) {
+    DCHECK_ALIGNED(size, 8u);
+    DCHECK_NE(size, 0u);
+    DCHECK_LE(size, kMaxSizeClassSize);
+    return size / 8u - 1u;
+  }
+
+  void* AllocFromSizeClass(size_t size) REQUIRES(!lock_);
+  void* AllocChunk(size_t size) REQUIRES(lock_);
   SpaceChunk NewFileChunk(size_t min_size) REQUIRES(lock_);
 
   int fd_;
   size_t size_;
   std::list<SpaceChunk> maps_;
 
+  std::unique_ptr<SizeClass> size_classes_[kNumSizeClasses];
+
   // NOTE: Boost.Bimap would be useful for the two following members.
 
   // Map start of a free chunk to its size.
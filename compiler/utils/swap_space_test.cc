@@ -20,6 +20,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <vector>
 #include "gtest/gtest.h"
 
 #include "base/unix_file/fd_file.h"
@@ -78,4 +79,49 @@ TEST_F(SwapSpaceTest, Swap) {
   SwapTest(true);
 }
 
+TEST_F(SwapSpaceTest, SizeClasses) {
+  ScratchFile scratch;
+  int fd = scratch.GetFd();
+  unlink(scratch.GetFilename().c_str());
+
+  SwapSpace pool(fd, 1 * MB);
+  size_t initial_size = pool.GetSize();
+
+  // A freed slot is reused by the next allocation of the same size class.
+  void* slot = pool.Alloc(24);
+  pool.Free(slot, 24);
+  EXPECT_EQ(slot, pool.Alloc(20));
+  pool.Free(slot, 20);
+
+  // Small allocations must not overlap.
+  static constexpr size_t kCount = 10000;
+  static constexpr size_t kSize = 40;
+  std::vector<uint8_t*> ptrs;
+  for (size_t i = 0; i != kCount; ++i) {
+    uint8_t* ptr = reinterpret_cast<uint8_t*>(pool.Alloc(kSize));
+    memset(ptr, static_cast<int>(i & 0xff), kSize);
+    ptrs.push_back(ptr);
+  }
+  for (size_t i = 0; i != kCount; ++i) {
+    for (size_t j = 0; j != kSize; ++j) {
+      ASSERT_EQ(static_cast<uint8_t>(i & 0xff), ptrs[i][j]);
+    }
+  }
+  // Freeing and reallocating recycles the same slots.
+  for (uint8_t* ptr : ptrs) {
+    pool.Free(ptr, kSize);
+  }
+  for (size_t i = 0; i != kCount; ++i) {
+    pool.Alloc(kSize);
+  }
+  EXPECT_EQ(initial_size, pool.GetSize());
+
+  // Large allocations still work next to the size classes.
+  void* large = pool.Alloc(1 * MB);
+  memset(large, 0, 1 * MB);
+  pool.Free(large, 1 * MB);
+
+  scratch.Close();
+}
+
 }  // namespace art
@@ -387,6 +387,7 @@ class X86_64Assembler FINAL : public Assembler {
   void leal(CpuRegister dst, const Address& src);
 
   void movaps(XmmRegister dst, XmmRegister src);
+  void movdqu(XmmRegister dst, const Address& src);
 
   void movss(XmmRegister dst, const Address& src);
   void movss(const Address& dst, XmmRegister src);
@@ -471,6 +472,9 @@ class X86_64Assembler FINAL : public Assembler {
   void orpd(XmmRegister dst, XmmRegister src);
   void orps(XmmRegister dst, XmmRegister src);
 
+  void pcmpeqb(XmmRegister dst, XmmRegister src);
+  void pmovmskb(CpuRegister dst, XmmRegister src);
+
   void flds(const Address& src);
   void fstps(const Address& dst);
   void fsts(const Address& dst);
@@ -661,7 +665,11 @@ class X86_64Assembler FINAL : public Assembler {
   void repe_cmpsw();
   void repe_cmpsl();
   void repe_cmpsq();
+  void rep_movsb();
   void rep_movsw();
+  void rep_movsl();
+  void rep_stosb();
+  void rep_stosl();
 
   //
   // Macros for High-level operations.
@@ -958,12 +958,36 @@ TEST_F(AssemblerX86_64Test, RepneScasw) {
   DriverStr(expected, "repne_scasw");
 }
 
+TEST_F(AssemblerX86_64Test, RepMovsb) {
+  GetAssembler()->rep_movsb();
+  const char* expected = "rep movsb\n";
+  DriverStr(expected, "rep_movsb");
+}
+
 TEST_F(AssemblerX86_64Test, RepMovsw) {
   GetAssembler()->rep_movsw();
   const char* expected = "rep movsw\n";
   DriverStr(expected, "rep_movsw");
 }
 
+TEST_F(AssemblerX86_64Test, RepMovsl) {
+  GetAssembler()->rep_movsl();
+  const char* expected = "rep movsl\n";
+  DriverStr(expected, "rep_movsl");
+}
+
+TEST_F(AssemblerX86_64Test, RepStosb) {
+  GetAssembler()->rep_stosb();
+  const char* expected = "rep stosb\n";
+  DriverStr(expected, "rep_stosb");
+}
+
+TEST_F(AssemblerX86_64Test, RepStosl) {
+  GetAssembler()->rep_stosl();
+  const char* expected = "rep stosl\n";
+  DriverStr(expected, "rep_stosl");
+}
+
 TEST_F(AssemblerX86_64Test, Movsxd) {
   DriverStr(RepeatRr(&x86_64::X86_64Assembler::movsxd, "movsxd %{reg2}, %{reg1}"), "movsxd");
 }
@@ -1105,6 +1129,26 @@ TEST_F(AssemblerX86_64Test, Xorpd) {
   DriverStr(RepeatFF(&x86_64::X86_64Assembler::xorpd, "xorpd %{reg2}, %{reg1}"), "xorpd");
 }
 
+TEST_F(AssemblerX86_64Test, Pcmpeqb) {
+  DriverStr(RepeatFF(&x86_64::X86_64Assembler::pcmpeqb, "pcmpeqb %{reg2}, %{reg1}"), "pcmpeqb");
+}
+
+TEST_F(AssemblerX86_64Test, Pmovmskb) {
+  DriverStr(RepeatrF(&x86_64::X86_64Assembler::pmovmskb, "pmovmskb %{reg2}, %{reg1}"),
+            "pmovmskb");
+}
+
+TEST_F(AssemblerX86_64Test, Movdqu) {
+  GetAssembler()->movdqu(x86_64::XmmRegister(x86_64::XMM0),
+                         x86_64::Address(x86_64::CpuRegister(x86_64::RDI), 8));
+  GetAssembler()->movdqu(x86_64::XmmRegister(x86_64::XMM9),
+                         x86_64::Address(x86_64::CpuRegister(x86_64::R13), 0));
+  const char* expected =
+      "movdqu 8(%RDI), %xmm0\n"
+      "movdqu 0(%R13), %xmm9\n";
+  DriverStr(expected, "movdqu");
+}
+
 TEST_F(AssemblerX86_64Test, Andps) {
   DriverStr(RepeatFF(&x86_64::X86_64Assembler::andps, "andps %{reg2}, %{reg1}"), "andps");
 }
@@ -22,6 +22,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <set>
 #include <sstream>
 #include <string>
 #include <unordered_set>
@@ -63,6 +64,7 @@
 #include "gc/space/space-inl.h"
 #include "image_writer.h"
 #include "interpreter/unstarted_runtime.h"
+#include "jit/offline_profiling_info.h"
 #include "leb128.h"
 #include "mirror/class-inl.h"
 #include "mirror/class_loader.h"
@@ -319,6 +321,14 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("");
   UsageError("  --profile-file=<filename>: specify profiler output file to use for compilation.");
   UsageError("");
+  UsageError("  --code-layout-profile=<filename>: specify a JIT profile of hot methods whose code");
+  UsageError("      is placed first in the oat file.");
+  UsageError("");
+  UsageError("  --image-layout-profile=<filename>: specify a file of class names in the order");
+  UsageError("      they are first used during startup. Their objects are placed first in each");
+  UsageError("      section of the image.");
+  UsageError("      Example: --image-layout-profile=frameworks/base/startup-classes");
+  UsageError("");
   UsageError("  --print-pass-names: print a list of pass names");
   UsageError("");
   UsageError("  --disable-passes=<pass-names>:  disable one or more passes separated by comma.");
@@ -505,6 +515,7 @@ class Dex2Oat FINAL {
       dump_cfg_append_(false),
       swap_fd_(-1),
       app_image_fd_(kInvalidImageFd),
+      class_loader_(nullptr),
       timings_(timings) {}
 
   ~Dex2Oat() {
@@ -903,6 +914,10 @@ class Dex2Oat FINAL {
         VLOG(compiler) << "dex2oat: profile file is " << profile_file_;
       } else if (option == "--no-profile-file") {
         // No profile
+      } else if (option.starts_with("--code-layout-profile=")) {
+        code_layout_profile_ = option.substr(strlen("--code-layout-profile=")).data();
+      } else if (option.starts_with("--image-layout-profile=")) {
+        image_layout_profile_ = option.substr(strlen("--image-layout-profile=")).data();
       } else if (option == "--host") {
         is_host_ = true;
       } else if (option == "--runtime-arg") {
@@ -1258,6 +1273,8 @@ class Dex2Oat FINAL {
 
       // Class path loader as parent so that we'll resolve there first.
       class_loader = class_linker->CreatePathClassLoader(self, dex_files_, class_path_class_loader);
+      // Keep the loader around, app image classes are looked up through it when writing the image.
+      class_loader_ = class_loader;
     }
 
     driver_.reset(new CompilerDriver(compiler_options_.get(),
@@ -1281,6 +1298,10 @@ class Dex2Oat FINAL {
 
     driver_->SetDexFilesForOatFile(dex_files_);
     driver_->CompileAll(class_loader, dex_files_, timings_);
+
+    // The runtime is usually leaked rather than shut down, so persist the verification outcomes
+    // (see -Xverification-cache) as soon as they are all known.
+    Runtime::Current()->SaveVerificationCache();
   }
 
   // Notes on the interleaving of creating the image and oat file to
@@ -1388,6 +1409,19 @@ class Dex2Oat FINAL {
         key_value_store_->Put(OatHeader::kImageLocationKey, image_file_location);
       }
 
+      if (!code_layout_profile_.empty()) {
+        std::string error_msg;
+        if (!OfflineProfilingInfo::LoadMethods(code_layout_profile_,
+                                               dex_files_,
+                                               &hot_methods_,
+                                               &error_msg)) {
+          // The layout is only an optimization, carry on without it.
+          LOG(WARNING) << "Failed to load code layout profile: " << error_msg;
+          hot_methods_.clear();
+        }
+        VLOG(compiler) << "Placing code of " << hot_methods_.size() << " hot methods first";
+      }
+
       oat_writer.reset(new OatWriter(dex_files_,
                                      image_file_location_oat_checksum,
                                      image_file_location_oat_data_begin,
@@ -1396,7 +1430,8 @@ class Dex2Oat FINAL {
                                      image_writer_.get(),
                                      IsBootImage(),
                                      timings_,
-                                     key_value_store_.get()));
+                                     key_value_store_.get(),
+                                     &hot_methods_));
     }
 
     if (IsImage()) {
@@ -1639,10 +1674,20 @@ class Dex2Oat FINAL {
 
   void PrepareImageWriter(uintptr_t image_base) {
     DCHECK(IsImage());
+    if (!image_layout_profile_.empty()) {
+      std::function<std::string(const char*)> process = DotToDescriptor;
+      startup_classes_.reset(ReadOrderedInputFromFile(image_layout_profile_.c_str(), &process));
+      if (startup_classes_ == nullptr) {
+        // The layout is only an optimization, carry on without it.
+        LOG(WARNING) << "Failed to load image layout profile " << image_layout_profile_;
+      }
+    }
     image_writer_.reset(new ImageWriter(*driver_,
                                         image_base,
                                         compiler_options_->GetCompilePic(),
-                                        IsAppImage()));
+                                        IsAppImage(),
+                                        startup_classes_.get(),
+                                        IsAppImage() ? class_loader_ : nullptr));
   }
 
   // Let the ImageWriter write the image file. If we do not compile PIC, also fix up the oat file.
@@ -1715,6 +1760,31 @@ class Dex2Oat FINAL {
     return result.release();
   }
 
+  // Read lines from the given file, dropping comments, empty lines and duplicates but keeping the
+  // order of first occurrence. Post-process each line with the given function.
+  static std::vector<std::string>* ReadOrderedInputFromFile(
+      const char* input_filename, std::function<std::string(const char*)>* process) {
+    std::ifstream input_file(input_filename, std::ifstream::in);
+    if (!input_file.good()) {
+      LOG(ERROR) << "Failed to open input file " << input_filename;
+      return nullptr;
+    }
+    std::unique_ptr<std::vector<std::string>> result(new std::vector<std::string>);
+    std::unordered_set<std::string> seen;
+    while (input_file.good()) {
+      std::string line;
+      std::getline(input_file, line);
+      if (StartsWith(line, "#") || line.empty()) {
+        continue;
+      }
+      std::string entry = (process != nullptr) ? (*process)(line.c_str()) : line;
+      if (seen.insert(entry).second) {
+        result->push_back(entry);
+      }
+    }
+    return result.release();
+  }
+
   // Read lines from the given file from the given zip file, dropping comments and empty lines.
   // Post-process each line with the given function.
   static std::unordered_set<std::string>* ReadCommentedInputFromZip(
@@ -1773,10 +1843,12 @@ class Dex2Oat FINAL {
     // Note: when creation of a runtime fails, e.g., when trying to compile an app but when there
     //       is no image, there won't be a Runtime::Current().
     // Note: driver creation can fail when loading an invalid dex file.
+    // Note: --dump-stats also reports the dedupe statistics of the compiled method storage.
+    const bool extended = kIsDebugBuild || VLOG_IS_ON(compiler) || dump_stats_;
     LOG(INFO) << "dex2oat took " << PrettyDuration(NanoTime() - start_ns_)
               << " (threads: " << thread_count_ << ") "
               << ((Runtime::Current() != nullptr && driver_ != nullptr) ?
-                  driver_->GetMemoryUsageString(kIsDebugBuild || VLOG_IS_ON(compiler)) :
+                  driver_->GetMemoryUsageString(extended) :
                   "");
   }
 
@@ -1847,6 +1919,15 @@ class Dex2Oat FINAL {
   std::string app_image_file_name_;
   int app_image_fd_;
   std::string profile_file_;  // Profile file to use
+  std::string code_layout_profile_;
+  // Methods from the code layout profile, referenced by the OatWriter.
+  std::set<MethodReference, MethodReferenceComparator> hot_methods_;
+  std::string image_layout_profile_;
+  // Classes from the image layout profile in first-touch order, referenced by the ImageWriter.
+  std::unique_ptr<std::vector<std::string>> startup_classes_;
+  // Global reference to the class loader of the compiled dex files, null when compiling the boot
+  // image.
+  jobject class_loader_;
   TimingLogger* timings_;
   std::unique_ptr<CumulativeLogger> compiler_phases_timings_;
 
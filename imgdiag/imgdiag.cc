@@ -241,6 +241,9 @@ class ImgDiagDumper {
     size_t dirty_pages = 0;
     size_t private_pages = 0;
     size_t private_dirty_pages = 0;
+    size_t resident_pages = 0;
+    // Number of dirty pages overlapping each image section.
+    size_t section_dirty_pages[ImageHeader::kSectionCount] = {};
 
     // Iterate through one page at a time. Boot map begin/end already implicitly aligned.
     for (uintptr_t begin = boot_map.start; begin != boot_map.end; begin += kPageSize) {
@@ -307,6 +310,32 @@ class ImgDiagDumper {
           dirty_pages++;
           dirty_page_set_remote.insert(dirty_page_set_remote.end(), remote_virtual_page_idx);
           dirty_page_set_local.insert(dirty_page_set_local.end(), virtual_page_idx);
+
+          // Attribute the dirty page to the image sections it overlaps, to tell how well the
+          // image layout packs the objects written at runtime.
+          const intptr_t page_image_offset = static_cast<intptr_t>(begin) -
+              reinterpret_cast<intptr_t>(image_begin_unaligned);
+          for (size_t i = 0; i < ImageHeader::kSectionCount; ++i) {
+            const ImageSection& section =
+                boot_image_header.GetImageSection(static_cast<ImageHeader::ImageSections>(i));
+            if (section.Size() != 0u &&
+                page_image_offset < static_cast<intptr_t>(section.End()) &&
+                page_image_offset + static_cast<intptr_t>(kPageSize) >
+                    static_cast<intptr_t>(section.Offset())) {
+              section_dirty_pages[i]++;
+            }
+          }
+        }
+
+        // Pages the remote process has faulted in, or shares with the zygote.
+        bool is_resident = false;
+        if (!IsPageResident(page_map_file.get(), remote_virtual_page_idx, &is_resident,
+                            &error_msg)) {
+          os << error_msg;
+          return false;
+        }
+        if (is_resident) {
+          resident_pages++;
         }
 
         bool is_dirty = dirtiness > 0;
@@ -485,9 +514,21 @@ class ImgDiagDumper {
        << dirty_pages << " pages are dirty; \n  "
        << false_dirty_pages << " pages are false dirty; \n  "
        << private_pages << " pages are private; \n  "
-       << private_dirty_pages << " pages are Private_Dirty\n  "
+       << private_dirty_pages << " pages are Private_Dirty; \n  "
+       << resident_pages << " pages are resident\n  "
        << "";
 
+    os << "\n" << "  Dirty page count by image section:\n";
+    for (size_t i = 0; i < ImageHeader::kSectionCount; ++i) {
+      const ImageSection& section =
+          boot_image_header.GetImageSection(static_cast<ImageHeader::ImageSections>(i));
+      if (section.Size() != 0u) {
+        os << "    " << static_cast<ImageHeader::ImageSections>(i) << " ("
+           << section_dirty_pages[i] << " of "
+           << RoundUp(section.Size(), kPageSize) / kPageSize << " pages)\n";
+      }
+    }
+
     // vector of pairs (int count, Class*)
     auto dirty_object_class_values = SortByValueDesc(dirty_object_class_map);
     auto clean_object_class_values = SortByValueDesc(clean_object_class_map);
@@ -741,6 +782,29 @@ class ImgDiagDumper {
     return true;
   }
 
+  static bool IsPageResident(File* page_map_file,
+                             size_t virtual_page_index,
+                             bool* is_resident,
+                             std::string* error_msg) {
+    CHECK(page_map_file != nullptr);
+    CHECK(is_resident != nullptr);
+    CHECK(error_msg != nullptr);
+
+    constexpr size_t kPageMapEntrySize = sizeof(uint64_t);
+    constexpr uint64_t kPagePresentMask = (1ULL << 63);  // bit 63 [in /proc/$pid/pagemap]
+
+    uint64_t page_map_entry = 0;
+    if (!page_map_file->PreadFully(&page_map_entry, kPageMapEntrySize,
+                                  virtual_page_index * kPageMapEntrySize)) {
+      *error_msg = StringPrintf("Failed to read the virtual page index entry from %s",
+                                page_map_file->GetPath().c_str());
+      return false;
+    }
+
+    *is_resident = (page_map_entry & kPagePresentMask) != 0;
+    return true;
+  }
+
   static int IsPageDirty(File* page_map_file,
                          File* clean_page_map_file,
                          File* kpage_flags_file,
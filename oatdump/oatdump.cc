@@ -42,6 +42,7 @@
 #include "gc/space/space-inl.h"
 #include "image.h"
 #include "indenter.h"
+#include "jit/offline_profiling_info.h"
 #include "mapping_table.h"
 #include "mirror/array-inl.h"
 #include "mirror/class-inl.h"
@@ -331,7 +332,8 @@ class OatDumperOptions {
                    bool list_classes,
                    bool list_methods,
                    const char* export_dex_location,
-                   uint32_t addr2instr)
+                   uint32_t addr2instr,
+                   const char* profile_page_ins)
     : dump_raw_mapping_table_(dump_raw_mapping_table),
       dump_raw_gc_map_(dump_raw_gc_map),
       dump_vmap_(dump_vmap),
@@ -344,6 +346,7 @@ class OatDumperOptions {
       list_methods_(list_methods),
       export_dex_location_(export_dex_location),
       addr2instr_(addr2instr),
+      profile_page_ins_(profile_page_ins),
       class_loader_(nullptr) {}
 
   const bool dump_raw_mapping_table_;
@@ -358,6 +361,7 @@ class OatDumperOptions {
   const bool list_methods_;
   const char* const export_dex_location_;
   uint32_t addr2instr_;
+  const char* const profile_page_ins_;
   Handle<mirror::ClassLoader>* class_loader_;
 };
 
@@ -480,6 +484,10 @@ class OatDumper {
       os << StringPrintf("0x%08x\n\n", resolved_addr2instr_);
     }
 
+    if (options_.profile_page_ins_ != nullptr) {
+      return DumpProfilePageIns(os);
+    }
+
     for (size_t i = 0; i < oat_dex_files_.size(); i++) {
       const OatFile::OatDexFile* oat_dex_file = oat_dex_files_[i];
       CHECK(oat_dex_file != nullptr);
@@ -495,6 +503,9 @@ class OatDumper {
         }
       }
     }
+    if (code_info_stats_.number_of_code_infos != 0u) {
+      code_info_stats_.Dump(os);
+    }
     os << std::flush;
     return success;
   }
@@ -541,6 +552,80 @@ class OatDumper {
   }
 
  private:
+  // Report how many pages of the executable section the code of the methods listed in a profile
+  // spans. Running this with a startup profile shows how well the code layout groups hot code.
+  bool DumpProfilePageIns(std::ostream& os) {
+    std::vector<const DexFile*> dex_files;
+    std::string error_msg;
+    for (const OatFile::OatDexFile* oat_dex_file : oat_dex_files_) {
+      const DexFile* const dex_file = OpenDexFile(oat_dex_file, &error_msg);
+      if (dex_file == nullptr) {
+        os << "Failed to open dex file '" << oat_dex_file->GetDexFileLocation() << "': "
+           << error_msg << "\n";
+        return false;
+      }
+      dex_files.push_back(dex_file);
+    }
+    std::set<MethodReference, MethodReferenceComparator> methods;
+    if (!OfflineProfilingInfo::LoadMethods(options_.profile_page_ins_,
+                                           dex_files,
+                                           &methods,
+                                           &error_msg)) {
+      os << error_msg << "\n";
+      return false;
+    }
+
+    std::set<size_t> pages;
+    size_t methods_with_code = 0u;
+    for (size_t i = 0; i < dex_files.size(); i++) {
+      const DexFile* dex_file = dex_files[i];
+      for (size_t class_def_index = 0;
+           class_def_index < dex_file->NumClassDefs();
+           class_def_index++) {
+        const uint8_t* class_data = dex_file->GetClassData(dex_file->GetClassDef(class_def_index));
+        if (class_data == nullptr) {
+          continue;
+        }
+        const OatFile::OatClass oat_class = oat_dex_files_[i]->GetOatClass(class_def_index);
+        ClassDataItemIterator it(*dex_file, class_data);
+        SkipAllFields(it);
+        for (uint32_t class_method_index = 0;
+             it.HasNextDirectMethod() || it.HasNextVirtualMethod();
+             class_method_index++, it.Next()) {
+          if (methods.find(MethodReference(dex_file, it.GetMemberIndex())) == methods.end()) {
+            continue;
+          }
+          const OatFile::OatMethod oat_method = oat_class.GetOatMethod(class_method_index);
+          uint32_t code_offset = AlignCodeOffset(oat_method.GetCodeOffset());
+          uint32_t code_size = oat_method.GetQuickCodeSize();
+          if (code_offset == 0u || code_size == 0u) {
+            continue;
+          }
+          ++methods_with_code;
+          // The method header is read when walking the stack, count it as well.
+          size_t first_page = (code_offset - sizeof(OatQuickMethodHeader)) / kPageSize;
+          size_t last_page = (code_offset + code_size - 1u) / kPageSize;
+          for (size_t page = first_page; page <= last_page; ++page) {
+            pages.insert(page);
+          }
+        }
+      }
+    }
+
+    const size_t executable_offset = oat_file_.GetOatHeader().GetExecutableOffset();
+    const size_t total_pages =
+        RoundUp(oat_file_.Size(), kPageSize) / kPageSize - executable_offset / kPageSize;
+    os << "PROFILE PAGE-INS:\n";
+    os << "methods in profile: " << methods.size() << "\n";
+    os << "methods with compiled code: " << methods_with_code << "\n";
+    os << StringPrintf("code pages touched: %zu of %zu (%.1f%%)\n\n",
+                       pages.size(),
+                       total_pages,
+                       total_pages == 0u ? 0.0 : 100.0 * pages.size() / total_pages);
+    os << std::flush;
+    return true;
+  }
+
   void AddAllOffsets() {
     // We don't know the length of the code for each method, but we need to know where to stop
     // when disassembling. What we do know is that a region of code will be followed by some other
@@ -1054,6 +1139,9 @@ class OatDumper {
       if (raw_code_info != nullptr) {
         CodeInfo code_info(raw_code_info);
         DCHECK(code_item != nullptr);
+        if (seen_code_infos_.insert(raw_code_info).second) {
+          code_info_stats_.Add(code_info);
+        }
         ScopedIndentation indent1(vios);
         DumpCodeInfo(vios, code_info, oat_method, *code_item);
       }
@@ -1465,6 +1553,89 @@ class OatDumper {
     }
   }
 
+  // Size breakdown of the (deduplicated) CodeInfo objects emitted by the optimizing compiler.
+  struct CodeInfoStats {
+    size_t number_of_code_infos;
+    size_t number_of_stack_maps;
+    size_t number_of_register_masks;
+    size_t number_of_stack_masks;
+    size_t total_bytes;
+    size_t header_bytes;
+    size_t stack_maps_bytes;
+    size_t register_masks_bytes;
+    size_t stack_masks_bytes;
+    size_t location_catalog_bytes;
+    size_t dex_register_maps_and_inline_infos_bytes;
+
+    CodeInfoStats()
+        : number_of_code_infos(0),
+          number_of_stack_maps(0),
+          number_of_register_masks(0),
+          number_of_stack_masks(0),
+          total_bytes(0),
+          header_bytes(0),
+          stack_maps_bytes(0),
+          register_masks_bytes(0),
+          stack_masks_bytes(0),
+          location_catalog_bytes(0),
+          dex_register_maps_and_inline_infos_bytes(0) {}
+
+    void Add(const CodeInfo& code_info) {
+      StackMapEncoding encoding = code_info.ExtractEncoding();
+      size_t dex_register_maps_offset = code_info.GetDexRegisterMapsOffset(encoding);
+      number_of_code_infos++;
+      number_of_stack_maps += code_info.GetNumberOfStackMaps();
+      number_of_register_masks += code_info.GetNumberOfRegisterMasks();
+      number_of_stack_masks += code_info.GetNumberOfStackMasks();
+      total_bytes += code_info.GetOverallSize();
+      header_bytes += code_info.GetStackMapsOffset();
+      stack_maps_bytes += code_info.GetStackMapsSize(encoding);
+      register_masks_bytes += code_info.GetRegisterMasksSize(encoding);
+      stack_masks_bytes += code_info.GetStackMasksSize(encoding);
+      location_catalog_bytes += code_info.GetDexRegisterLocationCatalogSize(encoding);
+      dex_register_maps_and_inline_infos_bytes +=
+          code_info.GetOverallSize() - dex_register_maps_offset;
+    }
+
+    double PercentOfTotalBytes(size_t size) const {
+      return (static_cast<double>(size) / static_cast<double>(total_bytes)) * 100;
+    }
+
+    void Dump(std::ostream& os) const {
+      os << "CODE INFO STATISTICS:\n";
+      os << StringPrintf("code_infos = %zd, stack_maps = %zd, total_bytes = %zd\n",
+                         number_of_code_infos,
+                         number_of_stack_maps,
+                         total_bytes);
+      os << StringPrintf("header_bytes                = %8zd (%2.0f%% of code info bytes)\n"
+                         "stack_maps_bytes            = %8zd (%2.0f%% of code info bytes)\n"
+                         "register_masks_bytes        = %8zd (%2.0f%% of code info bytes)\n"
+                         "stack_masks_bytes           = %8zd (%2.0f%% of code info bytes)\n"
+                         "location_catalog_bytes      = %8zd (%2.0f%% of code info bytes)\n"
+                         "dex_register_maps_and_inline_infos_bytes = "
+                         "%8zd (%2.0f%% of code info bytes)\n",
+                         header_bytes, PercentOfTotalBytes(header_bytes),
+                         stack_maps_bytes, PercentOfTotalBytes(stack_maps_bytes),
+                         register_masks_bytes, PercentOfTotalBytes(register_masks_bytes),
+                         stack_masks_bytes, PercentOfTotalBytes(stack_masks_bytes),
+                         location_catalog_bytes, PercentOfTotalBytes(location_catalog_bytes),
+                         dex_register_maps_and_inline_infos_bytes,
+                         PercentOfTotalBytes(dex_register_maps_and_inline_infos_bytes));
+      if (number_of_stack_maps != 0u) {
+        os << StringPrintf("average_stack_map_bits      = %8.1f\n"
+                           "distinct_register_masks     = %8zd (%2.0f%% of stack maps)\n"
+                           "distinct_stack_masks        = %8zd (%2.0f%% of stack maps)\n",
+                           static_cast<double>(stack_maps_bytes * kBitsPerByte) /
+                               number_of_stack_maps,
+                           number_of_register_masks,
+                           100.0 * number_of_register_masks / number_of_stack_maps,
+                           number_of_stack_masks,
+                           100.0 * number_of_stack_masks / number_of_stack_maps);
+      }
+      os << "\n";
+    }
+  };
+
   const OatFile& oat_file_;
   const std::vector<const OatFile::OatDexFile*> oat_dex_files_;
   const OatDumperOptions& options_;
@@ -1472,6 +1643,8 @@ class OatDumper {
   InstructionSet instruction_set_;
   std::set<uintptr_t> offsets_;
   Disassembler* disassembler_;
+  std::set<const void*> seen_code_infos_;
+  CodeInfoStats code_info_stats_;
 };
 
 class ImageDumper {
@@ -2512,6 +2685,8 @@ struct OatdumpArgs : public CmdlineArgs {
       list_methods_ = true;
     } else if (option.starts_with("--export-dex-to=")) {
       export_dex_location_ = option.substr(strlen("--export-dex-to=")).data();
+    } else if (option.starts_with("--profile-page-ins=")) {
+      profile_page_ins_ = option.substr(strlen("--profile-page-ins=")).data();
     } else if (option.starts_with("--addr2instr=")) {
       if (!ParseUint(option.substr(strlen("--addr2instr=")).data(), &addr2instr_)) {
         *error_msg = "Address conversion failed";
@@ -2605,6 +2780,10 @@ struct OatdumpArgs : public CmdlineArgs {
         "  --addr2instr=<address>: output matching method disassembled code from relative\n"
         "                          address (e.g. PC from crash dump)\n"
         "      Example: --addr2instr=0x00001a3b\n"
+        "\n"
+        "  --profile-page-ins=<file>: report how many pages of code the methods listed in a\n"
+        "                             JIT profile span instead of dumping the oat file.\n"
+        "      Example: --profile-page-ins=/data/misc/profiles/com.example.app\n"
         "\n";
 
     return usage;
@@ -2626,6 +2805,7 @@ struct OatdumpArgs : public CmdlineArgs {
   bool list_methods_ = false;
   uint32_t addr2instr_ = 0;
   const char* export_dex_location_ = nullptr;
+  const char* profile_page_ins_ = nullptr;
 };
 
 struct OatdumpMain : public CmdlineMain<OatdumpArgs> {
@@ -2647,7 +2827,8 @@ struct OatdumpMain : public CmdlineMain<OatdumpArgs> {
         args_->list_classes_,
         args_->list_methods_,
         args_->export_dex_location_,
-        args_->addr2instr_));
+        args_->addr2instr_,
+        args_->profile_page_ins_));
 
     return (args_->boot_image_location_ != nullptr || args_->image_location_ != nullptr) &&
           !args_->symbolize_;
@@ -38,6 +38,7 @@ LIBART_COMMON_SRC_FILES := \
   base/timing_logger.cc \
   base/unix_file/fd_file.cc \
   base/unix_file/random_access_file_utils.cc \
+  cha.cc \
   check_jni.cc \
   class_linker.cc \
   class_table.cc \
@@ -189,6 +190,7 @@ LIBART_COMMON_SRC_FILES := \
   verifier/reg_type.cc \
   verifier/reg_type_cache.cc \
   verifier/register_line.cc \
+  verifier/verification_cache.cc \
   well_known_classes.cc \
   zip_archive.cc
 
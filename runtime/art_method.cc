@@ -330,7 +330,7 @@ void ArtMethod::RegisterNative(const void* native_method, bool is_fast) {
   CHECK(!IsFastNative()) << PrettyMethod(this);
   CHECK(native_method != nullptr) << PrettyMethod(this);
   if (is_fast) {
-    SetAccessFlags(GetAccessFlags() | kAccFastNative);
+    AddAccessFlagsAtomic(kAccFastNative);
   }
   SetEntryPointFromJni(native_method);
 }
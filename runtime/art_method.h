@@ -84,6 +84,20 @@ class ArtMethod FINAL {
     access_flags_ = new_access_flags;
   }
 
+  // Atomically set `flags`, for methods whose flags other threads may be updating.
+  void AddAccessFlagsAtomic(uint32_t flags) {
+    reinterpret_cast<Atomic<uint32_t>*>(&access_flags_)->FetchAndOrSequentiallyConsistent(flags);
+  }
+
+  // Atomically clear `flags`, for methods whose flags other threads may be updating.
+  void ClearAccessFlagsAtomic(uint32_t flags) {
+    reinterpret_cast<Atomic<uint32_t>*>(&access_flags_)->FetchAndAndSequentiallyConsistent(~flags);
+  }
+
+  static MemberOffset AccessFlagsOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(ArtMethod, access_flags_));
+  }
+
   // Approximate what kind of method call would be used for this method.
   InvokeType GetInvokeType() SHARED_REQUIRES(Locks::mutator_lock_);
 
@@ -179,7 +193,20 @@ class ArtMethod FINAL {
 
   void SetPreverified() {
     DCHECK(!IsPreverified());
-    SetAccessFlags(GetAccessFlags() | kAccPreverified);
+    // Class hierarchy analysis may concurrently update the flags of virtual methods.
+    AddAccessFlagsAtomic(kAccPreverified);
+  }
+
+  // Returns true if no loaded class overrides this virtual method, so that calls to it can be
+  // devirtualized as long as no overriding class gets loaded.
+  bool IsSingleImplementation() {
+    return (GetAccessFlags() & kAccSingleImplementation) != 0;
+  }
+
+  // Returns true if compiled code of this method relied on a single implementation assumption
+  // that no longer holds.
+  bool HasInvalidatedSingleImplementationAssumption() {
+    return (GetAccessFlags() & kAccSingleImplementationInvalidated) != 0;
   }
 
   // Returns true if this method could be overridden by a default method.
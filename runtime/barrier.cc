@@ -30,8 +30,17 @@ Barrier::Barrier(int count)
 }
 
 void Barrier::Pass(Thread* self) {
+  // Checkpoints of many threads pass the barrier concurrently. Avoid contending on the lock
+  // unless this pass wakes up the waiters.
+  int count = count_.LoadRelaxed();
+  while (count != 1) {
+    if (count_.CompareExchangeWeakSequentiallyConsistent(count, count - 1)) {
+      return;
+    }
+    count = count_.LoadRelaxed();
+  }
   MutexLock mu(self, lock_);
-  SetCountLocked(self, count_ - 1);
+  AddToCountLocked(self, -1);
 }
 
 void Barrier::Wait(Thread* self) {
@@ -45,7 +54,7 @@ void Barrier::Init(Thread* self, int count) {
 
 void Barrier::Increment(Thread* self, int delta) {
   MutexLock mu(self, lock_);
-  SetCountLocked(self, count_ + delta);
+  AddToCountLocked(self, delta);
 
   // Increment the count.  If it becomes zero after the increment
   // then all the threads have already passed the barrier.  If
@@ -54,21 +63,21 @@ void Barrier::Increment(Thread* self, int delta) {
   // Pass function is called by the last thread, the count will
   // be decremented to zero and a Broadcast will be made on the
   // condition variable, thus waking this up.
-  while (count_ != 0) {
+  while (count_.LoadSequentiallyConsistent() != 0) {
     condition_.Wait(self);
   }
 }
 
 bool Barrier::Increment(Thread* self, int delta, uint32_t timeout_ms) {
   MutexLock mu(self, lock_);
-  SetCountLocked(self, count_ + delta);
+  AddToCountLocked(self, delta);
   bool timed_out = false;
-  if (count_ != 0) {
+  if (count_.LoadSequentiallyConsistent() != 0) {
     uint32_t timeout_ns = 0;
     uint64_t abs_timeout = NanoTime() + MsToNs(timeout_ms);
     for (;;) {
       timed_out = condition_.TimedWait(self, timeout_ms, timeout_ns);
-      if (timed_out || count_ == 0) return timed_out;
+      if (timed_out || count_.LoadSequentiallyConsistent() == 0) return timed_out;
       // Compute time remaining on timeout.
       uint64_t now = NanoTime();
       int64_t time_left = abs_timeout - now;
@@ -81,19 +90,26 @@ bool Barrier::Increment(Thread* self, int delta, uint32_t timeout_ms) {
 }
 
 void Barrier::SetCountLocked(Thread* self, int count) {
-  count_ = count;
+  count_.StoreSequentiallyConsistent(count);
   if (count == 0) {
     condition_.Broadcast(self);
   }
 }
 
+void Barrier::AddToCountLocked(Thread* self, int delta) {
+  // Passes may concurrently decrement the count without holding the lock.
+  if (count_.FetchAndAddSequentiallyConsistent(delta) + delta == 0) {
+    condition_.Broadcast(self);
+  }
+}
+
 Barrier::~Barrier() {
   if (gAborting == 0) {
     // Only check when not aborting.
-    CHECK_EQ(count_, 0) << "Attempted to destroy barrier with non zero count";
+    CHECK_EQ(count_.LoadRelaxed(), 0) << "Attempted to destroy barrier with non zero count";
   } else {
-    if (count_ != 0) {
-      LOG(WARNING) << "Attempted to destroy barrier with non zero count " << count_;
+    if (count_.LoadRelaxed() != 0) {
+      LOG(WARNING) << "Attempted to destroy barrier with non zero count " << count_.LoadRelaxed();
     }
   }
 }
@@ -28,6 +28,7 @@
 #define ART_RUNTIME_BARRIER_H_
 
 #include <memory>
+#include "atomic.h"
 #include "base/mutex.h"
 
 namespace art {
@@ -38,7 +39,8 @@ class Barrier {
   explicit Barrier(int count);
   virtual ~Barrier();
 
-  // Pass through the barrier, decrement the count but do not block.
+  // Pass through the barrier, decrement the count but do not block. Only takes the lock if the
+  // count drops to zero.
   void Pass(Thread* self) REQUIRES(!lock_);
 
   // Wait on the barrier, decrement the count.
@@ -63,9 +65,12 @@ class Barrier {
 
  private:
   void SetCountLocked(Thread* self, int count) REQUIRES(lock_);
+  void AddToCountLocked(Thread* self, int delta) REQUIRES(lock_);
 
-  // Counter, when this reaches 0 all people blocked on the barrier are signalled.
-  int count_ GUARDED_BY(lock_);
+  // Counter, when this reaches 0 all people blocked on the barrier are signalled. It may be
+  // decremented without holding `lock_`, but only while it stays non zero, so that waiters
+  // checking it under `lock_` cannot miss the broadcast.
+  AtomicInteger count_;
 
   Mutex lock_ ACQUIRED_AFTER(Locks::abort_lock_);
   ConditionVariable condition_ GUARDED_BY(lock_);
@@ -127,4 +127,30 @@ TEST_F(BarrierTest, CheckPass) {
   EXPECT_EQ(count.LoadRelaxed(), expected_total_tasks);
 }
 
+// Check that a thread waiting before the passes start is woken up by the last one, though
+// only that pass takes the barrier lock.
+TEST_F(BarrierTest, CheckPassWakesWaiter) {
+  Thread* self = Thread::Current();
+  ThreadPool thread_pool("Barrier test thread pool", num_threads);
+  Barrier barrier(0);
+  const int32_t num_tasks = num_threads * 4;
+  const int32_t num_sub_tasks = 128;
+  const int32_t expected_total_tasks = num_sub_tasks * num_tasks;
+  // Several rounds, so that the last pass races with the waiter in different ways.
+  for (size_t round = 0; round < 16; ++round) {
+    AtomicInteger count(0);
+    barrier.Init(self, expected_total_tasks);
+    for (int32_t i = 0; i < num_tasks; ++i) {
+      thread_pool.AddTask(self, new CheckPassTask(&barrier, &count, num_sub_tasks));
+    }
+    thread_pool.StartWorkers(self);
+    // Wait without changing the count, failing instead of hanging if a wakeup is missed.
+    bool timed_out = barrier.Increment(self, 0, 30 * 1000);
+    ASSERT_FALSE(timed_out);
+    EXPECT_EQ(count.LoadRelaxed(), expected_total_tasks);
+    thread_pool.Wait(self, true, false);
+    thread_pool.StopWorkers(self);
+  }
+}
+
 }  // namespace art
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cha.h"
+
+#include <algorithm>
+
+#include "art_method-inl.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
+#include "linear_alloc.h"
+#include "mirror/class-inl.h"
+#include "runtime.h"
+#include "thread.h"
+#include "utils.h"
+
+namespace art {
+
+ClassHierarchyAnalysis::ClassHierarchyAnalysis()
+    : lock_("Class hierarchy analysis lock", kCHALock) {
+}
+
+void ClassHierarchyAnalysis::UpdateAfterLinkingMethods(Thread* self,
+                                                       Handle<mirror::Class> klass,
+                                                       size_t pointer_size) {
+  if (klass->IsInterface()) {
+    // Interface methods are only dispatched through the interface tables.
+    return;
+  }
+
+  for (size_t i = 0, e = klass->NumVirtualMethods(); i < e; ++i) {
+    ArtMethod* method = klass->GetVirtualMethodDuringLinking(i, pointer_size);
+    // Methods copied from interfaces are shared by all implementations, skip them.
+    if (!method->IsAbstract() && !method->IsMiranda() && !method->IsDefault()) {
+      method->AddAccessFlagsAtomic(kAccSingleImplementation);
+    }
+  }
+
+  mirror::Class* super_class = klass->GetSuperClass();
+  if (super_class == nullptr) {
+    return;
+  }
+  std::vector<ArtMethod*> invalidated;
+  {
+    MutexLock mu(self, lock_);
+    mirror::PointerArray* vtable = klass->GetVTableDuringLinking();
+    for (int32_t i = 0, e = super_class->GetVTableLength(); i < e; ++i) {
+      ArtMethod* super_method = super_class->GetVTableEntry(i, pointer_size);
+      if (!super_method->IsSingleImplementation() ||
+          vtable->GetElementPtrSize<ArtMethod*>(i, pointer_size) == super_method) {
+        continue;
+      }
+      // Clear the flag under the lock, so that the JIT cannot register new dependencies on it.
+      super_method->ClearAccessFlagsAtomic(kAccSingleImplementation);
+      auto it = dependents_.find(super_method);
+      if (it != dependents_.end()) {
+        VLOG(jit) << PrettyMethod(super_method) << " is overridden by "
+                  << PrettyClass(klass.Get()) << ", invalidating "
+                  << it->second.size() << " compiled method(s)";
+        invalidated.insert(invalidated.end(), it->second.begin(), it->second.end());
+        dependents_.erase(it);
+      }
+    }
+  }
+
+  // The overriding class is not linked yet, so no instance of it can reach the invalidated code
+  // before we are done.
+  for (ArtMethod* dependent : invalidated) {
+    InvalidateCompiledCode(self, dependent);
+  }
+}
+
+bool ClassHierarchyAnalysis::AddDependencies(Thread* self,
+                                             ArtMethod* dependent,
+                                             const ArenaSet<ArtMethod*>& methods) {
+  MutexLock mu(self, lock_);
+  for (ArtMethod* method : methods) {
+    if (!method->IsSingleImplementation()) {
+      return false;
+    }
+  }
+  for (ArtMethod* method : methods) {
+    dependents_[method].push_back(dependent);
+  }
+  return true;
+}
+
+void ClassHierarchyAnalysis::RemoveDependenciesIn(Thread* self, const LinearAlloc& alloc) {
+  MutexLock mu(self, lock_);
+  for (auto it = dependents_.begin(); it != dependents_.end();) {
+    if (alloc.ContainsUnsafe(it->first)) {
+      it = dependents_.erase(it);
+      continue;
+    }
+    std::vector<ArtMethod*>& dependents = it->second;
+    dependents.erase(std::remove_if(dependents.begin(),
+                                    dependents.end(),
+                                    [&alloc](ArtMethod* dependent) {
+                                      return alloc.ContainsUnsafe(dependent);
+                                    }),
+                     dependents.end());
+    ++it;
+  }
+}
+
+void ClassHierarchyAnalysis::InvalidateCompiledCode(Thread* self, ArtMethod* dependent) {
+  // Running code checks this flag where it relied on the broken assumption, and the JIT stops
+  // making such assumptions for the method.
+  dependent->AddAccessFlagsAtomic(kAccSingleImplementationInvalidated);
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit != nullptr) {
+    jit->GetCodeCache()->InvalidateCompiledCodeFor(self, dependent);
+  }
+}
+
+}  // namespace art
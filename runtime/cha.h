@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_CHA_H_
+#define ART_RUNTIME_CHA_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "base/arena_containers.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "handle.h"
+
+namespace art {
+
+class ArtMethod;
+class LinearAlloc;
+
+namespace mirror {
+class Class;
+}  // namespace mirror
+
+// Class hierarchy analysis. Keeps track of the virtual methods that no loaded class overrides,
+// through the kAccSingleImplementation flag, so that the JIT can devirtualize calls to them.
+// The JIT registers the compiled methods relying on such an assumption, and loading a class
+// that breaks it invalidates their code: the code deoptimizes where it relied on the
+// assumption, and is no longer used as the entry point of the method.
+class ClassHierarchyAnalysis {
+ public:
+  ClassHierarchyAnalysis();
+
+  // Update the single implementation information once the virtual methods of `klass` have been
+  // linked. The methods `klass` declares have a single implementation, as no subclass can be
+  // loaded yet, and the methods it overrides no longer have one.
+  void UpdateAfterLinkingMethods(Thread* self, Handle<mirror::Class> klass, size_t pointer_size)
+      SHARED_REQUIRES(Locks::mutator_lock_)
+      REQUIRES(!lock_);
+
+  // Record that the compiled code of `dependent` relies on each of `methods` having a single
+  // implementation. Return false, without recording anything, if one of them no longer has.
+  bool AddDependencies(Thread* self,
+                       ArtMethod* dependent,
+                       const ArenaSet<ArtMethod*>& methods)
+      SHARED_REQUIRES(Locks::mutator_lock_)
+      REQUIRES(!lock_);
+
+  // Forget about the methods allocated in `alloc`, whose class loader is being unloaded.
+  void RemoveDependenciesIn(Thread* self, const LinearAlloc& alloc) REQUIRES(!lock_);
+
+ private:
+  void InvalidateCompiledCode(Thread* self, ArtMethod* dependent)
+      SHARED_REQUIRES(Locks::mutator_lock_)
+      REQUIRES(!lock_);
+
+  Mutex lock_;
+
+  // The compiled methods relying on each single implementation method.
+  std::unordered_map<ArtMethod*, std::vector<ArtMethod*>> dependents_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(ClassHierarchyAnalysis);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_CHA_H_
@@ -71,8 +71,8 @@ class CheckReferenceMapVisitor : public StackVisitor {
     uint16_t number_of_dex_registers = m->GetCodeItem()->registers_size_;
     DexRegisterMap dex_register_map =
         code_info.GetDexRegisterMapOf(stack_map, encoding, number_of_dex_registers);
-    MemoryRegion stack_mask = stack_map.GetStackMask(encoding);
-    uint32_t register_mask = stack_map.GetRegisterMask(encoding);
+    MemoryRegion stack_mask = code_info.GetStackMaskOf(stack_map, encoding);
+    uint32_t register_mask = code_info.GetRegisterMaskOf(stack_map, encoding);
     for (int i = 0; i < number_of_references; ++i) {
       int reg = registers[i];
       CHECK(reg < m->GetCodeItem()->registers_size_);
@@ -39,6 +39,7 @@
 #include "base/time_utils.h"
 #include "base/unix_file/fd_file.h"
 #include "base/value_object.h"
+#include "cha.h"
 #include "class_linker-inl.h"
 #include "class_table-inl.h"
 #include "compiler_callbacks.h"
@@ -54,6 +55,7 @@
 #include "handle_scope-inl.h"
 #include "intern_table.h"
 #include "interpreter/interpreter.h"
+#include "java_vm_ext.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
 #include "leb128.h"
@@ -315,7 +317,8 @@ ClassLinker::ClassLinker(InternTable* intern_table)
       quick_imt_conflict_trampoline_(nullptr),
       quick_generic_jni_trampoline_(nullptr),
       quick_to_interpreter_bridge_trampoline_(nullptr),
-      image_pointer_size_(sizeof(void*)) {
+      image_pointer_size_(sizeof(void*)),
+      cha_(new ClassHierarchyAnalysis()) {
   CHECK(intern_table_ != nullptr);
   static_assert(kFindArrayCacheSize == arraysize(find_array_class_cache_),
                 "Array cache size wrong.");
@@ -1255,6 +1258,8 @@ void ClassLinker::DeleteClassLoader(Thread* self, const ClassLoaderData& data) {
       code_cache->RemoveMethodsIn(self, *data.allocator);
     }
   }
+  ClassHierarchyAnalysis* cha = runtime->GetClassLinker()->GetClassHierarchyAnalysis();
+  cha->RemoveDependenciesIn(self, *data.allocator);
   delete data.allocator;
   delete data.class_table;
 }
@@ -3767,6 +3772,11 @@ bool ClassLinker::InitializeClass(Thread* self, Handle<mirror::Class> klass,
       FixupStaticTrampolines(klass.Get());
     }
   }
+  if (success && !Runtime::Current()->IsAotCompiler()) {
+    // Bind the native methods the loaded libraries already define in one go, instead of one
+    // dlsym lookup per method on its first call.
+    Runtime::Current()->GetJavaVM()->PrelinkNativeMethods(klass.Get());
+  }
   return success;
 }
 
@@ -4555,9 +4565,14 @@ bool ClassLinker::LinkMethods(Thread* self,
   // Link virtual methods then interface methods.
   // We set up the interface lookup table first because we need it to determine if we need to update
   // any vtable entries with new default method implementations.
-  return SetupInterfaceLookupTable(self, klass, interfaces)
-          && LinkVirtualMethods(self, klass, /*out*/ &default_translations)
-          && LinkInterfaceMethods(self, klass, default_translations, out_imt);
+  if (!SetupInterfaceLookupTable(self, klass, interfaces)
+      || !LinkVirtualMethods(self, klass, /*out*/ &default_translations)
+      || !LinkInterfaceMethods(self, klass, default_translations, out_imt)) {
+    return false;
+  }
+  // Now that the vtable is final, record which methods the class overrides.
+  cha_->UpdateAfterLinkingMethods(self, klass, image_pointer_size_);
+  return true;
 }
 
 // Comparator for name and signature of a method, used in finding overriding methods. Implementation
@@ -50,6 +50,7 @@ namespace mirror {
   class StackTraceElement;
 }  // namespace mirror
 
+class ClassHierarchyAnalysis;
 template<class T> class Handle;
 template<class T> class MutableHandle;
 class InternTable;
@@ -521,6 +522,10 @@ class ClassLinker {
       SHARED_REQUIRES(Locks::mutator_lock_)
       REQUIRES(!dex_lock_);
 
+  ClassHierarchyAnalysis* GetClassHierarchyAnalysis() const {
+    return cha_.get();
+  }
+
   size_t GetImagePointerSize() const {
     DCHECK(ValidPointerSize(image_pointer_size_)) << image_pointer_size_;
     return image_pointer_size_;
@@ -1031,6 +1036,9 @@ class ClassLinker {
   // Image pointer size.
   size_t image_pointer_size_;
 
+  // Single implementation information of virtual methods, used by the JIT to devirtualize.
+  std::unique_ptr<ClassHierarchyAnalysis> cha_;
+
   friend class ImageDumper;  // for DexLock
   friend class ImageWriter;  // for GetClassRoots
   friend class JniCompilerTest;  // for GetRuntimeQuickGenericJniStub
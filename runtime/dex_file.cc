@@ -1186,6 +1186,42 @@ const DexFile::AnnotationSetItem* DexFile::FindAnnotationSetForMethod(ArtMethod*
   return nullptr;
 }
 
+bool DexFile::IsMethodAnnotationPresent(const ClassDef& class_def,
+                                        uint32_t method_idx,
+                                        const char* descriptor,
+                                        uint32_t visibility) const {
+  const AnnotationsDirectoryItem* annotations_dir = GetAnnotationsDirectory(class_def);
+  if (annotations_dir == nullptr) {
+    return false;
+  }
+  const MethodAnnotationsItem* method_annotations = GetMethodAnnotations(annotations_dir);
+  if (method_annotations == nullptr) {
+    return false;
+  }
+  uint32_t method_count = annotations_dir->methods_size_;
+  for (uint32_t i = 0; i < method_count; ++i) {
+    if (method_annotations[i].method_idx_ == method_idx) {
+      const AnnotationSetItem* annotation_set = GetMethodAnnotationSetItem(method_annotations[i]);
+      if (annotation_set == nullptr) {
+        return false;
+      }
+      for (uint32_t j = 0; j < annotation_set->size_; ++j) {
+        const AnnotationItem* annotation_item = GetAnnotationItem(annotation_set, j);
+        if (annotation_item->visibility_ != visibility) {
+          continue;
+        }
+        const uint8_t* annotation = annotation_item->annotation_;
+        uint32_t type_index = DecodeUnsignedLeb128(&annotation);
+        if (strcmp(descriptor, StringByTypeIdx(type_index)) == 0) {
+          return true;
+        }
+      }
+      return false;
+    }
+  }
+  return false;
+}
+
 const DexFile::ParameterAnnotationsItem* DexFile::FindAnnotationsItemForMethod(ArtMethod* method)
     const {
   mirror::Class* klass = method->GetDeclaringClass();
@@ -956,6 +956,13 @@ class DexFile {
       SHARED_REQUIRES(Locks::mutator_lock_);
   bool IsMethodAnnotationPresent(ArtMethod* method, Handle<mirror::Class> annotation_class) const
       SHARED_REQUIRES(Locks::mutator_lock_);
+  // Returns whether method `method_idx` of `class_def` has an annotation of type `descriptor`
+  // with the given visibility. Unlike the above, this does not need the annotation class to be
+  // resolved, so it also works for build-time annotations.
+  bool IsMethodAnnotationPresent(const ClassDef& class_def,
+                                 uint32_t method_idx,
+                                 const char* descriptor,
+                                 uint32_t visibility) const;
 
   const AnnotationSetItem* FindAnnotationSetForClass(Handle<mirror::Class> klass) const
       SHARED_REQUIRES(Locks::mutator_lock_);
@@ -31,7 +31,8 @@ extern "C" void* artFindNativeMethod() {
 extern "C" void* artFindNativeMethod(Thread* self) {
   DCHECK_EQ(self, Thread::Current());
 #endif
-  Locks::mutator_lock_->AssertNotHeld(self);  // We come here as Native.
+  // We come here as Native, or as Runnable from the JNI stub of a critical native method, which
+  // does not leave the Runnable state.
   ScopedObjectAccess soa(self);
 
   ArtMethod* method = self->GetCurrentMethod(nullptr);
@@ -1164,9 +1164,17 @@ void MarkSweep::MarkRootsCheckpoint(Thread* self,
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
   CheckpointMarkThreadRoots check_point(this, revoke_ros_alloc_thread_local_buffers_at_checkpoint);
   ThreadList* thread_list = Runtime::Current()->GetThreadList();
+  // Marking thread roots is thread safe, so the roots of suspended threads may be marked by the
+  // GC thread pool. Its workers rely on this thread holding the locks that the closure requires
+  // until RunCheckpoint returns.
+  ThreadPool* thread_pool = (GetThreadCount(false) > 1) ? heap_->GetThreadPool() : nullptr;
+  if (thread_pool != nullptr) {
+    Locks::mutator_lock_->AssertSharedHeld(self);
+    Locks::heap_bitmap_lock_->AssertExclusiveHeld(self);
+  }
   // Request the check point is run on all threads returning a count of the threads that must
   // run through the barrier including self.
-  size_t barrier_count = thread_list->RunCheckpoint(&check_point);
+  size_t barrier_count = thread_list->RunCheckpoint(&check_point, thread_pool);
   // Release locks then wait for all mutator threads to pass the barrier.
   // If there are no threads to wait which implys that all the checkpoint functions are finished,
   // then no need to release locks.
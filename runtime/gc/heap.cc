@@ -3375,6 +3375,23 @@ bool Heap::IsMovableObject(const mirror::Object* obj) const {
   return false;
 }
 
+bool Heap::PinObject(mirror::Object* obj) {
+  // Only the regions of the concurrent copying collector can be kept from moving individually.
+  if (region_space_ == nullptr || !region_space_->HasAddress(obj)) {
+    return false;
+  }
+  region_space_->PinObject(obj);
+  return true;
+}
+
+bool Heap::UnpinObject(mirror::Object* obj) {
+  if (region_space_ == nullptr || !region_space_->HasAddress(obj)) {
+    return false;
+  }
+  region_space_->UnpinObject(obj);
+  return true;
+}
+
 void Heap::UpdateMaxNativeFootprint() {
   size_t native_size = native_bytes_allocated_.LoadRelaxed();
   // TODO: Tune the native heap utilization to be a value other than the java heap utilization.
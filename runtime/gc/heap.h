@@ -298,6 +298,14 @@ class Heap {
   // Returns true if there is any chance that the object (obj) will move.
   bool IsMovableObject(const mirror::Object* obj) const SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Keep a movable object at its address until UnpinObject(), without blocking the collector.
+  // Returns false if the object's space does not support pinning, in which case nothing is
+  // pinned. Must be called while runnable.
+  bool PinObject(mirror::Object* obj) SHARED_REQUIRES(Locks::mutator_lock_);
+  // Undo a successful PinObject(). Returns false, doing nothing, for objects that cannot be
+  // pinned.
+  bool UnpinObject(mirror::Object* obj) SHARED_REQUIRES(Locks::mutator_lock_);
+
   // Enables us to compacting GC until objects are released.
   void IncrementDisableMovingGC(Thread* self) REQUIRES(!*gc_complete_lock_);
   void DecrementDisableMovingGC(Thread* self) REQUIRES(!*gc_complete_lock_);
@@ -606,6 +614,10 @@ class Heap {
     return large_object_space_;
   }
 
+  space::RegionSpace* GetRegionSpace() const {
+    return region_space_;
+  }
+
   // Returns the free list space that may contain movable objects (the
   // one that's not the non-moving space), either rosalloc_space_ or
   // dlmalloc_space_.
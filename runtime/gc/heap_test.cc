@@ -18,7 +18,9 @@
 #include "common_runtime_test.h"
 #include "gc/accounting/card_table-inl.h"
 #include "gc/accounting/space_bitmap-inl.h"
+#include "gc/space/region_space.h"
 #include "handle_scope-inl.h"
+#include "mirror/array-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "mirror/object_array-inl.h"
@@ -72,6 +74,46 @@ TEST_F(HeapTest, HeapBitmapCapacityTest) {
   bitmap->Set(fake_end_of_heap_object);
 }
 
+TEST_F(HeapTest, PinnedObjectDoesNotMove) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  if (heap->CurrentCollectorType() != kCollectorTypeCC) {
+    // Only the region space of the concurrent copying collector supports pinning.
+    return;
+  }
+  space::RegionSpace* region_space = heap->GetRegionSpace();
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::IntArray> array(hs.NewHandle(mirror::IntArray::Alloc(soa.Self(), 16)));
+  ASSERT_TRUE(region_space->HasAddress(array.Get()));
+  array->Set(0, 42);
+  ASSERT_TRUE(heap->PinObject(array.Get()));
+  mirror::IntArray* pinned_address = array.Get();
+
+  // Explicit collections evacuate every region that is not pinned. The pinned region is neither
+  // evacuated nor freed, and stays part of the to-space.
+  heap->CollectGarbage(/* clear_soft_references */ false);
+  heap->CollectGarbage(/* clear_soft_references */ false);
+  EXPECT_EQ(pinned_address, array.Get());
+  EXPECT_TRUE(region_space->IsInToSpace(array.Get()));
+  EXPECT_EQ(42, array->Get(0));
+
+  // Once unpinned, the array moves again.
+  ASSERT_TRUE(heap->UnpinObject(array.Get()));
+  heap->CollectGarbage(/* clear_soft_references */ false);
+  EXPECT_NE(pinned_address, array.Get());
+  EXPECT_EQ(42, array->Get(0));
+}
+
+TEST_F(HeapTest, PinObjectOutsideRegionSpace) {
+  Heap* heap = Runtime::Current()->GetHeap();
+  ScopedObjectAccess soa(Thread::Current());
+  // Classes are allocated in the non-moving space, which has no per-object pinning.
+  mirror::Class* klass = class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;");
+  ASSERT_TRUE(klass != nullptr);
+  EXPECT_FALSE(heap->PinObject(klass));
+  EXPECT_FALSE(heap->UnpinObject(klass));
+}
+
 class ZygoteHeapTest : public CommonRuntimeTest {
   void SetUpRuntimeOptions(RuntimeOptions* options) {
     CommonRuntimeTest::SetUpRuntimeOptions(options);
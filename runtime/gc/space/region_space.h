@@ -205,6 +205,12 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
   void SetFromSpace(accounting::ReadBarrierTable* rb_table, bool force_evacuate_all)
       REQUIRES(!region_lock_);
 
+  // Keep the region holding `ref` from being evacuated until a matching UnpinObject(), so that
+  // `ref` does not move. Must be called while runnable: regions are only chosen for evacuation in
+  // a pause, which then sees the pin.
+  void PinObject(mirror::Object* ref) REQUIRES(!region_lock_);
+  void UnpinObject(mirror::Object* ref) REQUIRES(!region_lock_);
+
   size_t FromSpaceSize() REQUIRES(!region_lock_);
   size_t UnevacFromSpaceSize() REQUIRES(!region_lock_);
   size_t ToSpaceSize() REQUIRES(!region_lock_);
@@ -237,13 +243,13 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
           begin_(nullptr), top_(nullptr), end_(nullptr),
           state_(RegionState::kRegionStateAllocated), type_(RegionType::kRegionTypeToSpace),
           objects_allocated_(0), alloc_time_(0), live_bytes_(static_cast<size_t>(-1)),
-          is_newly_allocated_(false), is_a_tlab_(false), thread_(nullptr) {}
+          is_newly_allocated_(false), is_a_tlab_(false), thread_(nullptr), pin_count_(0) {}
 
     Region(size_t idx, uint8_t* begin, uint8_t* end)
         : idx_(idx), begin_(begin), top_(begin), end_(end),
           state_(RegionState::kRegionStateFree), type_(RegionType::kRegionTypeNone),
           objects_allocated_(0), alloc_time_(0), live_bytes_(static_cast<size_t>(-1)),
-          is_newly_allocated_(false), is_a_tlab_(false), thread_(nullptr) {
+          is_newly_allocated_(false), is_a_tlab_(false), thread_(nullptr), pin_count_(0) {
       DCHECK_LT(begin, end);
       DCHECK_EQ(static_cast<size_t>(end - begin), kRegionSize);
     }
@@ -257,6 +263,7 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     }
 
     void Clear() {
+      DCHECK_EQ(pin_count_, 0U);
       top_ = begin_;
       state_ = RegionState::kRegionStateFree;
       type_ = RegionType::kRegionTypeNone;
@@ -374,6 +381,10 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
 
     ALWAYS_INLINE bool ShouldBeEvacuated();
 
+    bool IsPinned() const {
+      return pin_count_ != 0U;
+    }
+
     void AddLiveBytes(size_t live_bytes) {
       DCHECK(IsInUnevacFromSpace());
       DCHECK(!IsLargeTail());
@@ -474,6 +485,7 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     bool is_newly_allocated_;      // True if it's allocated after the last collection.
     bool is_a_tlab_;               // True if it's a tlab.
     Thread* thread_;               // The owning thread if it's a tlab.
+    uint32_t pin_count_;           // Number of pinned objects. Guarded by region_lock_.
 
     friend class RegionSpace;
   };
@@ -25,6 +25,7 @@
 #include "utils.h"
 #include "verify_object-inl.h"
 
+#include <algorithm>
 #include <cstdlib>
 
 namespace art {
@@ -69,36 +70,62 @@ void IndirectReferenceTable::AbortIfNoCheckJNI() {
 IndirectReferenceTable::IndirectReferenceTable(size_t initialCount,
                                                size_t maxCount, IndirectRefKind desiredKind,
                                                bool abort_on_error)
-    : kind_(desiredKind),
+    : chunks_(new IrtEntry*[NumChunksFor(maxCount)]()),
+      num_chunks_(0),
+      kind_(desiredKind),
       max_entries_(maxCount) {
   CHECK_GT(initialCount, 0U);
   CHECK_LE(initialCount, maxCount);
+  CHECK_LT(maxCount, 65536U);  // The top index must fit in 16 bits.
   CHECK_NE(desiredKind, kHandleScopeOrInvalid);
 
-  std::string error_str;
-  const size_t table_bytes = maxCount * sizeof(IrtEntry);
-  table_mem_map_.reset(MemMap::MapAnonymous("indirect ref table", nullptr, table_bytes,
-                                            PROT_READ | PROT_WRITE, false, false, &error_str));
-  if (abort_on_error) {
-    CHECK(table_mem_map_.get() != nullptr) << error_str;
-    CHECK_EQ(table_mem_map_->Size(), table_bytes);
-    CHECK(table_mem_map_->Begin() != nullptr);
-  } else if (table_mem_map_.get() == nullptr ||
-             table_mem_map_->Size() != table_bytes ||
-             table_mem_map_->Begin() == nullptr) {
-    table_mem_map_.reset();
-    LOG(ERROR) << error_str;
-    return;
-  }
-  table_ = reinterpret_cast<IrtEntry*>(table_mem_map_->Begin());
   segment_state_.all = IRT_FIRST_SEGMENT;
+  if (!EnsureChunks(initialCount)) {
+    CHECK(!abort_on_error) << "Failed to allocate " << kind_ << " table of " << initialCount
+                           << " entries";
+    LOG(ERROR) << "Failed to allocate " << kind_ << " table of " << initialCount << " entries";
+  }
 }
 
 IndirectReferenceTable::~IndirectReferenceTable() {
+  for (size_t i = 0; i != num_chunks_; ++i) {
+    free(chunks_[i]);
+  }
 }
 
 bool IndirectReferenceTable::IsValid() const {
-  return table_mem_map_.get() != nullptr;
+  return num_chunks_ != 0;
+}
+
+bool IndirectReferenceTable::EnsureChunks(size_t entries) {
+  DCHECK_LE(entries, max_entries_);
+  const size_t num_chunks = NumChunksFor(entries);
+  while (num_chunks_ < num_chunks) {
+    // Zeroed memory holds null references with serial 0, like a fresh IrtEntry.
+    void* chunk = calloc(kIRTChunkEntries, sizeof(IrtEntry));
+    if (chunk == nullptr) {
+      return false;
+    }
+    chunks_[num_chunks_] = reinterpret_cast<IrtEntry*>(chunk);
+    ++num_chunks_;
+  }
+  return true;
+}
+
+size_t IndirectReferenceTable::FreeCapacity(uint32_t cookie) const {
+  IRTSegmentState prevState;
+  prevState.all = cookie;
+  DCHECK_GE(segment_state_.parts.numHoles, prevState.parts.numHoles);
+  const size_t numHoles = segment_state_.parts.numHoles - prevState.parts.numHoles;
+  return max_entries_ - segment_state_.parts.topIndex + numHoles;
+}
+
+bool IndirectReferenceTable::EnsureFreeCapacity(uint32_t cookie, size_t count) {
+  if (count > FreeCapacity(cookie)) {
+    return false;
+  }
+  // Holes are filled first, but do not rely on them.
+  return EnsureChunks(std::min(max_entries_, segment_state_.parts.topIndex + count));
 }
 
 IndirectRef IndirectReferenceTable::Add(uint32_t cookie, mirror::Object* obj) {
@@ -108,7 +135,7 @@ IndirectRef IndirectReferenceTable::Add(uint32_t cookie, mirror::Object* obj) {
 
   CHECK(obj != nullptr);
   VerifyObject(obj);
-  DCHECK(table_ != nullptr);
+  DCHECK(IsValid());
   DCHECK_GE(segment_state_.parts.numHoles, prevState.parts.numHoles);
 
   if (topIndex == max_entries_) {
@@ -126,21 +153,24 @@ IndirectRef IndirectReferenceTable::Add(uint32_t cookie, mirror::Object* obj) {
   if (numHoles > 0) {
     DCHECK_GT(topIndex, 1U);
     // Find the first hole; likely to be near the end of the list.
-    IrtEntry* pScan = &table_[topIndex - 1];
-    DCHECK(!pScan->GetReference()->IsNull());
-    --pScan;
-    while (!pScan->GetReference()->IsNull()) {
-      DCHECK_GE(pScan, table_ + prevState.parts.topIndex);
-      --pScan;
+    index = topIndex - 1;
+    DCHECK(!GetEntry(index)->GetReference()->IsNull());
+    --index;
+    while (!GetEntry(index)->GetReference()->IsNull()) {
+      DCHECK_GT(index, prevState.parts.topIndex);
+      --index;
     }
-    index = pScan - table_;
     segment_state_.parts.numHoles--;
   } else {
-    // Add to the end.
+    // Add to the end, allocating a new chunk if the top index just reached it.
+    if (UNLIKELY((topIndex >> kIRTChunkShift) == num_chunks_) && !EnsureChunks(topIndex + 1)) {
+      LOG(FATAL) << "JNI ERROR: failed to grow " << kind_ << " table to " << topIndex + 1
+                 << " entries";
+    }
     index = topIndex++;
     segment_state_.parts.topIndex = topIndex;
   }
-  table_[index].Add(obj);
+  GetEntry(index)->Add(obj);
   result = ToIndirectRef(index);
   if ((false)) {
     LOG(INFO) << "+++ added at " << ExtractIndex(result) << " top=" << segment_state_.parts.topIndex
@@ -153,7 +183,7 @@ IndirectRef IndirectReferenceTable::Add(uint32_t cookie, mirror::Object* obj) {
 
 void IndirectReferenceTable::AssertEmpty() {
   for (size_t i = 0; i < Capacity(); ++i) {
-    if (!table_[i].GetReference()->IsNull()) {
+    if (!GetEntry(i)->GetReference()->IsNull()) {
       ScopedObjectAccess soa(Thread::Current());
       LOG(FATAL) << "Internal Error: non-empty local reference table\n"
                  << MutatorLockedDumpable<IndirectReferenceTable>(*this);
@@ -175,7 +205,7 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
   int topIndex = segment_state_.parts.topIndex;
   int bottomIndex = prevState.parts.topIndex;
 
-  DCHECK(table_ != nullptr);
+  DCHECK(IsValid());
   DCHECK_GE(segment_state_.parts.numHoles, prevState.parts.numHoles);
 
   if (GetIndirectRefKind(iref) == kHandleScopeOrInvalid) {
@@ -214,16 +244,16 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
       return false;
     }
 
-    *table_[idx].GetReference() = GcRoot<mirror::Object>(nullptr);
+    *GetEntry(idx)->GetReference() = GcRoot<mirror::Object>(nullptr);
     int numHoles = segment_state_.parts.numHoles - prevState.parts.numHoles;
     if (numHoles != 0) {
       while (--topIndex > bottomIndex && numHoles != 0) {
         if ((false)) {
           LOG(INFO) << "+++ checking for hole at " << topIndex - 1
                     << " (cookie=" << cookie << ") val="
-                    << table_[topIndex - 1].GetReference()->Read<kWithoutReadBarrier>();
+                    << GetEntry(topIndex - 1)->GetReference()->Read<kWithoutReadBarrier>();
         }
-        if (!table_[topIndex - 1].GetReference()->IsNull()) {
+        if (!GetEntry(topIndex - 1)->GetReference()->IsNull()) {
           break;
         }
         if ((false)) {
@@ -242,7 +272,7 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
   } else {
     // Not the top-most entry.  This creates a hole.  We null out the entry to prevent somebody
     // from deleting it twice and screwing up the hole count.
-    if (table_[idx].GetReference()->IsNull()) {
+    if (GetEntry(idx)->GetReference()->IsNull()) {
       LOG(INFO) << "--- WEIRD: removing null entry " << idx;
       return false;
     }
@@ -250,7 +280,7 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
       return false;
     }
 
-    *table_[idx].GetReference() = GcRoot<mirror::Object>(nullptr);
+    *GetEntry(idx)->GetReference() = GcRoot<mirror::Object>(nullptr);
     segment_state_.parts.numHoles++;
     if ((false)) {
       LOG(INFO) << "+++ left hole at " << idx << ", holes=" << segment_state_.parts.numHoles;
@@ -261,10 +291,13 @@ bool IndirectReferenceTable::Remove(uint32_t cookie, IndirectRef iref) {
 }
 
 void IndirectReferenceTable::Trim() {
-  const size_t top_index = Capacity();
-  auto* release_start = AlignUp(reinterpret_cast<uint8_t*>(&table_[top_index]), kPageSize);
-  uint8_t* release_end = table_mem_map_->End();
-  madvise(release_start, release_end - release_start, MADV_DONTNEED);
+  // Keep the first chunk so that the table stays valid.
+  const size_t num_used_chunks = std::max<size_t>(NumChunksFor(Capacity()), 1u);
+  while (num_chunks_ > num_used_chunks) {
+    --num_chunks_;
+    free(chunks_[num_chunks_]);
+    chunks_[num_chunks_] = nullptr;
+  }
 }
 
 void IndirectReferenceTable::VisitRoots(RootVisitor* visitor, const RootInfo& root_info) {
@@ -281,9 +314,9 @@ void IndirectReferenceTable::Dump(std::ostream& os) const {
   os << kind_ << " table dump:\n";
   ReferenceTable::Table entries;
   for (size_t i = 0; i < Capacity(); ++i) {
-    mirror::Object* obj = table_[i].GetReference()->Read<kWithoutReadBarrier>();
+    mirror::Object* obj = GetEntry(i)->GetReference()->Read<kWithoutReadBarrier>();
     if (obj != nullptr) {
-      obj = table_[i].GetReference()->Read();
+      obj = GetEntry(i)->GetReference()->Read();
       entries.push_back(GcRoot<mirror::Object>(obj));
     }
   }
@@ -20,6 +20,7 @@
 #include <stdint.h>
 
 #include <iosfwd>
+#include <memory>
 #include <string>
 
 #include "base/logging.h"
@@ -37,8 +38,6 @@ namespace mirror {
 class Object;
 }  // namespace mirror
 
-class MemMap;
-
 /*
  * Maintain a table of indirect references.  Used for local/global JNI
  * references.
@@ -138,10 +137,10 @@ static const uint32_t IRT_FIRST_SEGMENT = 0;
  * most-recently-added entry).  For JNI local references, the common
  * operations are adding a new entry and removing an entire table segment.
  *
- * If "alloc_entries_" is not equal to "max_entries_", the table may expand
- * when entries are added, which means the memory may move.  If you want
- * to keep pointers into "table" rather than offsets, you must use a
- * fixed-size table.
+ * The entries are stored in fixed-size chunks of kIRTChunkEntries, allocated
+ * as the top index first reaches them.  A table only commits memory for the
+ * entries it has actually used, and chunks never move once allocated, so
+ * lookups are safe while another thread grows the table.
  *
  * If we delete entries from the middle of the list, we will be left with
  * "holes".  We track the number of holes so that, when adding new elements,
@@ -225,10 +224,16 @@ class IrtEntry {
 static_assert(sizeof(IrtEntry) == (1 + kIRTPrevCount) * sizeof(uint32_t),
               "Unexpected sizeof(IrtEntry)");
 
+// Number of entries per chunk of the table. 64 entries keep the initial local reference table of
+// a thread in a single chunk.
+static constexpr size_t kIRTChunkShift = 6;
+static constexpr size_t kIRTChunkEntries = 1u << kIRTChunkShift;
+
 class IrtIterator {
  public:
-  IrtIterator(IrtEntry* table, size_t i, size_t capacity) SHARED_REQUIRES(Locks::mutator_lock_)
-      : table_(table), i_(i), capacity_(capacity) {
+  IrtIterator(IrtEntry* const* chunks, size_t i, size_t capacity)
+      SHARED_REQUIRES(Locks::mutator_lock_)
+      : chunks_(chunks), i_(i), capacity_(capacity) {
   }
 
   IrtIterator& operator++() SHARED_REQUIRES(Locks::mutator_lock_) {
@@ -238,15 +243,15 @@ class IrtIterator {
 
   GcRoot<mirror::Object>* operator*() {
     // This does not have a read barrier as this is used to visit roots.
-    return table_[i_].GetReference();
+    return chunks_[i_ >> kIRTChunkShift][i_ & (kIRTChunkEntries - 1)].GetReference();
   }
 
   bool equals(const IrtIterator& rhs) const {
-    return (i_ == rhs.i_ && table_ == rhs.table_);
+    return (i_ == rhs.i_ && chunks_ == rhs.chunks_);
   }
 
  private:
-  IrtEntry* const table_;
+  IrtEntry* const* const chunks_;
   size_t i_;
   const size_t capacity_;
 };
@@ -326,13 +331,26 @@ class IndirectReferenceTable {
 
   // Note IrtIterator does not have a read barrier as it's used to visit roots.
   IrtIterator begin() {
-    return IrtIterator(table_, 0, Capacity());
+    return IrtIterator(chunks_.get(), 0, Capacity());
   }
 
   IrtIterator end() {
-    return IrtIterator(table_, Capacity(), Capacity());
+    return IrtIterator(chunks_.get(), Capacity(), Capacity());
   }
 
+  /*
+   * Return the number of entries that can still be added to the segment
+   * starting at "cookie".  This counts the holes of that segment.
+   */
+  size_t FreeCapacity(uint32_t cookie) const;
+
+  /*
+   * Make sure that "count" entries can be added to the segment starting at
+   * "cookie" without allocating.  Returns false if that would exceed the
+   * maximum size of the table, or if a chunk could not be allocated.
+   */
+  bool EnsureFreeCapacity(uint32_t cookie, size_t count);
+
   void VisitRoots(RootVisitor* visitor, const RootInfo& root_info)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
@@ -348,7 +366,8 @@ class IndirectReferenceTable {
     return Offset(OFFSETOF_MEMBER(IndirectReferenceTable, segment_state_));
   }
 
-  // Release pages past the end of the table that may have previously held references.
+  // Free the chunks past the end of the table that may have previously held references. Must
+  // not race with lookups, which is the case for the local table of a thread.
   void Trim() SHARED_REQUIRES(Locks::mutator_lock_);
 
  private:
@@ -364,11 +383,23 @@ class IndirectReferenceTable {
    */
   IndirectRef ToIndirectRef(uint32_t tableIndex) const {
     DCHECK_LT(tableIndex, 65536U);
-    uint32_t serialChunk = table_[tableIndex].GetSerial();
+    uint32_t serialChunk = GetEntry(tableIndex)->GetSerial();
     uintptr_t uref = (serialChunk << 20) | (tableIndex << 2) | kind_;
     return reinterpret_cast<IndirectRef>(uref);
   }
 
+  IrtEntry* GetEntry(size_t index) const ALWAYS_INLINE {
+    DCHECK_LT(index >> kIRTChunkShift, num_chunks_);
+    return &chunks_[index >> kIRTChunkShift][index & (kIRTChunkEntries - 1)];
+  }
+
+  static size_t NumChunksFor(size_t entries) {
+    return (entries + kIRTChunkEntries - 1) >> kIRTChunkShift;
+  }
+
+  // Allocate the chunks holding the first "entries" entries. Returns false on failure.
+  bool EnsureChunks(size_t entries);
+
   // Abort if check_jni is not enabled.
   static void AbortIfNoCheckJNI();
 
@@ -379,11 +410,12 @@ class IndirectReferenceTable {
   /* semi-public - read/write by jni down calls */
   IRTSegmentState segment_state_;
 
-  // Mem map where we store the indirect refs.
-  std::unique_ptr<MemMap> table_mem_map_;
-  // bottom of the stack. Do not directly access the object references
-  // in this as they are roots. Use Get() that has a read barrier.
-  IrtEntry* table_;
+  // Chunks of entries, indexed by entry index / kIRTChunkEntries, sized for max_entries_. Do not
+  // directly access the object references in these as they are roots. Use Get() that has a read
+  // barrier.
+  std::unique_ptr<IrtEntry*[]> chunks_;
+  // Number of allocated chunks, always the leading ones.
+  size_t num_chunks_;
   /* bit mask, ORed into all irefs */
   const IndirectRefKind kind_;
   /* max #of entries allowed */
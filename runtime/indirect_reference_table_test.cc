@@ -254,4 +254,57 @@ TEST_F(IndirectReferenceTableTest, BasicTest) {
   CheckDump(&irt, 0, 0);
 }
 
+TEST_F(IndirectReferenceTableTest, ChunkedSegments) {
+  ScopedObjectAccess soa(Thread::Current());
+  static const size_t kTableMax = 4 * kIRTChunkEntries;
+  IndirectReferenceTable irt(1, kTableMax, kLocal);
+  ASSERT_TRUE(irt.IsValid());
+
+  mirror::Class* c = class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;");
+  ASSERT_TRUE(c != nullptr);
+  mirror::Object* obj0 = c->AllocObject(soa.Self());
+  ASSERT_TRUE(obj0 != nullptr);
+  mirror::Object* obj1 = c->AllocObject(soa.Self());
+  ASSERT_TRUE(obj1 != nullptr);
+
+  // Fill the first segment past the first chunk.
+  const uint32_t cookie0 = IRT_FIRST_SEGMENT;
+  const size_t kBottomRefs = kIRTChunkEntries + 1;
+  std::vector<IndirectRef> refs;
+  for (size_t i = 0; i != kBottomRefs; ++i) {
+    refs.push_back(irt.Add(cookie0, obj0));
+    ASSERT_TRUE(refs.back() != nullptr);
+  }
+  EXPECT_EQ(kTableMax - kBottomRefs, irt.FreeCapacity(cookie0));
+  // A hole in the first segment counts as free space there.
+  ASSERT_TRUE(irt.Remove(cookie0, refs[1]));
+  EXPECT_EQ(kTableMax - kBottomRefs + 1, irt.FreeCapacity(cookie0));
+
+  // Push a segment, but not its hole.
+  const uint32_t cookie1 = irt.GetSegmentState();
+  EXPECT_EQ(kTableMax - kBottomRefs, irt.FreeCapacity(cookie1));
+  EXPECT_FALSE(irt.EnsureFreeCapacity(cookie1, kTableMax - kBottomRefs + 1));
+  EXPECT_TRUE(irt.EnsureFreeCapacity(cookie1, 2 * kIRTChunkEntries));
+  for (size_t i = 0; i != 2 * kIRTChunkEntries; ++i) {
+    IndirectRef ref = irt.Add(cookie1, obj1);
+    ASSERT_TRUE(ref != nullptr);
+    EXPECT_EQ(obj1, irt.Get(ref));
+  }
+  // References from the lower segment cannot be removed from the upper one.
+  EXPECT_FALSE(irt.Remove(cookie1, refs[0]));
+
+  // Pop the segment and trim the chunks it used.
+  irt.SetSegmentState(cookie1);
+  irt.Trim();
+  EXPECT_EQ(kBottomRefs, irt.Capacity());
+  EXPECT_EQ(obj0, irt.Get(refs[0]));
+  EXPECT_EQ(obj0, irt.Get(refs[kBottomRefs - 1]));
+  CheckDump(&irt, kBottomRefs - 1, 1);
+
+  // The lower segment grows again.
+  IndirectRef ref = irt.Add(cookie0, obj1);
+  ASSERT_TRUE(ref != nullptr);
+  EXPECT_EQ(obj1, irt.Get(ref));
+}
+
 }  // namespace art
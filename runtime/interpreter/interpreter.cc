@@ -222,20 +222,8 @@ static void InterpreterJni(Thread* self, ArtMethod* method, const StringPiece& s
   }
 }
 
-enum InterpreterImplKind {
-  kSwitchImpl,            // Switch-based interpreter implementation.
-  kComputedGotoImplKind   // Computed-goto-based interpreter implementation.
-};
-static std::ostream& operator<<(std::ostream& os, const InterpreterImplKind& rhs) {
-  os << ((rhs == kSwitchImpl) ? "Switch-based interpreter" : "Computed-goto-based interpreter");
-  return os;
-}
-
-#if !defined(__clang__)
-static constexpr InterpreterImplKind kInterpreterImplKind = kComputedGotoImplKind;
-#else
+#if defined(__clang__)
 // Clang 3.4 fails to build the goto interpreter implementation.
-static constexpr InterpreterImplKind kInterpreterImplKind = kSwitchImpl;
 template<bool do_access_check, bool transaction_active>
 JValue ExecuteGotoImpl(Thread*, const DexFile::CodeItem*, ShadowFrame&, JValue) {
   LOG(FATAL) << "UNREACHABLE";
@@ -266,17 +254,19 @@ static inline JValue Execute(Thread* self, const DexFile::CodeItem* code_item,
   DCHECK(!shadow_frame.GetMethod()->IsNative());
   shadow_frame.GetMethod()->GetDeclaringClass()->AssertInitializedOrInitializingInThread(self);
 
-  bool transaction_active = Runtime::Current()->IsActiveTransaction();
+  Runtime* const runtime = Runtime::Current();
+  bool transaction_active = runtime->IsActiveTransaction();
+  InterpreterImplKind impl_kind = runtime->GetInterpreterImplKind();
   if (LIKELY(shadow_frame.GetMethod()->IsPreverified())) {
     // Enter the "without access check" interpreter.
-    if (kInterpreterImplKind == kSwitchImpl) {
+    if (impl_kind == InterpreterImplKind::kSwitchImpl) {
       if (transaction_active) {
         return ExecuteSwitchImpl<false, true>(self, code_item, shadow_frame, result_register);
       } else {
         return ExecuteSwitchImpl<false, false>(self, code_item, shadow_frame, result_register);
       }
     } else {
-      DCHECK_EQ(kInterpreterImplKind, kComputedGotoImplKind);
+      DCHECK(impl_kind == InterpreterImplKind::kComputedGotoImpl);
       if (transaction_active) {
         return ExecuteGotoImpl<false, true>(self, code_item, shadow_frame, result_register);
       } else {
@@ -285,14 +275,14 @@ static inline JValue Execute(Thread* self, const DexFile::CodeItem* code_item,
     }
   } else {
     // Enter the "with access check" interpreter.
-    if (kInterpreterImplKind == kSwitchImpl) {
+    if (impl_kind == InterpreterImplKind::kSwitchImpl) {
       if (transaction_active) {
         return ExecuteSwitchImpl<true, true>(self, code_item, shadow_frame, result_register);
       } else {
         return ExecuteSwitchImpl<true, false>(self, code_item, shadow_frame, result_register);
       }
     } else {
-      DCHECK_EQ(kInterpreterImplKind, kComputedGotoImplKind);
+      DCHECK(impl_kind == InterpreterImplKind::kComputedGotoImpl);
       if (transaction_active) {
         return ExecuteGotoImpl<true, true>(self, code_item, shadow_frame, result_register);
       } else {
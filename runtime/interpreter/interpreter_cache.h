@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_INTERPRETER_INTERPRETER_CACHE_H_
+#define ART_RUNTIME_INTERPRETER_INTERPRETER_CACHE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include "base/logging.h"
+#include "base/macros.h"
+
+namespace art {
+
+class ArtField;
+class ArtMethod;
+class Instruction;
+
+namespace mirror {
+class Class;
+}  // namespace mirror
+
+namespace interpreter {
+
+// A small direct-mapped cache of what the dex instructions executed by the interpreter resolved
+// to, keyed by the address of the instruction. Field instructions map to their resolved instance
+// field. Invoke instructions map to their target for the last receiver class seen, which makes
+// them monomorphic inline caches.
+//
+// Each thread owns one cache, so no synchronization is needed. The cache holds no GC roots:
+// Thread::VisitRoots clears it, so entries never outlive a GC that could move or unload the
+// classes, methods and fields they refer to.
+//
+// The cache does not feed the JIT's ProfilingInfo. Virtual and interface invokes still report
+// their receiver class to the instrumentation listeners after each lookup, hit or miss.
+class InterpreterCache {
+ public:
+  InterpreterCache() {
+    Clear();
+  }
+
+  void Clear() {
+    memset(entries_, 0, sizeof(entries_));
+  }
+
+  // Returns the field `inst` resolved to, or null if it is not cached.
+  ArtField* GetField(const Instruction* inst) const {
+    const Entry& entry = entries_[IndexOf(inst)];
+    if (entry.inst == inst) {
+      DCHECK(entry.receiver_class == nullptr);
+      return reinterpret_cast<ArtField*>(entry.member);
+    }
+    return nullptr;
+  }
+
+  void SetField(const Instruction* inst, ArtField* field) {
+    Entry& entry = entries_[IndexOf(inst)];
+    entry.inst = inst;
+    entry.receiver_class = nullptr;
+    entry.member = field;
+  }
+
+  // Returns the method `inst` dispatches to for `receiver_class`, or null if it is not cached.
+  ArtMethod* GetInvokeTarget(const Instruction* inst, mirror::Class* receiver_class) const {
+    DCHECK(receiver_class != nullptr);
+    const Entry& entry = entries_[IndexOf(inst)];
+    if (entry.inst == inst && entry.receiver_class == receiver_class) {
+      return reinterpret_cast<ArtMethod*>(entry.member);
+    }
+    return nullptr;
+  }
+
+  void SetInvokeTarget(const Instruction* inst, mirror::Class* receiver_class, ArtMethod* target) {
+    DCHECK(receiver_class != nullptr);
+    Entry& entry = entries_[IndexOf(inst)];
+    entry.inst = inst;
+    entry.receiver_class = receiver_class;
+    entry.member = target;
+  }
+
+ private:
+  // Must be a power of two.
+  static constexpr size_t kSize = 128;
+
+  struct Entry {
+    const Instruction* inst;
+    mirror::Class* receiver_class;
+    void* member;
+  };
+
+  static size_t IndexOf(const Instruction* inst) {
+    // Dex instructions are 2-byte aligned.
+    return (reinterpret_cast<uintptr_t>(inst) >> 1) & (kSize - 1);
+  }
+
+  Entry entries_[kSize];
+
+  DISALLOW_COPY_AND_ASSIGN(InterpreterCache);
+};
+
+}  // namespace interpreter
+}  // namespace art
+
+#endif  // ART_RUNTIME_INTERPRETER_INTERPRETER_CACHE_H_
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "interpreter/interpreter_cache.h"
+
+#include <pthread.h>
+
+#include "barrier.h"
+#include "common_runtime_test.h"
+#include "dex_instruction.h"
+#include "gc/heap.h"
+#include "runtime.h"
+#include "scoped_thread_state_change.h"
+#include "thread-inl.h"
+
+namespace art {
+namespace interpreter {
+
+// The cache never dereferences what it stores, so the tests use made up fields, methods and
+// classes.
+template <typename T>
+static T* Fake(uintptr_t value) {
+  return reinterpret_cast<T*>(value);
+}
+
+class InterpreterCacheTest : public CommonRuntimeTest {
+ protected:
+  // Returns the instruction at `dex_pc` of a fake code item. Instructions 128 code units apart
+  // map to the same cache entry.
+  const Instruction* InstructionAt(size_t dex_pc) {
+    CHECK_LT(dex_pc, arraysize(code_));
+    return Instruction::At(&code_[dex_pc]);
+  }
+
+  uint16_t code_[256];
+};
+
+TEST_F(InterpreterCacheTest, FieldLookup) {
+  InterpreterCache cache;
+  const Instruction* inst = InstructionAt(0);
+  EXPECT_TRUE(cache.GetField(inst) == nullptr);
+
+  cache.SetField(inst, Fake<ArtField>(0x1000));
+  EXPECT_EQ(Fake<ArtField>(0x1000), cache.GetField(inst));
+  EXPECT_TRUE(cache.GetField(InstructionAt(1)) == nullptr);
+
+  cache.SetField(inst, Fake<ArtField>(0x2000));
+  EXPECT_EQ(Fake<ArtField>(0x2000), cache.GetField(inst));
+}
+
+TEST_F(InterpreterCacheTest, InvokeLookup) {
+  InterpreterCache cache;
+  const Instruction* inst = InstructionAt(2);
+  mirror::Class* klass = Fake<mirror::Class>(0x3000);
+  mirror::Class* other_class = Fake<mirror::Class>(0x4000);
+  EXPECT_TRUE(cache.GetInvokeTarget(inst, klass) == nullptr);
+
+  cache.SetInvokeTarget(inst, klass, Fake<ArtMethod>(0x5000));
+  EXPECT_EQ(Fake<ArtMethod>(0x5000), cache.GetInvokeTarget(inst, klass));
+  // The cache is monomorphic: another receiver class misses, and replaces the entry.
+  EXPECT_TRUE(cache.GetInvokeTarget(inst, other_class) == nullptr);
+  cache.SetInvokeTarget(inst, other_class, Fake<ArtMethod>(0x6000));
+  EXPECT_EQ(Fake<ArtMethod>(0x6000), cache.GetInvokeTarget(inst, other_class));
+  EXPECT_TRUE(cache.GetInvokeTarget(inst, klass) == nullptr);
+}
+
+TEST_F(InterpreterCacheTest, Overwrite) {
+  InterpreterCache cache;
+  const Instruction* inst = InstructionAt(4);
+  const Instruction* conflicting_inst = InstructionAt(4 + 128);
+  mirror::Class* klass = Fake<mirror::Class>(0x3000);
+
+  cache.SetField(inst, Fake<ArtField>(0x1000));
+  cache.SetField(conflicting_inst, Fake<ArtField>(0x2000));
+  EXPECT_TRUE(cache.GetField(inst) == nullptr);
+  EXPECT_EQ(Fake<ArtField>(0x2000), cache.GetField(conflicting_inst));
+
+  // An invoke evicts a field of the same entry.
+  cache.SetInvokeTarget(inst, klass, Fake<ArtMethod>(0x5000));
+  EXPECT_TRUE(cache.GetField(conflicting_inst) == nullptr);
+  EXPECT_EQ(Fake<ArtMethod>(0x5000), cache.GetInvokeTarget(inst, klass));
+  EXPECT_TRUE(cache.GetInvokeTarget(conflicting_inst, klass) == nullptr);
+}
+
+TEST_F(InterpreterCacheTest, Clear) {
+  InterpreterCache cache;
+  mirror::Class* klass = Fake<mirror::Class>(0x3000);
+  cache.SetField(InstructionAt(0), Fake<ArtField>(0x1000));
+  cache.SetInvokeTarget(InstructionAt(2), klass, Fake<ArtMethod>(0x5000));
+  cache.Clear();
+  EXPECT_TRUE(cache.GetField(InstructionAt(0)) == nullptr);
+  EXPECT_TRUE(cache.GetInvokeTarget(InstructionAt(2), klass) == nullptr);
+}
+
+// Check that a GC clears the cache of the thread that runs it.
+TEST_F(InterpreterCacheTest, ClearedByGc) {
+  ScopedObjectAccess soa(Thread::Current());
+  InterpreterCache* cache = soa.Self()->GetInterpreterCache();
+  cache->SetField(InstructionAt(0), Fake<ArtField>(0x1000));
+  Runtime::Current()->GetHeap()->CollectGarbage(/* clear_soft_references */ false);
+  EXPECT_TRUE(cache->GetField(InstructionAt(0)) == nullptr);
+}
+
+struct SuspendedThreadArgs {
+  const Instruction* inst;
+  Thread* thread;
+  Barrier* filled;
+  Barrier* release;
+};
+
+static void* FillCacheAndSuspend(void* arg) {
+  SuspendedThreadArgs* args = reinterpret_cast<SuspendedThreadArgs*>(arg);
+  CHECK(Runtime::Current()->AttachCurrentThread("Interpreter cache test thread",
+                                                /* as_daemon */ false,
+                                                /* thread_group */ nullptr,
+                                                /* create_peer */ false));
+  Thread* self = Thread::Current();
+  {
+    ScopedObjectAccess soa(self);
+    self->GetInterpreterCache()->SetField(args->inst, Fake<ArtField>(0x1000));
+  }
+  // Wait in native code, which counts as suspended for the GC.
+  args->thread = self;
+  args->filled->Pass(self);
+  args->release->Wait(self);
+  Runtime::Current()->DetachCurrentThread();
+  return nullptr;
+}
+
+// Check that a GC clears the cache of threads that are suspended while it visits their roots.
+TEST_F(InterpreterCacheTest, ClearedForSuspendedThread) {
+  Thread* self = Thread::Current();
+  Barrier filled(0);
+  Barrier release(2);
+  SuspendedThreadArgs args = { InstructionAt(0), nullptr, &filled, &release };
+  pthread_t pthread;
+  ASSERT_EQ(0, pthread_create(&pthread, nullptr, &FillCacheAndSuspend, &args));
+  filled.Increment(self, 1);
+  ASSERT_TRUE(args.thread != nullptr);
+  EXPECT_EQ(Fake<ArtField>(0x1000),
+            args.thread->GetInterpreterCache()->GetField(args.inst));
+  {
+    ScopedObjectAccess soa(self);
+    Runtime::Current()->GetHeap()->CollectGarbage(/* clear_soft_references */ false);
+  }
+  EXPECT_TRUE(args.thread->GetInterpreterCache()->GetField(args.inst) == nullptr);
+  release.Wait(self);
+  ASSERT_EQ(0, pthread_join(pthread, nullptr));
+}
+
+}  // namespace interpreter
+}  // namespace art
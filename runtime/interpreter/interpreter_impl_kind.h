@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_INTERPRETER_INTERPRETER_IMPL_KIND_H_
+#define ART_RUNTIME_INTERPRETER_INTERPRETER_IMPL_KIND_H_
+
+#include <stdint.h>
+
+namespace art {
+namespace interpreter {
+
+// The implementation used to execute dex code in the interpreter, see -Xinterpreter.
+enum class InterpreterImplKind : int8_t {
+  kSwitchImpl,        // Switch-based interpreter implementation.
+  kComputedGotoImpl,  // Computed-goto-based interpreter implementation.
+};
+
+#if !defined(__clang__)
+static constexpr bool kComputedGotoImplAvailable = true;
+static constexpr InterpreterImplKind kDefaultInterpreterImplKind =
+    InterpreterImplKind::kComputedGotoImpl;
+#else
+// Clang 3.4 fails to build the goto interpreter implementation.
+static constexpr bool kComputedGotoImplAvailable = false;
+static constexpr InterpreterImplKind kDefaultInterpreterImplKind =
+    InterpreterImplKind::kSwitchImpl;
+#endif
+
+}  // namespace interpreter
+}  // namespace art
+
+#endif  // ART_RUNTIME_INTERPRETER_INTERPRETER_IMPL_KIND_H_
@@ -20,18 +20,26 @@
 #include <cutils/trace.h>
 #include <dlfcn.h>
 
+#include <memory>
+#include <unordered_set>
+
 #include "art_method.h"
 #include "base/dumpable.h"
 #include "base/mutex.h"
 #include "base/stl_util.h"
+#include "base/unix_file/fd_file.h"
 #include "check_jni.h"
 #include "dex_file-inl.h"
+#include "elf_file.h"
+#include "elf_file_impl.h"
+#include "entrypoints/runtime_asm_entrypoints.h"
 #include "fault_handler.h"
 #include "indirect_reference_table-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/class_loader.h"
 #include "nativebridge/native_bridge.h"
 #include "java_vm_ext.h"
+#include "os.h"
 #include "parsed_options.h"
 #include "runtime-inl.h"
 #include "runtime_options.h"
@@ -39,6 +47,7 @@
 #include "scoped_thread_state_change.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "utf.h"
 
 namespace art {
 
@@ -60,6 +69,7 @@ class SharedLibrary {
       : path_(path),
         handle_(handle),
         needs_native_bridge_(false),
+        has_jni_symbol_index_(false),
         class_loader_(env->NewWeakGlobalRef(class_loader)),
         class_loader_allocator_(class_loader_allocator),
         jni_on_load_lock_("JNI_OnLoad lock"),
@@ -156,7 +166,93 @@ class SharedLibrary {
     return android::NativeBridgeGetTrampoline(handle_, symbol_name.c_str(), shorty, len);
   }
 
+  // Index the hashes of the JNI symbols ("Java_...") this library defines in its dynamic symbol
+  // table. Must be called before the library is published in the Libraries map. If the library
+  // file cannot be read (e.g. it is loaded directly from an APK), no index is built and every
+  // lookup goes to dlsym.
+  void BuildJniSymbolIndex() {
+    CHECK(!NeedsNativeBridge());
+    std::unique_ptr<File> file(OS::OpenFileForReading(path_.c_str()));
+    if (file.get() == nullptr) {
+      VLOG(jni) << "[No JNI symbol index for \"" << path_ << "\": cannot open file]";
+      return;
+    }
+    std::string error_msg;
+    std::unique_ptr<ElfFile> elf_file(ElfFile::Open(file.get(),
+                                                    /* writable */ false,
+                                                    /* program_header_only */ false,
+                                                    &error_msg));
+    if (elf_file.get() == nullptr) {
+      VLOG(jni) << "[No JNI symbol index for \"" << path_ << "\": " << error_msg << "]";
+      return;
+    }
+    has_jni_symbol_index_ = elf_file->Is64Bit()
+        ? IndexJniSymbols(elf_file->GetImpl64())
+        : IndexJniSymbols(elf_file->GetImpl32());
+    VLOG(jni) << "[Indexed " << jni_symbol_hashes_.size() << " JNI symbols of \"" << path_
+              << "\"]";
+  }
+
+  bool HasJniSymbolIndex() const {
+    return has_jni_symbol_index_;
+  }
+
+  // Returns false only if the index proves this library does not define `symbol_name` itself.
+  bool MayDefineJniSymbol(const std::string& symbol_name) const {
+    return !has_jni_symbol_index_ ||
+        jni_symbol_hashes_.find(ComputeModifiedUtf8Hash(symbol_name.c_str())) !=
+            jni_symbol_hashes_.end();
+  }
+
+  // Look up the native code of `m` by its short, then its long JNI name. The long name is only
+  // computed, into `jni_long_name`, if it is needed and still empty. With `use_index`, names the
+  // JNI symbol index rules out are not passed to dlsym.
+  void* FindNativeMethod(ArtMethod* m,
+                         const std::string& jni_short_name,
+                         std::string* jni_long_name,
+                         bool use_index)
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    const char* shorty = NeedsNativeBridge() ? m->GetShorty() : nullptr;
+    if (!use_index || MayDefineJniSymbol(jni_short_name)) {
+      void* fn = FindSymbol(jni_short_name, shorty);
+      if (fn != nullptr) {
+        return fn;
+      }
+    }
+    if (jni_long_name->empty()) {
+      *jni_long_name = JniLongName(m);
+    }
+    if (!use_index || MayDefineJniSymbol(*jni_long_name)) {
+      return FindSymbol(*jni_long_name, shorty);
+    }
+    return nullptr;
+  }
+
  private:
+  template <typename ElfFileImplType>
+  bool IndexJniSymbols(ElfFileImplType* elf_file) {
+    auto* const dynsym = elf_file->FindSectionByType(SHT_DYNSYM);
+    if (dynsym == nullptr) {
+      return false;
+    }
+    auto* const dynstr = elf_file->GetSectionHeader(dynsym->sh_link);
+    if (dynstr == nullptr) {
+      return false;
+    }
+    const uint32_t num_symbols = elf_file->GetSymbolNum(*dynsym);
+    for (uint32_t i = 0; i != num_symbols; ++i) {
+      const auto* const symbol = elf_file->GetSymbol(SHT_DYNSYM, i);
+      if (symbol == nullptr || symbol->st_shndx == SHN_UNDEF) {
+        continue;
+      }
+      const char* const name = elf_file->GetString(*dynstr, symbol->st_name);
+      if (name != nullptr && strncmp(name, "Java_", 5) == 0) {
+        jni_symbol_hashes_.insert(ComputeModifiedUtf8Hash(name));
+      }
+    }
+    return true;
+  }
+
   enum JNI_OnLoadState {
     kPending,
     kFailed,
@@ -172,6 +268,11 @@ class SharedLibrary {
   // True if a native bridge is required.
   bool needs_native_bridge_;
 
+  // True if jni_symbol_hashes_ lists all JNI symbols defined by the library. Set up before the
+  // library is shared with other threads and immutable afterwards.
+  bool has_jni_symbol_index_;
+  std::unordered_set<uint32_t> jni_symbol_hashes_;
+
   // The ClassLoader this library is associated with, a weak global JNI reference that is
   // created/deleted with the scope of the library.
   const jweak class_loader_;
@@ -232,37 +333,66 @@ class Libraries {
       REQUIRES(Locks::jni_libraries_lock_)
       SHARED_REQUIRES(Locks::mutator_lock_) {
     std::string jni_short_name(JniShortName(m));
-    std::string jni_long_name(JniLongName(m));
+    std::string jni_long_name;
+    void* fn = FindNativeMethod(m, jni_short_name, &jni_long_name, /* indexed_only */ false);
+    if (fn != nullptr) {
+      return fn;
+    }
+    if (jni_long_name.empty()) {
+      jni_long_name = JniLongName(m);
+    }
+    detail += "No implementation found for ";
+    detail += PrettyMethod(m);
+    detail += " (tried " + jni_short_name + " and " + jni_long_name + ")";
+    LOG(ERROR) << detail;
+    return nullptr;
+  }
+
+  // Look up the native code of `m` in the libraries of its class loader. The first pass walks
+  // the libraries in order, asking those with a JNI symbol index only for the names they define
+  // and fully searching the others. Unless `indexed_only`, a second pass then searches the
+  // indexed libraries with dlsym, which also finds symbols of their dependencies. With
+  // `indexed_only`, libraries without an index are skipped entirely.
+  //
+  // Unlike a single in-order dlsym search, a symbol that a library defines itself therefore
+  // takes precedence over one that an earlier indexed library only gets from its dependencies.
+  // For each library, the short name is still tried before the long name.
+  void* FindNativeMethod(ArtMethod* m,
+                         const std::string& jni_short_name,
+                         std::string* jni_long_name,
+                         bool indexed_only)
+      REQUIRES(Locks::jni_libraries_lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_) {
     mirror::ClassLoader* const declaring_class_loader = m->GetDeclaringClass()->GetClassLoader();
     ScopedObjectAccessUnchecked soa(Thread::Current());
     void* const declaring_class_loader_allocator =
         Runtime::Current()->GetClassLinker()->GetAllocatorForClassLoader(declaring_class_loader);
     CHECK(declaring_class_loader_allocator != nullptr);
-    for (const auto& lib : libraries_) {
-      SharedLibrary* const library = lib.second;
-      // Use the allocator address for class loader equality to avoid unnecessary weak root decode.
-      if (library->GetClassLoaderAllocator() != declaring_class_loader_allocator) {
-        // We only search libraries loaded by the appropriate ClassLoader.
-        continue;
-      }
-      // Try the short name then the long name...
-      const char* shorty = library->NeedsNativeBridge()
-          ? m->GetShorty()
-          : nullptr;
-      void* fn = library->FindSymbol(jni_short_name, shorty);
-      if (fn == nullptr) {
-        fn = library->FindSymbol(jni_long_name, shorty);
+    for (bool use_index : { true, false }) {
+      if (!use_index && indexed_only) {
+        break;
       }
-      if (fn != nullptr) {
-        VLOG(jni) << "[Found native code for " << PrettyMethod(m)
-                  << " in \"" << library->GetPath() << "\"]";
-        return fn;
+      for (const auto& lib : libraries_) {
+        SharedLibrary* const library = lib.second;
+        // Use the allocator address for class loader equality to avoid unnecessary weak root
+        // decode.
+        if (library->GetClassLoaderAllocator() != declaring_class_loader_allocator) {
+          // We only search libraries loaded by the appropriate ClassLoader.
+          continue;
+        }
+        if (!library->HasJniSymbolIndex() && (indexed_only || !use_index)) {
+          // Unindexed libraries are fully searched in the first pass, unless restricted to
+          // indexed lookups.
+          continue;
+        }
+        void* fn = library->FindNativeMethod(m, jni_short_name, jni_long_name, use_index);
+        if (fn != nullptr) {
+          VLOG(jni) << "[Found native code for " << PrettyMethod(m)
+                    << " in \"" << library->GetPath() << "\"]";
+          return fn;
+        }
       }
     }
-    detail += "No implementation found for ";
-    detail += PrettyMethod(m);
-    detail += " (tried " + jni_short_name + " and " + jni_long_name + ")";
-    LOG(ERROR) << detail;
     return nullptr;
   }
 
@@ -803,6 +933,12 @@ bool JavaVMExt::LoadNativeLibrary(JNIEnv* env, const std::string& path, jobject
     // Create SharedLibrary ahead of taking the libraries lock to maintain lock ordering.
     std::unique_ptr<SharedLibrary> new_library(
         new SharedLibrary(env, self, path, handle, class_loader, class_loader_allocator));
+    // Native bridge libraries are not in the host format, only index those dlopen accepted.
+    if (!needs_native_bridge) {
+      ATRACE_BEGIN("BuildJniSymbolIndex");
+      new_library->BuildJniSymbolIndex();
+      ATRACE_END();
+    }
     MutexLock mu(self, *Locks::jni_libraries_lock_);
     library = libraries_->Get(path);
     if (library == nullptr) {  // We won race to get libraries_lock.
@@ -887,6 +1023,41 @@ void* JavaVMExt::FindCodeForNativeMethod(ArtMethod* m) {
   return native_method;
 }
 
+void JavaVMExt::PrelinkNativeMethods(mirror::Class* klass) {
+  const size_t pointer_size = runtime_->GetClassLinker()->GetImagePointerSize();
+  const void* const dlsym_lookup_stub = GetJniDlsymLookupStub();
+  std::vector<ArtMethod*> unlinked_methods;
+  for (ArtMethod& method : klass->GetDirectMethods(pointer_size)) {
+    if (method.IsNative() && method.GetEntryPointFromJni() == dlsym_lookup_stub) {
+      unlinked_methods.push_back(&method);
+    }
+  }
+  for (ArtMethod& method : klass->GetVirtualMethods(pointer_size)) {
+    if (method.IsNative() && method.GetEntryPointFromJni() == dlsym_lookup_stub) {
+      unlinked_methods.push_back(&method);
+    }
+  }
+  if (unlinked_methods.empty()) {
+    return;
+  }
+  size_t num_linked = 0;
+  MutexLock mu(Thread::Current(), *Locks::jni_libraries_lock_);
+  for (ArtMethod* method : unlinked_methods) {
+    std::string jni_short_name(JniShortName(method));
+    std::string jni_long_name;
+    void* native_method = libraries_->FindNativeMethod(method,
+                                                       jni_short_name,
+                                                       &jni_long_name,
+                                                       /* indexed_only */ true);
+    if (native_method != nullptr) {
+      method->RegisterNative(native_method, false);
+      ++num_linked;
+    }
+  }
+  VLOG(jni) << "[Prelinked " << num_linked << " of " << unlinked_methods.size()
+            << " native methods of " << PrettyClass(klass) << "]";
+}
+
 void JavaVMExt::SweepJniWeakGlobals(IsMarkedVisitor* visitor) {
   MutexLock mu(Thread::Current(), weak_globals_lock_);
   Runtime* const runtime = Runtime::Current();
@@ -28,6 +28,7 @@ namespace art {
 
 namespace mirror {
   class Array;
+  class Class;
 }  // namespace mirror
 
 class ArtMethod;
@@ -100,6 +101,14 @@ class JavaVMExt : public JavaVM {
   void* FindCodeForNativeMethod(ArtMethod* m)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
+  /**
+   * Binds the still unbound native methods of 'klass' whose JNI symbols are listed in the
+   * symbol index of a loaded library, saving the dlsym(3) lookup on their first invocation.
+   */
+  void PrelinkNativeMethods(mirror::Class* klass)
+      REQUIRES(!Locks::jni_libraries_lock_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
   void DumpForSigQuit(std::ostream& os)
       REQUIRES(!Locks::jni_libraries_lock_, !globals_lock_, !weak_globals_lock_);
 
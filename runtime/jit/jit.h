@@ -46,12 +46,17 @@ class Jit {
   static constexpr bool kStressMode = kIsDebugBuild;
   static constexpr size_t kDefaultCompileThreshold = kStressMode ? 2 : 500;
   static constexpr size_t kDefaultWarmupThreshold = kDefaultCompileThreshold / 2;
+  // Number of times a method must be found executing its baseline code by the tier-up
+  // sampler before it is compiled with all optimizations. Zero disables the baseline tier.
+  static constexpr size_t kDefaultOptimizeThreshold = kStressMode ? 2 : 20;
 
   virtual ~Jit();
   static Jit* Create(JitOptions* options, std::string* error_msg);
-  bool CompileMethod(ArtMethod* method, Thread* self)
+  bool CompileMethod(ArtMethod* method, Thread* self, bool baseline)
       SHARED_REQUIRES(Locks::mutator_lock_);
-  void CreateInstrumentationCache(size_t compile_threshold, size_t warmup_threshold);
+  void CreateInstrumentationCache(size_t compile_threshold,
+                                  size_t warmup_threshold,
+                                  size_t optimize_threshold);
   void CreateThreadPool();
   CompilerCallbacks* GetCompilerCallbacks() {
     return compiler_callbacks_;
@@ -83,7 +88,7 @@ class Jit {
   void* jit_compiler_handle_;
   void* (*jit_load_)(CompilerCallbacks**);
   void (*jit_unload_)(void*);
-  bool (*jit_compile_method_)(void*, ArtMethod*, Thread*);
+  bool (*jit_compile_method_)(void*, ArtMethod*, Thread*, bool);
 
   // Performance monitoring.
   bool dump_info_on_shutdown_;
@@ -106,6 +111,9 @@ class JitOptions {
   size_t GetWarmupThreshold() const {
     return warmup_threshold_;
   }
+  size_t GetOptimizeThreshold() const {
+    return optimize_threshold_;
+  }
   size_t GetCodeCacheInitialCapacity() const {
     return code_cache_initial_capacity_;
   }
@@ -134,6 +142,7 @@ class JitOptions {
   size_t code_cache_max_capacity_;
   size_t compile_threshold_;
   size_t warmup_threshold_;
+  size_t optimize_threshold_;
   bool dump_info_on_shutdown_;
   bool save_profiling_info_;
 
@@ -142,6 +151,7 @@ class JitOptions {
         code_cache_initial_capacity_(0),
         code_cache_max_capacity_(0),
         compile_threshold_(0),
+        optimize_threshold_(0),
         dump_info_on_shutdown_(false),
         save_profiling_info_(false) { }
 
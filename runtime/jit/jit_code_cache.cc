@@ -20,6 +20,8 @@
 
 #include "art_method-inl.h"
 #include "base/time_utils.h"
+#include "cha.h"
+#include "class_linker.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
 #include "gc/accounting/bitmap-inl.h"
 #include "jit/profiling_info.h"
@@ -145,6 +147,28 @@ bool JitCodeCache::ContainsMethod(ArtMethod* method) {
   return false;
 }
 
+bool JitCodeCache::IsBaselineCompiled(ArtMethod* method) {
+  MutexLock mu(Thread::Current(), lock_);
+  return baseline_code_.find(method) != baseline_code_.end();
+}
+
+bool JitCodeCache::IsBaselineCode(ArtMethod* method, const void* code) {
+  MutexLock mu(Thread::Current(), lock_);
+  auto it = baseline_code_.find(method);
+  return it != baseline_code_.end() && it->second == code;
+}
+
+bool JitCodeCache::HasBaselineCode() {
+  MutexLock mu(Thread::Current(), lock_);
+  return !baseline_code_.empty();
+}
+
+bool JitCodeCache::RequestOptimization(ArtMethod* method) {
+  MutexLock mu(Thread::Current(), lock_);
+  auto it = baseline_code_.find(method);
+  return it != baseline_code_.end() && optimization_requested_.insert(it->second).second;
+}
+
 class ScopedCodeCacheWrite {
  public:
   explicit ScopedCodeCacheWrite(MemMap* code_map) : code_map_(code_map) {
@@ -168,7 +192,15 @@ uint8_t* JitCodeCache::CommitCode(Thread* self,
                                   size_t core_spill_mask,
                                   size_t fp_spill_mask,
                                   const uint8_t* code,
-                                  size_t code_size) {
+                                  size_t code_size,
+                                  const ArenaSet<ArtMethod*>& cha_single_implementation_list,
+                                  bool baseline) {
+  // Do not bother committing code whose assumptions a class load already broke.
+  for (ArtMethod* single_implementation : cha_single_implementation_list) {
+    if (!single_implementation->IsSingleImplementation()) {
+      return nullptr;
+    }
+  }
   uint8_t* result = CommitCodeInternal(self,
                                        method,
                                        mapping_table,
@@ -178,7 +210,9 @@ uint8_t* JitCodeCache::CommitCode(Thread* self,
                                        core_spill_mask,
                                        fp_spill_mask,
                                        code,
-                                       code_size);
+                                       code_size,
+                                       cha_single_implementation_list,
+                                       baseline);
   if (result == nullptr) {
     // Retry.
     GarbageCollectCache(self);
@@ -191,7 +225,9 @@ uint8_t* JitCodeCache::CommitCode(Thread* self,
                                 core_spill_mask,
                                 fp_spill_mask,
                                 code,
-                                code_size);
+                                code_size,
+                                cha_single_implementation_list,
+                                baseline);
   }
   return result;
 }
@@ -231,6 +267,16 @@ void JitCodeCache::FreeCode(const void* code_ptr, ArtMethod* method ATTRIBUTE_UN
   mspace_free(code_mspace_, reinterpret_cast<uint8_t*>(allocation));
 }
 
+void JitCodeCache::RemoveTierInformation(const void* code_ptr, ArtMethod* method) {
+  auto it = baseline_code_.find(method);
+  if (it != baseline_code_.end() && it->second == code_ptr) {
+    baseline_code_.erase(it);
+  }
+  replaced_code_.erase(code_ptr);
+  invalidated_code_.erase(code_ptr);
+  optimization_requested_.erase(code_ptr);
+}
+
 void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
   MutexLock mu(self, lock_);
   // We do not check if a code cache GC is in progress, as this method comes
@@ -240,6 +286,7 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
     ScopedCodeCacheWrite scc(code_map_.get());
     for (auto it = method_code_map_.begin(); it != method_code_map_.end();) {
       if (alloc.ContainsUnsafe(it->second)) {
+        RemoveTierInformation(it->first, it->second);
         FreeCode(it->first, it->second);
         it = method_code_map_.erase(it);
       } else {
@@ -268,7 +315,9 @@ uint8_t* JitCodeCache::CommitCodeInternal(Thread* self,
                                           size_t core_spill_mask,
                                           size_t fp_spill_mask,
                                           const uint8_t* code,
-                                          size_t code_size) {
+                                          size_t code_size,
+                                          const ArenaSet<ArtMethod*>& single_implementation_list,
+                                          bool baseline) {
   size_t alignment = GetInstructionSetAlignment(kRuntimeISA);
   // Ensure the header ends up at expected instruction alignment.
   size_t header_size = RoundUp(sizeof(OatQuickMethodHeader), alignment);
@@ -308,7 +357,31 @@ uint8_t* JitCodeCache::CommitCodeInternal(Thread* self,
   // We need to update the entry point in the runnable state for the instrumentation.
   {
     MutexLock mu(self, lock_);
+    // Register the class hierarchy analysis dependencies under the lock, so that an
+    // invalidation cannot happen between the check and the installation of the code.
+    ClassHierarchyAnalysis* cha = Runtime::Current()->GetClassLinker()->GetClassHierarchyAnalysis();
+    if (!single_implementation_list.empty() &&
+        !cha->AddDependencies(self, method, single_implementation_list)) {
+      VLOG(jit) << "Not installing code of " << PrettyMethod(method)
+                << " as a class load invalidated it during compilation";
+      ScopedCodeCacheWrite scc(code_map_.get());
+      // The metadata belongs to the caller, only free the code.
+      mspace_free(code_mspace_, reinterpret_cast<uint8_t*>(FromCodeToAllocation(code_ptr)));
+      return nullptr;
+    }
     method_code_map_.Put(code_ptr, method);
+    auto baseline_it = baseline_code_.find(method);
+    if (baseline_it != baseline_code_.end()) {
+      // Frames may still be executing the baseline code, so it is left to the next
+      // collection to free it.
+      replaced_code_.insert(baseline_it->second);
+      baseline_code_.erase(baseline_it);
+    }
+    if (baseline) {
+      baseline_code_.Put(method, code_ptr);
+      // The counter now measures how hot the baseline code is.
+      method->ClearCounter();
+    }
     Runtime::Current()->GetInstrumentation()->UpdateMethodsCode(
         method, method_header->GetEntryPoint());
     if (collection_in_progress_) {
@@ -329,6 +402,26 @@ uint8_t* JitCodeCache::CommitCodeInternal(Thread* self,
   return reinterpret_cast<uint8_t*>(method_header);
 }
 
+void JitCodeCache::InvalidateCompiledCodeFor(Thread* self, ArtMethod* method) {
+  MutexLock mu(self, lock_);
+  for (const auto& it : method_code_map_) {
+    if (it.second == method) {
+      invalidated_code_.insert(it.first);
+    }
+  }
+  auto baseline_it = baseline_code_.find(method);
+  if (baseline_it != baseline_code_.end() &&
+      invalidated_code_.find(baseline_it->second) != invalidated_code_.end()) {
+    baseline_code_.erase(baseline_it);
+  }
+  if (ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
+    Runtime::Current()->GetInstrumentation()->UpdateMethodsCode(
+        method, GetQuickToInterpreterBridge());
+    // Let the interpreter compile the method again once it is hot.
+    method->ClearCounter();
+  }
+}
+
 size_t JitCodeCache::CodeCacheSize() {
   MutexLock mu(Thread::Current(), lock_);
   return CodeCacheSizeLocked();
@@ -566,11 +659,19 @@ void JitCodeCache::GarbageCollectCache(Thread* self) {
         uintptr_t allocation = FromCodeToAllocation(code_ptr);
         const OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromCodePointer(code_ptr);
         if (GetLiveBitmap()->Test(allocation)) {
-          instrumentation->UpdateMethodsCode(method, method_header->GetEntryPoint());
+          // Code that class hierarchy analysis invalidated, or that a later compilation
+          // replaced, is only kept for the frames still executing it.
+          if (invalidated_code_.find(code_ptr) == invalidated_code_.end() &&
+              replaced_code_.find(code_ptr) == replaced_code_.end()) {
+            instrumentation->UpdateMethodsCode(method, method_header->GetEntryPoint());
+          }
           ++it;
         } else {
-          method->ClearCounter();
+          if (replaced_code_.find(code_ptr) == replaced_code_.end()) {
+            method->ClearCounter();
+          }
           DCHECK_NE(method->GetEntryPointFromQuickCompiledCode(), method_header->GetEntryPoint());
+          RemoveTierInformation(code_ptr, method);
           FreeCode(code_ptr, method);
           it = method_code_map_.erase(it);
         }
@@ -20,6 +20,7 @@
 #include "instrumentation.h"
 
 #include "atomic.h"
+#include "base/arena_containers.h"
 #include "base/macros.h"
 #include "base/mutex.h"
 #include "gc/accounting/bitmap.h"
@@ -66,7 +67,10 @@ class JitCodeCache {
   // of methods that got JIT compiled, as we might have collected some.
   size_t NumberOfCompiledCode() REQUIRES(!lock_);
 
-  // Allocate and write code and its metadata to the code cache.
+  // Allocate and write code and its metadata to the code cache. The code relies on each of
+  // `cha_single_implementation_list` having a single implementation; return null if one of
+  // them no longer has. Baseline code is replaced by the next non-baseline code committed
+  // for the same method.
   uint8_t* CommitCode(Thread* self,
                       ArtMethod* method,
                       const uint8_t* mapping_table,
@@ -76,7 +80,16 @@ class JitCodeCache {
                       size_t core_spill_mask,
                       size_t fp_spill_mask,
                       const uint8_t* code,
-                      size_t code_size)
+                      size_t code_size,
+                      const ArenaSet<ArtMethod*>& cha_single_implementation_list,
+                      bool baseline)
+      SHARED_REQUIRES(Locks::mutator_lock_)
+      REQUIRES(!lock_);
+
+  // Stop using the code compiled so far for `method`, because class hierarchy analysis
+  // invalidated it. Code compiled later no longer relies on the broken assumption, and
+  // can become the entry point again.
+  void InvalidateCompiledCodeFor(Thread* self, ArtMethod* method)
       SHARED_REQUIRES(Locks::mutator_lock_)
       REQUIRES(!lock_);
 
@@ -86,6 +99,19 @@ class JitCodeCache {
   // Return true if the code cache contains this method.
   bool ContainsMethod(ArtMethod* method) REQUIRES(!lock_);
 
+  // Return true if `method` has baseline code which was not replaced yet.
+  bool IsBaselineCompiled(ArtMethod* method) REQUIRES(!lock_);
+
+  // Return true if `code` is the baseline code of `method`, and was not replaced yet.
+  bool IsBaselineCode(ArtMethod* method, const void* code) REQUIRES(!lock_);
+
+  // Return true if some method has baseline code which was not replaced yet.
+  bool HasBaselineCode() REQUIRES(!lock_);
+
+  // Return true if `method` has baseline code, and this is the first request to optimize
+  // it. Samplers running concurrently thus enqueue a single optimizing compilation.
+  bool RequestOptimization(ArtMethod* method) REQUIRES(!lock_);
+
   // Reserve a region of data of size at least "size". Returns null if there is no more room.
   uint8_t* ReserveData(Thread* self, size_t size)
       SHARED_REQUIRES(Locks::mutator_lock_)
@@ -165,7 +191,9 @@ class JitCodeCache {
                               size_t core_spill_mask,
                               size_t fp_spill_mask,
                               const uint8_t* code,
-                              size_t code_size)
+                              size_t code_size,
+                              const ArenaSet<ArtMethod*>& single_implementation_list,
+                              bool baseline)
       REQUIRES(!lock_)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
@@ -183,6 +211,9 @@ class JitCodeCache {
   // Free in the mspace allocations taken by 'method'.
   void FreeCode(const void* code_ptr, ArtMethod* method) REQUIRES(lock_);
 
+  // Forget about `code_ptr` being baseline, replaced or invalidated code, as it is being freed.
+  void RemoveTierInformation(const void* code_ptr, ArtMethod* method) REQUIRES(lock_);
+
   // Number of bytes allocated in the code cache.
   size_t CodeCacheSizeLocked() REQUIRES(lock_);
 
@@ -219,6 +250,16 @@ class JitCodeCache {
   SafeMap<const void*, ArtMethod*> method_code_map_ GUARDED_BY(lock_);
   // ProfilingInfo objects we have allocated.
   std::vector<ProfilingInfo*> profiling_infos_ GUARDED_BY(lock_);
+  // The baseline code installed for a method, until optimized code replaces it.
+  SafeMap<ArtMethod*, const void*> baseline_code_ GUARDED_BY(lock_);
+  // Code replaced by a later compilation of its method. It is kept for the frames
+  // still executing it, but never becomes the entry point again.
+  std::set<const void*> replaced_code_ GUARDED_BY(lock_);
+  // Code whose class hierarchy analysis assumptions a class load broke. It is kept for the
+  // frames still executing it, which deoptimize where they relied on the assumptions.
+  std::set<const void*> invalidated_code_ GUARDED_BY(lock_);
+  // Baseline code whose method has been queued for an optimizing compilation.
+  std::set<const void*> optimization_requested_ GUARDED_BY(lock_);
 
   // The maximum capacity in bytes this code cache can go to.
   size_t max_capacity_ GUARDED_BY(lock_);
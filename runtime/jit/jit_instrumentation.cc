@@ -17,18 +17,30 @@
 #include "jit_instrumentation.h"
 
 #include "art_method-inl.h"
+#include "barrier.h"
 #include "jit.h"
 #include "jit_code_cache.h"
+#include "oat_quick_method_header.h"
 #include "scoped_thread_state_change.h"
+#include "stack.h"
 #include "thread_list.h"
 
 namespace art {
 namespace jit {
 
+// Time between two samples of the tier-up sampler.
+static constexpr int64_t kTierUpSamplingPeriodMs = 10;
+
+// Number of frames the tier-up sampler looks at, starting from the innermost one.
+// Hot loops and their callees are what we want to optimize, the callers further up
+// the stack are only seen once per call.
+static constexpr size_t kTierUpSampledFrames = 4;
+
 class JitCompileTask FINAL : public Task {
  public:
   enum TaskKind {
     kAllocateProfile,
+    kCompileBaseline,
     kCompile
   };
 
@@ -46,9 +58,11 @@ class JitCompileTask FINAL : public Task {
 
   void Run(Thread* self) OVERRIDE {
     ScopedObjectAccess soa(self);
-    if (kind_ == kCompile) {
-      VLOG(jit) << "JitCompileTask compiling method " << PrettyMethod(method_);
-      if (!Runtime::Current()->GetJit()->CompileMethod(method_, self)) {
+    if (kind_ == kCompile || kind_ == kCompileBaseline) {
+      bool baseline = (kind_ == kCompileBaseline);
+      VLOG(jit) << "JitCompileTask compiling method " << PrettyMethod(method_)
+                << (baseline ? " (baseline)" : "");
+      if (!Runtime::Current()->GetJit()->CompileMethod(method_, self, baseline)) {
         VLOG(jit) << "Failed to compile method " << PrettyMethod(method_);
       }
     } else {
@@ -71,11 +85,83 @@ class JitCompileTask FINAL : public Task {
   DISALLOW_IMPLICIT_CONSTRUCTORS(JitCompileTask);
 };
 
+// Runs the tier-up sampler on the thread of the tier-up pool.
+class JitTierUpSamplerTask FINAL : public Task {
+ public:
+  explicit JitTierUpSamplerTask(JitInstrumentationCache* cache) : cache_(cache) {}
+
+  void Run(Thread* self) OVERRIDE {
+    cache_->RunTierUpSampler(self);
+  }
+
+  void Finalize() OVERRIDE {
+    delete this;
+  }
+
+ private:
+  JitInstrumentationCache* const cache_;
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(JitTierUpSamplerTask);
+};
+
+// Adds a sample to the methods executing their baseline code in the innermost
+// frames of a thread.
+class TierUpSampleVisitor FINAL : public StackVisitor {
+ public:
+  TierUpSampleVisitor(Thread* thread, JitInstrumentationCache* cache)
+      SHARED_REQUIRES(Locks::mutator_lock_)
+      : StackVisitor(thread, nullptr, StackVisitor::StackWalkKind::kSkipInlinedFrames),
+        cache_(cache),
+        code_cache_(Runtime::Current()->GetJit()->GetCodeCache()),
+        visited_frames_(0) {}
+
+  bool VisitFrame() OVERRIDE SHARED_REQUIRES(Locks::mutator_lock_) {
+    ArtMethod* method = GetMethod();
+    if (method == nullptr || method->IsRuntimeMethod()) {
+      return true;
+    }
+    const OatQuickMethodHeader* method_header = GetCurrentOatQuickMethodHeader();
+    if (GetCurrentQuickFrame() != nullptr &&
+        method_header != nullptr &&
+        code_cache_->IsBaselineCode(method, method_header->GetCode())) {
+      cache_->AddBaselineSample(GetThread(), method);
+    }
+    return ++visited_frames_ < kTierUpSampledFrames;
+  }
+
+ private:
+  JitInstrumentationCache* const cache_;
+  JitCodeCache* const code_cache_;
+  size_t visited_frames_;
+};
+
+class TierUpSampleClosure FINAL : public Closure {
+ public:
+  TierUpSampleClosure(JitInstrumentationCache* cache, Barrier* barrier)
+      : cache_(cache), barrier_(barrier) {}
+
+  void Run(Thread* thread) OVERRIDE SHARED_REQUIRES(Locks::mutator_lock_) {
+    DCHECK(thread == Thread::Current());
+    TierUpSampleVisitor visitor(thread, cache_);
+    visitor.WalkStack();
+    barrier_->Pass(thread);
+  }
+
+ private:
+  JitInstrumentationCache* const cache_;
+  Barrier* const barrier_;
+};
+
 JitInstrumentationCache::JitInstrumentationCache(size_t hot_method_threshold,
-                                                 size_t warm_method_threshold)
+                                                 size_t warm_method_threshold,
+                                                 size_t optimize_method_threshold)
     : hot_method_threshold_(hot_method_threshold),
       warm_method_threshold_(warm_method_threshold),
-      listener_(this) {
+      optimize_method_threshold_(optimize_method_threshold),
+      listener_(this),
+      tier_up_lock_("Jit tier-up sampler lock"),
+      tier_up_cond_("Jit tier-up sampler condition", tier_up_lock_),
+      stop_tier_up_(false) {
 }
 
 void JitInstrumentationCache::CreateThreadPool() {
@@ -85,6 +171,11 @@ void JitInstrumentationCache::CreateThreadPool() {
   // is not null when we instrument.
   thread_pool_.reset(new ThreadPool("Jit thread pool", 1));
   thread_pool_->StartWorkers(Thread::Current());
+  if (UseBaselineTier()) {
+    tier_up_pool_.reset(new ThreadPool("Jit tier-up sampler", 1));
+    tier_up_pool_->AddTask(Thread::Current(), new JitTierUpSamplerTask(this));
+    tier_up_pool_->StartWorkers(Thread::Current());
+  }
   {
     // Add Jit interpreter instrumentation, tells the interpreter when
     // to notify the jit to compile something.
@@ -96,6 +187,16 @@ void JitInstrumentationCache::CreateThreadPool() {
 
 void JitInstrumentationCache::DeleteThreadPool(Thread* self) {
   DCHECK(Runtime::Current()->IsShuttingDown(self));
+  if (tier_up_pool_ != nullptr) {
+    // Stop the sampler first, as it adds tasks to `thread_pool_`.
+    {
+      MutexLock mu(self, tier_up_lock_);
+      stop_tier_up_ = true;
+      tier_up_cond_.Signal(self);
+    }
+    tier_up_pool_->Wait(self, false, false);
+    tier_up_pool_.reset();
+  }
   if (thread_pool_ != nullptr) {
     // First remove the listener, to avoid having mutators enter
     // 'AddSamples'.
@@ -149,10 +250,56 @@ void JitInstrumentationCache::AddSamples(Thread* self, ArtMethod* method, size_t
 
   if (sample_count == hot_method_threshold_) {
     DCHECK(thread_pool_ != nullptr);
+    JitCompileTask::TaskKind kind =
+        UseBaselineTier() ? JitCompileTask::kCompileBaseline : JitCompileTask::kCompile;
+    thread_pool_->AddTask(self, new JitCompileTask(method, kind));
+  }
+}
+
+void JitInstrumentationCache::AddBaselineSample(Thread* self, ArtMethod* method) {
+  // The sampler is stopped before the thread pool is deleted.
+  DCHECK(thread_pool_ != nullptr);
+  // Installing the baseline code cleared the counter, which now counts samples. Checkpoints
+  // of several threads may sample `method` concurrently, and the counter is not atomic, so
+  // it may skip the threshold or reach it twice: the code cache lets a single one of them
+  // enqueue the compilation.
+  if (method->IncrementCounter() >= optimize_method_threshold_ &&
+      Runtime::Current()->GetJit()->GetCodeCache()->RequestOptimization(method)) {
+    VLOG(jit) << "Baseline code of " << PrettyMethod(method) << " is hot";
+    // Adding the task from the checkpoint ensures the class of `method` is not
+    // unloaded before the task holds a reference to it.
     thread_pool_->AddTask(self, new JitCompileTask(method, JitCompileTask::kCompile));
   }
 }
 
+void JitInstrumentationCache::RunTierUpSampler(Thread* self) {
+  Runtime* const runtime = Runtime::Current();
+  JitCodeCache* const code_cache = runtime->GetJit()->GetCodeCache();
+  while (true) {
+    {
+      MutexLock mu(self, tier_up_lock_);
+      if (!stop_tier_up_) {
+        tier_up_cond_.TimedWait(self, kTierUpSamplingPeriodMs, 0);
+      }
+      if (stop_tier_up_) {
+        return;
+      }
+    }
+    if (!code_cache->HasBaselineCode()) {
+      // Nothing to sample, do not interrupt the mutators.
+      continue;
+    }
+    Barrier barrier(0);
+    TierUpSampleClosure closure(this, &barrier);
+    size_t threads_running_checkpoint =
+        runtime->GetThreadList()->RunCheckpointOnRunnableThreads(&closure);
+    if (threads_running_checkpoint != 0) {
+      ScopedThreadStateChange tsc(self, kWaitingForCheckPointsToRun);
+      barrier.Increment(self, threads_running_checkpoint);
+    }
+  }
+}
+
 JitInstrumentationListener::JitInstrumentationListener(JitInstrumentationCache* cache)
     : instrumentation_cache_(cache) {
   CHECK(instrumentation_cache_ != nullptr);
@@ -91,23 +91,43 @@ class JitInstrumentationListener : public instrumentation::InstrumentationListen
   DISALLOW_IMPLICIT_CONSTRUCTORS(JitInstrumentationListener);
 };
 
-// Keeps track of which methods are hot.
+// Keeps track of which methods are hot. Hot methods are first compiled to baseline
+// code, and compiled again with all optimizations once the tier-up sampler has seen
+// their baseline code executing often enough.
 class JitInstrumentationCache {
  public:
-  JitInstrumentationCache(size_t hot_method_threshold, size_t warm_method_threshold);
+  JitInstrumentationCache(size_t hot_method_threshold,
+                          size_t warm_method_threshold,
+                          size_t optimize_method_threshold);
   void AddSamples(Thread* self, ArtMethod* method, size_t samples)
       SHARED_REQUIRES(Locks::mutator_lock_);
+  // Called by the tier-up sampler when `method` is found executing its baseline code.
+  void AddBaselineSample(Thread* self, ArtMethod* method)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+  // Samples the stacks of the running threads until the thread pool is deleted.
+  void RunTierUpSampler(Thread* self) REQUIRES(!tier_up_lock_);
   void CreateThreadPool();
-  void DeleteThreadPool(Thread* self);
+  void DeleteThreadPool(Thread* self) REQUIRES(!tier_up_lock_);
   // Wait until there is no more pending compilation tasks.
   void WaitForCompilationToFinish(Thread* self);
 
  private:
+  bool UseBaselineTier() const {
+    return optimize_method_threshold_ != 0;
+  }
+
   size_t hot_method_threshold_;
   size_t warm_method_threshold_;
+  size_t optimize_method_threshold_;
   JitInstrumentationListener listener_;
   std::unique_ptr<ThreadPool> thread_pool_;
 
+  // Runs the tier-up sampler, when the baseline tier is used.
+  std::unique_ptr<ThreadPool> tier_up_pool_;
+  Mutex tier_up_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  ConditionVariable tier_up_cond_ GUARDED_BY(tier_up_lock_);
+  bool stop_tier_up_ GUARDED_BY(tier_up_lock_);
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(JitInstrumentationCache);
 };
 
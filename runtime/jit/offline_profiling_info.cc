@@ -168,4 +168,61 @@ bool OfflineProfilingInfo::Serialize(const std::string& filename,
 
   return CloseDescriptorForFile(fd, filename);
 }
+
+bool OfflineProfilingInfo::LoadMethods(
+    const std::string& filename,
+    const std::vector<const DexFile*>& dex_files,
+    std::set<MethodReference, MethodReferenceComparator>* methods,
+    std::string* error_msg) {
+  std::string data;
+  if (!ReadFileToString(filename, &data)) {
+    *error_msg = StringPrintf("Failed to read profile file '%s'", filename.c_str());
+    return false;
+  }
+  std::vector<std::string> lines;
+  Split(data, kLineSeparator, &lines);
+  std::vector<std::string> fields;
+  for (const std::string& line : lines) {
+    fields.clear();
+    Split(line, kFieldSeparator, &fields);
+    // Split() drops the empty multidex suffix of the primary dex file.
+    std::string multidex_suffix;
+    size_t field = 0u;
+    if (!fields.empty() && fields[0][0] == DexFile::kMultiDexSeparator) {
+      multidex_suffix = fields[0];
+      ++field;
+    }
+    uint32_t checksum;
+    if (field == fields.size() || !ParseUint(fields[field].c_str(), &checksum)) {
+      *error_msg = StringPrintf("Malformed profile record '%s' in '%s'",
+                                line.c_str(),
+                                filename.c_str());
+      return false;
+    }
+    const DexFile* dex_file = nullptr;
+    for (const DexFile* candidate : dex_files) {
+      if (candidate->GetLocationChecksum() == checksum &&
+          DexFile::GetMultiDexSuffix(candidate->GetLocation()) == multidex_suffix) {
+        dex_file = candidate;
+        break;
+      }
+    }
+    if (dex_file == nullptr) {
+      continue;
+    }
+    for (++field; field != fields.size(); ++field) {
+      uint32_t method_idx;
+      if (!ParseUint(fields[field].c_str(), &method_idx) ||
+          method_idx >= dex_file->NumMethodIds()) {
+        *error_msg = StringPrintf("Bad method index '%s' in profile '%s'",
+                                  fields[field].c_str(),
+                                  filename.c_str());
+        return false;
+      }
+      methods->insert(MethodReference(dex_file, method_idx));
+    }
+  }
+  return true;
+}
+
 }  // namespace art
@@ -18,9 +18,12 @@
 #define ART_RUNTIME_JIT_OFFLINE_PROFILING_INFO_H_
 
 #include <set>
+#include <string>
+#include <vector>
 
 #include "atomic.h"
 #include "dex_file.h"
+#include "method_reference.h"
 #include "safe_map.h"
 
 namespace art {
@@ -40,6 +43,15 @@ class OfflineProfilingInfo {
                          uint64_t last_update_time_ns,
                          const std::set<ArtMethod*>& methods);
 
+  // Read a profile written by SaveProfilingInfo() and add the methods it lists for `dex_files`
+  // to `methods`. Dex files are matched by multidex suffix and location checksum; records for
+  // other dex files are ignored. Returns false and sets `error_msg` if the file cannot be read
+  // or is malformed.
+  static bool LoadMethods(const std::string& filename,
+                          const std::vector<const DexFile*>& dex_files,
+                          std::set<MethodReference, MethodReferenceComparator>* methods,
+                          std::string* error_msg);
+
  private:
   // Map identifying the location of the profiled methods.
   // dex_file_ -> [dex_method_index]+
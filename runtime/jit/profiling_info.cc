@@ -16,6 +16,8 @@
 
 #include "profiling_info.h"
 
+#include <algorithm>
+
 #include "art_method-inl.h"
 #include "dex_instruction.h"
 #include "jit/jit.h"
@@ -65,15 +67,21 @@ bool ProfilingInfo::Create(Thread* self, ArtMethod* method, bool retry_allocatio
   return code_cache->AddProfilingInfo(self, method, entries, retry_allocation) != nullptr;
 }
 
-void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
-  InlineCache* cache = nullptr;
-  // TODO: binary search if array is too long.
-  for (size_t i = 0; i < number_of_inline_caches_; ++i) {
-    if (cache_[i].dex_pc == dex_pc) {
-      cache = &cache_[i];
-      break;
-    }
+ProfilingInfo::InlineCache* ProfilingInfo::GetInlineCache(uint32_t dex_pc) {
+  // Inline caches are created in increasing dex pc order.
+  InlineCache* cache = std::lower_bound(
+      cache_,
+      cache_ + number_of_inline_caches_,
+      dex_pc,
+      [](const InlineCache& lhs, uint32_t rhs) { return lhs.dex_pc < rhs; });
+  if (cache == cache_ + number_of_inline_caches_ || cache->dex_pc != dex_pc) {
+    return nullptr;
   }
+  return cache;
+}
+
+void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
+  InlineCache* cache = GetInlineCache(dex_pc);
   DCHECK(cache != nullptr);
 
   for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
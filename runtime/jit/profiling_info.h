@@ -40,34 +40,6 @@ class Class;
  */
 class ProfilingInfo {
  public:
-  // Create a ProfilingInfo for 'method'. Return whether it succeeded, or if it is
-  // not needed in case the method does not have virtual/interface invocations.
-  static bool Create(Thread* self, ArtMethod* method, bool retry_allocation)
-      SHARED_REQUIRES(Locks::mutator_lock_);
-
-  // Add information from an executed INVOKE instruction to the profile.
-  void AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls)
-      // Method should not be interruptible, as it manipulates the ProfilingInfo
-      // which can be concurrently collected.
-      REQUIRES(Roles::uninterruptible_)
-      SHARED_REQUIRES(Locks::mutator_lock_);
-
-  // NO_THREAD_SAFETY_ANALYSIS since we don't know what the callback requires.
-  template<typename RootVisitorType>
-  void VisitRoots(RootVisitorType& visitor) NO_THREAD_SAFETY_ANALYSIS {
-    for (size_t i = 0; i < number_of_inline_caches_; ++i) {
-      InlineCache* cache = &cache_[i];
-      for (size_t j = 0; j < InlineCache::kIndividualCacheSize; ++j) {
-        visitor.VisitRootIfNonNull(cache->classes_[j].AddressWithoutBarrier());
-      }
-    }
-  }
-
-  ArtMethod* GetMethod() const {
-    return method_;
-  }
-
- private:
   // Structure to store the classes seen at runtime for a specific instruction.
   // Once the classes_ array is full, we consider the INVOKE to be megamorphic.
   struct InlineCache {
@@ -94,11 +66,48 @@ class ProfilingInfo {
       return !classes_[1].IsNull() && classes_[kIndividualCacheSize - 1].IsNull();
     }
 
+    // Return the `index`th class seen by the INVOKE, or null if fewer classes were seen.
+    mirror::Class* GetTypeAt(size_t index) const SHARED_REQUIRES(Locks::mutator_lock_) {
+      DCHECK_LT(index, kIndividualCacheSize);
+      return classes_[index].Read();
+    }
+
     static constexpr uint16_t kIndividualCacheSize = 5;
     uint32_t dex_pc;
     GcRoot<mirror::Class> classes_[kIndividualCacheSize];
   };
 
+  // Create a ProfilingInfo for 'method'. Return whether it succeeded, or if it is
+  // not needed in case the method does not have virtual/interface invocations.
+  static bool Create(Thread* self, ArtMethod* method, bool retry_allocation)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Add information from an executed INVOKE instruction to the profile.
+  void AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls)
+      // Method should not be interruptible, as it manipulates the ProfilingInfo
+      // which can be concurrently collected.
+      REQUIRES(Roles::uninterruptible_)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // NO_THREAD_SAFETY_ANALYSIS since we don't know what the callback requires.
+  template<typename RootVisitorType>
+  void VisitRoots(RootVisitorType& visitor) NO_THREAD_SAFETY_ANALYSIS {
+    for (size_t i = 0; i < number_of_inline_caches_; ++i) {
+      InlineCache* cache = &cache_[i];
+      for (size_t j = 0; j < InlineCache::kIndividualCacheSize; ++j) {
+        visitor.VisitRootIfNonNull(cache->classes_[j].AddressWithoutBarrier());
+      }
+    }
+  }
+
+  ArtMethod* GetMethod() const {
+    return method_;
+  }
+
+  // Return the inline cache of the INVOKE at `dex_pc`, or null if it is not profiled.
+  InlineCache* GetInlineCache(uint32_t dex_pc);
+
+ private:
   ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& entries)
       : number_of_inline_caches_(entries.size()),
         method_(method) {
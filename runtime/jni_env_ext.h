@@ -29,9 +29,9 @@ namespace art {
 
 class JavaVMExt;
 
-// Maximum number of local references in the indirect reference table. The value is arbitrary but
-// low enough that it forces sanity checks.
-static constexpr size_t kLocalsMax = 512;
+// Maximum number of local references in the indirect reference table. The table only allocates
+// memory as it grows, so the value is arbitrary but low enough that it catches leaking code.
+static constexpr size_t kLocalsMax = 8192;
 
 struct JNIEnvExt : public JNIEnv {
   static JNIEnvExt* Create(Thread* self, JavaVMExt* vm);
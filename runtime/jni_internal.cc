@@ -500,7 +500,9 @@ class JNI {
   static jint PushLocalFrame(JNIEnv* env, jint capacity) {
     // TODO: SOA may not be necessary but I do it to please lock annotations.
     ScopedObjectAccess soa(env);
-    if (EnsureLocalCapacityInternal(soa, capacity, "PushLocalFrame") != JNI_OK) {
+    // The new frame starts at the current segment state, without the holes below it.
+    const uint32_t frame_cookie = soa.Env()->locals.GetSegmentState();
+    if (EnsureLocalCapacityInternal(soa, capacity, frame_cookie, "PushLocalFrame") != JNI_OK) {
       return JNI_ERR;
     }
     down_cast<JNIEnvExt*>(env)->PushFrame(capacity);
@@ -517,7 +519,10 @@ class JNI {
   static jint EnsureLocalCapacity(JNIEnv* env, jint desired_capacity) {
     // TODO: SOA may not be necessary but I do it to please lock annotations.
     ScopedObjectAccess soa(env);
-    return EnsureLocalCapacityInternal(soa, desired_capacity, "EnsureLocalCapacity");
+    return EnsureLocalCapacityInternal(soa,
+                                       desired_capacity,
+                                       soa.Env()->local_ref_cookie,
+                                       "EnsureLocalCapacity");
   }
 
   static jobject NewGlobalRef(JNIEnv* env, jobject obj) {
@@ -1902,7 +1907,7 @@ class JNI {
       return nullptr;
     }
     gc::Heap* heap = Runtime::Current()->GetHeap();
-    if (heap->IsMovableObject(array)) {
+    if (heap->IsMovableObject(array) && !heap->PinObject(array)) {
       if (!kUseReadBarrier) {
         heap->IncrementDisableMovingGC(soa.Self());
       } else {
@@ -2337,17 +2342,16 @@ class JNI {
   }
 
  private:
+  // Make sure `desired_capacity` local references can be added to the segment starting at
+  // `cookie`. The table grows to that size right away, so the additions do not allocate.
   static jint EnsureLocalCapacityInternal(ScopedObjectAccess& soa, jint desired_capacity,
-                                          const char* caller)
+                                          uint32_t cookie, const char* caller)
       SHARED_REQUIRES(Locks::mutator_lock_) {
-    // TODO: we should try to expand the table if necessary.
     if (desired_capacity < 0 || desired_capacity > static_cast<jint>(kLocalsMax)) {
       LOG(ERROR) << "Invalid capacity given to " << caller << ": " << desired_capacity;
       return JNI_ERR;
     }
-    // TODO: this isn't quite right, since "capacity" includes holes.
-    const size_t capacity = soa.Env()->locals.Capacity();
-    bool okay = (static_cast<jint>(kLocalsMax - capacity) >= desired_capacity);
+    bool okay = soa.Env()->locals.EnsureFreeCapacity(cookie, desired_capacity);
     if (!okay) {
       soa.Self()->ThrowOutOfMemoryError(caller);
     }
@@ -2392,8 +2396,9 @@ class JNI {
     if (UNLIKELY(array == nullptr)) {
       return nullptr;
     }
-    // Only make a copy if necessary.
-    if (Runtime::Current()->GetHeap()->IsMovableObject(array)) {
+    // Only make a copy if the array may move. Pinning keeps the collector running.
+    gc::Heap* heap = Runtime::Current()->GetHeap();
+    if (heap->IsMovableObject(array) && !heap->PinObject(array)) {
       if (is_copy != nullptr) {
         *is_copy = JNI_TRUE;
       }
@@ -2453,8 +2458,9 @@ class JNI {
     if (mode != JNI_COMMIT) {
       if (is_copy) {
         delete[] reinterpret_cast<uint64_t*>(elements);
-      } else if (heap->IsMovableObject(array)) {
-        // Non copy to a movable object must means that we had disabled the moving GC.
+      } else if (heap->IsMovableObject(array) && !heap->UnpinObject(array)) {
+        // Non copy to a movable object that could not be pinned must means that we had disabled
+        // the moving GC.
         if (!kUseReadBarrier) {
           heap->DecrementDisableMovingGC(soa.Self());
         } else {
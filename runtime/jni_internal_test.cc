@@ -18,7 +18,9 @@
 
 #include "art_method-inl.h"
 #include "common_compiler_test.h"
+#include "gc/heap.h"
 #include "java_vm_ext.h"
+#include "mirror/array-inl.h"
 #include "mirror/string-inl.h"
 #include "scoped_thread_state_change.h"
 #include "ScopedLocalRef.h"
@@ -868,7 +870,7 @@ TEST_F(JniInternalTest, FromReflectedField_ToReflectedField) {
   jobject field = env_->ToReflectedField(c, fid, JNI_FALSE);
   for (size_t i = 0; i <= kLocalsMax; ++i) {
     // Regression test for b/18396311, ToReflectedField leaking local refs causing a local
-    // reference table overflows with 512 references to ArtField
+    // reference table overflow with kLocalsMax references to ArtField
     env_->DeleteLocalRef(env_->ToReflectedField(c, fid, JNI_FALSE));
   }
   ASSERT_NE(c, nullptr);
@@ -899,7 +901,7 @@ TEST_F(JniInternalTest, FromReflectedMethod_ToReflectedMethod) {
   jobject method = env_->ToReflectedMethod(c, mid, JNI_FALSE);
   for (size_t i = 0; i <= kLocalsMax; ++i) {
     // Regression test for b/18396311, ToReflectedMethod leaking local refs causing a local
-    // reference table overflows with 512 references to ArtMethod
+    // reference table overflow with kLocalsMax references to ArtMethod
     env_->DeleteLocalRef(env_->ToReflectedMethod(c, mid, JNI_FALSE));
   }
   ASSERT_NE(method, nullptr);
@@ -1185,6 +1187,46 @@ TEST_F(JniInternalTest, SetPrimitiveArrayRegionElementsOfWrongType) {
   SetPrimitiveArrayRegionElementsOfWrongType(true);
 }
 
+TEST_F(JniInternalTest, GetPrimitiveArrayElementsWithoutCopy) {
+  gc::Heap* heap = Runtime::Current()->GetHeap();
+  if (heap->CurrentCollectorType() != gc::kCollectorTypeCC) {
+    // Only the concurrent copying collector can pin arrays instead of copying them.
+    return;
+  }
+  // CheckJNI hands out guarded copies.
+  bool old_check_jni = vm_->SetCheckJniEnabled(false);
+  jintArray array = env_->NewIntArray(16);
+  ASSERT_NE(array, nullptr);
+  void* data;
+  {
+    ScopedObjectAccess soa(env_);
+    data = soa.Decode<mirror::IntArray*>(array)->GetData();
+  }
+
+  jboolean is_copy = JNI_TRUE;
+  jint* elements = env_->GetIntArrayElements(array, &is_copy);
+  EXPECT_EQ(JNI_FALSE, is_copy);
+  EXPECT_EQ(data, elements);
+  elements[0] = 42;
+  // The array keeps its address across a collection while its elements are held.
+  heap->CollectGarbage(/* clear_soft_references */ false);
+  {
+    ScopedObjectAccess soa(env_);
+    data = soa.Decode<mirror::IntArray*>(array)->GetData();
+  }
+  EXPECT_EQ(data, elements);
+  env_->ReleaseIntArrayElements(array, elements, 0);
+
+  is_copy = JNI_TRUE;
+  void* critical = env_->GetPrimitiveArrayCritical(array, &is_copy);
+  EXPECT_EQ(JNI_FALSE, is_copy);
+  EXPECT_EQ(data, critical);
+  EXPECT_EQ(42, reinterpret_cast<jint*>(critical)[0]);
+  env_->ReleasePrimitiveArrayCritical(array, critical, 0);
+
+  EXPECT_FALSE(vm_->SetCheckJniEnabled(old_check_jni));
+}
+
 TEST_F(JniInternalTest, NewObjectArray) {
   jclass element_class = env_->FindClass("java/lang/String");
   ASSERT_NE(element_class, nullptr);
@@ -1866,8 +1908,8 @@ TEST_F(JniInternalTest, PushLocalFrame_10395422) {
   // Negative capacities are not allowed.
   ASSERT_EQ(JNI_ERR, env_->PushLocalFrame(-1));
 
-  // And it's okay to have an upper limit. Ours is currently 512.
-  ASSERT_EQ(JNI_ERR, env_->PushLocalFrame(8192));
+  // And it's okay to have an upper limit. Ours is kLocalsMax.
+  ASSERT_EQ(JNI_ERR, env_->PushLocalFrame(static_cast<jint>(kLocalsMax) + 1));
 }
 
 TEST_F(JniInternalTest, PushLocalFrame_PopLocalFrame) {
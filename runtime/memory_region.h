@@ -124,23 +124,34 @@ class MemoryRegion FINAL : public ValueObject {
   // The bit at the smallest offset is the least significant bit in the
   // loaded value.  `length` must not be larger than the number of bits
   // contained in the return value (32).
-  uint32_t LoadBits(uintptr_t bit_offset, size_t length) const {
-    CHECK_LE(length, sizeof(uint32_t) * kBitsPerByte);
-    uint32_t value = 0u;
-    for (size_t i = 0; i < length; ++i) {
-      value |= LoadBit(bit_offset + i) << i;
+  ALWAYS_INLINE uint32_t LoadBits(uintptr_t bit_offset, size_t length) const {
+    DCHECK_LE(length, BitSizeOf<uint32_t>());
+    if (length == 0u) {
+      return 0u;
+    }
+    // Assemble the (at most 5) bytes covering the requested bits in a
+    // little-endian fashion, then shift and mask the result.
+    uintptr_t first_byte = bit_offset >> kBitsPerByteLog2;
+    uintptr_t last_byte = (bit_offset + length - 1u) >> kBitsPerByteLog2;
+    DCHECK_LT(last_byte, size());
+    const uint8_t* data = start();
+    uint64_t value = 0u;
+    for (uintptr_t i = last_byte + 1u; i != first_byte; --i) {
+      value = (value << kBitsPerByte) | data[i - 1u];
     }
-    return value;
+    value >>= (bit_offset & (kBitsPerByte - 1));
+    return static_cast<uint32_t>(value) & MaxInt<uint32_t>(length);
   }
 
   // Store `value` on `length` bits in the region starting at bit offset
   // `bit_offset`.  The bit at the smallest offset is the least significant
   // bit of the stored `value`.  `value` must not be larger than `length`
   // bits.
-  void StoreBits(uintptr_t bit_offset, uint32_t value, size_t length) {
-    CHECK_LT(value, 2u << length);
+  void StoreBits(uintptr_t bit_offset, uint32_t value, size_t length) const {
+    CHECK_LE(length, BitSizeOf<uint32_t>());
+    CHECK(length == 0u ? value == 0u : value <= MaxInt<uint32_t>(length)) << value;
     for (size_t i = 0; i < length; ++i) {
-      bool ith_bit = value & (1 << i);
+      bool ith_bit = (value >> i) & 1u;
       StoreBit(bit_offset + i, ith_bit);
     }
   }
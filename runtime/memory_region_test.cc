@@ -55,4 +55,29 @@ TEST(MemoryRegion, StoreUnaligned) {
   }
 }
 
+TEST(MemoryRegion, LoadAndStoreBits) {
+  const size_t n = 8;
+  uint8_t data[n] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  MemoryRegion region(&data, n);
+
+  // Values straddling byte boundaries, including a full 32-bit value on a
+  // non-byte-aligned offset (which spans five bytes).
+  region.StoreBits(3, 0x15u, 5);
+  region.StoreBits(8, 0u, 0);
+  region.StoreBits(8, 0x1FFu, 9);
+  region.StoreBits(17, 0xDEADBEEFu, 32);
+  region.StoreBits(49, 0x5u, 3);
+
+  ASSERT_EQ(0x15u, region.LoadBits(3, 5));
+  ASSERT_EQ(0u, region.LoadBits(8, 0));
+  ASSERT_EQ(0x1FFu, region.LoadBits(8, 9));
+  ASSERT_EQ(0xDEADBEEFu, region.LoadBits(17, 32));
+  ASSERT_EQ(0x5u, region.LoadBits(49, 3));
+  ASSERT_EQ(0u, region.LoadBits(0, 3));
+  ASSERT_EQ(0u, region.LoadBits(52, 12));
+  for (size_t i = 0; i < 32; ++i) {
+    ASSERT_EQ((0xDEADBEEFu >> i) & 1u, region.LoadBits(17 + i, 1)) << i;
+  }
+}
+
 }  // namespace art
@@ -50,6 +50,10 @@ class MANAGED String FINAL : public Object {
     return OFFSET_OF_OBJECT_MEMBER(String, value_);
   }
 
+  static MemberOffset HashCodeOffset() {
+    return OFFSET_OF_OBJECT_MEMBER(String, hash_code_);
+  }
+
   uint16_t* GetValue() SHARED_REQUIRES(Locks::mutator_lock_) {
     return &value_[0];
   }
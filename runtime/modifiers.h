@@ -48,12 +48,19 @@ static constexpr uint32_t kAccClassIsProxy =         0x00040000;  // class  (dex
 static constexpr uint32_t kAccPreverified =          0x00080000;  // class (runtime),
                                                                   // method (dex only)
 static constexpr uint32_t kAccFastNative =           0x00080000;  // method (dex only)
+static constexpr uint32_t kAccCriticalNative =       0x00100000;  // method (compiler only)
 static constexpr uint32_t kAccMiranda =              0x00200000;  // method (dex only)
 static constexpr uint32_t kAccDefault =              0x00400000;  // method (runtime)
 // This is set by the class linker during LinkInterfaceMethods. Prior to that point we do not know
 // if any particular method needs to be a default conflict. Used to figure out at runtime if
 // invoking this method will throw an exception.
 static constexpr uint32_t kAccDefaultConflict =      0x00800000;  // method (runtime)
+// Set on methods whose compiled code assumed a virtual method had a single implementation, once
+// a class overriding that method gets loaded. Such code deoptimizes where it relied on the
+// assumption, and the method is not compiled with such assumptions again.
+static constexpr uint32_t kAccSingleImplementationInvalidated = 0x04000000;  // method (runtime)
+// Set by class hierarchy analysis on virtual methods that no loaded class overrides.
+static constexpr uint32_t kAccSingleImplementation =  0x08000000;  // method (runtime)
 
 // Special runtime-only flags.
 // Interface and all its super-interfaces with default methods have been recursively initialized.
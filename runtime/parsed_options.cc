@@ -164,6 +164,9 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjitwarmupthreshold:_")
           .WithType<unsigned int>()
           .IntoKey(M::JITWarmupThreshold)
+      .Define("-Xjitoptimizethreshold:_")
+          .WithType<unsigned int>()
+          .IntoKey(M::JITOptimizeThreshold)
       .Define("-Xjitsaveprofilinginfo")
           .WithValue(true)
           .IntoKey(M::JITSaveProfilingInfo)
@@ -259,6 +262,14 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
                          {"all",      verifier::VerifyMode::kEnable},
                          {"softfail", verifier::VerifyMode::kSoftFail}})
           .IntoKey(M::Verify)
+      .Define("-Xinterpreter:_")
+          .WithType<interpreter::InterpreterImplKind>()
+          .WithValueMap({{"switch", interpreter::InterpreterImplKind::kSwitchImpl},
+                         {"goto",   interpreter::InterpreterImplKind::kComputedGotoImpl}})
+          .IntoKey(M::InterpreterImpl)
+      .Define("-Xverification-cache:_")
+          .WithType<std::string>()
+          .IntoKey(M::VerificationCache)
       .Define("-XX:NativeBridge=_")
           .WithType<std::string>()
           .IntoKey(M::NativeBridge)
@@ -696,6 +707,8 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -X[no]relocate\n");
   UsageMessage(stream, "  -X[no]dex2oat (Whether to invoke dex2oat on the application)\n");
   UsageMessage(stream, "  -X[no]image-dex2oat (Whether to create and use a boot image)\n");
+  UsageMessage(stream, "  -Xverification-cache:filename "
+                       "(Reuse class verification results across runs)\n");
   UsageMessage(stream, "  -Xno-dex-file-fallback "
                        "(Don't fall back to dex files without oat files)\n");
   UsageMessage(stream, "  -Xexperimental:{lambdas,default-methods} "
@@ -710,6 +723,7 @@ void ParsedOptions::Usage(const char* fmt, ...) {
   UsageMessage(stream, "  -dsa\n");
   UsageMessage(stream, "   (-enablesystemassertions, -disablesystemassertions)\n");
   UsageMessage(stream, "  -Xverify:{none,remote,all,softfail}\n");
+  UsageMessage(stream, "  -Xinterpreter:{switch,goto}\n");
   UsageMessage(stream, "  -Xrs\n");
   UsageMessage(stream, "  -Xint:portable, -Xint:fast, -Xint:jit\n");
   UsageMessage(stream, "  -Xdexopt:{none,verified,all,full}\n");
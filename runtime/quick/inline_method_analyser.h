@@ -75,6 +75,11 @@ enum InlineMethodOpcode : uint16_t {
   kIntrinsicUnsafePut,
   kIntrinsicSystemArrayCopyCharArray,
   kIntrinsicSystemArrayCopy,
+  kIntrinsicSystemArrayCopyByteArray,
+  kIntrinsicSystemArrayCopyIntArray,
+  kIntrinsicHashCode,
+  kIntrinsicArraysFill,
+  kIntrinsicArraysEquals,
 
   kInlineOpNop,
   kInlineOpReturnArg,
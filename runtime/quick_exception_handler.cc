@@ -95,7 +95,13 @@ class CatchBlockStackVisitor FINAL : public StackVisitor {
   bool HandleTryItems(ArtMethod* method)
       SHARED_REQUIRES(Locks::mutator_lock_) {
     uint32_t dex_pc = DexFile::kDexNoIndex;
-    if (!method->IsNative()) {
+    if (!method->IsNative() && !method->IsProxyMethod()) {
+      const DexFile::CodeItem* code_item = method->GetCodeItem();
+      if (code_item == nullptr || code_item->tries_size_ == 0) {
+        // Most frames have no try item. Unwind them without decoding their dex pc.
+        RemoveDebuggerShadowFrame();
+        return true;  // Continue stack walk.
+      }
       dex_pc = GetDexPc();
     }
     if (dex_pc != DexFile::kDexNoIndex) {
@@ -113,20 +119,26 @@ class CatchBlockStackVisitor FINAL : public StackVisitor {
         exception_handler_->SetHandlerQuickFrame(GetCurrentQuickFrame());
         exception_handler_->SetHandlerMethodHeader(GetCurrentOatQuickMethodHeader());
         return false;  // End stack walk.
-      } else if (UNLIKELY(GetThread()->HasDebuggerShadowFrames())) {
-        // We are going to unwind this frame. Did we prepare a shadow frame for debugging?
-        size_t frame_id = GetFrameId();
-        ShadowFrame* frame = GetThread()->FindDebuggerShadowFrame(frame_id);
-        if (frame != nullptr) {
-          // We will not execute this shadow frame so we can safely deallocate it.
-          GetThread()->RemoveDebuggerShadowFrameMapping(frame_id);
-          ShadowFrame::DeleteDeoptimizedFrame(frame);
-        }
+      } else {
+        RemoveDebuggerShadowFrame();
       }
     }
     return true;  // Continue stack walk.
   }
 
+  void RemoveDebuggerShadowFrame() SHARED_REQUIRES(Locks::mutator_lock_) {
+    if (UNLIKELY(GetThread()->HasDebuggerShadowFrames())) {
+      // We are going to unwind this frame. Did we prepare a shadow frame for debugging?
+      size_t frame_id = GetFrameId();
+      ShadowFrame* frame = GetThread()->FindDebuggerShadowFrame(frame_id);
+      if (frame != nullptr) {
+        // We will not execute this shadow frame so we can safely deallocate it.
+        GetThread()->RemoveDebuggerShadowFrameMapping(frame_id);
+        ShadowFrame::DeleteDeoptimizedFrame(frame);
+      }
+    }
+  }
+
   // The exception we're looking for the catch block of.
   Handle<mirror::Throwable>* exception_;
   // The quick exception handler we're visiting for.
@@ -222,8 +234,7 @@ void QuickExceptionHandler::SetCatchEnvironmentForOptimizedHandler(StackVisitor*
   StackMapEncoding encoding = code_info.ExtractEncoding();
 
   // Find stack map of the throwing instruction.
-  StackMap throw_stack_map =
-      code_info.GetStackMapForNativePcOffset(stack_visitor->GetNativePcOffset(), encoding);
+  StackMap throw_stack_map = stack_visitor->GetCurrentStackMap(code_info, encoding);
   DCHECK(throw_stack_map.IsValid());
   DexRegisterMap throw_vreg_map =
       code_info.GetDexRegisterMapOf(throw_stack_map, encoding, number_of_vregs);
@@ -368,12 +379,11 @@ class DeoptimizeStackVisitor FINAL : public StackVisitor {
       SHARED_REQUIRES(Locks::mutator_lock_) {
     const OatQuickMethodHeader* method_header = GetCurrentOatQuickMethodHeader();
     CodeInfo code_info = method_header->GetOptimizedCodeInfo();
-    uintptr_t native_pc_offset = method_header->NativeQuickPcOffset(GetCurrentQuickFramePc());
     StackMapEncoding encoding = code_info.ExtractEncoding();
-    StackMap stack_map = code_info.GetStackMapForNativePcOffset(native_pc_offset, encoding);
+    StackMap stack_map = GetCurrentStackMap(code_info, encoding);
     const size_t number_of_vregs = m->GetCodeItem()->registers_size_;
-    MemoryRegion stack_mask = stack_map.GetStackMask(encoding);
-    uint32_t register_mask = stack_map.GetRegisterMask(encoding);
+    MemoryRegion stack_mask = code_info.GetStackMaskOf(stack_map, encoding);
+    uint32_t register_mask = code_info.GetRegisterMaskOf(stack_map, encoding);
     DexRegisterMap vreg_map = IsInInlinedFrame()
         ? code_info.GetDexRegisterMapAtDepth(GetCurrentInliningDepth() - 1,
                                              code_info.GetInlineInfoOf(stack_map, encoding),
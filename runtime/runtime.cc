@@ -134,6 +134,7 @@
 #include "transaction.h"
 #include "utils.h"
 #include "verifier/method_verifier.h"
+#include "verifier/verification_cache.h"
 #include "well_known_classes.h"
 
 namespace art {
@@ -198,6 +199,7 @@ Runtime::Runtime()
       dump_gc_performance_on_shutdown_(false),
       preinitialization_transaction_(nullptr),
       verify_(verifier::VerifyMode::kNone),
+      interpreter_impl_kind_(interpreter::kDefaultInterpreterImplKind),
       allow_dex_file_fallback_(true),
       target_sdk_version_(0),
       implicit_null_checks_(false),
@@ -220,6 +222,7 @@ Runtime::~Runtime() {
   }
 
   MaybeSaveJitProfilingInfo();
+  SaveVerificationCache();
 
   if (dump_gc_performance_on_shutdown_) {
     // This can't be called from the Heap destructor below because it
@@ -886,6 +889,22 @@ bool Runtime::Init(const RuntimeOptions& raw_options, bool ignore_unrecognized)
   intern_table_ = new InternTable;
 
   verify_ = runtime_options.GetOrDefault(Opt::Verify);
+  interpreter_impl_kind_ = runtime_options.GetOrDefault(Opt::InterpreterImpl);
+  if (interpreter_impl_kind_ == interpreter::InterpreterImplKind::kComputedGotoImpl &&
+      !interpreter::kComputedGotoImplAvailable) {
+    LOG(WARNING) << "Computed-goto interpreter is not available, using the switch interpreter";
+    interpreter_impl_kind_ = interpreter::InterpreterImplKind::kSwitchImpl;
+  }
+  if (runtime_options.Exists(Opt::VerificationCache)) {
+    std::string filename = runtime_options.GetOrDefault(Opt::VerificationCache);
+    verification_cache_.reset(new verifier::VerificationCache(filename));
+    std::string error_msg;
+    if (!verification_cache_->Load(&error_msg)) {
+      // A broken cache only costs us the verification time, start from an empty one.
+      LOG(WARNING) << error_msg;
+      verification_cache_.reset(new verifier::VerificationCache(filename));
+    }
+  }
   allow_dex_file_fallback_ = !runtime_options.Exists(Opt::NoDexFileFallback);
 
   no_sig_chain_ = runtime_options.Exists(Opt::NoSigChain);
@@ -1790,7 +1809,8 @@ void Runtime::CreateJit() {
   if (jit_.get() != nullptr) {
     compiler_callbacks_ = jit_->GetCompilerCallbacks();
     jit_->CreateInstrumentationCache(jit_options_->GetCompileThreshold(),
-                                     jit_options_->GetWarmupThreshold());
+                                     jit_options_->GetWarmupThreshold(),
+                                     jit_options_->GetOptimizeThreshold());
     jit_->CreateThreadPool();
   } else {
     LOG(WARNING) << "Failed to create JIT " << error_msg;
@@ -1817,6 +1837,16 @@ void Runtime::SetImtUnimplementedMethod(ArtMethod* method) {
   imt_unimplemented_method_ = method;
 }
 
+void Runtime::SaveVerificationCache() {
+  if (verification_cache_ == nullptr) {
+    return;
+  }
+  std::string error_msg;
+  if (!verification_cache_->Save(&error_msg)) {
+    LOG(WARNING) << error_msg;
+  }
+}
+
 bool Runtime::IsVerificationEnabled() const {
   return verify_ == verifier::VerifyMode::kEnable;
 }
@@ -31,6 +31,7 @@
 #include "experimental_flags.h"
 #include "gc_root.h"
 #include "instrumentation.h"
+#include "interpreter/interpreter_impl_kind.h"
 #include "jobject_comparator.h"
 #include "method_reference.h"
 #include "object_callbacks.h"
@@ -69,6 +70,7 @@ namespace mirror {
 }  // namespace mirror
 namespace verifier {
   class MethodVerifier;
+  class VerificationCache;
   enum class VerifyMode : int8_t;
 }  // namespace verifier
 class ArenaPool;
@@ -511,9 +513,21 @@ class Runtime {
     return !implicit_so_checks_;
   }
 
+  interpreter::InterpreterImplKind GetInterpreterImplKind() const {
+    return interpreter_impl_kind_;
+  }
+
   bool IsVerificationEnabled() const;
   bool IsVerificationSoftFail() const;
 
+  // Returns null unless a verification cache file was given with -Xverification-cache.
+  verifier::VerificationCache* GetVerificationCache() const {
+    return verification_cache_.get();
+  }
+
+  // Write out the verification cache, if there is one.
+  void SaveVerificationCache();
+
   bool IsDexFileFallbackEnabled() const {
     return allow_dex_file_fallback_;
   }
@@ -744,6 +758,12 @@ class Runtime {
   // If kNone, verification is disabled. kEnable by default.
   verifier::VerifyMode verify_;
 
+  // Which interpreter implementation executes dex code, see -Xinterpreter.
+  interpreter::InterpreterImplKind interpreter_impl_kind_;
+
+  // Persistent class verification outcomes, see verifier::VerificationCache.
+  std::unique_ptr<verifier::VerificationCache> verification_cache_;
+
   // If true, the runtime may use dex files directly with the interpreter if an oat file is not
   // available/usable.
   bool allow_dex_file_fallback_;
@@ -30,6 +30,7 @@
 #include "jit/jit_code_cache.h"
 #include "gc/collector_type.h"
 #include "gc/space/large_object_space.h"
+#include "interpreter/interpreter_impl_kind.h"
 #include "profiler_options.h"
 #include "arch/instruction_set.h"
 #include "verifier/verify_mode.h"
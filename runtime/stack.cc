@@ -115,10 +115,9 @@ StackVisitor::StackVisitor(Thread* thread,
 
 InlineInfo StackVisitor::GetCurrentInlineInfo() const {
   const OatQuickMethodHeader* method_header = GetCurrentOatQuickMethodHeader();
-  uint32_t native_pc_offset = method_header->NativeQuickPcOffset(cur_quick_frame_pc_);
   CodeInfo code_info = method_header->GetOptimizedCodeInfo();
   StackMapEncoding encoding = code_info.ExtractEncoding();
-  StackMap stack_map = code_info.GetStackMapForNativePcOffset(native_pc_offset, encoding);
+  StackMap stack_map = GetCurrentStackMap(code_info, encoding);
   DCHECK(stack_map.IsValid());
   return code_info.GetInlineInfoOf(stack_map, encoding);
 }
@@ -200,6 +199,15 @@ size_t StackVisitor::GetNativePcOffset() const {
   return GetCurrentOatQuickMethodHeader()->NativeQuickPcOffset(cur_quick_frame_pc_);
 }
 
+StackMap StackVisitor::GetCurrentStackMap(const CodeInfo& code_info,
+                                          const StackMapEncoding& encoding) const {
+  DCHECK(!IsShadowFrame());
+  uint32_t native_pc_offset = GetNativePcOffset();
+  // Use the cache of the current thread rather than `thread_`, which may be running.
+  return Thread::Current()->GetStackMapCache()->Lookup(
+      cur_quick_frame_pc_, native_pc_offset, code_info, encoding);
+}
+
 bool StackVisitor::IsReferenceVReg(ArtMethod* m, uint16_t vreg) {
   DCHECK_EQ(m, GetMethod());
   // Process register map (which native and runtime methods don't have)
@@ -310,8 +318,7 @@ bool StackVisitor::GetVRegFromOptimizedCode(ArtMethod* m, uint16_t vreg, VRegKin
   CodeInfo code_info = method_header->GetOptimizedCodeInfo();
   StackMapEncoding encoding = code_info.ExtractEncoding();
 
-  uint32_t native_pc_offset = method_header->NativeQuickPcOffset(cur_quick_frame_pc_);
-  StackMap stack_map = code_info.GetStackMapForNativePcOffset(native_pc_offset, encoding);
+  StackMap stack_map = GetCurrentStackMap(code_info, encoding);
   DCHECK(stack_map.IsValid());
   size_t depth_in_stack_map = current_inlining_depth_ - 1;
 
@@ -862,9 +869,7 @@ void StackVisitor::WalkStack(bool include_transitions) {
             && cur_oat_quick_method_header_->IsOptimized()) {
           CodeInfo code_info = cur_oat_quick_method_header_->GetOptimizedCodeInfo();
           StackMapEncoding encoding = code_info.ExtractEncoding();
-          uint32_t native_pc_offset =
-              cur_oat_quick_method_header_->NativeQuickPcOffset(cur_quick_frame_pc_);
-          StackMap stack_map = code_info.GetStackMapForNativePcOffset(native_pc_offset, encoding);
+          StackMap stack_map = GetCurrentStackMap(code_info, encoding);
           if (stack_map.IsValid() && stack_map.HasInlineInfo(encoding)) {
             InlineInfo inline_info = code_info.GetInlineInfoOf(stack_map, encoding);
             DCHECK_EQ(current_inlining_depth_, 0u);
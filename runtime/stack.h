@@ -39,10 +39,13 @@ namespace mirror {
 class ArtMethod;
 class Context;
 class HandleScope;
+class CodeInfo;
 class InlineInfo;
 class OatQuickMethodHeader;
 class ScopedObjectAccess;
 class ShadowFrame;
+class StackMap;
+class StackMapEncoding;
 class StackVisitor;
 class Thread;
 
@@ -565,6 +568,11 @@ class StackVisitor {
 
   size_t GetNativePcOffset() const SHARED_REQUIRES(Locks::mutator_lock_);
 
+  // Returns the stack map of the current optimized frame at its return pc, going through the
+  // stack map cache of the calling thread. `code_info` must be the frame's CodeInfo.
+  StackMap GetCurrentStackMap(const CodeInfo& code_info, const StackMapEncoding& encoding) const
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
   // Returns the height of the stack in the managed stack frames, including transitions.
   size_t GetFrameHeight() SHARED_REQUIRES(Locks::mutator_lock_) {
     return GetNumFrames() - cur_depth_ - 1;
@@ -26,6 +26,7 @@ namespace art {
 constexpr size_t DexRegisterLocationCatalog::kNoLocationEntryIndex;
 constexpr uint32_t StackMap::kNoDexRegisterMap;
 constexpr uint32_t StackMap::kNoInlineInfo;
+constexpr size_t CodeInfo::kNoStackMapIndex;
 
 DexRegisterLocation::Kind DexRegisterMap::GetLocationInternalKind(
     uint16_t dex_register_number,
@@ -54,41 +55,18 @@ DexRegisterLocation DexRegisterMap::GetDexRegisterLocation(uint16_t dex_register
   return dex_register_location_catalog.GetDexRegisterLocation(location_catalog_entry_index);
 }
 
-uint32_t StackMap::LoadAt(size_t number_of_bytes, size_t offset, bool check_max) const {
-  if (number_of_bytes == 0u) {
-    DCHECK(!check_max);
-    return 0;
-  } else if (number_of_bytes == 1u) {
-    uint8_t value = region_.LoadUnaligned<uint8_t>(offset);
-    return (check_max && value == 0xFF) ? -1 : value;
-  } else if (number_of_bytes == 2u) {
-    uint16_t value = region_.LoadUnaligned<uint16_t>(offset);
-    return (check_max && value == 0xFFFF) ? -1 : value;
-  } else if (number_of_bytes == 3u) {
-    uint16_t low = region_.LoadUnaligned<uint16_t>(offset);
-    uint16_t high = region_.LoadUnaligned<uint8_t>(offset + sizeof(uint16_t));
-    uint32_t value = (high << 16) + low;
-    return (check_max && value == 0xFFFFFF) ? -1 : value;
-  } else {
-    DCHECK_EQ(number_of_bytes, 4u);
-    return region_.LoadUnaligned<uint32_t>(offset);
+void StackMap::StoreAt(size_t offset, size_t number_of_bits, uint32_t value) const {
+  if (number_of_bits == 0u) {
+    // Only kNoDexRegisterMap and kNoInlineInfo may be encoded without any bit.
+    DCHECK(value == 0u || value == static_cast<uint32_t>(-1)) << value;
+    return;
   }
-}
-
-void StackMap::StoreAt(size_t number_of_bytes, size_t offset, uint32_t value) const {
-  if (number_of_bytes == 0u) {
-    DCHECK_EQ(value, 0u);
-  } else if (number_of_bytes == 1u) {
-    region_.StoreUnaligned<uint8_t>(offset, value);
-  } else if (number_of_bytes == 2u) {
-    region_.StoreUnaligned<uint16_t>(offset, value);
-  } else if (number_of_bytes == 3u) {
-    region_.StoreUnaligned<uint16_t>(offset, Low16Bits(value));
-    region_.StoreUnaligned<uint8_t>(offset + sizeof(uint16_t), High16Bits(value));
-  } else {
-    region_.StoreUnaligned<uint32_t>(offset, value);
-    DCHECK_EQ(number_of_bytes, 4u);
+  if (number_of_bits < StackMapEncoding::kMaxBitsPerField &&
+      value == static_cast<uint32_t>(-1)) {
+    // Encode kNoDexRegisterMap and kNoInlineInfo as the all-ones value of the field.
+    value = MaxInt<uint32_t>(number_of_bits);
   }
+  region_.StoreBits(bit_offset_ + offset, value, number_of_bits);
 }
 
 static void DumpRegisterMapping(std::ostream& os,
@@ -112,12 +90,21 @@ void CodeInfo::Dump(VariableIndentationOutputStream* vios,
       << "Optimized CodeInfo (size=" << code_info_size
       << ", number_of_dex_registers=" << number_of_dex_registers
       << ", number_of_stack_maps=" << number_of_stack_maps
+      << ", number_of_sorted_stack_maps=" << GetNumberOfSortedStackMaps()
+      << ", number_of_catch_stack_maps=" << GetNumberOfCatchStackMaps()
       << ", has_inline_info=" << encoding.HasInlineInfo()
-      << ", number_of_bytes_for_inline_info=" << encoding.NumberOfBytesForInlineInfo()
-      << ", number_of_bytes_for_dex_register_map=" << encoding.NumberOfBytesForDexRegisterMap()
-      << ", number_of_bytes_for_dex_pc=" << encoding.NumberOfBytesForDexPc()
-      << ", number_of_bytes_for_native_pc=" << encoding.NumberOfBytesForNativePc()
-      << ", number_of_bytes_for_register_mask=" << encoding.NumberOfBytesForRegisterMask()
+      << ", number_of_bits_for_native_pc=" << encoding.NumberOfBitsForNativePc()
+      << ", number_of_bits_for_dex_pc=" << encoding.NumberOfBitsForDexPc()
+      << ", number_of_bits_for_dex_register_map=" << encoding.NumberOfBitsForDexRegisterMap()
+      << ", number_of_bits_for_inline_info=" << encoding.NumberOfBitsForInlineInfo()
+      << ", number_of_bits_for_register_mask_index="
+      << encoding.NumberOfBitsForRegisterMaskIndex()
+      << ", number_of_bits_for_stack_mask_index=" << encoding.NumberOfBitsForStackMaskIndex()
+      << ", stack_maps_size_in_bytes=" << GetStackMapsSize(encoding)
+      << ", number_of_register_masks=" << GetNumberOfRegisterMasks()
+      << ", number_of_bits_for_register_mask=" << encoding.NumberOfBitsForRegisterMask()
+      << ", number_of_stack_masks=" << GetNumberOfStackMasks()
+      << ", number_of_bytes_for_stack_mask=" << encoding.NumberOfBytesForStackMask()
       << ")\n";
   ScopedIndentation indent1(vios);
   // Display the Dex register location catalog.
@@ -189,10 +176,10 @@ void StackMap::Dump(VariableIndentationOutputStream* vios,
       << ", native_pc_offset=0x" << GetNativePcOffset(encoding)
       << ", dex_register_map_offset=0x" << GetDexRegisterMapOffset(encoding)
       << ", inline_info_offset=0x" << GetInlineDescriptorOffset(encoding)
-      << ", register_mask=0x" << GetRegisterMask(encoding)
+      << ", register_mask=0x" << code_info.GetRegisterMaskOf(*this, encoding)
       << std::dec
       << ", stack_mask=0b";
-  MemoryRegion stack_mask = GetStackMask(encoding);
+  MemoryRegion stack_mask = code_info.GetStackMaskOf(*this, encoding);
   for (size_t i = 0, e = stack_mask.size_in_bits(); i < e; ++i) {
     vios->Stream() << stack_mask.LoadBit(e - i - 1);
   }
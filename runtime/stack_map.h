@@ -26,9 +26,6 @@ namespace art {
 #define ELEMENT_BYTE_OFFSET_AFTER(PreviousElement) \
   k ## PreviousElement ## Offset + sizeof(PreviousElement ## Type)
 
-#define ELEMENT_BIT_OFFSET_AFTER(PreviousElement) \
-  k ## PreviousElement ## BitOffset + PreviousElement ## BitSize
-
 class VariableIndentationOutputStream;
 
 // Size of a frame slot, in bytes.  This constant is a signed value,
@@ -39,11 +36,6 @@ static constexpr ssize_t kFrameSlotSize = 4;
 // Size of Dex virtual registers.
 static constexpr size_t kVRegSize = 4;
 
-// We encode the number of bytes needed for writing a value on 3 bits
-// (i.e. up to 8 values), for values that we know are maximum 32-bit
-// long.
-static constexpr size_t kNumberOfBitForNumberOfBytesForEncoding = 3;
-
 class CodeInfo;
 class StackMapEncoding;
 
@@ -682,104 +674,118 @@ class StackMapEncoding {
   StackMapEncoding() {}
 
   StackMapEncoding(size_t stack_mask_size,
-                   size_t bytes_for_inline_info,
-                   size_t bytes_for_dex_register_map,
-                   size_t bytes_for_dex_pc,
-                   size_t bytes_for_native_pc,
-                   size_t bytes_for_register_mask)
+                   size_t bits_for_native_pc,
+                   size_t bits_for_dex_pc,
+                   size_t bits_for_dex_register_map,
+                   size_t bits_for_inline_info,
+                   size_t bits_for_register_mask_index,
+                   size_t bits_for_stack_mask_index,
+                   size_t bits_for_register_mask)
       : bytes_for_stack_mask_(stack_mask_size),
-        bytes_for_inline_info_(bytes_for_inline_info),
-        bytes_for_dex_register_map_(bytes_for_dex_register_map),
-        bytes_for_dex_pc_(bytes_for_dex_pc),
-        bytes_for_native_pc_(bytes_for_native_pc),
-        bytes_for_register_mask_(bytes_for_register_mask) {}
+        bits_for_native_pc_(bits_for_native_pc),
+        bits_for_dex_pc_(bits_for_dex_pc),
+        bits_for_dex_register_map_(bits_for_dex_register_map),
+        bits_for_inline_info_(bits_for_inline_info),
+        bits_for_register_mask_index_(bits_for_register_mask_index),
+        bits_for_stack_mask_index_(bits_for_stack_mask_index),
+        bits_for_register_mask_(bits_for_register_mask) {
+    DCHECK_LE(bits_for_native_pc, kMaxBitsPerField);
+    DCHECK_LE(bits_for_dex_pc, kMaxBitsPerField);
+    DCHECK_LE(bits_for_dex_register_map, kMaxBitsPerField);
+    DCHECK_LE(bits_for_inline_info, kMaxBitsPerField);
+    DCHECK_LE(bits_for_register_mask_index, kMaxBitsPerField);
+    DCHECK_LE(bits_for_stack_mask_index, kMaxBitsPerField);
+    DCHECK_LE(bits_for_register_mask, kMaxBitsPerField);
+  }
 
   static StackMapEncoding CreateFromSizes(size_t stack_mask_size,
                                           size_t inline_info_size,
                                           size_t dex_register_map_size,
                                           size_t dex_pc_max,
                                           size_t native_pc_max,
-                                          size_t register_mask_max) {
+                                          size_t register_mask_max,
+                                          size_t number_of_register_masks,
+                                          size_t number_of_stack_masks) {
     return StackMapEncoding(
         stack_mask_size,
-        // + 1 to also encode kNoInlineInfo: if an inline info offset
-        // is at 0xFF, we want to overflow to a larger encoding, because it will
-        // conflict with kNoInlineInfo.
-        // The offset is relative to the dex register map. TODO: Change this.
+        EncodingSizeInBits(native_pc_max),
+        EncodingSizeInBits(dex_pc_max),
+        // The all-ones value of a field encodes kNoDexRegisterMap. Offsets are strictly
+        // smaller than `dex_register_map_size`, so make room for one more value.
+        EncodingSizeInBits(dex_register_map_size),
+        // Likewise for kNoInlineInfo. The offset is relative to the dex register map.
+        // TODO: Change this.
         inline_info_size == 0
-          ? 0
-          : EncodingSizeInBytes(dex_register_map_size + inline_info_size + 1),
-        // + 1 to also encode kNoDexRegisterMap: if a dex register map offset
-        // is at 0xFF, we want to overflow to a larger encoding, because it will
-        // conflict with kNoDexRegisterMap.
-        EncodingSizeInBytes(dex_register_map_size + 1),
-        EncodingSizeInBytes(dex_pc_max),
-        EncodingSizeInBytes(native_pc_max),
-        EncodingSizeInBytes(register_mask_max));
-  }
-
-  // Get the size of one stack map of this CodeInfo object, in bytes.
-  // All stack maps of a CodeInfo have the same size.
-  size_t ComputeStackMapSize() const {
-    return bytes_for_register_mask_
-         + bytes_for_stack_mask_
-         + bytes_for_inline_info_
-         + bytes_for_dex_register_map_
-         + bytes_for_dex_pc_
-         + bytes_for_native_pc_;
-  }
-
-  bool HasInlineInfo() const { return bytes_for_inline_info_ > 0; }
+            ? 0
+            : EncodingSizeInBits(dex_register_map_size + inline_info_size),
+        number_of_register_masks == 0 ? 0 : EncodingSizeInBits(number_of_register_masks - 1),
+        number_of_stack_masks == 0 ? 0 : EncodingSizeInBits(number_of_stack_masks - 1),
+        EncodingSizeInBits(register_mask_max));
+  }
+
+  // Get the size of one stack map of this CodeInfo object, in bits.
+  // All stack maps of a CodeInfo have the same size and are stored
+  // back to back, without padding.
+  size_t ComputeStackMapSizeInBits() const {
+    return GetStackMaskIndexBitOffset() + bits_for_stack_mask_index_;
+  }
+
+  bool HasInlineInfo() const { return bits_for_inline_info_ > 0; }
 
+  // Size of one entry of the (deduplicated) stack mask table.
   size_t NumberOfBytesForStackMask() const { return bytes_for_stack_mask_; }
-  size_t NumberOfBytesForInlineInfo() const { return bytes_for_inline_info_; }
-  size_t NumberOfBytesForDexRegisterMap() const { return bytes_for_dex_register_map_; }
-  size_t NumberOfBytesForDexPc() const { return bytes_for_dex_pc_; }
-  size_t NumberOfBytesForNativePc() const { return bytes_for_native_pc_; }
-  size_t NumberOfBytesForRegisterMask() const { return bytes_for_register_mask_; }
+  size_t NumberOfBitsForNativePc() const { return bits_for_native_pc_; }
+  size_t NumberOfBitsForDexPc() const { return bits_for_dex_pc_; }
+  size_t NumberOfBitsForDexRegisterMap() const { return bits_for_dex_register_map_; }
+  size_t NumberOfBitsForInlineInfo() const { return bits_for_inline_info_; }
+  size_t NumberOfBitsForRegisterMaskIndex() const { return bits_for_register_mask_index_; }
+  size_t NumberOfBitsForStackMaskIndex() const { return bits_for_stack_mask_index_; }
+  // Size of one entry of the (deduplicated) register mask table.
+  size_t NumberOfBitsForRegisterMask() const { return bits_for_register_mask_; }
 
-  size_t ComputeStackMapRegisterMaskOffset() const {
-    return kRegisterMaskOffset;
+  // The native PC offset comes first: it is the field read when searching for a stack map.
+  size_t GetNativePcBitOffset() const {
+    return kNativePcBitOffset;
   }
 
-  size_t ComputeStackMapStackMaskOffset() const {
-    return ComputeStackMapRegisterMaskOffset() + bytes_for_register_mask_;
+  size_t GetDexPcBitOffset() const {
+    return GetNativePcBitOffset() + bits_for_native_pc_;
   }
 
-  size_t ComputeStackMapDexPcOffset() const {
-    return ComputeStackMapStackMaskOffset() + bytes_for_stack_mask_;
+  size_t GetDexRegisterMapBitOffset() const {
+    return GetDexPcBitOffset() + bits_for_dex_pc_;
   }
 
-  size_t ComputeStackMapNativePcOffset() const {
-    return ComputeStackMapDexPcOffset() + bytes_for_dex_pc_;
+  size_t GetInlineInfoBitOffset() const {
+    return GetDexRegisterMapBitOffset() + bits_for_dex_register_map_;
   }
 
-  size_t ComputeStackMapDexRegisterMapOffset() const {
-    return ComputeStackMapNativePcOffset() + bytes_for_native_pc_;
+  size_t GetRegisterMaskIndexBitOffset() const {
+    return GetInlineInfoBitOffset() + bits_for_inline_info_;
   }
 
-  size_t ComputeStackMapInlineInfoOffset() const {
-    return ComputeStackMapDexRegisterMapOffset() + bytes_for_dex_register_map_;
+  size_t GetStackMaskIndexBitOffset() const {
+    return GetRegisterMaskIndexBitOffset() + bits_for_register_mask_index_;
   }
 
+  static constexpr size_t kMaxBitsPerField = BitSizeOf<uint32_t>();
+
  private:
-  static size_t EncodingSizeInBytes(size_t max_element) {
+  static size_t EncodingSizeInBits(size_t max_element) {
     DCHECK(IsUint<32>(max_element));
-    return (max_element == 0) ? 0
-         : IsUint<8>(max_element) ? 1
-         : IsUint<16>(max_element) ? 2
-         : IsUint<24>(max_element) ? 3
-         : 4;
+    return MinimumBitsToStore(static_cast<uint32_t>(max_element));
   }
 
-  static constexpr int kRegisterMaskOffset = 0;
+  static constexpr size_t kNativePcBitOffset = 0;
 
-  size_t bytes_for_stack_mask_;
-  size_t bytes_for_inline_info_;
-  size_t bytes_for_dex_register_map_;
-  size_t bytes_for_dex_pc_;
-  size_t bytes_for_native_pc_;
-  size_t bytes_for_register_mask_;
+  uint32_t bytes_for_stack_mask_;
+  uint8_t bits_for_native_pc_;
+  uint8_t bits_for_dex_pc_;
+  uint8_t bits_for_dex_register_map_;
+  uint8_t bits_for_inline_info_;
+  uint8_t bits_for_register_mask_index_;
+  uint8_t bits_for_stack_mask_index_;
+  uint8_t bits_for_register_mask_;
 };
 
 /**
@@ -792,79 +798,81 @@ class StackMapEncoding {
  *
  * The information is of the form:
  *
- *   [dex_pc, native_pc_offset, dex_register_map_offset, inlining_info_offset, register_mask,
- *   stack_mask].
+ *   [native_pc_offset, dex_pc, dex_register_map_offset, inlining_info_offset,
+ *   register_mask_index, stack_mask_index].
+ *
+ * Each field is stored on the number of bits given by the StackMapEncoding of
+ * the enclosing CodeInfo, and stack maps are packed back to back. Register masks
+ * and stack masks are indices into deduplicated tables of the CodeInfo, see
+ * CodeInfo::GetRegisterMaskOf and CodeInfo::GetStackMaskOf.
  */
 class StackMap {
  public:
-  StackMap() {}
-  explicit StackMap(MemoryRegion region) : region_(region) {}
+  StackMap() : bit_offset_(0) {}
+  StackMap(MemoryRegion region, size_t bit_offset) : region_(region), bit_offset_(bit_offset) {}
 
   bool IsValid() const { return region_.pointer() != nullptr; }
 
   uint32_t GetDexPc(const StackMapEncoding& encoding) const {
-    return LoadAt(encoding.NumberOfBytesForDexPc(), encoding.ComputeStackMapDexPcOffset());
+    return LoadAt(encoding.GetDexPcBitOffset(), encoding.NumberOfBitsForDexPc());
   }
 
   void SetDexPc(const StackMapEncoding& encoding, uint32_t dex_pc) {
-    StoreAt(encoding.NumberOfBytesForDexPc(), encoding.ComputeStackMapDexPcOffset(), dex_pc);
+    StoreAt(encoding.GetDexPcBitOffset(), encoding.NumberOfBitsForDexPc(), dex_pc);
   }
 
   uint32_t GetNativePcOffset(const StackMapEncoding& encoding) const {
-    return LoadAt(encoding.NumberOfBytesForNativePc(), encoding.ComputeStackMapNativePcOffset());
+    return LoadAt(encoding.GetNativePcBitOffset(), encoding.NumberOfBitsForNativePc());
   }
 
   void SetNativePcOffset(const StackMapEncoding& encoding, uint32_t native_pc_offset) {
-    StoreAt(encoding.NumberOfBytesForNativePc(),
-            encoding.ComputeStackMapNativePcOffset(),
-            native_pc_offset);
+    StoreAt(encoding.GetNativePcBitOffset(), encoding.NumberOfBitsForNativePc(), native_pc_offset);
   }
 
   uint32_t GetDexRegisterMapOffset(const StackMapEncoding& encoding) const {
-    return LoadAt(encoding.NumberOfBytesForDexRegisterMap(),
-                  encoding.ComputeStackMapDexRegisterMapOffset(),
+    return LoadAt(encoding.GetDexRegisterMapBitOffset(),
+                  encoding.NumberOfBitsForDexRegisterMap(),
                   /* check_max */ true);
   }
 
   void SetDexRegisterMapOffset(const StackMapEncoding& encoding, uint32_t offset) {
-    StoreAt(encoding.NumberOfBytesForDexRegisterMap(),
-            encoding.ComputeStackMapDexRegisterMapOffset(),
+    StoreAt(encoding.GetDexRegisterMapBitOffset(),
+            encoding.NumberOfBitsForDexRegisterMap(),
             offset);
   }
 
   uint32_t GetInlineDescriptorOffset(const StackMapEncoding& encoding) const {
     if (!encoding.HasInlineInfo()) return kNoInlineInfo;
-    return LoadAt(encoding.NumberOfBytesForInlineInfo(),
-                  encoding.ComputeStackMapInlineInfoOffset(),
+    return LoadAt(encoding.GetInlineInfoBitOffset(),
+                  encoding.NumberOfBitsForInlineInfo(),
                   /* check_max */ true);
   }
 
   void SetInlineDescriptorOffset(const StackMapEncoding& encoding, uint32_t offset) {
     DCHECK(encoding.HasInlineInfo());
-    StoreAt(encoding.NumberOfBytesForInlineInfo(),
-            encoding.ComputeStackMapInlineInfoOffset(),
-            offset);
+    StoreAt(encoding.GetInlineInfoBitOffset(), encoding.NumberOfBitsForInlineInfo(), offset);
   }
 
-  uint32_t GetRegisterMask(const StackMapEncoding& encoding) const {
-    return LoadAt(encoding.NumberOfBytesForRegisterMask(),
-                  encoding.ComputeStackMapRegisterMaskOffset());
+  uint32_t GetRegisterMaskIndex(const StackMapEncoding& encoding) const {
+    return LoadAt(encoding.GetRegisterMaskIndexBitOffset(),
+                  encoding.NumberOfBitsForRegisterMaskIndex());
   }
 
-  void SetRegisterMask(const StackMapEncoding& encoding, uint32_t mask) {
-    StoreAt(encoding.NumberOfBytesForRegisterMask(),
-            encoding.ComputeStackMapRegisterMaskOffset(),
-            mask);
+  void SetRegisterMaskIndex(const StackMapEncoding& encoding, uint32_t index) {
+    StoreAt(encoding.GetRegisterMaskIndexBitOffset(),
+            encoding.NumberOfBitsForRegisterMaskIndex(),
+            index);
   }
 
-  MemoryRegion GetStackMask(const StackMapEncoding& encoding) const {
-    return region_.Subregion(encoding.ComputeStackMapStackMaskOffset(),
-                             encoding.NumberOfBytesForStackMask());
+  uint32_t GetStackMaskIndex(const StackMapEncoding& encoding) const {
+    return LoadAt(encoding.GetStackMaskIndexBitOffset(),
+                  encoding.NumberOfBitsForStackMaskIndex());
   }
 
-  void SetStackMask(const StackMapEncoding& encoding, const BitVector& sp_map) {
-    MemoryRegion region = GetStackMask(encoding);
-    sp_map.CopyTo(region.start(), region.size());
+  void SetStackMaskIndex(const StackMapEncoding& encoding, uint32_t index) {
+    StoreAt(encoding.GetStackMaskIndexBitOffset(),
+            encoding.NumberOfBitsForStackMaskIndex(),
+            index);
   }
 
   bool HasDexRegisterMap(const StackMapEncoding& encoding) const {
@@ -877,7 +885,7 @@ class StackMap {
 
   bool Equals(const StackMap& other) const {
     return region_.pointer() == other.region_.pointer()
-       && region_.size() == other.region_.size();
+       && bit_offset_ == other.bit_offset_;
   }
 
   void Dump(VariableIndentationOutputStream* vios,
@@ -896,14 +904,24 @@ class StackMap {
   static constexpr uint32_t kNoInlineInfo = -1;
 
  private:
-  static constexpr int kFixedSize = 0;
+  // Loads `number_of_bits` at the given bit `offset` of this stack map. If `check_max` is
+  // true, this method converts the all-ones value of size `number_of_bits` into 0xFFFFFFFF.
+  ALWAYS_INLINE uint32_t LoadAt(size_t offset, size_t number_of_bits, bool check_max = false)
+      const {
+    uint32_t value = region_.LoadBits(bit_offset_ + offset, number_of_bits);
+    if (check_max &&
+        (number_of_bits == 0u || value == MaxInt<uint32_t>(number_of_bits))) {
+      return -1;
+    }
+    return value;
+  }
 
-  // Loads `number_of_bytes` at the given `offset` and assemble a uint32_t. If `check_max` is true,
-  // this method converts a maximum value of size `number_of_bytes` into a uint32_t 0xFFFFFFFF.
-  uint32_t LoadAt(size_t number_of_bytes, size_t offset, bool check_max = false) const;
-  void StoreAt(size_t number_of_bytes, size_t offset, uint32_t value) const;
+  void StoreAt(size_t offset, size_t number_of_bits, uint32_t value) const;
 
+  // The region of all the stack maps of the CodeInfo, and the bit offset of this
+  // stack map within it.
   MemoryRegion region_;
+  size_t bit_offset_;
 
   friend class StackMapStream;
 };
@@ -1010,30 +1028,42 @@ class InlineInfo {
  * Wrapper around all compiler information collected for a method.
  * The information is of the form:
  *
- *   [overall_size, encoding_info, number_of_location_catalog_entries, number_of_stack_maps,
- *   stack_mask_size, DexRegisterLocationCatalog+, StackMap+, DexRegisterMap+, InlineInfo*]
+ *   [overall_size, number_of_stack_maps, number_of_sorted_stack_maps,
+ *   number_of_catch_stack_maps, number_of_location_catalog_entries, number_of_register_masks,
+ *   number_of_stack_masks, stack_mask_size, encoding_info,
+ *   StackMap+, RegisterMask*, StackMask*, DexRegisterLocationCatalog+, DexRegisterMap+,
+ *   InlineInfo*]
  *
- * where `encoding_info` is of the form:
+ * where `encoding_info` holds the number of bits used by each column of the
+ * stack map table, and by the entries of the register mask table:
  *
- *  [has_inline_info, inline_info_size_in_bytes, dex_register_map_size_in_bytes,
- *  dex_pc_size_in_bytes, native_pc_size_in_bytes, register_mask_size_in_bytes].
+ *  [native_pc_bits, dex_pc_bits, dex_register_map_bits, inline_info_bits,
+ *  register_mask_index_bits, stack_mask_index_bits, register_mask_bits].
+ *
+ * Stack maps and register masks are bit-packed. Stack masks are stored on
+ * `stack_mask_size` bytes each. The register mask and stack mask tables only
+ * hold distinct values, which stack maps refer to by index.
  */
 class CodeInfo {
  public:
   // Memory layout: fixed contents.
   typedef uint32_t OverallSizeType;
-  typedef uint16_t EncodingInfoType;
-  typedef uint32_t NumberOfLocationCatalogEntriesType;
   typedef uint32_t NumberOfStackMapsType;
+  typedef uint32_t NumberOfSortedStackMapsType;
+  typedef uint32_t NumberOfCatchStackMapsType;
+  typedef uint32_t NumberOfLocationCatalogEntriesType;
+  typedef uint32_t NumberOfRegisterMasksType;
+  typedef uint32_t NumberOfStackMasksType;
   typedef uint32_t StackMaskSizeType;
 
-  // Memory (bit) layout: encoding info.
-  static constexpr int HasInlineInfoBitSize = 1;
-  static constexpr int InlineInfoBitSize = kNumberOfBitForNumberOfBytesForEncoding;
-  static constexpr int DexRegisterMapBitSize = kNumberOfBitForNumberOfBytesForEncoding;
-  static constexpr int DexPcBitSize = kNumberOfBitForNumberOfBytesForEncoding;
-  static constexpr int NativePcBitSize = kNumberOfBitForNumberOfBytesForEncoding;
-  static constexpr int RegisterMaskBitSize = kNumberOfBitForNumberOfBytesForEncoding;
+  // Memory layout: encoding info, one bit count per field.
+  typedef uint8_t NativePcBitsType;
+  typedef uint8_t DexPcBitsType;
+  typedef uint8_t DexRegisterMapBitsType;
+  typedef uint8_t InlineInfoBitsType;
+  typedef uint8_t RegisterMaskIndexBitsType;
+  typedef uint8_t StackMaskIndexBitsType;
+  typedef uint8_t RegisterMaskBitsType;
 
   explicit CodeInfo(MemoryRegion region) : region_(region) {}
 
@@ -1043,34 +1073,37 @@ class CodeInfo {
   }
 
   StackMapEncoding ExtractEncoding() const {
-    return StackMapEncoding(region_.LoadUnaligned<uint32_t>(kStackMaskSizeOffset),
-                            GetNumberOfBytesForEncoding(kInlineInfoBitOffset),
-                            GetNumberOfBytesForEncoding(kDexRegisterMapBitOffset),
-                            GetNumberOfBytesForEncoding(kDexPcBitOffset),
-                            GetNumberOfBytesForEncoding(kNativePcBitOffset),
-                            GetNumberOfBytesForEncoding(kRegisterMaskBitOffset));
+    return StackMapEncoding(
+        region_.LoadUnaligned<StackMaskSizeType>(kStackMaskSizeOffset),
+        region_.LoadUnaligned<NativePcBitsType>(kNativePcBitsOffset),
+        region_.LoadUnaligned<DexPcBitsType>(kDexPcBitsOffset),
+        region_.LoadUnaligned<DexRegisterMapBitsType>(kDexRegisterMapBitsOffset),
+        region_.LoadUnaligned<InlineInfoBitsType>(kInlineInfoBitsOffset),
+        region_.LoadUnaligned<RegisterMaskIndexBitsType>(kRegisterMaskIndexBitsOffset),
+        region_.LoadUnaligned<StackMaskIndexBitsType>(kStackMaskIndexBitsOffset),
+        region_.LoadUnaligned<RegisterMaskBitsType>(kRegisterMaskBitsOffset));
   }
 
   void SetEncoding(const StackMapEncoding& encoding) {
-    region_.StoreUnaligned<uint32_t>(kStackMaskSizeOffset, encoding.NumberOfBytesForStackMask());
-    region_.StoreBit(kHasInlineInfoBitOffset, encoding.NumberOfBytesForInlineInfo() != 0);
-    SetEncodingAt(kInlineInfoBitOffset, encoding.NumberOfBytesForInlineInfo());
-    SetEncodingAt(kDexRegisterMapBitOffset, encoding.NumberOfBytesForDexRegisterMap());
-    SetEncodingAt(kDexPcBitOffset, encoding.NumberOfBytesForDexPc());
-    SetEncodingAt(kNativePcBitOffset, encoding.NumberOfBytesForNativePc());
-    SetEncodingAt(kRegisterMaskBitOffset, encoding.NumberOfBytesForRegisterMask());
-  }
-
-  void SetEncodingAt(size_t bit_offset, size_t number_of_bytes) {
-    region_.StoreBits(bit_offset, number_of_bytes, kNumberOfBitForNumberOfBytesForEncoding);
-  }
-
-  size_t GetNumberOfBytesForEncoding(size_t bit_offset) const {
-    return region_.LoadBits(bit_offset, kNumberOfBitForNumberOfBytesForEncoding);
+    region_.StoreUnaligned<StackMaskSizeType>(kStackMaskSizeOffset,
+                                              encoding.NumberOfBytesForStackMask());
+    region_.StoreUnaligned<NativePcBitsType>(kNativePcBitsOffset,
+                                             encoding.NumberOfBitsForNativePc());
+    region_.StoreUnaligned<DexPcBitsType>(kDexPcBitsOffset, encoding.NumberOfBitsForDexPc());
+    region_.StoreUnaligned<DexRegisterMapBitsType>(kDexRegisterMapBitsOffset,
+                                                   encoding.NumberOfBitsForDexRegisterMap());
+    region_.StoreUnaligned<InlineInfoBitsType>(kInlineInfoBitsOffset,
+                                               encoding.NumberOfBitsForInlineInfo());
+    region_.StoreUnaligned<RegisterMaskIndexBitsType>(
+        kRegisterMaskIndexBitsOffset, encoding.NumberOfBitsForRegisterMaskIndex());
+    region_.StoreUnaligned<StackMaskIndexBitsType>(kStackMaskIndexBitsOffset,
+                                                   encoding.NumberOfBitsForStackMaskIndex());
+    region_.StoreUnaligned<RegisterMaskBitsType>(kRegisterMaskBitsOffset,
+                                                 encoding.NumberOfBitsForRegisterMask());
   }
 
   bool HasInlineInfo() const {
-    return region_.LoadBit(kHasInlineInfoBitOffset);
+    return region_.LoadUnaligned<InlineInfoBitsType>(kInlineInfoBitsOffset) != 0;
   }
 
   DexRegisterLocationCatalog GetDexRegisterLocationCatalog(const StackMapEncoding& encoding) const {
@@ -1080,8 +1113,7 @@ class CodeInfo {
   }
 
   StackMap GetStackMapAt(size_t i, const StackMapEncoding& encoding) const {
-    size_t stack_map_size = encoding.ComputeStackMapSize();
-    return StackMap(GetStackMaps(encoding).Subregion(i * stack_map_size, stack_map_size));
+    return StackMap(GetStackMaps(encoding), i * encoding.ComputeStackMapSizeInBits());
   }
 
   OverallSizeType GetOverallSize() const {
@@ -1115,22 +1147,106 @@ class CodeInfo {
     region_.StoreUnaligned<NumberOfStackMapsType>(kNumberOfStackMapsOffset, number_of_stack_maps);
   }
 
+  // Number of leading stack maps sorted by native pc offset.
+  NumberOfSortedStackMapsType GetNumberOfSortedStackMaps() const {
+    return region_.LoadUnaligned<NumberOfSortedStackMapsType>(kNumberOfSortedStackMapsOffset);
+  }
+
+  void SetNumberOfSortedStackMaps(NumberOfSortedStackMapsType number_of_sorted_stack_maps) {
+    region_.StoreUnaligned<NumberOfSortedStackMapsType>(kNumberOfSortedStackMapsOffset,
+                                                        number_of_sorted_stack_maps);
+  }
+
+  // Number of trailing stack maps that are catch block entries, sorted by dex pc.
+  NumberOfCatchStackMapsType GetNumberOfCatchStackMaps() const {
+    return region_.LoadUnaligned<NumberOfCatchStackMapsType>(kNumberOfCatchStackMapsOffset);
+  }
+
+  void SetNumberOfCatchStackMaps(NumberOfCatchStackMapsType number_of_catch_stack_maps) {
+    region_.StoreUnaligned<NumberOfCatchStackMapsType>(kNumberOfCatchStackMapsOffset,
+                                                       number_of_catch_stack_maps);
+  }
+
+  NumberOfRegisterMasksType GetNumberOfRegisterMasks() const {
+    return region_.LoadUnaligned<NumberOfRegisterMasksType>(kNumberOfRegisterMasksOffset);
+  }
+
+  void SetNumberOfRegisterMasks(NumberOfRegisterMasksType number_of_register_masks) {
+    region_.StoreUnaligned<NumberOfRegisterMasksType>(kNumberOfRegisterMasksOffset,
+                                                      number_of_register_masks);
+  }
+
+  NumberOfStackMasksType GetNumberOfStackMasks() const {
+    return region_.LoadUnaligned<NumberOfStackMasksType>(kNumberOfStackMasksOffset);
+  }
+
+  void SetNumberOfStackMasks(NumberOfStackMasksType number_of_stack_masks) {
+    region_.StoreUnaligned<NumberOfStackMasksType>(kNumberOfStackMasksOffset,
+                                                   number_of_stack_masks);
+  }
+
   // Get the size of all the stack maps of this CodeInfo object, in bytes.
   size_t GetStackMapsSize(const StackMapEncoding& encoding) const {
-    return encoding.ComputeStackMapSize() * GetNumberOfStackMaps();
+    return BitsToBytes(encoding.ComputeStackMapSizeInBits() * GetNumberOfStackMaps());
   }
 
-  uint32_t GetDexRegisterLocationCatalogOffset(const StackMapEncoding& encoding) const {
+  // Get the size of the register mask table of this CodeInfo object, in bytes.
+  size_t GetRegisterMasksSize(const StackMapEncoding& encoding) const {
+    return BitsToBytes(encoding.NumberOfBitsForRegisterMask() * GetNumberOfRegisterMasks());
+  }
+
+  // Get the size of the stack mask table of this CodeInfo object, in bytes.
+  size_t GetStackMasksSize(const StackMapEncoding& encoding) const {
+    return encoding.NumberOfBytesForStackMask() * GetNumberOfStackMasks();
+  }
+
+  uint32_t GetStackMapsOffset() const {
+    return kFixedSize;
+  }
+
+  size_t GetRegisterMasksOffset(const StackMapEncoding& encoding) const {
     return GetStackMapsOffset() + GetStackMapsSize(encoding);
   }
 
+  size_t GetStackMasksOffset(const StackMapEncoding& encoding) const {
+    return GetRegisterMasksOffset(encoding) + GetRegisterMasksSize(encoding);
+  }
+
+  uint32_t GetDexRegisterLocationCatalogOffset(const StackMapEncoding& encoding) const {
+    return GetStackMasksOffset(encoding) + GetStackMasksSize(encoding);
+  }
+
   size_t GetDexRegisterMapsOffset(const StackMapEncoding& encoding) const {
     return GetDexRegisterLocationCatalogOffset(encoding)
          + GetDexRegisterLocationCatalogSize(encoding);
   }
 
-  uint32_t GetStackMapsOffset() const {
-    return kFixedSize;
+  uint32_t GetRegisterMaskAt(size_t index, const StackMapEncoding& encoding) const {
+    size_t number_of_bits = encoding.NumberOfBitsForRegisterMask();
+    return region_.LoadBits(
+        GetRegisterMasksOffset(encoding) * kBitsPerByte + index * number_of_bits,
+        number_of_bits);
+  }
+
+  void SetRegisterMaskAt(size_t index, const StackMapEncoding& encoding, uint32_t mask) {
+    size_t number_of_bits = encoding.NumberOfBitsForRegisterMask();
+    region_.StoreBits(GetRegisterMasksOffset(encoding) * kBitsPerByte + index * number_of_bits,
+                      mask,
+                      number_of_bits);
+  }
+
+  MemoryRegion GetStackMaskAt(size_t index, const StackMapEncoding& encoding) const {
+    size_t stack_mask_size = encoding.NumberOfBytesForStackMask();
+    return region_.Subregion(GetStackMasksOffset(encoding) + index * stack_mask_size,
+                             stack_mask_size);
+  }
+
+  uint32_t GetRegisterMaskOf(StackMap stack_map, const StackMapEncoding& encoding) const {
+    return GetRegisterMaskAt(stack_map.GetRegisterMaskIndex(encoding), encoding);
+  }
+
+  MemoryRegion GetStackMaskOf(StackMap stack_map, const StackMapEncoding& encoding) const {
+    return GetStackMaskAt(stack_map.GetStackMaskIndex(encoding), encoding);
   }
 
   DexRegisterMap GetDexRegisterMapOf(StackMap stack_map,
@@ -1174,11 +1290,20 @@ class CodeInfo {
     return StackMap();
   }
 
-  // Searches the stack map list backwards because catch stack maps are stored
-  // at the end.
+  // Binary searches the catch stack maps, which are stored at the end and sorted by dex pc.
   StackMap GetCatchStackMapForDexPc(uint32_t dex_pc, const StackMapEncoding& encoding) const {
-    for (size_t i = GetNumberOfStackMaps(); i > 0; --i) {
-      StackMap stack_map = GetStackMapAt(i - 1, encoding);
+    size_t low = GetNumberOfStackMaps() - GetNumberOfCatchStackMaps();
+    size_t high = GetNumberOfStackMaps();
+    while (low < high) {
+      size_t mid = low + (high - low) / 2;
+      if (GetStackMapAt(mid, encoding).GetDexPc(encoding) < dex_pc) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    if (low < GetNumberOfStackMaps()) {
+      StackMap stack_map = GetStackMapAt(low, encoding);
       if (stack_map.GetDexPc(encoding) == dex_pc) {
         return stack_map;
       }
@@ -1188,18 +1313,65 @@ class CodeInfo {
 
   StackMap GetStackMapForNativePcOffset(uint32_t native_pc_offset,
                                         const StackMapEncoding& encoding) const {
-    // TODO: Safepoint stack maps are sorted by native_pc_offset but catch stack
-    //       maps are not. If we knew that the method does not have try/catch,
-    //       we could do binary search.
-    for (size_t i = 0, e = GetNumberOfStackMaps(); i < e; ++i) {
-      StackMap stack_map = GetStackMapAt(i, encoding);
-      if (stack_map.GetNativePcOffset(encoding) == native_pc_offset) {
-        return stack_map;
+    size_t index = FindStackMapIndexForNativePcOffset(native_pc_offset, encoding);
+    return (index == kNoStackMapIndex) ? StackMap() : GetStackMapAt(index, encoding);
+  }
+
+  // Return the index of the first stack map at `native_pc_offset`, or kNoStackMapIndex.
+  // The sorted stack maps (safepoints) are binary searched. The remaining ones (catch
+  // block entries, which are emitted last) are searched linearly.
+  size_t FindStackMapIndexForNativePcOffset(uint32_t native_pc_offset,
+                                            const StackMapEncoding& encoding) const {
+    MemoryRegion stack_maps = GetStackMaps(encoding);
+    size_t stack_map_size_in_bits = encoding.ComputeStackMapSizeInBits();
+    auto native_pc_offset_at = [&](size_t i) {
+      return StackMap(stack_maps, i * stack_map_size_in_bits).GetNativePcOffset(encoding);
+    };
+    size_t low = 0;
+    size_t high = GetNumberOfSortedStackMaps();
+    while (low < high) {
+      size_t mid = low + (high - low) / 2;
+      if (native_pc_offset_at(mid) < native_pc_offset) {
+        low = mid + 1;
+      } else {
+        high = mid;
       }
     }
-    return StackMap();
+    size_t number_of_sorted_stack_maps = GetNumberOfSortedStackMaps();
+    if (low < number_of_sorted_stack_maps && native_pc_offset_at(low) == native_pc_offset) {
+      return low;
+    }
+    for (size_t i = number_of_sorted_stack_maps, e = GetNumberOfStackMaps(); i < e; ++i) {
+      if (native_pc_offset_at(i) == native_pc_offset) {
+        return i;
+      }
+    }
+    return kNoStackMapIndex;
   }
 
+  // Return whether FindStackMapIndexForNativePcOffset(native_pc_offset, encoding) would
+  // return `index`, which must be the index of a sorted stack map. This is cheaper than
+  // the search and used to validate cached lookups.
+  bool IsSortedStackMapIndexForNativePcOffset(size_t index,
+                                              uint32_t native_pc_offset,
+                                              const StackMapEncoding& encoding) const {
+    if (index >= GetNumberOfSortedStackMaps()) {
+      return false;
+    }
+    MemoryRegion stack_maps = GetStackMaps(encoding);
+    size_t stack_map_size_in_bits = encoding.ComputeStackMapSizeInBits();
+    if (StackMap(stack_maps, index * stack_map_size_in_bits).GetNativePcOffset(encoding) !=
+        native_pc_offset) {
+      return false;
+    }
+    // Stack maps may share a native pc offset. The search returns the first one.
+    return index == 0 ||
+        StackMap(stack_maps, (index - 1) * stack_map_size_in_bits).GetNativePcOffset(encoding) !=
+            native_pc_offset;
+  }
+
+  static constexpr size_t kNoStackMapIndex = static_cast<size_t>(-1);
+
   // Dump this CodeInfo object on `os`.  `code_offset` is the (absolute)
   // native PC of the compiled method and `number_of_dex_registers` the
   // number of Dex virtual registers used in this method.  If
@@ -1212,27 +1384,31 @@ class CodeInfo {
 
  private:
   static constexpr int kOverallSizeOffset = 0;
-  static constexpr int kEncodingInfoOffset = ELEMENT_BYTE_OFFSET_AFTER(OverallSize);
+  static constexpr int kNumberOfStackMapsOffset = ELEMENT_BYTE_OFFSET_AFTER(OverallSize);
+  static constexpr int kNumberOfSortedStackMapsOffset =
+      ELEMENT_BYTE_OFFSET_AFTER(NumberOfStackMaps);
+  static constexpr int kNumberOfCatchStackMapsOffset =
+      ELEMENT_BYTE_OFFSET_AFTER(NumberOfSortedStackMaps);
   static constexpr int kNumberOfLocationCatalogEntriesOffset =
-      ELEMENT_BYTE_OFFSET_AFTER(EncodingInfo);
-  static constexpr int kNumberOfStackMapsOffset =
+      ELEMENT_BYTE_OFFSET_AFTER(NumberOfCatchStackMaps);
+  static constexpr int kNumberOfRegisterMasksOffset =
       ELEMENT_BYTE_OFFSET_AFTER(NumberOfLocationCatalogEntries);
-  static constexpr int kStackMaskSizeOffset = ELEMENT_BYTE_OFFSET_AFTER(NumberOfStackMaps);
-  static constexpr int kFixedSize = ELEMENT_BYTE_OFFSET_AFTER(StackMaskSize);
+  static constexpr int kNumberOfStackMasksOffset = ELEMENT_BYTE_OFFSET_AFTER(NumberOfRegisterMasks);
+  static constexpr int kStackMaskSizeOffset = ELEMENT_BYTE_OFFSET_AFTER(NumberOfStackMasks);
 
-  static constexpr int kHasInlineInfoBitOffset = kEncodingInfoOffset * kBitsPerByte;
-  static constexpr int kInlineInfoBitOffset = ELEMENT_BIT_OFFSET_AFTER(HasInlineInfo);
-  static constexpr int kDexRegisterMapBitOffset = ELEMENT_BIT_OFFSET_AFTER(InlineInfo);
-  static constexpr int kDexPcBitOffset = ELEMENT_BIT_OFFSET_AFTER(DexRegisterMap);
-  static constexpr int kNativePcBitOffset = ELEMENT_BIT_OFFSET_AFTER(DexPc);
-  static constexpr int kRegisterMaskBitOffset = ELEMENT_BIT_OFFSET_AFTER(NativePc);
+  static constexpr int kNativePcBitsOffset = ELEMENT_BYTE_OFFSET_AFTER(StackMaskSize);
+  static constexpr int kDexPcBitsOffset = ELEMENT_BYTE_OFFSET_AFTER(NativePcBits);
+  static constexpr int kDexRegisterMapBitsOffset = ELEMENT_BYTE_OFFSET_AFTER(DexPcBits);
+  static constexpr int kInlineInfoBitsOffset = ELEMENT_BYTE_OFFSET_AFTER(DexRegisterMapBits);
+  static constexpr int kRegisterMaskIndexBitsOffset = ELEMENT_BYTE_OFFSET_AFTER(InlineInfoBits);
+  static constexpr int kStackMaskIndexBitsOffset =
+      ELEMENT_BYTE_OFFSET_AFTER(RegisterMaskIndexBits);
+  static constexpr int kRegisterMaskBitsOffset = ELEMENT_BYTE_OFFSET_AFTER(StackMaskIndexBits);
+  static constexpr int kFixedSize = ELEMENT_BYTE_OFFSET_AFTER(RegisterMaskBits);
 
-  static constexpr int kEncodingInfoPastTheEndBitOffset = ELEMENT_BIT_OFFSET_AFTER(RegisterMask);
-  static constexpr int kEncodingInfoOverallBitSize =
-      kEncodingInfoPastTheEndBitOffset - kHasInlineInfoBitOffset;
-
-  static_assert(kEncodingInfoOverallBitSize <= (sizeof(EncodingInfoType) * kBitsPerByte),
-                "art::CodeInfo::EncodingInfoType is too short to hold all encoding info elements.");
+  static size_t BitsToBytes(size_t number_of_bits) {
+    return RoundUp(number_of_bits, kBitsPerByte) / kBitsPerByte;
+  }
 
   MemoryRegion GetStackMaps(const StackMapEncoding& encoding) const {
     return region_.size() == 0
@@ -1298,7 +1474,6 @@ class CodeInfo {
 };
 
 #undef ELEMENT_BYTE_OFFSET_AFTER
-#undef ELEMENT_BIT_OFFSET_AFTER
 
 }  // namespace art
 
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_STACK_MAP_CACHE_H_
+#define ART_RUNTIME_STACK_MAP_CACHE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include "base/macros.h"
+#include "stack_map.h"
+
+namespace art {
+
+// A small direct-mapped cache of the stack maps found for return addresses of optimized code,
+// keyed by the absolute return pc. Stack walks for GC root visiting, exception delivery and
+// sampling keep hitting the same few call sites, and each miss costs a binary search over the
+// stack maps of the method.
+//
+// Each thread owns one cache, so no synchronization is needed. Entries only hold the index of
+// the stack map and are revalidated against the CodeInfo of the frame on every hit, so an entry
+// left over from code that has since been freed and replaced can never be returned.
+class StackMapCache {
+ public:
+  StackMapCache() {
+    Clear();
+  }
+
+  void Clear() {
+    memset(entries_, 0, sizeof(entries_));
+  }
+
+  // Returns the stack map of `code_info` at `native_pc_offset`, where `pc` is the absolute
+  // address corresponding to `native_pc_offset`.
+  StackMap Lookup(uintptr_t pc,
+                  uint32_t native_pc_offset,
+                  const CodeInfo& code_info,
+                  const StackMapEncoding& encoding) {
+    Entry& entry = entries_[IndexOf(pc)];
+    if (entry.pc == pc &&
+        code_info.IsSortedStackMapIndexForNativePcOffset(entry.index, native_pc_offset, encoding)) {
+      return code_info.GetStackMapAt(entry.index, encoding);
+    }
+    size_t index = code_info.FindStackMapIndexForNativePcOffset(native_pc_offset, encoding);
+    if (index == CodeInfo::kNoStackMapIndex) {
+      return StackMap();
+    }
+    // Only the sorted stack maps can be revalidated cheaply.
+    if (index < code_info.GetNumberOfSortedStackMaps()) {
+      entry.pc = pc;
+      entry.index = index;
+    }
+    return code_info.GetStackMapAt(index, encoding);
+  }
+
+ private:
+  // Must be a power of two.
+  static constexpr size_t kSize = 64;
+
+  struct Entry {
+    uintptr_t pc;
+    size_t index;
+  };
+
+  static size_t IndexOf(uintptr_t pc) {
+    // Return addresses are at least 2-byte aligned.
+    return (pc >> 1) & (kSize - 1);
+  }
+
+  Entry entries_[kSize];
+
+  DISALLOW_COPY_AND_ASSIGN(StackMapCache);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_STACK_MAP_CACHE_H_
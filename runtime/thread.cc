@@ -1978,130 +1978,84 @@ class CountStackDepthVisitor : public StackVisitor {
   DISALLOW_COPY_AND_ASSIGN(CountStackDepthVisitor);
 };
 
-template<bool kTransactionActive>
-class BuildInternalStackTraceVisitor : public StackVisitor {
+// Collects the methods and dex pcs of the frames of a stack trace in a single walk, skipping
+// the frames up to and including the exception's constructor.
+class CollectStackTraceVisitor : public StackVisitor {
  public:
-  BuildInternalStackTraceVisitor(Thread* self, Thread* thread, int skip_depth)
+  explicit CollectStackTraceVisitor(Thread* thread)
+      SHARED_REQUIRES(Locks::mutator_lock_)
       : StackVisitor(thread, nullptr, StackVisitor::StackWalkKind::kIncludeInlinedFrames),
-        self_(self),
-        skip_depth_(skip_depth),
-        count_(0),
-        trace_(nullptr),
-        pointer_size_(Runtime::Current()->GetClassLinker()->GetImagePointerSize()) {}
-
-  bool Init(int depth) SHARED_REQUIRES(Locks::mutator_lock_) ACQUIRE(Roles::uninterruptible_) {
-    // Allocate method trace as an object array where the first element is a pointer array that
-    // contains the ArtMethod pointers and dex PCs. The rest of the elements are the declaring
-    // class of the ArtMethod pointers.
-    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
-    StackHandleScope<1> hs(self_);
-    mirror::Class* array_class = class_linker->GetClassRoot(ClassLinker::kObjectArrayClass);
-    // The first element is the methods and dex pc array, the other elements are declaring classes
-    // for the methods to ensure classes in the stack trace don't get unloaded.
-    Handle<mirror::ObjectArray<mirror::Object>> trace(
-        hs.NewHandle(
-            mirror::ObjectArray<mirror::Object>::Alloc(hs.Self(), array_class, depth + 1)));
-    if (trace.Get() == nullptr) {
-      // Acquire uninterruptible_ in all paths.
-      self_->StartAssertNoThreadSuspension("Building internal stack trace");
-      self_->AssertPendingOOMException();
-      return false;
-    }
-    mirror::PointerArray* methods_and_pcs = class_linker->AllocPointerArray(self_, depth * 2);
-    const char* last_no_suspend_cause =
-        self_->StartAssertNoThreadSuspension("Building internal stack trace");
-    if (methods_and_pcs == nullptr) {
-      self_->AssertPendingOOMException();
-      return false;
-    }
-    trace->Set(0, methods_and_pcs);
-    trace_ = trace.Get();
-    // If We are called from native, use non-transactional mode.
-    CHECK(last_no_suspend_cause == nullptr) << last_no_suspend_cause;
-    return true;
-  }
-
-  virtual ~BuildInternalStackTraceVisitor() RELEASE(Roles::uninterruptible_) {
-    self_->EndAssertNoThreadSuspension(nullptr);
-  }
+        skipping_(true) {}
 
   bool VisitFrame() SHARED_REQUIRES(Locks::mutator_lock_) {
-    if (trace_ == nullptr) {
-      return true;  // We're probably trying to fillInStackTrace for an OutOfMemoryError.
-    }
-    if (skip_depth_ > 0) {
-      skip_depth_--;
-      return true;
-    }
     ArtMethod* m = GetMethod();
     if (m->IsRuntimeMethod()) {
       return true;  // Ignore runtime frames (in particular callee save).
     }
-    mirror::PointerArray* trace_methods_and_pcs = GetTraceMethodsAndPCs();
-    trace_methods_and_pcs->SetElementPtrSize<kTransactionActive>(count_, m, pointer_size_);
-    trace_methods_and_pcs->SetElementPtrSize<kTransactionActive>(
-        trace_methods_and_pcs->GetLength() / 2 + count_,
-        m->IsProxyMethod() ? DexFile::kDexNoIndex : GetDexPc(),
-        pointer_size_);
-    // Save the declaring class of the method to ensure that the declaring classes of the methods
-    // do not get unloaded while the stack trace is live.
-    trace_->Set(count_ + 1, m->GetDeclaringClass());
-    ++count_;
+    if (skipping_ &&
+        !mirror::Throwable::GetJavaLangThrowable()->IsAssignableFrom(m->GetDeclaringClass())) {
+      skipping_ = false;
+    }
+    if (!skipping_) {
+      frames_.push_back(std::make_pair(m, m->IsProxyMethod() ? DexFile::kDexNoIndex : GetDexPc()));
+    }
     return true;
   }
 
-  mirror::PointerArray* GetTraceMethodsAndPCs() const SHARED_REQUIRES(Locks::mutator_lock_) {
-    return down_cast<mirror::PointerArray*>(trace_->Get(0));
-  }
-
-  mirror::ObjectArray<mirror::Object>* GetInternalStackTrace() const {
-    return trace_;
+  const std::vector<std::pair<ArtMethod*, uint32_t>>& GetFrames() const {
+    return frames_;
   }
 
  private:
-  Thread* const self_;
-  // How many more frames to skip.
-  int32_t skip_depth_;
-  // Current position down stack trace.
-  uint32_t count_;
-  // An object array where the first element is a pointer array that contains the ArtMethod
-  // pointers on the stack and dex PCs. The rest of the elements are the declaring
-  // class of the ArtMethod pointers. trace_[i+1] contains the declaring class of the ArtMethod of
-  // the i'th frame.
-  mirror::ObjectArray<mirror::Object>* trace_;
-  // For cross compilation.
-  const size_t pointer_size_;
-
-  DISALLOW_COPY_AND_ASSIGN(BuildInternalStackTraceVisitor);
+  bool skipping_;
+  std::vector<std::pair<ArtMethod*, uint32_t>> frames_;
+
+  DISALLOW_COPY_AND_ASSIGN(CollectStackTraceVisitor);
 };
 
 template<bool kTransactionActive>
 jobject Thread::CreateInternalStackTrace(const ScopedObjectAccessAlreadyRunnable& soa) const {
-  // Compute depth of stack
-  CountStackDepthVisitor count_visitor(const_cast<Thread*>(this));
-  count_visitor.WalkStack();
-  int32_t depth = count_visitor.GetDepth();
-  int32_t skip_depth = count_visitor.GetSkipDepth();
-
-  // Build internal stack trace.
-  BuildInternalStackTraceVisitor<kTransactionActive> build_trace_visitor(soa.Self(),
-                                                                         const_cast<Thread*>(this),
-                                                                         skip_depth);
-  if (!build_trace_visitor.Init(depth)) {
+  // Walk the stack once, before allocating anything on the managed heap. The frames cannot
+  // change while we allocate: either this is the current thread, or it is suspended. Creating
+  // the StackTraceElements is deferred to InternalStackTraceToStackTraceElementArray, which
+  // only runs when the stack trace is requested.
+  CollectStackTraceVisitor collect_visitor(const_cast<Thread*>(this));
+  collect_visitor.WalkStack();
+  const std::vector<std::pair<ArtMethod*, uint32_t>>& frames = collect_visitor.GetFrames();
+  const int32_t depth = frames.size();
+
+  // Allocate method trace as an object array where the first element is a pointer array that
+  // contains the ArtMethod pointers and dex PCs. The rest of the elements are the declaring
+  // class of the ArtMethod pointers, to ensure classes in the stack trace don't get unloaded.
+  Thread* self = soa.Self();
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  const size_t pointer_size = class_linker->GetImagePointerSize();
+  StackHandleScope<1> hs(self);
+  mirror::Class* array_class = class_linker->GetClassRoot(ClassLinker::kObjectArrayClass);
+  Handle<mirror::ObjectArray<mirror::Object>> trace(
+      hs.NewHandle(mirror::ObjectArray<mirror::Object>::Alloc(self, array_class, depth + 1)));
+  if (trace.Get() == nullptr) {
+    self->AssertPendingOOMException();
     return nullptr;  // Allocation failed.
   }
-  build_trace_visitor.WalkStack();
-  mirror::ObjectArray<mirror::Object>* trace = build_trace_visitor.GetInternalStackTrace();
-  if (kIsDebugBuild) {
-    mirror::PointerArray* trace_methods = build_trace_visitor.GetTraceMethodsAndPCs();
-    // Second half of trace_methods is dex PCs.
-    for (uint32_t i = 0; i < static_cast<uint32_t>(trace_methods->GetLength() / 2); ++i) {
-      auto* method = trace_methods->GetElementPtrSize<ArtMethod*>(
-          i, Runtime::Current()->GetClassLinker()->GetImagePointerSize());
-      CHECK(method != nullptr);
-    }
+  mirror::PointerArray* methods_and_pcs = class_linker->AllocPointerArray(self, depth * 2);
+  if (methods_and_pcs == nullptr) {
+    self->AssertPendingOOMException();
+    return nullptr;  // Allocation failed.
+  }
+  ScopedAssertNoThreadSuspension ants(self, "Building internal stack trace");
+  trace->Set(0, methods_and_pcs);
+  for (int32_t i = 0; i < depth; ++i) {
+    ArtMethod* method = frames[i].first;
+    DCHECK(method != nullptr);
+    methods_and_pcs->SetElementPtrSize<kTransactionActive>(i, method, pointer_size);
+    // Second half of the pointer array is dex PCs.
+    methods_and_pcs->SetElementPtrSize<kTransactionActive>(depth + i,
+                                                           frames[i].second,
+                                                           pointer_size);
+    trace->Set(i + 1, method->GetDeclaringClass());
   }
-  return soa.AddLocalReference<jobject>(trace);
+  return soa.AddLocalReference<jobject>(trace.Get());
 }
 template jobject Thread::CreateInternalStackTrace<false>(
     const ScopedObjectAccessAlreadyRunnable& soa) const;
@@ -2691,12 +2645,11 @@ class ReferenceMapVisitor : public StackVisitor {
       if (method_header->IsOptimized()) {
         auto* vreg_base = reinterpret_cast<StackReference<mirror::Object>*>(
             reinterpret_cast<uintptr_t>(cur_quick_frame));
-        uintptr_t native_pc_offset = method_header->NativeQuickPcOffset(GetCurrentQuickFramePc());
         CodeInfo code_info = method_header->GetOptimizedCodeInfo();
         StackMapEncoding encoding = code_info.ExtractEncoding();
-        StackMap map = code_info.GetStackMapForNativePcOffset(native_pc_offset, encoding);
+        StackMap map = GetCurrentStackMap(code_info, encoding);
         DCHECK(map.IsValid());
-        MemoryRegion mask = map.GetStackMask(encoding);
+        MemoryRegion mask = code_info.GetStackMaskOf(map, encoding);
         // Visit stack entries that hold pointers.
         for (size_t i = 0; i < mask.size_in_bits(); ++i) {
           if (mask.LoadBit(i)) {
@@ -2712,7 +2665,7 @@ class ReferenceMapVisitor : public StackVisitor {
           }
         }
         // Visit callee-save registers that hold pointers.
-        uint32_t register_mask = map.GetRegisterMask(encoding);
+        uint32_t register_mask = code_info.GetRegisterMaskOf(map, encoding);
         for (size_t i = 0; i < BitSizeOf<uint32_t>(); ++i) {
           if (register_mask & (1 << i)) {
             mirror::Object** ref_addr = reinterpret_cast<mirror::Object**>(GetGPRAddress(i));
@@ -2791,6 +2744,10 @@ class RootCallbackVisitor {
 
 void Thread::VisitRoots(RootVisitor* visitor) {
   const uint32_t thread_id = GetThreadId();
+  // The interpreter cache refers to classes, methods and fields without holding them as roots.
+  // Drop it whenever the GC looks at this thread, so that no entry survives the objects moving
+  // or being unloaded.
+  interpreter_cache_.Clear();
   visitor->VisitRootIfNonNull(&tlsPtr_.opeer, RootInfo(kRootThreadObject, thread_id));
   if (tlsPtr_.exception != nullptr && tlsPtr_.exception != GetDeoptimizationException()) {
     visitor->VisitRoot(reinterpret_cast<mirror::Object**>(&tlsPtr_.exception),
@@ -35,11 +35,13 @@
 #include "globals.h"
 #include "handle_scope.h"
 #include "instrumentation.h"
+#include "interpreter/interpreter_cache.h"
 #include "jvalue.h"
 #include "object_callbacks.h"
 #include "offsets.h"
 #include "runtime_stats.h"
 #include "stack.h"
+#include "stack_map_cache.h"
 #include "thread_state.h"
 
 class BacktraceMap;
@@ -1012,6 +1014,19 @@ class Thread {
   void PushVerifier(verifier::MethodVerifier* verifier);
   void PopVerifier(verifier::MethodVerifier* verifier);
 
+  // The innermost method verifier running on this thread, if any.
+  verifier::MethodVerifier* GetVerifier() const {
+    return tlsPtr_.method_verifier;
+  }
+
+  interpreter::InterpreterCache* GetInterpreterCache() {
+    return &interpreter_cache_;
+  }
+
+  StackMapCache* GetStackMapCache() {
+    return &stack_map_cache_;
+  }
+
   void InitStringEntryPoints();
 
  private:
@@ -1387,6 +1402,12 @@ class Thread {
   // Thread "interrupted" status; stays raised until queried or thrown.
   bool interrupted_ GUARDED_BY(wait_mutex_);
 
+  // Resolution results of the instructions recently executed by the interpreter on this thread.
+  interpreter::InterpreterCache interpreter_cache_;
+
+  // Stack maps recently looked up by stack walks running on this thread.
+  StackMapCache stack_map_cache_;
+
   friend class Dbg;  // For SetStateUnsafe.
   friend class gc::collector::SemiSpace;  // For getting stack traces.
   friend class Runtime;  // For CreatePeer.
@@ -39,6 +39,7 @@
 #include "monitor.h"
 #include "scoped_thread_state_change.h"
 #include "thread.h"
+#include "thread_pool.h"
 #include "trace.h"
 #include "well_known_classes.h"
 
@@ -270,7 +271,70 @@ static void ThreadSuspendSleep(useconds_t delay_us) {
   }
 }
 
-size_t ThreadList::RunCheckpoint(Closure* checkpoint_function) {
+// Run `checkpoint_function` for `thread`, whose suspend count has been raised, once it has
+// finished suspending, then lower the suspend count again. `self` may be a thread pool worker
+// of RunCheckpoint: the raised suspend count keeps `thread` from running managed code or
+// unregistering until this returns, and the caller of RunCheckpoint holds the locks the
+// closure needs on behalf of the workers.
+static void RunCheckpointOnSuspendedThread(Thread* self,
+                                           Closure* checkpoint_function,
+                                           Thread* thread)
+    NO_THREAD_SAFETY_ANALYSIS {
+  if (!thread->IsSuspended()) {
+    if (ATRACE_ENABLED()) {
+      std::ostringstream oss;
+      thread->ShortDump(oss);
+      ATRACE_BEGIN((std::string("Waiting for suspension of thread ") + oss.str()).c_str());
+    }
+    // Busy wait until the thread is suspended.
+    const uint64_t start_time = NanoTime();
+    do {
+      ThreadSuspendSleep(kThreadSuspendInitialSleepUs);
+    } while (!thread->IsSuspended());
+    const uint64_t total_delay = NanoTime() - start_time;
+    // Shouldn't need to wait for longer than 1000 microseconds.
+    constexpr uint64_t kLongWaitThreshold = MsToNs(1);
+    ATRACE_END();
+    if (UNLIKELY(total_delay > kLongWaitThreshold)) {
+      LOG(WARNING) << "Long wait of " << PrettyDuration(total_delay) << " for "
+          << *thread << " suspension!";
+    }
+  }
+  // We know for sure that the thread is suspended at this point.
+  checkpoint_function->Run(thread);
+  {
+    MutexLock mu(self, *Locks::thread_suspend_count_lock_);
+    thread->ModifySuspendCount(self, -1, nullptr, false);
+  }
+}
+
+// Runs the checkpoint of a batch of suspended threads on a thread pool worker.
+class SuspendedThreadsCheckpointTask : public Task {
+ public:
+  SuspendedThreadsCheckpointTask(Closure* checkpoint_function,
+                                 Thread* const* begin,
+                                 Thread* const* end)
+      : checkpoint_function_(checkpoint_function), begin_(begin), end_(end) {}
+
+  void Run(Thread* self) OVERRIDE {
+    for (Thread* const* it = begin_; it != end_; ++it) {
+      RunCheckpointOnSuspendedThread(self, checkpoint_function_, *it);
+    }
+  }
+
+ private:
+  Closure* const checkpoint_function_;
+  Thread* const* const begin_;
+  Thread* const* const end_;
+
+  DISALLOW_COPY_AND_ASSIGN(SuspendedThreadsCheckpointTask);
+};
+
+// Minimum number of suspended threads handed to a thread pool worker by RunCheckpoint. Visiting
+// the roots of a blocked thread is cheap, so smaller batches are not worth waking a worker for.
+static constexpr size_t kMinSuspendedThreadsPerCheckpointTask = 16;
+
+size_t ThreadList::RunCheckpoint(Closure* checkpoint_function, ThreadPool* thread_pool) {
   Thread* self = Thread::Current();
   Locks::mutator_lock_->AssertNotExclusiveHeld(self);
   Locks::thread_list_lock_->AssertNotHeld(self);
@@ -309,33 +373,36 @@ size_t ThreadList::RunCheckpoint(Closure* checkpoint_function) {
   // Run the checkpoint on ourself while we wait for threads to suspend.
   checkpoint_function->Run(self);
 
-  // Run the checkpoint on the suspended threads.
-  for (const auto& thread : suspended_count_modified_threads) {
-    if (!thread->IsSuspended()) {
-      if (ATRACE_ENABLED()) {
-        std::ostringstream oss;
-        thread->ShortDump(oss);
-        ATRACE_BEGIN((std::string("Waiting for suspension of thread ") + oss.str()).c_str());
-      }
-      // Busy wait until the thread is suspended.
-      const uint64_t start_time = NanoTime();
-      do {
-        ThreadSuspendSleep(kThreadSuspendInitialSleepUs);
-      } while (!thread->IsSuspended());
-      const uint64_t total_delay = NanoTime() - start_time;
-      // Shouldn't need to wait for longer than 1000 microseconds.
-      constexpr uint64_t kLongWaitThreshold = MsToNs(1);
-      ATRACE_END();
-      if (UNLIKELY(total_delay > kLongWaitThreshold)) {
-        LOG(WARNING) << "Long wait of " << PrettyDuration(total_delay) << " for "
-            << *thread << " suspension!";
-      }
+  // Run the checkpoint on the suspended threads, splitting them between the workers of
+  // `thread_pool` if there are enough of them. Each thread is resumed as soon as its
+  // checkpoint has run.
+  const size_t num_suspended = suspended_count_modified_threads.size();
+  size_t num_tasks = 0;
+  if (thread_pool != nullptr) {
+    num_tasks = std::min(thread_pool->GetThreadCount() + 1,
+                         num_suspended / kMinSuspendedThreadsPerCheckpointTask);
+  }
+  if (num_tasks > 1) {
+    // The workers run the closure without acquiring the mutator lock, like the other
+    // parallel GC tasks: they rely on this thread holding it until they are done.
+    Locks::mutator_lock_->AssertSharedHeld(self);
+    std::vector<std::unique_ptr<SuspendedThreadsCheckpointTask>> tasks;
+    Thread* const* threads = suspended_count_modified_threads.data();
+    for (size_t i = 0; i < num_tasks; ++i) {
+      tasks.emplace_back(new SuspendedThreadsCheckpointTask(
+          checkpoint_function,
+          threads + num_suspended * i / num_tasks,
+          threads + num_suspended * (i + 1) / num_tasks));
+      thread_pool->AddTask(self, tasks.back().get());
     }
-    // We know for sure that the thread is suspended at this point.
-    checkpoint_function->Run(thread);
-    {
-      MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
-      thread->ModifySuspendCount(self, -1, nullptr, false);
+    // The calling thread works on the tasks too.
+    thread_pool->SetMaxActiveWorkers(num_tasks - 1);
+    thread_pool->StartWorkers(self);
+    thread_pool->Wait(self, true, true);
+    thread_pool->StopWorkers(self);
+  } else {
+    for (Thread* thread : suspended_count_modified_threads) {
+      RunCheckpointOnSuspendedThread(self, checkpoint_function, thread);
     }
   }
 
@@ -35,6 +35,7 @@ namespace gc {
 }  // namespace gc
 class Closure;
 class Thread;
+class ThreadPool;
 class TimingLogger;
 
 class ThreadList {
@@ -94,8 +95,11 @@ class ThreadList {
 
   // Run a checkpoint on threads, running threads are not suspended but run the checkpoint inside
   // of the suspend check. Returns how many checkpoints that are expected to run, including for
-  // already suspended threads for b/24191051.
-  size_t RunCheckpoint(Closure* checkpoint_function)
+  // already suspended threads for b/24191051. If `thread_pool` is not null, the checkpoints of
+  // suspended threads may be run in parallel on its workers, so the closure must support
+  // concurrent calls for different threads. The workers do not acquire any lock: the caller
+  // must hold the mutator lock shared, and any other lock the closure needs, until this returns.
+  size_t RunCheckpoint(Closure* checkpoint_function, ThreadPool* thread_pool = nullptr)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
   size_t RunCheckpointOnRunnableThreads(Closure* checkpoint_function)
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2012 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "thread_list.h"
+
+#include <algorithm>
+#include <pthread.h>
+#include <vector>
+
+#include "barrier.h"
+#include "base/mutex.h"
+#include "common_runtime_test.h"
+#include "runtime.h"
+#include "scoped_thread_state_change.h"
+#include "thread-inl.h"
+#include "thread_pool.h"
+
+namespace art {
+
+// Records the threads a checkpoint ran for, and checks that the threads it did not run on
+// were suspended.
+class RecordingCheckpoint : public Closure {
+ public:
+  explicit RecordingCheckpoint(bool check_resumption)
+      : lock_("Recording checkpoint lock"),
+        previous_suspended_thread_(nullptr),
+        check_resumption_(check_resumption) {}
+
+  void Run(Thread* thread) OVERRIDE NO_THREAD_SAFETY_ANALYSIS {
+    Thread* self = Thread::Current();
+    if (thread != self) {
+      EXPECT_TRUE(thread->IsSuspended()) << *thread;
+    }
+    MutexLock mu(self, lock_);
+    if (check_resumption_ && thread != self) {
+      // The checkpoints of suspended threads run one after the other: the previous thread
+      // must have been resumed already.
+      if (previous_suspended_thread_ != nullptr) {
+        MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
+        EXPECT_EQ(0, previous_suspended_thread_->GetSuspendCount()) << *previous_suspended_thread_;
+      }
+      previous_suspended_thread_ = thread;
+    }
+    visited_.push_back(thread);
+  }
+
+  size_t CountVisits(Thread* thread) {
+    MutexLock mu(Thread::Current(), lock_);
+    return std::count(visited_.begin(), visited_.end(), thread);
+  }
+
+ private:
+  Mutex lock_;
+  std::vector<Thread*> visited_ GUARDED_BY(lock_);
+  Thread* previous_suspended_thread_ GUARDED_BY(lock_);
+  const bool check_resumption_;
+};
+
+class ThreadListTest : public CommonRuntimeTest {
+ public:
+  ThreadListTest()
+      : attached_(0),
+        release_(0),
+        attached_threads_lock_("Attached threads lock") {}
+
+  // Attaches threads which stay in native code, and thus suspended, until the end of the test.
+  void AttachThreads(size_t count) {
+    Thread* self = Thread::Current();
+    attached_.Init(self, 0);
+    for (size_t i = 0; i < count; ++i) {
+      pthread_t pthread;
+      ASSERT_EQ(0, pthread_create(&pthread, nullptr, &AttachedThread, this));
+      pthreads_.push_back(pthread);
+    }
+    attached_.Increment(self, count);
+  }
+
+  void DetachThreads() {
+    release_.Wait(Thread::Current());
+    for (pthread_t pthread : pthreads_) {
+      ASSERT_EQ(0, pthread_join(pthread, nullptr));
+    }
+  }
+
+  std::vector<Thread*> GetAttachedThreads() {
+    MutexLock mu(Thread::Current(), attached_threads_lock_);
+    return attached_threads_;
+  }
+
+  void RunCheckpointTest(bool parallel) {
+    // Enough suspended threads for every worker of the pool to get a batch.
+    static constexpr size_t kNumWorkers = 4;
+    static constexpr size_t kNumThreads = 64;
+    Thread* self = Thread::Current();
+    std::unique_ptr<ThreadPool> thread_pool(
+        parallel ? new ThreadPool("Thread list test thread pool", kNumWorkers) : nullptr);
+    release_.Init(self, kNumThreads + 1);
+    AttachThreads(kNumThreads);
+    RecordingCheckpoint checkpoint(/* check_resumption */ !parallel);
+    {
+      ScopedObjectAccess soa(self);
+      size_t count = Runtime::Current()->GetThreadList()->RunCheckpoint(&checkpoint,
+                                                                        thread_pool.get());
+      EXPECT_GE(count, kNumThreads + 1);
+    }
+    EXPECT_EQ(1u, checkpoint.CountVisits(self));
+    for (Thread* thread : GetAttachedThreads()) {
+      // Suspended threads have their checkpoint run before RunCheckpoint returns.
+      EXPECT_EQ(1u, checkpoint.CountVisits(thread)) << *thread;
+      MutexLock mu(self, *Locks::thread_suspend_count_lock_);
+      EXPECT_EQ(0, thread->GetSuspendCount()) << *thread;
+    }
+    DetachThreads();
+  }
+
+ private:
+  static void* AttachedThread(void* arg) {
+    ThreadListTest* test = reinterpret_cast<ThreadListTest*>(arg);
+    CHECK(Runtime::Current()->AttachCurrentThread("Thread list test thread",
+                                                  /* as_daemon */ false,
+                                                  /* thread_group */ nullptr,
+                                                  /* create_peer */ false));
+    Thread* self = Thread::Current();
+    {
+      MutexLock mu(self, test->attached_threads_lock_);
+      test->attached_threads_.push_back(self);
+    }
+    test->attached_.Pass(self);
+    test->release_.Wait(self);
+    Runtime::Current()->DetachCurrentThread();
+    return nullptr;
+  }
+
+  Barrier attached_;
+  Barrier release_;
+  std::vector<pthread_t> pthreads_;
+  Mutex attached_threads_lock_;
+  std::vector<Thread*> attached_threads_ GUARDED_BY(attached_threads_lock_);
+};
+
+// Check that the checkpoints of suspended threads run on the caller, each followed by the
+// resumption of its thread.
+TEST_F(ThreadListTest, RunCheckpoint) {
+  RunCheckpointTest(/* parallel */ false);
+}
+
+// Check that the checkpoints of suspended threads run on a thread pool, once for each thread.
+TEST_F(ThreadListTest, RunCheckpointInParallel) {
+  RunCheckpointTest(/* parallel */ true);
+}
+
+}  // namespace art
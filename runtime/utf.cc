@@ -16,6 +16,14 @@
 
 #include "utf.h"
 
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 #include "base/logging.h"
 #include "mirror/array.h"
 #include "mirror/object-inl.h"
@@ -23,6 +31,106 @@
 
 namespace art {
 
+// Kernels for the ASCII fast paths of the conversions below. Most strings seen by the runtime
+// are ASCII, so the conversions look at whole blocks of characters whenever they are at a
+// character boundary, and only fall back to decoding one character at a time for blocks that
+// contain other characters. SSE2 and NEON are part of the baseline of the x86 and arm64
+// targets, so the kernels are selected at compile time.
+static constexpr size_t kAsciiBlockSize = 16;
+
+#if defined(__SSE2__)
+
+// Returns whether the kAsciiBlockSize bytes at `utf8` are all ASCII.
+ALWAYS_INLINE static inline bool IsAsciiBlock(const char* utf8) {
+  __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(utf8));
+  return _mm_movemask_epi8(bytes) == 0;
+}
+
+// Zero extends the kAsciiBlockSize ASCII bytes at `utf8` to `utf16`.
+ALWAYS_INLINE static inline void WidenAsciiBlock(uint16_t* utf16, const char* utf8) {
+  __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(utf8));
+  __m128i zero = _mm_setzero_si128();
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(utf16), _mm_unpacklo_epi8(bytes, zero));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(utf16 + 8), _mm_unpackhi_epi8(bytes, zero));
+}
+
+// Returns whether the kAsciiBlockSize chars at `utf16` are all in [1, 0x7f], that is whether
+// each of them is encoded as a single byte of modified UTF-8.
+ALWAYS_INLINE static inline bool IsModifiedUtf8AsciiBlock(const uint16_t* utf16) {
+  __m128i one = _mm_set1_epi16(1);
+  __m128i lo = _mm_sub_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(utf16)), one);
+  __m128i hi = _mm_sub_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(utf16 + 8)), one);
+  // Subtracting one maps 0 to 0xffff, so any bit above the low seven marks a non-ASCII char.
+  __m128i high_bits = _mm_and_si128(_mm_or_si128(lo, hi), _mm_set1_epi16(0xff80));
+  return _mm_movemask_epi8(_mm_cmpeq_epi16(high_bits, _mm_setzero_si128())) == 0xffff;
+}
+
+// Narrows the kAsciiBlockSize ASCII chars at `utf16` to `utf8`.
+ALWAYS_INLINE static inline void NarrowAsciiBlock(char* utf8, const uint16_t* utf16) {
+  __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(utf16));
+  __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(utf16 + 8));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(utf8), _mm_packus_epi16(lo, hi));
+}
+
+#elif defined(__aarch64__) || defined(__ARM_NEON__)
+
+ALWAYS_INLINE static inline bool IsAsciiBlock(const char* utf8) {
+  uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(utf8));
+  uint8x8_t folded = vorr_u8(vget_low_u8(bytes), vget_high_u8(bytes));
+  return (vget_lane_u64(vreinterpret_u64_u8(folded), 0) & UINT64_C(0x8080808080808080)) == 0;
+}
+
+ALWAYS_INLINE static inline void WidenAsciiBlock(uint16_t* utf16, const char* utf8) {
+  uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(utf8));
+  vst1q_u16(utf16, vmovl_u8(vget_low_u8(bytes)));
+  vst1q_u16(utf16 + 8, vmovl_u8(vget_high_u8(bytes)));
+}
+
+ALWAYS_INLINE static inline bool IsModifiedUtf8AsciiBlock(const uint16_t* utf16) {
+  uint16x8_t one = vdupq_n_u16(1);
+  uint16x8_t lo = vsubq_u16(vld1q_u16(utf16), one);
+  uint16x8_t hi = vsubq_u16(vld1q_u16(utf16 + 8), one);
+  // Subtracting one maps 0 to 0xffff, so any bit above the low seven marks a non-ASCII char.
+  uint16x8_t chars = vorrq_u16(lo, hi);
+  uint16x4_t folded = vorr_u16(vget_low_u16(chars), vget_high_u16(chars));
+  return (vget_lane_u64(vreinterpret_u64_u16(folded), 0) & UINT64_C(0xff80ff80ff80ff80)) == 0;
+}
+
+ALWAYS_INLINE static inline void NarrowAsciiBlock(char* utf8, const uint16_t* utf16) {
+  uint8x16_t bytes = vcombine_u8(vmovn_u16(vld1q_u16(utf16)), vmovn_u16(vld1q_u16(utf16 + 8)));
+  vst1q_u8(reinterpret_cast<uint8_t*>(utf8), bytes);
+}
+
+#else
+
+ALWAYS_INLINE static inline bool IsAsciiBlock(const char* utf8) {
+  uint64_t words[kAsciiBlockSize / sizeof(uint64_t)];
+  memcpy(words, utf8, sizeof(words));
+  return ((words[0] | words[1]) & UINT64_C(0x8080808080808080)) == 0;
+}
+
+ALWAYS_INLINE static inline void WidenAsciiBlock(uint16_t* utf16, const char* utf8) {
+  for (size_t i = 0; i < kAsciiBlockSize; ++i) {
+    utf16[i] = static_cast<uint8_t>(utf8[i]);
+  }
+}
+
+ALWAYS_INLINE static inline bool IsModifiedUtf8AsciiBlock(const uint16_t* utf16) {
+  uint16_t high_bits = 0;
+  for (size_t i = 0; i < kAsciiBlockSize; ++i) {
+    high_bits |= static_cast<uint16_t>(utf16[i] - 1u);
+  }
+  return (high_bits & 0xff80) == 0;
+}
+
+ALWAYS_INLINE static inline void NarrowAsciiBlock(char* utf8, const uint16_t* utf16) {
+  for (size_t i = 0; i < kAsciiBlockSize; ++i) {
+    utf8[i] = static_cast<char>(utf16[i]);
+  }
+}
+
+#endif
+
 // This is used only from debugger and test code.
 size_t CountModifiedUtf8Chars(const char* utf8) {
   return CountModifiedUtf8Chars(utf8, strlen(utf8));
@@ -48,6 +156,14 @@ size_t CountModifiedUtf8Chars(const char* utf8, size_t byte_count) {
   size_t len = 0;
   const char* end = utf8 + byte_count;
   for (; utf8 < end; ++utf8) {
+    // Skip whole blocks of ASCII characters. `utf8` may be past `end` for invalid input.
+    while (end - utf8 >= static_cast<ptrdiff_t>(kAsciiBlockSize) && IsAsciiBlock(utf8)) {
+      utf8 += kAsciiBlockSize;
+      len += kAsciiBlockSize;
+    }
+    if (utf8 >= end) {
+      break;
+    }
     int ic = *utf8;
     len++;
     if (LIKELY((ic & 0x80) == 0)) {
@@ -96,7 +212,12 @@ void ConvertModifiedUtf8ToUtf16(uint16_t* utf16_data_out, size_t out_chars,
 
   if (LIKELY(out_chars == in_bytes)) {
     // Common case where all characters are ASCII.
-    for (const char *p = in_start; p < in_end;) {
+    const char *p = in_start;
+    for (; in_end - p >= static_cast<ptrdiff_t>(kAsciiBlockSize); p += kAsciiBlockSize) {
+      WidenAsciiBlock(out_p, p);
+      out_p += kAsciiBlockSize;
+    }
+    while (p < in_end) {
       // Safe even if char is signed because ASCII characters always have
       // the high bit cleared.
       *out_p++ = dchecked_integral_cast<uint16_t>(*p++);
@@ -106,6 +227,12 @@ void ConvertModifiedUtf8ToUtf16(uint16_t* utf16_data_out, size_t out_chars,
 
   // String contains non-ASCII characters.
   for (const char *p = in_start; p < in_end;) {
+    if (in_end - p >= static_cast<ptrdiff_t>(kAsciiBlockSize) && IsAsciiBlock(p)) {
+      WidenAsciiBlock(out_p, p);
+      out_p += kAsciiBlockSize;
+      p += kAsciiBlockSize;
+      continue;
+    }
     const uint32_t ch = GetUtf16FromUtf8(&p);
     const uint16_t leading = GetLeadingUtf16Char(ch);
     const uint16_t trailing = GetTrailingUtf16Char(ch);
@@ -122,15 +249,28 @@ void ConvertUtf16ToModifiedUtf8(char* utf8_out, size_t byte_count,
   if (LIKELY(byte_count == char_count)) {
     // Common case where all characters are ASCII.
     const uint16_t *utf16_end = utf16_in + char_count;
-    for (const uint16_t *p = utf16_in; p < utf16_end;) {
+    const uint16_t *p = utf16_in;
+    for (; utf16_end - p >= static_cast<ptrdiff_t>(kAsciiBlockSize); p += kAsciiBlockSize) {
+      NarrowAsciiBlock(utf8_out, p);
+      utf8_out += kAsciiBlockSize;
+    }
+    while (p < utf16_end) {
       *utf8_out++ = dchecked_integral_cast<char>(*p++);
     }
     return;
   }
 
   // String contains non-ASCII characters.
-  while (char_count--) {
+  while (char_count != 0) {
+    if (char_count >= kAsciiBlockSize && IsModifiedUtf8AsciiBlock(utf16_in)) {
+      NarrowAsciiBlock(utf8_out, utf16_in);
+      utf8_out += kAsciiBlockSize;
+      utf16_in += kAsciiBlockSize;
+      char_count -= kAsciiBlockSize;
+      continue;
+    }
     const uint16_t ch = *utf16_in++;
+    --char_count;
     if (ch > 0 && ch <= 0x7f) {
       *utf8_out++ = ch;
     } else {
@@ -171,7 +311,14 @@ void ConvertUtf16ToModifiedUtf8(char* utf8_out, size_t byte_count,
 }
 
 int32_t ComputeUtf16Hash(const uint16_t* chars, size_t char_count) {
+  static constexpr uint32_t k31Pow2 = 31u * 31u;
+  static constexpr uint32_t k31Pow3 = 31u * 31u * 31u;
+  static constexpr uint32_t k31Pow4 = 31u * 31u * 31u * 31u;
   uint32_t hash = 0;
+  // Fold four characters per iteration to break the dependency on the previous multiplication.
+  for (; char_count >= 4; char_count -= 4, chars += 4) {
+    hash = hash * k31Pow4 + chars[0] * k31Pow3 + chars[1] * k31Pow2 + chars[2] * 31u + chars[3];
+  }
   while (char_count--) {
     hash = hash * 31 + *chars++;
   }
@@ -226,6 +373,12 @@ size_t CountUtf8Bytes(const uint16_t* chars, size_t char_count) {
   size_t result = 0;
   const uint16_t *end = chars + char_count;
   while (chars < end) {
+    if (end - chars >= static_cast<ptrdiff_t>(kAsciiBlockSize) &&
+        IsModifiedUtf8AsciiBlock(chars)) {
+      chars += kAsciiBlockSize;
+      result += kAsciiBlockSize;
+      continue;
+    }
     const uint16_t ch = *chars++;
     if (LIKELY(ch != 0 && ch < 0x80)) {
       result++;
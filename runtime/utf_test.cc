@@ -378,4 +378,51 @@ TEST_F(UtfTest, ExhaustiveBidirectionalCodePointCheck) {
   }
 }
 
+
+static void testLongConversions(const std::vector<uint16_t>& chars) {
+  const size_t byte_count = CountUtf8Bytes_reference(chars.data(), chars.size());
+  EXPECT_EQ(byte_count, CountUtf8Bytes(chars.data(), chars.size()));
+
+  // Both buffers are null terminated for CountModifiedUtf8Chars.
+  std::vector<char> bytes_reference(byte_count + 1, '\0');
+  std::vector<char> bytes_test(byte_count + 1, '\0');
+  ConvertUtf16ToModifiedUtf8_reference(bytes_reference.data(), chars.data(), chars.size());
+  ConvertUtf16ToModifiedUtf8(bytes_test.data(), byte_count, chars.data(), chars.size());
+  EXPECT_EQ(bytes_reference, bytes_test);
+
+  EXPECT_EQ(chars.size(), CountModifiedUtf8Chars(bytes_test.data(), byte_count));
+  std::vector<uint16_t> chars_test(chars.size());
+  ConvertModifiedUtf8ToUtf16(chars_test.data(), chars_test.size(), bytes_test.data(), byte_count);
+  EXPECT_EQ(chars, chars_test);
+
+  uint32_t hash = 0;
+  for (uint16_t c : chars) {
+    hash = hash * 31 + c;
+  }
+  EXPECT_EQ(static_cast<int32_t>(hash), ComputeUtf16Hash(chars.data(), chars.size()));
+}
+
+// Moves a non-ASCII character through strings spanning several blocks of the ASCII fast paths.
+TEST_F(UtfTest, LongStringConversions) {
+  static const uint16_t kNonAscii[] = { 0x0000, 0x00e9, 0x20ac, 0xdc00, 0xd801 };
+  for (uint16_t non_ascii : kNonAscii) {
+    for (size_t length = 0; length <= 50; ++length) {
+      for (size_t pos = 0; pos <= length; ++pos) {
+        std::vector<uint16_t> chars(length);
+        for (size_t i = 0; i < length; ++i) {
+          chars[i] = 'a' + (i % 26);
+        }
+        if (pos < length) {
+          chars[pos] = non_ascii;
+          if (non_ascii == 0xd801 && pos + 1 < length) {
+            // Make a surrogate pair, encoded as four bytes.
+            chars[pos + 1] = 0xdc00;
+          }
+        }
+        testLongConversions(chars);
+      }
+    }
+  }
+}
+
 }  // namespace art
@@ -47,6 +47,7 @@
 #include "utils.h"
 #include "handle_scope-inl.h"
 #include "verifier/dex_gc_map.h"
+#include "verifier/verification_cache.h"
 
 namespace art {
 namespace verifier {
@@ -175,6 +176,7 @@ void MethodVerifier::VerifyMethods(Thread* self,
                                    bool allow_soft_failures,
                                    bool log_hard_failures,
                                    bool need_precise_constants,
+                                   VerificationDependencies* dependencies,
                                    bool* hard_fail,
                                    size_t* error_count,
                                    std::string* error_string) {
@@ -215,6 +217,7 @@ void MethodVerifier::VerifyMethods(Thread* self,
                                                       allow_soft_failures,
                                                       log_hard_failures,
                                                       need_precise_constants,
+                                                      dependencies,
                                                       &hard_failure_msg);
     if (result != kNoFailure) {
       if (result == kHardFailure) {
@@ -259,13 +262,27 @@ MethodVerifier::FailureKind MethodVerifier::VerifyClass(Thread* self,
     // empty class, probably a marker interface
     return kNoFailure;
   }
+  // Reuse a cached outcome if the class and the class path assumptions it was verified under are
+  // unchanged. The compiler needs the per-method results reported through its callbacks, so it
+  // only ever populates the cache.
+  Runtime* const runtime = Runtime::Current();
+  VerificationCache* const cache = runtime->GetVerificationCache();
+  if (cache != nullptr && !runtime->IsAotCompiler()) {
+    FailureKind cached_result;
+    if (cache->Lookup(self, *dex_file, *class_def, class_loader, &cached_result)) {
+      return cached_result;
+    }
+  }
+  VerificationDependencies dependencies;
+  VerificationDependencies* const dependencies_ptr = (cache != nullptr) ? &dependencies : nullptr;
+
   ClassDataItemIterator it(*dex_file, class_data);
   while (it.HasNextStaticField() || it.HasNextInstanceField()) {
     it.Next();
   }
   size_t error_count = 0;
   bool hard_fail = false;
-  ClassLinker* linker = Runtime::Current()->GetClassLinker();
+  ClassLinker* linker = runtime->GetClassLinker();
   // Direct methods.
   VerifyMethods<true>(self,
                       linker,
@@ -277,6 +294,7 @@ MethodVerifier::FailureKind MethodVerifier::VerifyClass(Thread* self,
                       allow_soft_failures,
                       log_hard_failures,
                       false /* need precise constants */,
+                      dependencies_ptr,
                       &hard_fail,
                       &error_count,
                       error);
@@ -291,15 +309,16 @@ MethodVerifier::FailureKind MethodVerifier::VerifyClass(Thread* self,
                       allow_soft_failures,
                       log_hard_failures,
                       false /* need precise constants */,
+                      dependencies_ptr,
                       &hard_fail,
                       &error_count,
                       error);
 
-  if (error_count == 0) {
-    return kNoFailure;
-  } else {
-    return hard_fail ? kHardFailure : kSoftFailure;
+  FailureKind result = (error_count == 0) ? kNoFailure : (hard_fail ? kHardFailure : kSoftFailure);
+  if (cache != nullptr && result != kHardFailure) {
+    cache->Put(*dex_file, *class_def, result, dependencies);
   }
+  return result;
 }
 
 static bool IsLargeMethod(const DexFile::CodeItem* const code_item) {
@@ -325,6 +344,7 @@ MethodVerifier::FailureKind MethodVerifier::VerifyMethod(Thread* self,
                                                          bool allow_soft_failures,
                                                          bool log_hard_failures,
                                                          bool need_precise_constants,
+                                                         VerificationDependencies* dependencies,
                                                          std::string* hard_failure_msg) {
   MethodVerifier::FailureKind result = kNoFailure;
   uint64_t start_ns = kTimeVerifyMethod ? NanoTime() : 0;
@@ -332,6 +352,7 @@ MethodVerifier::FailureKind MethodVerifier::VerifyMethod(Thread* self,
   MethodVerifier verifier(self, dex_file, dex_cache, class_loader, class_def, code_item,
                           method_idx, method, method_access_flags, true, allow_soft_failures,
                           need_precise_constants, true);
+  verifier.dependencies_ = dependencies;
   if (verifier.Verify()) {
     // Verification completed, however failures may be pending that didn't cause the verification
     // to hard fail.
@@ -449,7 +470,8 @@ MethodVerifier::MethodVerifier(Thread* self,
       verify_to_dump_(verify_to_dump),
       allow_thread_suspension_(allow_thread_suspension),
       is_constructor_(false),
-      link_(nullptr) {
+      link_(nullptr),
+      dependencies_(nullptr) {
   self->PushVerifier(this);
   DCHECK(class_def != nullptr);
 }
@@ -3559,6 +3581,11 @@ const RegType& MethodVerifier::ResolveClassAndCheckAccess(uint32_t class_idx) {
   if (klass == nullptr && !result->IsUnresolvedTypes()) {
     dex_cache_->SetResolvedType(class_idx, result->GetClass());
   }
+  if (dependencies_ != nullptr) {
+    dependencies_->AddClassResolution(dex_file_->StringByTypeIdx(class_idx),
+                                      result->IsUnresolvedTypes() ? nullptr : result->GetClass(),
+                                      GetClassLoader());
+  }
   // Check if access is allowed. Unresolved types use xxxWithAccessCheck to
   // check at runtime if access is allowed and so pass here. If result is
   // primitive, skip the access check.
@@ -3660,6 +3687,9 @@ ArtMethod* MethodVerifier::ResolveMethodAndCheckAccess(
         res_method = klass->FindDirectMethod(name, signature, pointer_size);
       }
       if (res_method == nullptr) {
+        if (dependencies_ != nullptr) {
+          dependencies_->AddMethodResolution(*dex_file_, dex_method_idx, method_type, nullptr);
+        }
         Fail(VERIFY_ERROR_NO_METHOD) << "couldn't find method "
                                      << PrettyDescriptor(klass) << "." << name
                                      << " " << signature;
@@ -3667,6 +3697,9 @@ ArtMethod* MethodVerifier::ResolveMethodAndCheckAccess(
       }
     }
   }
+  if (dependencies_ != nullptr) {
+    dependencies_->AddMethodResolution(*dex_file_, dex_method_idx, method_type, res_method);
+  }
   // Make sure calls to constructors are "direct". There are additional restrictions but we don't
   // enforce them here.
   if (res_method->IsConstructor() && method_type != METHOD_DIRECT) {
@@ -4302,6 +4335,9 @@ ArtField* MethodVerifier::GetStaticField(int field_idx) {
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
   ArtField* field = class_linker->ResolveFieldJLS(*dex_file_, field_idx, dex_cache_,
                                                   class_loader_);
+  if (dependencies_ != nullptr) {
+    dependencies_->AddFieldResolution(*dex_file_, field_idx, field);
+  }
   if (field == nullptr) {
     VLOG(verifier) << "Unable to resolve static field " << field_idx << " ("
               << dex_file_->GetFieldName(field_id) << ") in "
@@ -4337,6 +4373,9 @@ ArtField* MethodVerifier::GetInstanceField(const RegType& obj_type, int field_id
   ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
   ArtField* field = class_linker->ResolveFieldJLS(*dex_file_, field_idx, dex_cache_,
                                                   class_loader_);
+  if (dependencies_ != nullptr) {
+    dependencies_->AddFieldResolution(*dex_file_, field_idx, field);
+  }
   if (field == nullptr) {
     VLOG(verifier) << "Unable to resolve instance field " << field_idx << " ("
               << dex_file_->GetFieldName(field_id) << ") in "
@@ -44,6 +44,7 @@ class DexPcToReferenceMap;
 class MethodVerifier;
 class RegisterLine;
 class RegType;
+class VerificationDependencies;
 
 /*
  * "Direct" and "virtual" methods are stored independently. The type of call used to invoke the
@@ -284,6 +285,12 @@ class MethodVerifier {
     return arena_;
   }
 
+  // The dependencies collector of the verification cache, or null if the outcome of this
+  // verification is not going to be cached.
+  VerificationDependencies* GetDependencies() const {
+    return dependencies_;
+  }
+
  private:
   void UninstantiableError(const char* descriptor);
   static bool IsInstantiableOrPrimitive(mirror::Class* klass) SHARED_REQUIRES(Locks::mutator_lock_);
@@ -326,6 +333,7 @@ class MethodVerifier {
                             bool allow_soft_failures,
                             bool log_hard_failures,
                             bool need_precise_constants,
+                            VerificationDependencies* dependencies,
                             bool* hard_fail,
                             size_t* error_count,
                             std::string* error_string)
@@ -353,6 +361,7 @@ class MethodVerifier {
                                   bool allow_soft_failures,
                                   bool log_hard_failures,
                                   bool need_precise_constants,
+                                  VerificationDependencies* dependencies,
                                   std::string* hard_failure_msg)
       SHARED_REQUIRES(Locks::mutator_lock_);
 
@@ -831,6 +840,9 @@ class MethodVerifier {
   // Link, for the method verifier root linked list.
   MethodVerifier* link_;
 
+  // Where to record the class path assumptions made while verifying, see VerificationCache.
+  VerificationDependencies* dependencies_;
+
   friend class art::Thread;
 
   // Map of dex pcs of invocations of java.lang.String.<init> to the set of other registers that
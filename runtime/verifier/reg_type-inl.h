@@ -22,6 +22,7 @@
 #include "base/casts.h"
 #include "base/scoped_arena_allocator.h"
 #include "mirror/class.h"
+#include "verification_cache.h"
 
 namespace art {
 namespace verifier {
@@ -97,13 +98,15 @@ inline bool RegType::AssignableFrom(const RegType& lhs, const RegType& rhs, bool
         return true;  // All reference types can be assigned to Object.
       } else if (!strict && !lhs.IsUnresolvedTypes() && lhs.GetClass()->IsInterface()) {
         // If we're not strict allow assignment to any interface, see comment in ClassJoin.
+        VerificationCache::MaybeRecordAssignability(lhs, rhs, strict, true);
         return true;
       } else if (lhs.IsJavaLangObjectArray()) {
         return rhs.IsObjectArrayTypes();  // All reference arrays may be assigned to Object[]
-      } else if (lhs.HasClass() && rhs.HasClass() &&
-                 lhs.GetClass()->IsAssignableFrom(rhs.GetClass())) {
-        // We're assignable from the Class point-of-view.
-        return true;
+      } else if (lhs.HasClass() && rhs.HasClass()) {
+        // Check whether we're assignable from the Class point-of-view.
+        bool is_assignable = lhs.GetClass()->IsAssignableFrom(rhs.GetClass());
+        VerificationCache::MaybeRecordAssignability(lhs, rhs, strict, is_assignable);
+        return is_assignable;
       } else {
         // Unresolved types are only assignable for null and equality.
         return false;
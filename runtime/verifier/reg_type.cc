@@ -27,6 +27,7 @@
 #include "mirror/object_array-inl.h"
 #include "reg_type_cache-inl.h"
 #include "scoped_thread_state_change.h"
+#include "verification_cache.h"
 
 #include <limits>
 #include <sstream>
@@ -688,6 +689,7 @@ const RegType& RegType::Merge(const RegType& incoming_type, RegTypeCache* reg_ty
       DCHECK(c1 != nullptr && !c1->IsPrimitive());
       DCHECK(c2 != nullptr && !c2->IsPrimitive());
       mirror::Class* join_class = ClassJoin(c1, c2);
+      VerificationCache::MaybeRecordClassJoin(c1, c2, join_class);
       if (c1 == join_class && !IsPreciseReference()) {
         return *this;
       } else if (c2 == join_class && !incoming_type.IsPreciseReference()) {
@@ -25,6 +25,7 @@
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
 #include "reg_type-inl.h"
+#include "verification_cache.h"
 
 namespace art {
 namespace verifier {
@@ -183,6 +184,7 @@ const RegType& RegTypeCache::From(mirror::ClassLoader* loader,
   // Class not found in the cache, will create a new type for that.
   // Try resolving class.
   mirror::Class* klass = ResolveClass(descriptor, loader);
+  VerificationCache::MaybeRecordClassResolution(descriptor, klass);
   if (klass != nullptr) {
     // Class resolved, first look for the class in the list of entries
     // Class was not found, must create new type.
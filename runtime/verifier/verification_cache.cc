@@ -0,0 +1,585 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "verification_cache.h"
+
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "art_field-inl.h"
+#include "art_method-inl.h"
+#include "base/logging.h"
+#include "base/mutex-inl.h"
+#include "base/unix_file/fd_file.h"
+#include "class_linker.h"
+#include "dex_file-inl.h"
+#include "handle_scope-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/class_loader.h"
+#include "modifiers.h"
+#include "os.h"
+#include "reg_type-inl.h"
+#include "runtime.h"
+#include "thread-inl.h"
+#include "utils.h"
+
+namespace art {
+namespace verifier {
+
+static constexpr const char kCacheMagic[] = "verification-cache-v2";
+static constexpr char kFieldSeparator = ',';
+static constexpr char kLineSeparator = '\n';
+static constexpr char kClassTag = 'C';
+static constexpr char kAssignabilityTag = 'A';
+static constexpr char kClassResolutionTag = 'R';
+static constexpr char kFieldResolutionTag = 'F';
+static constexpr char kMethodResolutionTag = 'M';
+static constexpr char kClassJoinTag = 'J';
+
+// Returns the descriptor of `klass`, or an empty string if it is null.
+static std::string DescriptorOf(mirror::Class* klass) SHARED_REQUIRES(Locks::mutator_lock_) {
+  if (klass == nullptr) {
+    return std::string();
+  }
+  std::string temp;
+  return std::string(klass->GetDescriptor(&temp));
+}
+
+void VerificationDependencies::AddAssignability(const RegType& destination,
+                                                const RegType& source,
+                                                bool is_strict,
+                                                bool is_assignable) {
+  DCHECK(destination.HasClass());
+  AssignabilityDependency dependency;
+  dependency.destination = destination.GetDescriptor().as_string();
+  // An unresolved source only matters for the "any interface" rule, which depends on the
+  // destination alone. Record it with an empty source descriptor.
+  dependency.source = source.HasClass() ? source.GetDescriptor().as_string() : std::string();
+  dependency.is_strict = is_strict;
+  dependency.is_assignable = is_assignable;
+  assignabilities_.insert(dependency);
+}
+
+void VerificationDependencies::AddClassResolution(const char* descriptor,
+                                                  mirror::Class* klass,
+                                                  mirror::ClassLoader* class_loader) {
+  ClassResolutionDependency dependency;
+  dependency.descriptor = descriptor;
+  dependency.is_resolved = (klass != nullptr);
+  dependency.access_flags = (klass != nullptr) ? (klass->GetAccessFlags() & kAccJavaFlagsMask) : 0u;
+  dependency.is_same_class_loader = (klass != nullptr) && (klass->GetClassLoader() == class_loader);
+  dependency.superclass = (klass != nullptr) ? DescriptorOf(klass->GetSuperClass()) : std::string();
+  classes_.insert(dependency);
+}
+
+void VerificationDependencies::AddFieldResolution(const DexFile& dex_file,
+                                                  uint32_t field_idx,
+                                                  ArtField* field) {
+  const DexFile::FieldId& field_id = dex_file.GetFieldId(field_idx);
+  MemberResolutionDependency dependency;
+  dependency.klass = dex_file.GetFieldDeclaringClassDescriptor(field_id);
+  dependency.name = dex_file.GetFieldName(field_id);
+  dependency.signature = dex_file.GetFieldTypeDescriptor(field_id);
+  dependency.lookup = 0u;
+  dependency.declaring_class =
+      (field != nullptr) ? DescriptorOf(field->GetDeclaringClass()) : std::string();
+  dependency.access_flags = (field != nullptr) ? (field->GetAccessFlags() & kAccJavaFlagsMask) : 0u;
+  fields_.insert(dependency);
+}
+
+void VerificationDependencies::AddMethodResolution(const DexFile& dex_file,
+                                                   uint32_t method_idx,
+                                                   MethodType method_type,
+                                                   ArtMethod* method) {
+  const DexFile::MethodId& method_id = dex_file.GetMethodId(method_idx);
+  MemberResolutionDependency dependency;
+  dependency.klass = dex_file.GetMethodDeclaringClassDescriptor(method_id);
+  dependency.name = dex_file.GetMethodName(method_id);
+  dependency.signature = dex_file.GetMethodSignature(method_id).ToString();
+  dependency.lookup = static_cast<uint32_t>(method_type);
+  dependency.declaring_class =
+      (method != nullptr) ? DescriptorOf(method->GetDeclaringClass()) : std::string();
+  dependency.access_flags =
+      (method != nullptr) ? (method->GetAccessFlags() & kAccJavaFlagsMask) : 0u;
+  methods_.insert(dependency);
+}
+
+void VerificationDependencies::AddClassJoin(mirror::Class* lhs,
+                                            mirror::Class* rhs,
+                                            mirror::Class* join) {
+  ClassJoinDependency dependency;
+  dependency.lhs = DescriptorOf(lhs);
+  dependency.rhs = DescriptorOf(rhs);
+  dependency.join = DescriptorOf(join);
+  class_joins_.insert(dependency);
+}
+
+VerificationCache::VerificationCache(const std::string& filename)
+    : filename_(filename),
+      lock_("verification cache lock"),
+      dirty_(false) {
+}
+
+VerificationCache::~VerificationCache() {
+}
+
+void VerificationCache::MaybeRecordAssignability(const RegType& destination,
+                                                 const RegType& source,
+                                                 bool is_strict,
+                                                 bool is_assignable) {
+  MethodVerifier* verifier = Thread::Current()->GetVerifier();
+  if (verifier == nullptr || verifier->GetDependencies() == nullptr) {
+    return;
+  }
+  verifier->GetDependencies()->AddAssignability(destination, source, is_strict, is_assignable);
+}
+
+void VerificationCache::MaybeRecordClassResolution(const char* descriptor, mirror::Class* klass) {
+  MethodVerifier* verifier = Thread::Current()->GetVerifier();
+  if (verifier == nullptr || verifier->GetDependencies() == nullptr) {
+    return;
+  }
+  verifier->GetDependencies()->AddClassResolution(descriptor, klass, verifier->GetClassLoader());
+}
+
+void VerificationCache::MaybeRecordClassJoin(mirror::Class* lhs,
+                                             mirror::Class* rhs,
+                                             mirror::Class* join) {
+  MethodVerifier* verifier = Thread::Current()->GetVerifier();
+  if (verifier == nullptr || verifier->GetDependencies() == nullptr) {
+    return;
+  }
+  verifier->GetDependencies()->AddClassJoin(lhs, rhs, join);
+}
+
+uint32_t VerificationCache::ComputeCodeHash(const DexFile& dex_file,
+                                            const DexFile::ClassDef& class_def) {
+  // 32-bit FNV-1a over the method indices, access flags and code items of the class.
+  uint32_t hash = 0x811c9dc5u;
+  auto hash_bytes = [&hash](const void* data, size_t size) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+      hash = (hash ^ bytes[i]) * 16777619u;
+    }
+  };
+  const uint8_t* class_data = dex_file.GetClassData(class_def);
+  if (class_data == nullptr) {
+    return hash;
+  }
+  ClassDataItemIterator it(dex_file, class_data);
+  while (it.HasNextStaticField() || it.HasNextInstanceField()) {
+    it.Next();
+  }
+  for (; it.HasNextDirectMethod() || it.HasNextVirtualMethod(); it.Next()) {
+    uint32_t method_idx = it.GetMemberIndex();
+    uint32_t access_flags = it.GetMethodAccessFlags();
+    hash_bytes(&method_idx, sizeof(method_idx));
+    hash_bytes(&access_flags, sizeof(access_flags));
+    const DexFile::CodeItem* code_item = it.GetMethodCodeItem();
+    if (code_item == nullptr) {
+      continue;
+    }
+    hash_bytes(&code_item->registers_size_, sizeof(code_item->registers_size_));
+    hash_bytes(&code_item->ins_size_, sizeof(code_item->ins_size_));
+    hash_bytes(&code_item->outs_size_, sizeof(code_item->outs_size_));
+    hash_bytes(&code_item->tries_size_, sizeof(code_item->tries_size_));
+    hash_bytes(code_item->insns_, code_item->insns_size_in_code_units_ * sizeof(uint16_t));
+    if (code_item->tries_size_ != 0) {
+      hash_bytes(DexFile::GetTryItems(*code_item, 0),
+                 code_item->tries_size_ * sizeof(DexFile::TryItem));
+    }
+  }
+  return hash;
+}
+
+void VerificationCache::Put(const DexFile& dex_file,
+                            const DexFile::ClassDef& class_def,
+                            MethodVerifier::FailureKind result,
+                            const VerificationDependencies& dependencies) {
+  if (result == MethodVerifier::kHardFailure) {
+    return;
+  }
+  ClassKey key(dex_file.GetLocationChecksum(), dex_file.GetClassDescriptor(class_def));
+  ClassEntry entry;
+  entry.code_hash = ComputeCodeHash(dex_file, class_def);
+  entry.result = result;
+  entry.assignabilities = dependencies.GetAssignabilities();
+  entry.classes = dependencies.GetClasses();
+  entry.fields = dependencies.GetFields();
+  entry.methods = dependencies.GetMethods();
+  entry.class_joins = dependencies.GetClassJoins();
+  MutexLock mu(Thread::Current(), lock_);
+  entries_[key] = std::move(entry);
+  dirty_ = true;
+}
+
+bool VerificationCache::Lookup(Thread* self,
+                               const DexFile& dex_file,
+                               const DexFile::ClassDef& class_def,
+                               Handle<mirror::ClassLoader> class_loader,
+                               MethodVerifier::FailureKind* result) {
+  ClassKey key(dex_file.GetLocationChecksum(), dex_file.GetClassDescriptor(class_def));
+  ClassEntry entry;
+  {
+    MutexLock mu(self, lock_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      return false;
+    }
+    entry = it->second;
+  }
+  if (entry.code_hash != ComputeCodeHash(dex_file, class_def)) {
+    VLOG(verifier) << "Stale verification cache entry for " << key.second;
+    return false;
+  }
+  // Resolving the dependencies may load classes and suspend, so do not hold the lock.
+  if (!ValidateDependencies(self, entry, class_loader)) {
+    VLOG(verifier) << "Verification cache dependencies changed for " << key.second;
+    return false;
+  }
+  *result = entry.result;
+  return true;
+}
+
+// Returns the class `descriptor` resolves to through `class_loader`, or null.
+static mirror::Class* FindClass(Thread* self,
+                                const std::string& descriptor,
+                                Handle<mirror::ClassLoader> class_loader)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  mirror::Class* klass = class_linker->FindClass(self, descriptor.c_str(), class_loader);
+  if (klass == nullptr) {
+    self->ClearException();
+  }
+  return klass;
+}
+
+static bool MatchesMember(const MemberResolutionDependency& dependency,
+                          mirror::Class* declaring_class,
+                          uint32_t access_flags)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  return DescriptorOf(declaring_class) == dependency.declaring_class &&
+      (access_flags & kAccJavaFlagsMask) == dependency.access_flags;
+}
+
+bool VerificationCache::ValidateDependencies(Thread* self,
+                                             const ClassEntry& entry,
+                                             Handle<mirror::ClassLoader> class_loader) {
+  StackHandleScope<2> hs(self);
+  MutableHandle<mirror::Class> destination(hs.NewHandle<mirror::Class>(nullptr));
+  MutableHandle<mirror::Class> source(hs.NewHandle<mirror::Class>(nullptr));
+
+  // Class resolutions. Resolving through the same loader must give a class with the same access
+  // flags, defining loader and superclass, or fail again.
+  for (const ClassResolutionDependency& dependency : entry.classes) {
+    mirror::Class* klass = FindClass(self, dependency.descriptor, class_loader);
+    if (klass == nullptr || !dependency.is_resolved) {
+      if ((klass != nullptr) != dependency.is_resolved) {
+        return false;
+      }
+      continue;
+    }
+    if ((klass->GetAccessFlags() & kAccJavaFlagsMask) != dependency.access_flags ||
+        (klass->GetClassLoader() == class_loader.Get()) != dependency.is_same_class_loader ||
+        DescriptorOf(klass->GetSuperClass()) != dependency.superclass) {
+      return false;
+    }
+  }
+
+  // Field and method resolutions, using the lookups of the verifier.
+  for (const MemberResolutionDependency& dependency : entry.fields) {
+    destination.Assign(FindClass(self, dependency.klass, class_loader));
+    if (destination.Get() == nullptr) {
+      return false;
+    }
+    ArtField* field =
+        mirror::Class::FindField(self, destination, dependency.name, dependency.signature);
+    if (!MatchesMember(dependency,
+                       (field != nullptr) ? field->GetDeclaringClass() : nullptr,
+                       (field != nullptr) ? field->GetAccessFlags() : 0u)) {
+      return false;
+    }
+  }
+  size_t pointer_size = Runtime::Current()->GetClassLinker()->GetImagePointerSize();
+  for (const MemberResolutionDependency& dependency : entry.methods) {
+    mirror::Class* klass = FindClass(self, dependency.klass, class_loader);
+    if (klass == nullptr) {
+      return false;
+    }
+    // Mirror the lookup in MethodVerifier::ResolveMethodAndCheckAccess.
+    MethodType method_type = static_cast<MethodType>(dependency.lookup);
+    ArtMethod* method = nullptr;
+    if (method_type == METHOD_DIRECT || method_type == METHOD_STATIC) {
+      method = klass->FindDirectMethod(dependency.name, dependency.signature, pointer_size);
+    } else if (method_type == METHOD_INTERFACE) {
+      method = klass->FindInterfaceMethod(dependency.name, dependency.signature, pointer_size);
+    } else {
+      method = klass->FindVirtualMethod(dependency.name, dependency.signature, pointer_size);
+    }
+    if (method == nullptr && (method_type == METHOD_INTERFACE || method_type == METHOD_VIRTUAL)) {
+      method = klass->FindDirectMethod(dependency.name, dependency.signature, pointer_size);
+    }
+    if (!MatchesMember(dependency,
+                       (method != nullptr) ? method->GetDeclaringClass() : nullptr,
+                       (method != nullptr) ? method->GetAccessFlags() : 0u)) {
+      return false;
+    }
+  }
+
+  for (const AssignabilityDependency& dependency : entry.assignabilities) {
+    destination.Assign(FindClass(self, dependency.destination, class_loader));
+    if (destination.Get() == nullptr) {
+      return false;
+    }
+    source.Assign(nullptr);
+    if (!dependency.source.empty()) {
+      source.Assign(FindClass(self, dependency.source, class_loader));
+      if (source.Get() == nullptr) {
+        return false;
+      }
+    }
+    // Mirror the decision taken in RegType::AssignableFrom.
+    bool is_assignable = (!dependency.is_strict && destination->IsInterface()) ||
+        (source.Get() != nullptr && destination->IsAssignableFrom(source.Get()));
+    if (is_assignable != dependency.is_assignable) {
+      return false;
+    }
+  }
+
+  for (const ClassJoinDependency& dependency : entry.class_joins) {
+    destination.Assign(FindClass(self, dependency.lhs, class_loader));
+    source.Assign(FindClass(self, dependency.rhs, class_loader));
+    if (destination.Get() == nullptr || source.Get() == nullptr) {
+      return false;
+    }
+    if (DescriptorOf(RegType::ClassJoin(destination.Get(), source.Get())) != dependency.join) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t VerificationCache::Size() {
+  MutexLock mu(Thread::Current(), lock_);
+  return entries_.size();
+}
+
+/**
+ * Serialization format, one record per line:
+ *    verification-cache-v2
+ *    C,dex_location_checksum,class_descriptor,code_hash,failure_kind
+ *    A,is_strict,is_assignable,destination_descriptor,source_descriptor
+ *    R,is_resolved,access_flags,is_same_class_loader,descriptor,superclass_descriptor
+ *    F,access_flags,class_descriptor,name,type_descriptor,declaring_class_descriptor
+ *    M,method_type,access_flags,class_descriptor,name,signature,declaring_class_descriptor
+ *    J,lhs_descriptor,rhs_descriptor,join_descriptor
+ *    ...
+ * Dependency records belong to the closest preceding class record. Type descriptors, member
+ * names and signatures cannot contain the field separator. Fields which may be empty come last.
+ **/
+bool VerificationCache::Save(std::string* error_msg) {
+  std::ostringstream os;
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    if (!dirty_) {
+      return true;
+    }
+    os << kCacheMagic << kLineSeparator;
+    for (const auto& pair : entries_) {
+      const ClassEntry& entry = pair.second;
+      os << kClassTag
+          << kFieldSeparator << pair.first.first
+          << kFieldSeparator << pair.first.second
+          << kFieldSeparator << entry.code_hash
+          << kFieldSeparator << static_cast<uint32_t>(entry.result)
+          << kLineSeparator;
+      for (const AssignabilityDependency& dependency : entry.assignabilities) {
+        os << kAssignabilityTag
+            << kFieldSeparator << (dependency.is_strict ? 1 : 0)
+            << kFieldSeparator << (dependency.is_assignable ? 1 : 0)
+            << kFieldSeparator << dependency.destination
+            << kFieldSeparator << dependency.source
+            << kLineSeparator;
+      }
+      for (const ClassResolutionDependency& dependency : entry.classes) {
+        os << kClassResolutionTag
+            << kFieldSeparator << (dependency.is_resolved ? 1 : 0)
+            << kFieldSeparator << dependency.access_flags
+            << kFieldSeparator << (dependency.is_same_class_loader ? 1 : 0)
+            << kFieldSeparator << dependency.descriptor
+            << kFieldSeparator << dependency.superclass
+            << kLineSeparator;
+      }
+      for (const MemberResolutionDependency& dependency : entry.fields) {
+        os << kFieldResolutionTag
+            << kFieldSeparator << dependency.access_flags
+            << kFieldSeparator << dependency.klass
+            << kFieldSeparator << dependency.name
+            << kFieldSeparator << dependency.signature
+            << kFieldSeparator << dependency.declaring_class
+            << kLineSeparator;
+      }
+      for (const MemberResolutionDependency& dependency : entry.methods) {
+        os << kMethodResolutionTag
+            << kFieldSeparator << dependency.lookup
+            << kFieldSeparator << dependency.access_flags
+            << kFieldSeparator << dependency.klass
+            << kFieldSeparator << dependency.name
+            << kFieldSeparator << dependency.signature
+            << kFieldSeparator << dependency.declaring_class
+            << kLineSeparator;
+      }
+      for (const ClassJoinDependency& dependency : entry.class_joins) {
+        os << kClassJoinTag
+            << kFieldSeparator << dependency.lhs
+            << kFieldSeparator << dependency.rhs
+            << kFieldSeparator << dependency.join
+            << kLineSeparator;
+      }
+    }
+    dirty_ = false;
+  }
+
+  std::unique_ptr<File> file(OS::CreateEmptyFile(filename_.c_str()));
+  if (file.get() == nullptr) {
+    *error_msg = StringPrintf("Failed to create verification cache file '%s'", filename_.c_str());
+    return false;
+  }
+  const std::string data = os.str();
+  if (!file->WriteFully(data.c_str(), data.length())) {
+    file->Erase();
+    *error_msg = StringPrintf("Failed to write verification cache file '%s'", filename_.c_str());
+    return false;
+  }
+  if (file->FlushCloseOrErase() != 0) {
+    *error_msg = StringPrintf("Failed to flush verification cache file '%s'", filename_.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool VerificationCache::Load(std::string* error_msg) {
+  if (!OS::FileExists(filename_.c_str())) {
+    return true;
+  }
+  std::string data;
+  if (!ReadFileToString(filename_, &data)) {
+    *error_msg = StringPrintf("Failed to read verification cache file '%s'", filename_.c_str());
+    return false;
+  }
+  std::vector<std::string> lines;
+  Split(data, kLineSeparator, &lines);
+  if (lines.empty() || lines[0] != kCacheMagic) {
+    *error_msg = StringPrintf("Bad verification cache header in '%s'", filename_.c_str());
+    return false;
+  }
+
+  std::map<ClassKey, ClassEntry> entries;
+  ClassEntry* current = nullptr;
+  std::vector<std::string> fields;
+  for (size_t i = 1; i < lines.size(); ++i) {
+    fields.clear();
+    Split(lines[i], kFieldSeparator, &fields);
+    bool ok = false;
+    if (fields.size() == 5u && fields[0].size() == 1u && fields[0][0] == kClassTag) {
+      uint32_t checksum;
+      uint32_t code_hash;
+      uint32_t result;
+      if (ParseUint(fields[1].c_str(), &checksum) &&
+          ParseUint(fields[3].c_str(), &code_hash) &&
+          ParseUint(fields[4].c_str(), &result) &&
+          result < static_cast<uint32_t>(MethodVerifier::kHardFailure)) {
+        current = &entries[ClassKey(checksum, fields[2])];
+        current->code_hash = code_hash;
+        current->result = static_cast<MethodVerifier::FailureKind>(result);
+        ok = true;
+      }
+    } else if (current != nullptr &&
+               (fields.size() == 5u || fields.size() == 4u) &&
+               fields[0].size() == 1u && fields[0][0] == kAssignabilityTag) {
+      // Split() drops a trailing empty source descriptor.
+      AssignabilityDependency dependency;
+      dependency.is_strict = (fields[1] == "1");
+      dependency.is_assignable = (fields[2] == "1");
+      dependency.destination = fields[3];
+      dependency.source = (fields.size() == 5u) ? fields[4] : std::string();
+      current->assignabilities.insert(dependency);
+      ok = true;
+    } else if (current != nullptr &&
+               (fields.size() == 6u || fields.size() == 5u) &&
+               fields[0].size() == 1u && fields[0][0] == kClassResolutionTag) {
+      ClassResolutionDependency dependency;
+      if (ParseUint(fields[2].c_str(), &dependency.access_flags)) {
+        dependency.is_resolved = (fields[1] == "1");
+        dependency.is_same_class_loader = (fields[3] == "1");
+        dependency.descriptor = fields[4];
+        dependency.superclass = (fields.size() == 6u) ? fields[5] : std::string();
+        current->classes.insert(dependency);
+        ok = true;
+      }
+    } else if (current != nullptr &&
+               (fields.size() == 6u || fields.size() == 5u) &&
+               fields[0].size() == 1u && fields[0][0] == kFieldResolutionTag) {
+      MemberResolutionDependency dependency;
+      if (ParseUint(fields[1].c_str(), &dependency.access_flags)) {
+        dependency.klass = fields[2];
+        dependency.name = fields[3];
+        dependency.signature = fields[4];
+        dependency.lookup = 0u;
+        dependency.declaring_class = (fields.size() == 6u) ? fields[5] : std::string();
+        current->fields.insert(dependency);
+        ok = true;
+      }
+    } else if (current != nullptr &&
+               (fields.size() == 7u || fields.size() == 6u) &&
+               fields[0].size() == 1u && fields[0][0] == kMethodResolutionTag) {
+      MemberResolutionDependency dependency;
+      if (ParseUint(fields[1].c_str(), &dependency.lookup) &&
+          ParseUint(fields[2].c_str(), &dependency.access_flags)) {
+        dependency.klass = fields[3];
+        dependency.name = fields[4];
+        dependency.signature = fields[5];
+        dependency.declaring_class = (fields.size() == 7u) ? fields[6] : std::string();
+        current->methods.insert(dependency);
+        ok = true;
+      }
+    } else if (current != nullptr &&
+               fields.size() == 4u &&
+               fields[0].size() == 1u && fields[0][0] == kClassJoinTag) {
+      ClassJoinDependency dependency;
+      dependency.lhs = fields[1];
+      dependency.rhs = fields[2];
+      dependency.join = fields[3];
+      current->class_joins.insert(dependency);
+      ok = true;
+    }
+    if (!ok) {
+      *error_msg = StringPrintf("Malformed verification cache record %zu in '%s'",
+                                i,
+                                filename_.c_str());
+      return false;
+    }
+  }
+
+  MutexLock mu(Thread::Current(), lock_);
+  entries_.swap(entries);
+  dirty_ = false;
+  return true;
+}
+
+}  // namespace verifier
+}  // namespace art
@@ -0,0 +1,280 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_VERIFIER_VERIFICATION_CACHE_H_
+#define ART_RUNTIME_VERIFIER_VERIFICATION_CACHE_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "dex_file.h"
+#include "handle.h"
+#include "method_verifier.h"
+
+namespace art {
+
+class ArtField;
+class ArtMethod;
+
+namespace mirror {
+class Class;
+class ClassLoader;
+}  // namespace mirror
+
+namespace verifier {
+
+class RegType;
+
+// An assignability decision the verifier made between two resolved classes.
+struct AssignabilityDependency {
+  std::string destination;
+  std::string source;
+  bool is_strict;
+  bool is_assignable;
+
+  bool operator<(const AssignabilityDependency& other) const {
+    if (destination != other.destination) {
+      return destination < other.destination;
+    }
+    if (source != other.source) {
+      return source < other.source;
+    }
+    if (is_strict != other.is_strict) {
+      return is_strict < other.is_strict;
+    }
+    return is_assignable < other.is_assignable;
+  }
+};
+
+// How the verifier resolved a type descriptor through the loader of the verified class. The
+// access flags, defining loader and superclass decide the access checks and the hierarchy
+// based decisions that are not recorded as assignabilities.
+struct ClassResolutionDependency {
+  std::string descriptor;
+  bool is_resolved;
+  uint32_t access_flags;
+  bool is_same_class_loader;
+  std::string superclass;
+
+  bool operator<(const ClassResolutionDependency& other) const {
+    return std::tie(descriptor, is_resolved, access_flags, is_same_class_loader, superclass) <
+        std::tie(other.descriptor,
+                 other.is_resolved,
+                 other.access_flags,
+                 other.is_same_class_loader,
+                 other.superclass);
+  }
+};
+
+// How the verifier resolved a field or method reference. For fields, `lookup` is unused and
+// `signature` holds the field type; for methods, `lookup` is the MethodType of the invoke.
+// `declaring_class` is empty if the member did not resolve.
+struct MemberResolutionDependency {
+  std::string klass;
+  std::string name;
+  std::string signature;
+  uint32_t lookup;
+  std::string declaring_class;
+  uint32_t access_flags;
+
+  bool operator<(const MemberResolutionDependency& other) const {
+    return std::tie(klass, name, signature, lookup, declaring_class, access_flags) <
+        std::tie(other.klass,
+                 other.name,
+                 other.signature,
+                 other.lookup,
+                 other.declaring_class,
+                 other.access_flags);
+  }
+};
+
+// The common superclass the verifier computed when merging two resolved reference types.
+struct ClassJoinDependency {
+  std::string lhs;
+  std::string rhs;
+  std::string join;
+
+  bool operator<(const ClassJoinDependency& other) const {
+    return std::tie(lhs, rhs, join) < std::tie(other.lhs, other.rhs, other.join);
+  }
+};
+
+// The dependencies collected while verifying the methods of a single class.
+class VerificationDependencies {
+ public:
+  VerificationDependencies() {}
+
+  void AddAssignability(const RegType& destination,
+                        const RegType& source,
+                        bool is_strict,
+                        bool is_assignable)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Record that `descriptor` resolved to `klass` (null if unresolved) through `class_loader`.
+  void AddClassResolution(const char* descriptor,
+                          mirror::Class* klass,
+                          mirror::ClassLoader* class_loader)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Record that field `field_idx` of `dex_file` resolved to `field` (null if unresolved).
+  void AddFieldResolution(const DexFile& dex_file, uint32_t field_idx, ArtField* field)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Record that method `method_idx` of `dex_file`, invoked with `method_type`, resolved to
+  // `method` (null if unresolved).
+  void AddMethodResolution(const DexFile& dex_file,
+                           uint32_t method_idx,
+                           MethodType method_type,
+                           ArtMethod* method)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  void AddClassJoin(mirror::Class* lhs, mirror::Class* rhs, mirror::Class* join)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  const std::set<AssignabilityDependency>& GetAssignabilities() const {
+    return assignabilities_;
+  }
+
+  const std::set<ClassResolutionDependency>& GetClasses() const {
+    return classes_;
+  }
+
+  const std::set<MemberResolutionDependency>& GetFields() const {
+    return fields_;
+  }
+
+  const std::set<MemberResolutionDependency>& GetMethods() const {
+    return methods_;
+  }
+
+  const std::set<ClassJoinDependency>& GetClassJoins() const {
+    return class_joins_;
+  }
+
+ private:
+  std::set<AssignabilityDependency> assignabilities_;
+  std::set<ClassResolutionDependency> classes_;
+  std::set<MemberResolutionDependency> fields_;
+  std::set<MemberResolutionDependency> methods_;
+  std::set<ClassJoinDependency> class_joins_;
+
+  DISALLOW_COPY_AND_ASSIGN(VerificationDependencies);
+};
+
+// A cache of class verification outcomes. Each entry is keyed by the class descriptor and the
+// location checksum of its dex file, and tagged with a hash of the class' code items. Alongside
+// the outcome we record what the verifier looked up in the class path: how types, fields and
+// methods resolved (including the access flags the access checks used), the assignability
+// decisions between resolved classes and the joins of merged types. A later verification of the
+// same class (in another dex2oat run, or at runtime when the oat file has no usable verification
+// status) may reuse the outcome as long as all recorded lookups still give the same answers.
+class VerificationCache {
+ public:
+  explicit VerificationCache(const std::string& filename);
+  ~VerificationCache();
+
+  const std::string& GetFilename() const {
+    return filename_;
+  }
+
+  // Read entries from the backing file, if it exists. Returns false and sets `error_msg` if the
+  // file exists but is malformed.
+  bool Load(std::string* error_msg) REQUIRES(!lock_);
+
+  // Write all entries to the backing file. Only does work if entries were added since the last
+  // Load() or Save().
+  bool Save(std::string* error_msg) REQUIRES(!lock_);
+
+  // Record the outcome of verifying `class_def`. Hard failures are never recorded, as the class
+  // linker needs the precise error message to throw.
+  void Put(const DexFile& dex_file,
+           const DexFile::ClassDef& class_def,
+           MethodVerifier::FailureKind result,
+           const VerificationDependencies& dependencies)
+      REQUIRES(!lock_);
+
+  // Look up a previous verification outcome for `class_def`. Returns true and sets `result` if
+  // an entry exists, the code items of the class are unchanged and every recorded dependency
+  // still holds when resolved through `class_loader`.
+  bool Lookup(Thread* self,
+              const DexFile& dex_file,
+              const DexFile::ClassDef& class_def,
+              Handle<mirror::ClassLoader> class_loader,
+              MethodVerifier::FailureKind* result)
+      SHARED_REQUIRES(Locks::mutator_lock_)
+      REQUIRES(!lock_);
+
+  size_t Size() REQUIRES(!lock_);
+
+  // Hash of the code items and method signatures of the class, used to detect changed classes
+  // that happen to keep their descriptor and dex location checksum.
+  static uint32_t ComputeCodeHash(const DexFile& dex_file, const DexFile::ClassDef& class_def);
+
+  // Record an assignability decision taken by the verifier running on the current thread, if it
+  // is collecting dependencies.
+  static void MaybeRecordAssignability(const RegType& destination,
+                                       const RegType& source,
+                                       bool is_strict,
+                                       bool is_assignable)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Same as above for class resolutions done by the register type cache through the loader of
+  // the verified class.
+  static void MaybeRecordClassResolution(const char* descriptor, mirror::Class* klass)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+  // Same as above for the joins computed when merging register types.
+  static void MaybeRecordClassJoin(mirror::Class* lhs, mirror::Class* rhs, mirror::Class* join)
+      SHARED_REQUIRES(Locks::mutator_lock_);
+
+ private:
+  struct ClassEntry {
+    uint32_t code_hash;
+    MethodVerifier::FailureKind result;
+    std::set<AssignabilityDependency> assignabilities;
+    std::set<ClassResolutionDependency> classes;
+    std::set<MemberResolutionDependency> fields;
+    std::set<MemberResolutionDependency> methods;
+    std::set<ClassJoinDependency> class_joins;
+  };
+
+  // Keyed by (dex location checksum, class descriptor).
+  typedef std::pair<uint32_t, std::string> ClassKey;
+
+  bool ValidateDependencies(Thread* self,
+                            const ClassEntry& entry,
+                            Handle<mirror::ClassLoader> class_loader)
+      SHARED_REQUIRES(Locks::mutator_lock_)
+      REQUIRES(!lock_);
+
+  const std::string filename_;
+
+  Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::map<ClassKey, ClassEntry> entries_ GUARDED_BY(lock_);
+  bool dirty_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(VerificationCache);
+};
+
+}  // namespace verifier
+}  // namespace art
+
+#endif  // ART_RUNTIME_VERIFIER_VERIFICATION_CACHE_H_
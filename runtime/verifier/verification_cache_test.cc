@@ -0,0 +1,267 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "verification_cache.h"
+
+#include <unistd.h>
+#include <memory>
+
+#include "art_field-inl.h"
+#include "art_method-inl.h"
+#include "base/scoped_arena_allocator.h"
+#include "class_linker-inl.h"
+#include "common_runtime_test.h"
+#include "dex_file.h"
+#include "handle_scope-inl.h"
+#include "reg_type_cache-inl.h"
+#include "reg_type-inl.h"
+#include "scoped_thread_state_change.h"
+#include "utf.h"
+
+namespace art {
+namespace verifier {
+
+class VerificationCacheTest : public CommonRuntimeTest {
+ protected:
+  void PostRuntimeCreate() OVERRIDE {
+    stack_.reset(new ArenaStack(Runtime::Current()->GetArenaPool()));
+    allocator_.reset(new ScopedArenaAllocator(stack_.get()));
+  }
+
+  const DexFile::ClassDef* FindClassDef(const char* descriptor) {
+    return java_lang_dex_file_->FindClassDef(descriptor, ComputeModifiedUtf8Hash(descriptor));
+  }
+
+  // Caches `dependencies` for java.lang.Object and returns whether the entry is then found
+  // valid against the boot class path.
+  bool PutAndLookup(const VerificationDependencies& dependencies)
+      SHARED_REQUIRES(Locks::mutator_lock_) {
+    ScratchFile tmp;
+    tmp.Unlink();
+    VerificationCache cache(tmp.GetFilename());
+    const DexFile::ClassDef* class_def = FindClassDef("Ljava/lang/Object;");
+    EXPECT_TRUE(class_def != nullptr);
+    cache.Put(*java_lang_dex_file_, *class_def, MethodVerifier::kNoFailure, dependencies);
+    Thread* self = Thread::Current();
+    StackHandleScope<1> hs(self);
+    Handle<mirror::ClassLoader> class_loader(hs.NewHandle<mirror::ClassLoader>(nullptr));
+    MethodVerifier::FailureKind result;
+    return cache.Lookup(self, *java_lang_dex_file_, *class_def, class_loader, &result);
+  }
+
+  mirror::Class* FindSystemClass(const char* descriptor) SHARED_REQUIRES(Locks::mutator_lock_) {
+    return class_linker_->FindSystemClass(Thread::Current(), descriptor);
+  }
+
+  std::unique_ptr<ArenaStack> stack_;
+  std::unique_ptr<ScopedArenaAllocator> allocator_;
+};
+
+TEST_F(VerificationCacheTest, SaveAndLoad) {
+  ScopedObjectAccess soa(Thread::Current());
+  ScratchFile tmp;
+  tmp.Unlink();
+  const std::string filename = tmp.GetFilename();
+
+  const DexFile::ClassDef* class_def = FindClassDef("Ljava/lang/Object;");
+  ASSERT_TRUE(class_def != nullptr);
+  {
+    VerificationCache cache(filename);
+    VerificationDependencies dependencies;
+    RegTypeCache reg_types(true, *allocator_);
+    dependencies.AddAssignability(reg_types.JavaLangObject(false),
+                                  reg_types.JavaLangString(),
+                                  /* is_strict */ false,
+                                  /* is_assignable */ true);
+    cache.Put(*java_lang_dex_file_, *class_def, MethodVerifier::kNoFailure, dependencies);
+    EXPECT_EQ(1u, cache.Size());
+    std::string error_msg;
+    ASSERT_TRUE(cache.Save(&error_msg)) << error_msg;
+  }
+
+  VerificationCache cache(filename);
+  std::string error_msg;
+  ASSERT_TRUE(cache.Load(&error_msg)) << error_msg;
+  EXPECT_EQ(1u, cache.Size());
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::ClassLoader> class_loader(hs.NewHandle<mirror::ClassLoader>(nullptr));
+  MethodVerifier::FailureKind result = MethodVerifier::kHardFailure;
+  EXPECT_TRUE(cache.Lookup(soa.Self(), *java_lang_dex_file_, *class_def, class_loader, &result));
+  EXPECT_EQ(MethodVerifier::kNoFailure, result);
+
+  // Classes without an entry miss.
+  const DexFile::ClassDef* string_def = FindClassDef("Ljava/lang/String;");
+  ASSERT_TRUE(string_def != nullptr);
+  EXPECT_FALSE(cache.Lookup(soa.Self(), *java_lang_dex_file_, *string_def, class_loader, &result));
+  unlink(filename.c_str());
+}
+
+TEST_F(VerificationCacheTest, BrokenDependency) {
+  ScopedObjectAccess soa(Thread::Current());
+  ScratchFile tmp;
+  tmp.Unlink();
+  VerificationCache cache(tmp.GetFilename());
+
+  const DexFile::ClassDef* class_def = FindClassDef("Ljava/lang/Object;");
+  ASSERT_TRUE(class_def != nullptr);
+  VerificationDependencies dependencies;
+  RegTypeCache reg_types(true, *allocator_);
+  // Pretend String was not assignable to Object when the class was verified.
+  dependencies.AddAssignability(reg_types.JavaLangObject(false),
+                                reg_types.JavaLangString(),
+                                /* is_strict */ true,
+                                /* is_assignable */ false);
+  cache.Put(*java_lang_dex_file_, *class_def, MethodVerifier::kSoftFailure, dependencies);
+
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::ClassLoader> class_loader(hs.NewHandle<mirror::ClassLoader>(nullptr));
+  MethodVerifier::FailureKind result = MethodVerifier::kHardFailure;
+  EXPECT_FALSE(cache.Lookup(soa.Self(), *java_lang_dex_file_, *class_def, class_loader, &result));
+  EXPECT_EQ(MethodVerifier::kHardFailure, result);
+}
+
+TEST_F(VerificationCacheTest, HardFailuresAreNotCached) {
+  ScopedObjectAccess soa(Thread::Current());
+  ScratchFile tmp;
+  tmp.Unlink();
+  VerificationCache cache(tmp.GetFilename());
+
+  const DexFile::ClassDef* class_def = FindClassDef("Ljava/lang/Object;");
+  ASSERT_TRUE(class_def != nullptr);
+  VerificationDependencies dependencies;
+  cache.Put(*java_lang_dex_file_, *class_def, MethodVerifier::kHardFailure, dependencies);
+  EXPECT_EQ(0u, cache.Size());
+}
+
+TEST_F(VerificationCacheTest, ClassResolution) {
+  ScopedObjectAccess soa(Thread::Current());
+  mirror::Class* string_class = FindSystemClass("Ljava/lang/String;");
+  mirror::Class* object_class = FindSystemClass("Ljava/lang/Object;");
+  {
+    VerificationDependencies dependencies;
+    dependencies.AddClassResolution("Ljava/lang/String;", string_class, nullptr);
+    dependencies.AddClassResolution("LDoesNotExist;", nullptr, nullptr);
+    EXPECT_TRUE(PutAndLookup(dependencies));
+  }
+  {
+    // A class now resolves to a class with other access flags and another superclass.
+    VerificationDependencies dependencies;
+    dependencies.AddClassResolution("Ljava/lang/String;", object_class, nullptr);
+    EXPECT_FALSE(PutAndLookup(dependencies));
+  }
+  {
+    // A class that did not resolve now does.
+    VerificationDependencies dependencies;
+    dependencies.AddClassResolution("Ljava/lang/String;", nullptr, nullptr);
+    EXPECT_FALSE(PutAndLookup(dependencies));
+  }
+}
+
+TEST_F(VerificationCacheTest, MemberResolution) {
+  ScopedObjectAccess soa(Thread::Current());
+  size_t pointer_size = class_linker_->GetImagePointerSize();
+  mirror::Class* string_class = FindSystemClass("Ljava/lang/String;");
+  ArtMethod* length = string_class->FindVirtualMethod("length", "()I", pointer_size);
+  ASSERT_TRUE(length != nullptr);
+  ArtField* count = string_class->FindDeclaredInstanceField("count", "I");
+  ASSERT_TRUE(count != nullptr);
+  ASSERT_EQ(java_lang_dex_file_, length->GetDexFile());
+  ASSERT_EQ(java_lang_dex_file_, count->GetDexFile());
+  {
+    VerificationDependencies dependencies;
+    dependencies.AddMethodResolution(
+        *java_lang_dex_file_, length->GetDexMethodIndex(), METHOD_VIRTUAL, length);
+    dependencies.AddFieldResolution(*java_lang_dex_file_, count->GetDexFieldIndex(), count);
+    EXPECT_TRUE(PutAndLookup(dependencies));
+  }
+  {
+    // The method was not found, or was looked up as a static method.
+    VerificationDependencies dependencies;
+    dependencies.AddMethodResolution(
+        *java_lang_dex_file_, length->GetDexMethodIndex(), METHOD_VIRTUAL, nullptr);
+    EXPECT_FALSE(PutAndLookup(dependencies));
+  }
+  {
+    VerificationDependencies dependencies;
+    dependencies.AddMethodResolution(
+        *java_lang_dex_file_, length->GetDexMethodIndex(), METHOD_STATIC, length);
+    EXPECT_FALSE(PutAndLookup(dependencies));
+  }
+  {
+    VerificationDependencies dependencies;
+    dependencies.AddFieldResolution(*java_lang_dex_file_, count->GetDexFieldIndex(), nullptr);
+    EXPECT_FALSE(PutAndLookup(dependencies));
+  }
+}
+
+TEST_F(VerificationCacheTest, ClassJoin) {
+  ScopedObjectAccess soa(Thread::Current());
+  mirror::Class* string_class = FindSystemClass("Ljava/lang/String;");
+  mirror::Class* integer_class = FindSystemClass("Ljava/lang/Integer;");
+  mirror::Class* number_class = FindSystemClass("Ljava/lang/Number;");
+  mirror::Class* object_class = FindSystemClass("Ljava/lang/Object;");
+  {
+    VerificationDependencies dependencies;
+    dependencies.AddClassJoin(string_class, integer_class, object_class);
+    EXPECT_TRUE(PutAndLookup(dependencies));
+  }
+  {
+    VerificationDependencies dependencies;
+    dependencies.AddClassJoin(string_class, integer_class, number_class);
+    EXPECT_FALSE(PutAndLookup(dependencies));
+  }
+}
+
+TEST_F(VerificationCacheTest, SaveAndLoadResolutions) {
+  ScopedObjectAccess soa(Thread::Current());
+  ScratchFile tmp;
+  tmp.Unlink();
+  const std::string filename = tmp.GetFilename();
+  size_t pointer_size = class_linker_->GetImagePointerSize();
+  mirror::Class* string_class = FindSystemClass("Ljava/lang/String;");
+  mirror::Class* object_class = FindSystemClass("Ljava/lang/Object;");
+  ArtMethod* length = string_class->FindVirtualMethod("length", "()I", pointer_size);
+  ASSERT_TRUE(length != nullptr);
+  const DexFile::ClassDef* class_def = FindClassDef("Ljava/lang/Object;");
+  ASSERT_TRUE(class_def != nullptr);
+  {
+    VerificationCache cache(filename);
+    VerificationDependencies dependencies;
+    dependencies.AddClassResolution("Ljava/lang/Object;", object_class, nullptr);
+    dependencies.AddClassResolution("LDoesNotExist;", nullptr, nullptr);
+    dependencies.AddMethodResolution(
+        *java_lang_dex_file_, length->GetDexMethodIndex(), METHOD_DIRECT, nullptr);
+    dependencies.AddClassJoin(string_class, object_class, object_class);
+    cache.Put(*java_lang_dex_file_, *class_def, MethodVerifier::kNoFailure, dependencies);
+    std::string error_msg;
+    ASSERT_TRUE(cache.Save(&error_msg)) << error_msg;
+  }
+
+  // The records with empty trailing fields (no superclass, unresolved method) survive the
+  // round trip. The direct method lookup of String.length() fails, as recorded.
+  VerificationCache cache(filename);
+  std::string error_msg;
+  ASSERT_TRUE(cache.Load(&error_msg)) << error_msg;
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::ClassLoader> class_loader(hs.NewHandle<mirror::ClassLoader>(nullptr));
+  MethodVerifier::FailureKind result = MethodVerifier::kHardFailure;
+  EXPECT_TRUE(cache.Lookup(soa.Self(), *java_lang_dex_file_, *class_def, class_loader, &result));
+  EXPECT_EQ(MethodVerifier::kNoFailure, result);
+  unlink(filename.c_str());
+}
+
+}  // namespace verifier
+}  // namespace art
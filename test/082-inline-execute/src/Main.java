@@ -86,6 +86,8 @@ public class Main {
     test_Long_rotateLeft();
     test_Integer_rotateRightLeft();
     test_Long_rotateRightLeft();
+    test_Arrays_equals_B();
+    test_Arrays_equals_I();
   }
 
   /**
@@ -1500,4 +1502,48 @@ public class Main {
                           Long.rotateRight(0xBBAAAADDFF0000DDL, i));
     }
   }
+
+  public static void test_Arrays_equals_B() {
+    Assert.assertTrue(Arrays.equals((byte[]) null, (byte[]) null));
+    Assert.assertFalse(Arrays.equals(new byte[0], (byte[]) null));
+    Assert.assertFalse(Arrays.equals((byte[]) null, new byte[0]));
+    Assert.assertFalse(Arrays.equals(new byte[1], new byte[2]));
+    // Cover every tail length and a difference in every position, including the last byte.
+    for (int length = 0; length <= 40; length++) {
+      byte[] a = new byte[length];
+      for (int i = 0; i < length; i++) {
+        a[i] = (byte) (i * 7 + 1);
+      }
+      Assert.assertTrue(Arrays.equals(a, a));
+      Assert.assertTrue(Arrays.equals(a, a.clone()));
+      for (int i = 0; i < length; i++) {
+        byte[] b = a.clone();
+        b[i]++;
+        Assert.assertFalse(Arrays.equals(a, b));
+        Assert.assertFalse(Arrays.equals(b, a));
+      }
+    }
+  }
+
+  public static void test_Arrays_equals_I() {
+    Assert.assertTrue(Arrays.equals((int[]) null, (int[]) null));
+    Assert.assertFalse(Arrays.equals(new int[0], (int[]) null));
+    Assert.assertFalse(Arrays.equals((int[]) null, new int[0]));
+    Assert.assertFalse(Arrays.equals(new int[1], new int[2]));
+    // Cover every tail length and a difference in every position, including the last int.
+    for (int length = 0; length <= 12; length++) {
+      int[] a = new int[length];
+      for (int i = 0; i < length; i++) {
+        a[i] = i * 0x01010101 + 1;
+      }
+      Assert.assertTrue(Arrays.equals(a, a));
+      Assert.assertTrue(Arrays.equals(a, a.clone()));
+      for (int i = 0; i < length; i++) {
+        int[] b = a.clone();
+        b[i] ^= 0x80000000;
+        Assert.assertFalse(Arrays.equals(a, b));
+        Assert.assertFalse(Arrays.equals(b, a));
+      }
+    }
+  }
 }
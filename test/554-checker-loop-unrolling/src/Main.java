@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  /// CHECK-START: int Main.fullyUnrolled() loop_unrolling (before)
+  /// CHECK-DAG: Phi loop:{{B\d+}}
+
+  /// CHECK-START: int Main.fullyUnrolled() loop_unrolling (after)
+  /// CHECK-DAG: Add loop:none
+  /// CHECK-DAG: Add loop:none
+  /// CHECK-DAG: Add loop:none
+  /// CHECK-DAG: Add loop:none
+
+  /// CHECK-START: int Main.fullyUnrolled() dead_code_elimination_final (after)
+  /// CHECK-NOT: Phi
+  /// CHECK-NOT: If
+
+  /// CHECK-START: int Main.fullyUnrolled() dead_code_elimination_final (after)
+  /// CHECK-DAG: <<Const:i\d+>> IntConstant 6
+  /// CHECK-DAG:                Return [<<Const>>]
+
+  public static int fullyUnrolled() {
+    int sum = 0;
+    for (int i = 0; i < 4; ++i) {
+      sum += i;
+    }
+    return sum;
+  }
+
+  /// CHECK-START: int Main.singleTrip() dead_code_elimination_final (after)
+  /// CHECK-NOT: Phi
+  /// CHECK-NOT: If
+
+  /// CHECK-START: int Main.singleTrip() dead_code_elimination_final (after)
+  /// CHECK-DAG: <<Const:i\d+>> IntConstant 7
+  /// CHECK-DAG:                Return [<<Const>>]
+
+  public static int singleTrip() {
+    int sum = 7;
+    for (int i = 0; i < 1; ++i) {
+      sum *= i + 1;
+    }
+    return sum;
+  }
+
+  // A loop which is never entered is left alone.
+
+  /// CHECK-START: int Main.zeroTrips() loop_unrolling (after)
+  /// CHECK-DAG: Phi loop:{{B\d+}}
+  /// CHECK-NOT: Add loop:none
+
+  public static int zeroTrips() {
+    int sum = 0;
+    for (int i = 0; i < 0; ++i) {
+      sum += i;
+    }
+    return sum;
+  }
+
+  // The trip count is not a multiple of the unrolling factor: the first iteration
+  // is peeled into the pre-header, and the loop runs several copies of its body.
+
+  /// CHECK-START: int Main.partiallyUnrolled() loop_unrolling (before)
+  /// CHECK-NOT: Add loop:none
+
+  /// CHECK-START: int Main.partiallyUnrolled() loop_unrolling (after)
+  /// CHECK-DAG: Add loop:none
+  /// CHECK-DAG: Add loop:none
+  /// CHECK-DAG: Add loop:<<Loop:B\d+>>
+  /// CHECK-DAG: Add loop:<<Loop>>
+  /// CHECK-DAG: Add loop:<<Loop>>
+  /// CHECK-DAG: Add loop:<<Loop>>
+
+  public static int partiallyUnrolled() {
+    int sum = 0;
+    for (int i = 0; i < 101; ++i) {
+      sum += i;
+    }
+    return sum;
+  }
+
+  // Without a known trip count, the loop is peeled once behind a copy of its exit
+  // test so that the null check only runs in the peeled iteration. The sum leaves
+  // through a new phi, since the peeled exit test may skip the loop.
+
+  /// CHECK-START: int Main.peeled(int[], int) loop_unrolling (before)
+  /// CHECK-DAG: NullCheck loop:{{B\d+}}
+  /// CHECK-DAG: ArrayLength loop:{{B\d+}}
+
+  /// CHECK-START: int Main.peeled(int[], int) loop_unrolling (after)
+  /// CHECK-NOT: NullCheck loop:{{B\d+}}
+
+  /// CHECK-START: int Main.peeled(int[], int) loop_unrolling (after)
+  /// CHECK-DAG: <<Zero:i\d+>> IntConstant 0
+  /// CHECK-DAG:               NullCheck loop:none
+  /// CHECK-DAG:               ArrayLength loop:none
+  /// CHECK-DAG: <<Sum:i\d+>>  Phi [{{i\d+}},{{i\d+}}] loop:{{B\d+}}
+  /// CHECK-DAG: <<Exit:i\d+>> Phi [<<Sum>>,<<Zero>>] loop:none
+  /// CHECK-DAG:               Return [<<Exit>>]
+
+  public static int peeled(int[] array, int n) {
+    int sum = 0;
+    for (int i = 0; i < n; ++i) {
+      sum += array.length;
+    }
+    return sum;
+  }
+
+  public static void main(String[] args) {
+    expectEquals(6, fullyUnrolled());
+    expectEquals(7, singleTrip());
+    expectEquals(0, zeroTrips());
+    expectEquals(5050, partiallyUnrolled());
+    int[] array = new int[3];
+    expectEquals(0, peeled(array, 0));
+    expectEquals(3, peeled(array, 1));
+    expectEquals(30, peeled(array, 10));
+    expectEquals(0, peeled(null, 0));
+    try {
+      peeled(null, 1);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+      // Expected.
+    }
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
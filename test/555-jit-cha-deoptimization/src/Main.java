@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Base {
+  int getValue() {
+    return 1;
+  }
+}
+
+// Only loaded through reflection, once the JIT relied on Base.getValue() having
+// a single implementation.
+class Sub extends Base {
+  int getValue() {
+    return 2;
+  }
+}
+
+public class Main {
+  static boolean sHasJit;
+  static boolean sLoadSub;
+
+  // The call is devirtualized and inlined as long as Sub is not loaded.
+  static int callGetValue(Base b) {
+    return b.getValue();
+  }
+
+  // Loads Sub while the compiled code of this method is running. The guard in
+  // front of the inlined call must then deoptimize, and the interpreter must
+  // dispatch the call to Sub.getValue().
+  static int loadSubAndCall(Base b) {
+    Base receiver = b;
+    if (sLoadSub) {
+      receiver = newSub();
+    }
+    int result = receiver.getValue();
+    if (sHasJit) {
+      expectEquals(sLoadSub, isInterpreted());
+    }
+    return result;
+  }
+
+  static Base newSub() {
+    try {
+      return (Base) Class.forName("Sub").newInstance();
+    } catch (Exception e) {
+      throw new Error(e);
+    }
+  }
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    sHasJit = hasJit();
+    Base base = new Base();
+
+    ensureJitCompiled(Main.class, "callGetValue");
+    ensureJitCompiled(Main.class, "loadSubAndCall");
+    expectEquals(1, callGetValue(base));
+    System.out.println("Base " + loadSubAndCall(base));
+
+    // Deoptimize while running, and stop using the invalidated code.
+    sLoadSub = true;
+    System.out.println("Sub " + loadSubAndCall(base));
+    if (sHasJit) {
+      expectEquals(false, isJitCompiled(Main.class, "callGetValue"));
+      expectEquals(false, isJitCompiled(Main.class, "loadSubAndCall"));
+    }
+    Base sub = newSub();
+    System.out.println("Sub " + callGetValue(sub));
+
+    // Code compiled after the class load no longer relies on the broken
+    // assumption, and becomes the entry point again.
+    ensureJitCompiled(Main.class, "callGetValue");
+    if (sHasJit) {
+      expectEquals(true, isJitCompiled(Main.class, "callGetValue"));
+    }
+    System.out.println("Base " + callGetValue(base));
+    System.out.println("Sub " + callGetValue(sub));
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(boolean expected, boolean result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static native boolean hasJit();
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+  private static native boolean isJitCompiled(Class<?> cls, String methodName);
+  private static native boolean isInterpreted();
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  /// CHECK-START: int Main.selectInt(int, int, int, int) select_generator (before)
+  /// CHECK-DAG: <<Phi:i\d+>> Phi
+  /// CHECK-DAG:              If
+  /// CHECK-DAG:              Return [<<Phi>>]
+
+  /// CHECK-START: int Main.selectInt(int, int, int, int) select_generator (after)
+  /// CHECK-NOT: Phi
+  /// CHECK-NOT: If
+
+  /// CHECK-START: int Main.selectInt(int, int, int, int) select_generator (after)
+  /// CHECK-DAG: <<Cond:z\d+>>   GreaterThan
+  /// CHECK-DAG: <<Select:i\d+>> Select [{{i\d+}},{{i\d+}},<<Cond>>]
+  /// CHECK-DAG:                 Return [<<Select>>]
+
+  /// CHECK-START-X86_64: int Main.selectInt(int, int, int, int) disassembly (after)
+  /// CHECK:      Select
+  /// CHECK-NEXT: cmov
+
+  /// CHECK-START-ARM64: int Main.selectInt(int, int, int, int) disassembly (after)
+  /// CHECK:      Select
+  /// CHECK:      csel
+
+  public static int selectInt(int a, int b, int x, int y) {
+    return (a > b) ? x : y;
+  }
+
+  /// CHECK-START: long Main.selectLong(int, int, long, long) select_generator (after)
+  /// CHECK-NOT: Phi
+  /// CHECK-NOT: If
+
+  /// CHECK-START: long Main.selectLong(int, int, long, long) select_generator (after)
+  /// CHECK-DAG: <<Select:j\d+>> Select [{{j\d+}},{{j\d+}},{{z\d+}}]
+  /// CHECK-DAG:                 Return [<<Select>>]
+
+  /// CHECK-START-X86_64: long Main.selectLong(int, int, long, long) disassembly (after)
+  /// CHECK:      Select
+  /// CHECK-NEXT: cmov
+
+  /// CHECK-START-ARM64: long Main.selectLong(int, int, long, long) disassembly (after)
+  /// CHECK:      Select
+  /// CHECK:      csel
+
+  public static long selectLong(int a, int b, long x, long y) {
+    return (a < b) ? x : y;
+  }
+
+  /// CHECK-START: java.lang.Object Main.selectReference(int, int, java.lang.Object, java.lang.Object) select_generator (after)
+  /// CHECK-NOT: Phi
+  /// CHECK-NOT: If
+
+  /// CHECK-START: java.lang.Object Main.selectReference(int, int, java.lang.Object, java.lang.Object) select_generator (after)
+  /// CHECK-DAG: <<Select:l\d+>> Select [{{l\d+}},{{l\d+}},{{z\d+}}]
+  /// CHECK-DAG:                 Return [<<Select>>]
+
+  /// CHECK-START-X86_64: java.lang.Object Main.selectReference(int, int, java.lang.Object, java.lang.Object) disassembly (after)
+  /// CHECK:      Select
+  /// CHECK-NEXT: cmov
+
+  /// CHECK-START-ARM64: java.lang.Object Main.selectReference(int, int, java.lang.Object, java.lang.Object) disassembly (after)
+  /// CHECK:      Select
+  /// CHECK:      csel
+
+  public static Object selectReference(int a, int b, Object x, Object y) {
+    return (a == b) ? x : y;
+  }
+
+  // Floating point selects branch over a move on x86-64, and use fcsel on arm64.
+
+  /// CHECK-START: float Main.selectFloat(int, int, float, float) select_generator (after)
+  /// CHECK-NOT: Phi
+  /// CHECK-NOT: If
+
+  /// CHECK-START: float Main.selectFloat(int, int, float, float) select_generator (after)
+  /// CHECK-DAG: <<Select:f\d+>> Select [{{f\d+}},{{f\d+}},{{z\d+}}]
+  /// CHECK-DAG:                 Return [<<Select>>]
+
+  /// CHECK-START-ARM64: float Main.selectFloat(int, int, float, float) disassembly (after)
+  /// CHECK:      Select
+  /// CHECK:      fcsel
+
+  public static float selectFloat(int a, int b, float x, float y) {
+    return (a >= b) ? x : y;
+  }
+
+  /// CHECK-START: double Main.selectDouble(int, int, double, double) select_generator (after)
+  /// CHECK-NOT: Phi
+  /// CHECK-NOT: If
+
+  /// CHECK-START: double Main.selectDouble(int, int, double, double) select_generator (after)
+  /// CHECK-DAG: <<Select:d\d+>> Select [{{d\d+}},{{d\d+}},{{z\d+}}]
+  /// CHECK-DAG:                 Return [<<Select>>]
+
+  /// CHECK-START-ARM64: double Main.selectDouble(int, int, double, double) disassembly (after)
+  /// CHECK:      Select
+  /// CHECK:      fcsel
+
+  public static double selectDouble(int a, int b, double x, double y) {
+    return (a != b) ? x : y;
+  }
+
+  // Each branch computes its value, which moves in front of the select. Once GVN
+  // found both values equal, the simplifier removes the select.
+
+  /// CHECK-START: int Main.selectSameValue(int, int, int) select_generator (after)
+  /// CHECK-DAG: <<Add1:i\d+>>   Add
+  /// CHECK-DAG: <<Add2:i\d+>>   Add
+  /// CHECK-DAG: <<Select:i\d+>> Select [<<Add1>>,<<Add2>>,{{z\d+}}]
+  /// CHECK-DAG:                 Return [<<Select>>]
+
+  /// CHECK-START: int Main.selectSameValue(int, int, int) instruction_simplifier_after_bce (after)
+  /// CHECK-NOT: Select
+
+  /// CHECK-START: int Main.selectSameValue(int, int, int) instruction_simplifier_after_bce (after)
+  /// CHECK-DAG: <<Add:i\d+>>    Add
+  /// CHECK-DAG:                 Return [<<Add>>]
+
+  public static int selectSameValue(int a, int b, int x) {
+    return (a > b) ? x + 1 : x + 1;
+  }
+
+  // A branch with more than one instruction is left alone.
+
+  /// CHECK-START: int Main.noSelect(int, int, int) select_generator (after)
+  /// CHECK-NOT: Select
+
+  public static int noSelect(int a, int b, int x) {
+    return (a > b) ? (x + 1) * x : x;
+  }
+
+  public static void main(String[] args) {
+    expectEquals(3, selectInt(1, 0, 3, 4));
+    expectEquals(4, selectInt(0, 0, 3, 4));
+    expectEquals(5L, selectLong(-1, 0, 5L, 1L << 40));
+    expectEquals(1L << 40, selectLong(0, 0, 5L, 1L << 40));
+    Object o1 = new Object();
+    Object o2 = new Object();
+    expectSame(o1, selectReference(2, 2, o1, o2));
+    expectSame(o2, selectReference(2, 3, o1, o2));
+    expectSame(null, selectReference(2, 3, o1, null));
+    expectEquals(1.5f, selectFloat(1, 1, 1.5f, -2.5f));
+    expectEquals(-2.5f, selectFloat(0, 1, 1.5f, -2.5f));
+    expectEquals(1.5, selectDouble(0, 1, 1.5, Double.NaN));
+    expectEquals(Double.NaN, selectDouble(1, 1, 1.5, Double.NaN));
+    expectEquals(8, selectSameValue(1, 0, 7));
+    expectEquals(8, selectSameValue(0, 1, 7));
+    expectEquals(56, noSelect(1, 0, 7));
+    expectEquals(7, noSelect(0, 1, 7));
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(long expected, long result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(float expected, float result) {
+    if (Float.compare(expected, result) != 0) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(double expected, double result) {
+    if (Double.compare(expected, result) != 0) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectSame(Object expected, Object result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+interface Itf {
+  int getValue();
+}
+
+class A implements Itf {
+  public int getValue() {
+    return 1;
+  }
+}
+
+// Shares the target of A, so A and B can be guarded in front of a single inlined body.
+class B extends A {
+}
+
+class C implements Itf {
+  public int getValue() {
+    return 3;
+  }
+}
+
+// Never seen by the inline caches before the callers are compiled.
+class D implements Itf {
+  public int getValue() {
+    return 4;
+  }
+}
+
+public class Main {
+  static boolean sHasJit;
+  static boolean sCompiled;
+
+  // Only ever sees A before being compiled: inlined behind a monomorphic type guard.
+  static int callMonomorphic(Itf itf, boolean expectDeoptimization) {
+    int result = itf.getValue();
+    if (sHasJit && sCompiled) {
+      expectEquals(expectDeoptimization, isInterpreted());
+    }
+    return result;
+  }
+
+  // Sees A and B before being compiled: inlined behind a polymorphic type guard.
+  static int callPolymorphic(Itf itf, boolean expectDeoptimization) {
+    int result = itf.getValue();
+    if (sHasJit && sCompiled) {
+      expectEquals(expectDeoptimization, isInterpreted());
+    }
+    return result;
+  }
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    sHasJit = hasJit();
+    Itf a = new A();
+    Itf b = new B();
+    Itf c = new C();
+    Itf d = new D();
+
+    // Fill the inline caches from the interpreter, then compile with them.
+    ensureProfilingInfo(Main.class, "callMonomorphic");
+    ensureProfilingInfo(Main.class, "callPolymorphic");
+    for (int i = 0; i < 2; ++i) {
+      expectEquals(1, callMonomorphic(a, false));
+      expectEquals(1, callPolymorphic(a, false));
+      expectEquals(1, callPolymorphic(b, false));
+    }
+    ensureJitCompiled(Main.class, "callMonomorphic");
+    ensureJitCompiled(Main.class, "callPolymorphic");
+    sCompiled = true;
+
+    // The receiver types seen in the profile pass the guards and run the inlined body.
+    System.out.println("A " + callMonomorphic(a, false));
+    System.out.println("A " + callPolymorphic(a, false));
+    System.out.println("B " + callPolymorphic(b, false));
+
+    // Unseen receiver types fail the guards: the compiled code deoptimizes and the
+    // interpreter dispatches the call to the right target.
+    System.out.println("B " + callMonomorphic(b, true));
+    System.out.println("C " + callMonomorphic(c, true));
+    System.out.println("C " + callPolymorphic(c, true));
+    System.out.println("D " + callPolymorphic(d, true));
+
+    // A deoptimization does not discard the code, which keeps running for seen types.
+    System.out.println("A " + callMonomorphic(a, false));
+    System.out.println("B " + callPolymorphic(b, false));
+    if (sHasJit) {
+      expectEquals(true, isJitCompiled(Main.class, "callMonomorphic"));
+      expectEquals(true, isJitCompiled(Main.class, "callPolymorphic"));
+    }
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(boolean expected, boolean result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static native boolean hasJit();
+  private static native boolean isInterpreted();
+  private static native void ensureProfilingInfo(Class<?> cls, String methodName);
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+  private static native boolean isJitCompiled(Class<?> cls, String methodName);
+}
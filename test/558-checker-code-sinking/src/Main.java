@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.util.Arrays;
+
+public class Main {
+
+  // The allocation, its initializing stores and the computation of a stored
+  // value are only needed when throwing.
+
+  /// CHECK-START: int Main.sinkAllocation(int) code_sinking (before)
+  /// CHECK:                      NewArray
+  /// CHECK:                      Add
+  /// CHECK:                      If
+  /// CHECK:                      Throw
+
+  /// CHECK-START: int Main.sinkAllocation(int) code_sinking (after)
+  /// CHECK:                      If
+  /// CHECK:      <<Array:l\d+>>  NewArray
+  /// CHECK:                      ArraySet [<<Array>>,{{i\d+}},{{i\d+}}]
+  /// CHECK:      <<Add:i\d+>>    Add
+  /// CHECK:                      ArraySet [<<Array>>,{{i\d+}},<<Add>>]
+  /// CHECK:                      InvokeStaticOrDirect [<<Array>>{{(,[ij]\d+)?}}]
+  /// CHECK:                      Throw
+
+  public static int sinkAllocation(int x) {
+    int[] values = new int[2];
+    values[0] = x;
+    values[1] = x + 1;
+    if (x < 0) {
+      throw new IllegalArgumentException(Arrays.toString(values));
+    }
+    return x;
+  }
+
+  // The allocation inside the loop stays there, even though it is only used on
+  // a throwing path branching out of the loop.
+
+  /// CHECK-START: int Main.noSinkingOutOfLoop(int[]) code_sinking (before)
+  /// CHECK:                      NewArray loop:<<Loop:B\d+>>
+  /// CHECK:                      ArraySet loop:<<Loop>>
+  /// CHECK:                      If loop:<<Loop>>
+  /// CHECK:                      Throw loop:none
+
+  /// CHECK-START: int Main.noSinkingOutOfLoop(int[]) code_sinking (after)
+  /// CHECK:                      NewArray loop:<<Loop:B\d+>>
+  /// CHECK:                      ArraySet loop:<<Loop>>
+  /// CHECK:                      If loop:<<Loop>>
+  /// CHECK:                      Throw loop:none
+
+  public static int noSinkingOutOfLoop(int[] array) {
+    int sum = 0;
+    for (int i = 0; i < array.length; i++) {
+      int[] values = new int[1];
+      values[0] = array[i];
+      if (array[i] < 0) {
+        throw new IllegalArgumentException(Arrays.toString(values));
+      }
+      sum += array[i];
+    }
+    return sum;
+  }
+
+  public static void main(String[] args) {
+    expectEquals(1, sinkAllocation(1));
+    try {
+      sinkAllocation(-1);
+      throw new Error("Expected IllegalArgumentException");
+    } catch (IllegalArgumentException e) {
+      expectEquals("[-1, 0]", e.getMessage());
+    }
+    expectEquals(6, noSinkingOutOfLoop(new int[] { 1, 2, 3 }));
+    try {
+      noSinkingOutOfLoop(new int[] { 1, -2, 3 });
+      throw new Error("Expected IllegalArgumentException");
+    } catch (IllegalArgumentException e) {
+      expectEquals("[-2]", e.getMessage());
+    }
+  }
+
+  public static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void expectEquals(String expected, String result) {
+    if (!expected.equals(result)) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  static boolean doThrow = false;
+  static int sCounter;
+  static int sInt;
+  static long sLong;
+  static String sString;
+  static String sOther;
+
+  static void $noinline$sideEffect() {
+    if (doThrow) throw new Error();
+    sCounter++;
+  }
+
+  // The multiplication at the start of both branches, with its inputs swapped,
+  // is hoisted before the If.
+
+  /// CHECK-START: void Main.hoist(int, int, boolean) GVN (before)
+  /// CHECK:                    If
+  /// CHECK:                    Mul
+  /// CHECK:                    Mul
+
+  /// CHECK-START: void Main.hoist(int, int, boolean) GVN (after)
+  /// CHECK:                    Mul
+  /// CHECK:                    If
+
+  /// CHECK-START: void Main.hoist(int, int, boolean) GVN (after)
+  /// CHECK:                    Mul
+  /// CHECK-NOT:                Mul
+
+  public static void hoist(int a, int b, boolean c) {
+    if (c) {
+      sInt = (a * b) ^ 5;
+    } else {
+      sInt = (b * a) | 3;
+    }
+  }
+
+  // The load of sInt in the merge block is available at the end of both
+  // branches, which load it again after their call: it becomes a phi.
+
+  /// CHECK-START: long Main.phiOfLoads(boolean) GVN (before)
+  /// CHECK:                    StaticFieldGet
+  /// CHECK:                    StaticFieldGet
+  /// CHECK:                    StaticFieldGet
+  /// CHECK:                    StaticFieldGet
+
+  /// CHECK-START: long Main.phiOfLoads(boolean) GVN (after)
+  /// CHECK:                    InvokeStaticOrDirect
+  /// CHECK:      <<Get1:i\d+>> StaticFieldGet
+  /// CHECK:                    InvokeStaticOrDirect
+  /// CHECK:      <<Get2:i\d+>> StaticFieldGet
+  /// CHECK:      <<Neg:i\d+>>  Neg [<<Get2>>]
+  /// CHECK-DAG:                Phi [<<Get1>>,<<Neg>>]
+  /// CHECK-DAG:                Phi [<<Get1>>,<<Get2>>]
+  /// CHECK-NOT:                StaticFieldGet
+
+  public static long phiOfLoads(boolean c) {
+    long base = sLong;
+    int result;
+    if (c) {
+      $noinline$sideEffect();
+      result = sInt;
+    } else {
+      $noinline$sideEffect();
+      result = -sInt;
+    }
+    return sInt + result + base;
+  }
+
+  // The string and the class loaded in the merge block are only loaded by one
+  // branch: the loads move to the end of the other branch, and become phis.
+
+  /// CHECK-START: void Main.moveToPredecessor(boolean) GVN (before)
+  /// CHECK:                       InvokeStaticOrDirect
+  /// CHECK-NEXT:                  Goto
+  /// CHECK:                       LoadString
+  /// CHECK:                       LoadClass
+  /// CHECK:                       StaticFieldSet
+  /// CHECK:                       LoadString
+  /// CHECK:                       LoadClass
+  /// CHECK:                       StaticFieldSet
+
+  /// CHECK-START: void Main.moveToPredecessor(boolean) GVN (after)
+  /// CHECK:                       InvokeStaticOrDirect
+  /// CHECK-NEXT: <<String1:l\d+>> LoadString
+  /// CHECK-NEXT: <<Class1:l\d+>>  LoadClass
+  /// CHECK-NEXT:                  Goto
+  /// CHECK:      <<String2:l\d+>> LoadString
+  /// CHECK:      <<Class2:l\d+>>  LoadClass
+  /// CHECK:                       StaticFieldSet [<<Class2>>,<<String2>>]
+  /// CHECK-DAG:  <<String:l\d+>>  Phi [<<String1>>,<<String2>>]
+  /// CHECK-DAG:  <<Class:l\d+>>   Phi [<<Class1>>,<<Class2>>]
+  /// CHECK-DAG:                   StaticFieldSet [<<Class>>,<<String>>]
+  /// CHECK-NOT:                   LoadString
+  /// CHECK-NOT:                   LoadClass
+
+  public static void moveToPredecessor(boolean c) {
+    if (c) {
+      $noinline$sideEffect();
+    } else {
+      sString = "string";
+    }
+    sOther = "string";
+  }
+
+  public static void main(String[] args) {
+    hoist(6, 7, true);
+    expectEquals(42 ^ 5, sInt);
+    hoist(6, 7, false);
+    expectEquals(42 | 3, sInt);
+
+    sInt = 2;
+    sLong = 40L;
+    expectEquals(44L, phiOfLoads(true));
+    expectEquals(40L, phiOfLoads(false));
+
+    moveToPredecessor(true);
+    expectEquals(null, sString);
+    expectEquals("string", sOther);
+    sOther = null;
+    moveToPredecessor(false);
+    expectEquals("string", sString);
+    expectEquals("string", sOther);
+    expectEquals(3, sCounter);
+  }
+
+  public static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void expectEquals(long expected, long result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void expectEquals(String expected, String result) {
+    if (expected == null ? result != null : !expected.equals(result)) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  static boolean sHasJit;
+  static int sValue;
+
+  // Runs long enough in its baseline code for the tier-up sampler to find it.
+  static int hot(int iterations) {
+    int sum = 0;
+    for (int i = 0; i < iterations; i++) {
+      sum += i ^ sValue;
+    }
+    return sum;
+  }
+
+  // Its baseline code is replaced while this frame executes it, and survives a code
+  // cache collection for this frame to return to.
+  static int runningBaseline(boolean replace) {
+    int result = 1;
+    if (replace) {
+      result += $noinline$replaceAndCollect();
+    }
+    return result;
+  }
+
+  static int $noinline$replaceAndCollect() {
+    if (sHasJit) {
+      ensureJitCompiled(Main.class, "runningBaseline");
+      expectEquals(false, isJitBaselineCompiled(Main.class, "runningBaseline"));
+      collectJitCodeCache();
+      // The optimized code is not running, and is freed. The baseline code is running, and
+      // kept, but it was replaced and must not become the entry point again.
+      expectEquals(false, isJitCompiled(Main.class, "runningBaseline"));
+    }
+    return 1;
+  }
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    sHasJit = hasJit();
+
+    // Baseline code becomes hot and gets replaced by optimized code.
+    ensureJitBaselineCompiled(Main.class, "hot");
+    if (sHasJit) {
+      expectEquals(true, isJitBaselineCompiled(Main.class, "hot"));
+    }
+    long deadline = System.currentTimeMillis() + 60 * 1000;
+    while (sHasJit && isJitBaselineCompiled(Main.class, "hot")) {
+      if (System.currentTimeMillis() > deadline) {
+        throw new Error("Baseline code of hot() was not replaced");
+      }
+      hot(1000000);
+    }
+    if (sHasJit) {
+      expectEquals(true, isJitCompiled(Main.class, "hot"));
+    }
+    System.out.println("hot " + hot(10));
+
+    // Replaced baseline code stays usable by the frames executing it.
+    ensureJitBaselineCompiled(Main.class, "runningBaseline");
+    System.out.println("runningBaseline " + runningBaseline(true));
+    System.out.println("runningBaseline " + runningBaseline(false));
+    ensureJitCompiled(Main.class, "runningBaseline");
+    if (sHasJit) {
+      expectEquals(false, isJitBaselineCompiled(Main.class, "runningBaseline"));
+      expectEquals(true, isJitCompiled(Main.class, "runningBaseline"));
+    }
+    System.out.println("runningBaseline " + runningBaseline(false));
+  }
+
+  private static void expectEquals(boolean expected, boolean result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static native boolean hasJit();
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+  private static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+  private static native boolean isJitCompiled(Class<?> cls, String methodName);
+  private static native boolean isJitBaselineCompiled(Class<?> cls, String methodName);
+  private static native void collectJitCodeCache();
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jni.h"
+
+#include "art_method-inl.h"
+#include "entrypoints/runtime_asm_entrypoints.h"
+#include "scoped_thread_state_change.h"
+
+namespace art {
+
+// Defined in libarttest, which indexes its JNI symbols when loaded.
+
+extern "C" JNIEXPORT jint JNICALL Java_Main_indexHit(JNIEnv*, jclass) {
+  return 42;
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_Prelinked_value(JNIEnv*, jclass) {
+  return 7;
+}
+
+// "Aa" and "BB" have the same hash, so the index cannot tell Java_Prelinked_nativeBB, which is
+// not defined anywhere, from this symbol.
+extern "C" JNIEXPORT jint JNICALL Java_Prelinked_nativeAa(JNIEnv*, jclass) {
+  return 1;
+}
+
+// Only reachable from the classes of another class loader through a library that depends on
+// libarttest.
+extern "C" JNIEXPORT jint JNICALL Java_Dependent_fromDependency(JNIEnv*, jclass) {
+  return 3;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_isNativeMethodBound(JNIEnv* env,
+                                                                   jclass,
+                                                                   jobject reflected_method) {
+  ScopedObjectAccess soa(env);
+  ArtMethod* method = ArtMethod::FromReflectedMethod(soa, reflected_method);
+  CHECK(method->IsNative());
+  return method->GetEntryPointFromJni() != GetJniDlsymLookupStub();
+}
+
+}  // namespace art
@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Loaded by its own class loader, which only has libjnisymbolindex.
+public class Dependent {
+    public static void loadLibrary(String name) {
+        System.loadLibrary(name);
+    }
+
+    // Defined in libjnisymbolindex itself.
+    public static native int fromLibrary();
+
+    // Defined in libarttest, a dependency of libjnisymbolindex.
+    public static native int fromDependency();
+}
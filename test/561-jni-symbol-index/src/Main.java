@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Constructor;
+import java.lang.reflect.Method;
+
+class Prelinked {
+    static {
+        System.out.println("Prelinked.<clinit>");
+    }
+
+    static void initialize() {
+    }
+
+    static native int value();
+    static native int nativeAa();
+    static native int nativeBB();
+}
+
+public class Main {
+    static final String DEX_FILE = System.getenv("DEX_LOCATION") + "/561-jni-symbol-index-ex.jar";
+
+    public static void main(String[] args) throws Exception {
+        System.loadLibrary(args[0]);
+
+        // Main was initialized before libarttest was loaded, so this goes through the dlsym
+        // lookup stub, which finds the symbol in the index.
+        System.out.println("indexHit " + indexHit());
+
+        testPrelink();
+        testCollision();
+        // The debug build of the test library links against the debug build of libarttest.
+        testDependency(args[0].endsWith("d") ? "jnisymbolindexd" : "jnisymbolindex");
+    }
+
+    private static void testPrelink() throws Exception {
+        // Neither the class literal nor reflection initialize the class.
+        Method value = Prelinked.class.getDeclaredMethod("value");
+        Method nativeBB = Prelinked.class.getDeclaredMethod("nativeBB");
+        System.out.println("value bound before init: " + isNativeMethodBound(value));
+        Prelinked.initialize();
+        System.out.println("value bound after init: " + isNativeMethodBound(value));
+        System.out.println("nativeBB bound after init: " + isNativeMethodBound(nativeBB));
+        System.out.println("value " + Prelinked.value());
+    }
+
+    private static void testCollision() {
+        System.out.println("nativeAa " + Prelinked.nativeAa());
+        try {
+            Prelinked.nativeBB();
+            System.out.println("nativeBB found");
+        } catch (UnsatisfiedLinkError e) {
+            System.out.println("nativeBB UnsatisfiedLinkError");
+        }
+    }
+
+    private static void testDependency(String libraryName) throws Exception {
+        Class<?> pathClassLoader = Class.forName("dalvik.system.PathClassLoader");
+        Constructor<?> constructor =
+            pathClassLoader.getDeclaredConstructor(String.class, ClassLoader.class);
+        ClassLoader loader =
+            (ClassLoader) constructor.newInstance(DEX_FILE, Main.class.getClassLoader());
+        Class<?> dependent = loader.loadClass("Dependent");
+        dependent.getDeclaredMethod("loadLibrary", String.class).invoke(null, libraryName);
+        Method fromLibrary = dependent.getDeclaredMethod("fromLibrary");
+        System.out.println("fromLibrary " + fromLibrary.invoke(null));
+        Method fromDependency = dependent.getDeclaredMethod("fromDependency");
+        System.out.println("fromDependency " + fromDependency.invoke(null));
+    }
+
+    private static native int indexHit();
+    private static native boolean isNativeMethodBound(Method method);
+}
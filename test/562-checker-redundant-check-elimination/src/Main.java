@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2015 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Super {
+  int value = 1;
+}
+
+class SubA extends Super {
+  SubA() {
+    value = 2;
+  }
+}
+
+class Other {
+}
+
+public class Main {
+
+  // The checks of an inlined callee are only known after inlining, so reference type
+  // propagation did not use them to refine the checks of the caller.
+
+  public static Super $inline$castToSuper(Object o) {
+    return (Super) o;
+  }
+
+  public static int $inline$superValue(Object o) {
+    return ((Super) o).value;
+  }
+
+  public static boolean $inline$isSubA(Object o) {
+    return o instanceof SubA;
+  }
+
+  /// CHECK-START: int Main.castAfterInlinedCast(java.lang.Object) redundant_check_elimination (before)
+  /// CHECK:         LoadClass
+  /// CHECK:         CheckCast
+  /// CHECK:         LoadClass
+  /// CHECK:         CheckCast
+
+  /// CHECK-START: int Main.castAfterInlinedCast(java.lang.Object) redundant_check_elimination (after)
+  /// CHECK:         CheckCast
+  /// CHECK-NOT:     CheckCast
+
+  /// CHECK-START: int Main.castAfterInlinedCast(java.lang.Object) redundant_check_elimination (after)
+  /// CHECK:         LoadClass
+  /// CHECK-NOT:     LoadClass
+  public static int castAfterInlinedCast(Object o) {
+    $inline$castToSuper(o);
+    return ((Super) o).value;
+  }
+
+  /// CHECK-START: boolean Main.instanceOfAfterInlinedCast(java.lang.Object) redundant_check_elimination (before)
+  /// CHECK:         InstanceOf
+
+  /// CHECK-START: boolean Main.instanceOfAfterInlinedCast(java.lang.Object) redundant_check_elimination (after)
+  /// CHECK-NOT:     InstanceOf
+
+  /// CHECK-START: boolean Main.instanceOfAfterInlinedCast(java.lang.Object) redundant_check_elimination (after)
+  /// CHECK-DAG:     <<Object:l\d+>> ParameterValue
+  /// CHECK-DAG:     <<Null:l\d+>>   NullConstant
+  /// CHECK-DAG:     <<Test:z\d+>>   NotEqual [<<Null>>,<<Object>>]
+  /// CHECK-DAG:                     Return [<<Test>>]
+  public static boolean instanceOfAfterInlinedCast(Object o) {
+    // The cast lets null through, so only the null test is left.
+    $inline$castToSuper(o);
+    return o instanceof Super;
+  }
+
+  /// CHECK-START: boolean Main.instanceOfAfterInlinedFieldGet(java.lang.Object) redundant_check_elimination (before)
+  /// CHECK:         InstanceOf
+
+  /// CHECK-START: boolean Main.instanceOfAfterInlinedFieldGet(java.lang.Object) redundant_check_elimination (after)
+  /// CHECK-NOT:     InstanceOf
+
+  /// CHECK-START: boolean Main.instanceOfAfterInlinedFieldGet(java.lang.Object) redundant_check_elimination (after)
+  /// CHECK-DAG:     <<Const1:i\d+>> IntConstant 1
+  /// CHECK-DAG:                     Return [<<Const1>>]
+
+  /// CHECK-START: boolean Main.instanceOfAfterInlinedFieldGet(java.lang.Object) redundant_check_elimination (after)
+  /// CHECK:         LoadClass
+  /// CHECK-NOT:     LoadClass
+  public static boolean instanceOfAfterInlinedFieldGet(Object o) {
+    // The field access also rules out null.
+    sValue = $inline$superValue(o);
+    return o instanceof Super;
+  }
+
+  /// CHECK-START: boolean Main.notInstanceOfSuper(java.lang.Object) redundant_check_elimination (before)
+  /// CHECK:         InstanceOf
+  /// CHECK:         InstanceOf
+
+  /// CHECK-START: boolean Main.notInstanceOfSuper(java.lang.Object) redundant_check_elimination (after)
+  /// CHECK:         InstanceOf
+  /// CHECK-NOT:     InstanceOf
+  public static boolean notInstanceOfSuper(Object o) {
+    if (o instanceof Super) {
+      return false;
+    }
+    // An object which is not a Super is not a SubA either.
+    return $inline$isSubA(o);
+  }
+
+  /// CHECK-START: SubA Main.castAfterInlinedNullCheck(java.lang.Object) redundant_check_elimination (before)
+  /// CHECK:         CheckCast
+  /// CHECK:         CheckCast must_do_null_check:true
+
+  /// CHECK-START: SubA Main.castAfterInlinedNullCheck(java.lang.Object) redundant_check_elimination (after)
+  /// CHECK:         CheckCast
+  /// CHECK:         CheckCast must_do_null_check:false
+  public static SubA castAfterInlinedNullCheck(Object o) {
+    // The cast to SubA may still fail, but it no longer needs to test for null.
+    sValue = $inline$superValue(o);
+    return (SubA) o;
+  }
+
+  public static void main(String[] args) {
+    Super sup = new Super();
+    SubA subA = new SubA();
+    Other other = new Other();
+
+    expectEquals(1, castAfterInlinedCast(sup));
+    expectEquals(2, castAfterInlinedCast(subA));
+    try {
+      castAfterInlinedCast(other);
+      throw new Error("Expected ClassCastException");
+    } catch (ClassCastException e) {
+      // Expected.
+    }
+    try {
+      castAfterInlinedCast(null);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException e) {
+      // Expected.
+    }
+
+    expectEquals(true, instanceOfAfterInlinedCast(sup));
+    expectEquals(true, instanceOfAfterInlinedCast(subA));
+    expectEquals(false, instanceOfAfterInlinedCast(null));
+
+    expectEquals(true, instanceOfAfterInlinedFieldGet(subA));
+    expectEquals(2, sValue);
+
+    expectEquals(false, notInstanceOfSuper(sup));
+    expectEquals(false, notInstanceOfSuper(subA));
+    expectEquals(false, notInstanceOfSuper(other));
+    expectEquals(false, notInstanceOfSuper(null));
+
+    expectEquals(subA, castAfterInlinedNullCheck(subA));
+    try {
+      castAfterInlinedNullCheck(sup);
+      throw new Error("Expected ClassCastException");
+    } catch (ClassCastException e) {
+      // Expected.
+    }
+    try {
+      castAfterInlinedNullCheck(null);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException e) {
+      // Expected.
+    }
+  }
+
+  public static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void expectEquals(boolean expected, boolean result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  public static void expectEquals(Object expected, Object result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  static int sValue;
+}
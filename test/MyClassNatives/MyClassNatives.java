@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+import dalvik.annotation.optimization.CriticalNative;
+
 class MyClassNatives {
     native void throwException();
     native void foo();
@@ -102,4 +104,7 @@ class MyClassNatives {
     static native boolean returnTrue();
     static native boolean returnFalse();
     static native int returnInt();
+
+    @CriticalNative
+    static native int criticalAdd(int x, int y);
 }
@@ -16,14 +16,20 @@
 
 #include "jni.h"
 
+#include "art_method-inl.h"
 #include "base/logging.h"
+#include "class_linker.h"
 #include "dex_file-inl.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
+#include "jit/profiling_info.h"
 #include "mirror/class-inl.h"
 #include "nth_caller_visitor.h"
 #include "runtime.h"
 #include "scoped_thread_state_change.h"
 #include "stack.h"
 #include "thread-inl.h"
+#include "ScopedUtfChars.h"
 
 namespace art {
 
@@ -116,4 +122,137 @@ extern "C" JNIEXPORT jboolean JNICALL Java_Main_compiledWithOptimizing(JNIEnv* e
   return JNI_TRUE;
 }
 
+// public static native boolean hasJit();
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_hasJit(JNIEnv* env ATTRIBUTE_UNUSED,
+                                                       jclass cls ATTRIBUTE_UNUSED) {
+  return Runtime::Current()->GetJit() != nullptr ? JNI_TRUE : JNI_FALSE;
+}
+
+static ArtMethod* FindMethodByName(ScopedObjectAccess& soa, jclass cls, jstring method_name)
+    SHARED_REQUIRES(Locks::mutator_lock_) {
+  ScopedUtfChars chars(soa.Env(), method_name);
+  CHECK(chars.c_str() != nullptr);
+  mirror::Class* klass = soa.Decode<mirror::Class*>(cls);
+  size_t pointer_size = Runtime::Current()->GetClassLinker()->GetImagePointerSize();
+  for (ArtMethod& method : klass->GetDirectMethods(pointer_size)) {
+    if (strcmp(method.GetName(), chars.c_str()) == 0) {
+      return &method;
+    }
+  }
+  ArtMethod* method = klass->FindDeclaredVirtualMethodByName(chars.c_str(), pointer_size);
+  CHECK(method != nullptr) << "Unable to find method " << chars.c_str();
+  return method;
+}
+
+// public static native void ensureJitCompiled(Class<?> cls, String methodName);
+// Compile the method with the JIT, unless its current entry point is already optimized
+// JIT code.
+
+extern "C" JNIEXPORT void JNICALL Java_Main_ensureJitCompiled(JNIEnv* env,
+                                                             jclass,
+                                                             jclass cls,
+                                                             jstring method_name) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr) {
+    return;
+  }
+  ScopedObjectAccess soa(env);
+  ArtMethod* method = FindMethodByName(soa, cls, method_name);
+  jit::JitCodeCache* code_cache = jit->GetCodeCache();
+  // A compilation may fail because of a concurrent class load, so try until the code is in.
+  while (!code_cache->ContainsPc(method->GetEntryPointFromQuickCompiledCode()) ||
+         code_cache->IsBaselineCompiled(method)) {
+    jit->CompileMethod(method, soa.Self(), /* baseline */ false);
+  }
+}
+
+// public static native void ensureJitBaselineCompiled(Class<?> cls, String methodName);
+// Compile the method with the baseline tier of the JIT, unless its current entry point is
+// already JIT code.
+
+extern "C" JNIEXPORT void JNICALL Java_Main_ensureJitBaselineCompiled(JNIEnv* env,
+                                                                     jclass,
+                                                                     jclass cls,
+                                                                     jstring method_name) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr) {
+    return;
+  }
+  ScopedObjectAccess soa(env);
+  ArtMethod* method = FindMethodByName(soa, cls, method_name);
+  jit::JitCodeCache* code_cache = jit->GetCodeCache();
+  while (!code_cache->ContainsPc(method->GetEntryPointFromQuickCompiledCode())) {
+    jit->CompileMethod(method, soa.Self(), /* baseline */ true);
+  }
+}
+
+// public static native boolean isJitBaselineCompiled(Class<?> cls, String methodName);
+// Whether the method has baseline JIT code which optimized code did not replace yet.
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_isJitBaselineCompiled(JNIEnv* env,
+                                                                     jclass,
+                                                                     jclass cls,
+                                                                     jstring method_name) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr) {
+    return JNI_FALSE;
+  }
+  ScopedObjectAccess soa(env);
+  ArtMethod* method = FindMethodByName(soa, cls, method_name);
+  return jit->GetCodeCache()->IsBaselineCompiled(method) ? JNI_TRUE : JNI_FALSE;
+}
+
+// public static native void collectJitCodeCache();
+// Run a collection of the JIT code cache.
+
+extern "C" JNIEXPORT void JNICALL Java_Main_collectJitCodeCache(JNIEnv* env, jclass) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr) {
+    return;
+  }
+  ScopedObjectAccess soa(env);
+  // A request following a collection may only grow the code cache, so make two.
+  jit->GetCodeCache()->GarbageCollectCache(soa.Self());
+  jit->GetCodeCache()->GarbageCollectCache(soa.Self());
+}
+
+// public static native void ensureProfilingInfo(Class<?> cls, String methodName);
+// Allocate the profiling info of the method, so that the interpreter fills its inline caches.
+
+extern "C" JNIEXPORT void JNICALL Java_Main_ensureProfilingInfo(JNIEnv* env,
+                                                               jclass,
+                                                               jclass cls,
+                                                               jstring method_name) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr) {
+    return;
+  }
+  ScopedObjectAccess soa(env);
+  ArtMethod* method = FindMethodByName(soa, cls, method_name);
+  size_t pointer_size = Runtime::Current()->GetClassLinker()->GetImagePointerSize();
+  if (method->GetProfilingInfo(pointer_size) == nullptr) {
+    CHECK(ProfilingInfo::Create(soa.Self(), method, /* retry_allocation */ true))
+        << "Unable to allocate the profiling info of " << PrettyMethod(method);
+  }
+}
+
+// public static native boolean isJitCompiled(Class<?> cls, String methodName);
+// Whether the entry point of the method is JIT code.
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_isJitCompiled(JNIEnv* env,
+                                                             jclass,
+                                                             jclass cls,
+                                                             jstring method_name) {
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr) {
+    return JNI_FALSE;
+  }
+  ScopedObjectAccess soa(env);
+  ArtMethod* method = FindMethodByName(soa, cls, method_name);
+  return jit->GetCodeCache()->ContainsPc(method->GetEntryPointFromQuickCompiledCode())
+      ? JNI_TRUE
+      : JNI_FALSE;
+}
+
 }  // namespace art
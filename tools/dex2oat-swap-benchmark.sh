@@ -0,0 +1,65 @@
+#!/bin/bash
+#
+# Copyright (C) 2015 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Compares peak RSS and wall time of a host dex2oat compilation with and without a swap file.
+#
+# Usage: dex2oat-swap-benchmark.sh [--runs N] <dex2oat arguments>
+#
+# The dex2oat arguments must not contain --swap-file or --swap-fd. Note that dex2oat only uses
+# the swap file for apps with at least two dex files and 20MB of dex code.
+
+if [ -z "$ANDROID_HOST_OUT" ]; then
+  echo "ANDROID_HOST_OUT is not set, run lunch first."
+  exit 1
+fi
+
+runs=3
+if [ "$1" = "--runs" ]; then
+  runs=$2
+  shift 2
+fi
+
+dex2oat=$ANDROID_HOST_OUT/bin/dex2oat
+time_cmd=/usr/bin/time
+if [ ! -x $time_cmd ]; then
+  echo "$time_cmd is required to measure peak RSS."
+  exit 1
+fi
+
+swap_file=$(mktemp /tmp/dex2oat-swap.XXXXXX)
+trap "rm -f $swap_file" EXIT
+
+function run_dex2oat() {
+  local mode=$1
+  shift
+  local total_time=0
+  local max_rss=0
+  for i in $(seq 1 $runs); do
+    # %e: elapsed seconds, %M: maximum resident set size in KB.
+    local result=$($time_cmd -f "%e %M" "$dex2oat" "$@" 2>&1 >/dev/null | tail -n 1)
+    local elapsed=$(echo $result | cut -d' ' -f1)
+    local rss=$(echo $result | cut -d' ' -f2)
+    total_time=$(echo "$total_time + $elapsed" | bc)
+    if [ "$rss" -gt "$max_rss" ]; then
+      max_rss=$rss
+    fi
+  done
+  echo "$mode: average time $(echo "scale=2; $total_time / $runs" | bc)s," \
+       "peak RSS $((max_rss / 1024))MB over $runs runs"
+}
+
+run_dex2oat "without swap" "$@"
+run_dex2oat "with swap" --swap-file=$swap_file "$@"